@@ -15,9 +15,14 @@ void Camera::Init(){
 
 	cameraMatrix_ = MakeAffineMatrix(cameraTransform_);
 
-	viewMatrix_ = Inverse(cameraMatrix_);
-
-	prijectionMatrix_ = MakePerspectiveFovMatrix(0.45f, float(1280) / float(720), 0.1f, 100.0f);
+	// カメラは拡縮しないので回転と平行移動だけの逆行列で良い
+	viewMatrix_ = InverseRigid(cameraMatrix_);
+
+	fovY_ = 0.45f;
+	aspectRatio_ = float(1280) / float(720);
+	nearClip_ = 0.1f;
+	farClip_ = 100.0f;
+	prijectionMatrix_ = MakePerspectiveFovMatrix(fovY_, aspectRatio_, nearClip_, farClip_);
 
 	vpMatrix_ = Multiply(viewMatrix_, prijectionMatrix_);
 }
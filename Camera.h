@@ -12,6 +12,11 @@ private:
 	Matrix4x4 viewMatrix_;
 	Matrix4x4 vpMatrix_;
 
+	float fovY_;
+	float aspectRatio_;
+	float nearClip_;
+	float farClip_;
+
 public:
 
 	Camera();
@@ -23,5 +28,11 @@ public:
 
 	/// accsser
 	Matrix4x4 GetVpMatrix() const { return vpMatrix_; }
+	Matrix4x4 GetProjectionMatrix() const { return prijectionMatrix_; }
+	Vector3 GetTranslate() const { return cameraTransform_.translate; }
+	float GetFovY() const { return fovY_; }
+	float GetAspectRatio() const { return aspectRatio_; }
+	float GetNearClip() const { return nearClip_; }
+	float GetFarClip() const { return farClip_; }
 };
 
@@ -0,0 +1,236 @@
+#include "CookManifest.h"
+#include "Function/Hash.h"
+
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+/// 表のファイルの識別子("CMAN")
+const uint32_t kCookManifestMagic = 0x4E414D43;
+/// 形式を変えた時に上げる
+const uint32_t kCookManifestVersion = 1;
+
+/// <summary>
+/// 表のファイルの先頭
+/// この後に エントリ(元ファイル, 焼いたファイルのパス, 依存ファイルの数 u32, 依存ファイル × 数) × entryCount と続く
+/// ファイルは パスの長さ u32, UTF-8のパス, 大きさ u64, 更新日時 i64, ハッシュ u64
+/// </summary>
+struct CookManifestHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t entryCount;
+	uint32_t reserved;
+};
+
+template<typename T>
+bool ReadValue(std::ifstream& file, T& value) {
+	file.read(reinterpret_cast<char*>(&value), sizeof(T));
+	return static_cast<bool>(file);
+}
+
+template<typename T>
+void WriteValue(std::ofstream& file, const T& value) {
+	file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+bool ReadPath(std::ifstream& file, uint64_t remainingSize, std::wstring& outPath) {
+	uint32_t pathSize = 0;
+	// 壊れた長さで大きな領域を確保しないように、残りの大きさと比べる
+	if (!ReadValue(file, pathSize) || pathSize > remainingSize) {
+		return false;
+	}
+	std::u8string path(pathSize, u8'\0');
+	file.read(reinterpret_cast<char*>(path.data()), pathSize);
+	if (!file) {
+		return false;
+	}
+	outPath = std::filesystem::path(path).generic_wstring();
+	return true;
+}
+
+void WritePath(std::ofstream& file, const std::wstring& path) {
+	const std::u8string utf8 = std::filesystem::path(path).generic_u8string();
+	WriteValue(file, uint32_t(utf8.size()));
+	file.write(reinterpret_cast<const char*>(utf8.data()), utf8.size());
+}
+
+bool ReadSourceFile(std::ifstream& file, uint64_t remainingSize, CookSourceFile& outFile) {
+	return ReadPath(file, remainingSize, outFile.filePath) && ReadValue(file, outFile.size) && ReadValue(file, outFile.writeTime) && ReadValue(file, outFile.hash);
+}
+
+void WriteSourceFile(std::ofstream& file, const CookSourceFile& sourceFile) {
+	WritePath(file, sourceFile.filePath);
+	WriteValue(file, sourceFile.size);
+	WriteValue(file, sourceFile.writeTime);
+	WriteValue(file, sourceFile.hash);
+}
+
+/// <summary>
+/// 大きさと更新日時(読めなければfalse)
+/// </summary>
+bool GetFileStamp(const std::wstring& filePath, uint64_t& outSize, int64_t& outWriteTime) {
+	std::error_code error;
+	const std::filesystem::path path(filePath);
+	outSize = std::filesystem::file_size(path, error);
+	if (error) {
+		return false;
+	}
+	const std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(path, error);
+	if (error) {
+		return false;
+	}
+	outWriteTime = static_cast<int64_t>(writeTime.time_since_epoch().count());
+	return true;
+}
+
+}
+
+//=============================================================================================================================
+//	ファイル
+//=============================================================================================================================
+std::wstring NormalizeCookPath(const std::wstring& filePath) {
+	std::filesystem::path path(filePath);
+	if (path.is_absolute()) {
+		std::error_code error;
+		const std::filesystem::path currentPath = std::filesystem::current_path(error);
+		if (!error) {
+			path = path.lexically_proximate(currentPath);
+		}
+	}
+	return path.lexically_normal().generic_wstring();
+}
+
+std::wstring GetCookManifestPath(const std::wstring& cacheDirectory) {
+	return (std::filesystem::path(cacheDirectory) / L"manifest.bin").generic_wstring();
+}
+
+bool MakeCookSourceFile(const std::wstring& filePath, CookSourceFile& outFile) {
+	outFile.filePath = NormalizeCookPath(filePath);
+	// 日時を先に取る(ハッシュを取っている間に書き換わっても、次に比べた時に日時が違うので取り直しになる)
+	if (!GetFileStamp(filePath, outFile.size, outFile.writeTime)) {
+		return false;
+	}
+	return HashFile(filePath, outFile.hash);
+}
+
+bool IsCookSourceUnchanged(const CookSourceFile& file) {
+	uint64_t size = 0;
+	int64_t writeTime = 0;
+	if (!GetFileStamp(file.filePath, size, writeTime) || size != file.size) {
+		return false;
+	}
+	if (writeTime == file.writeTime) {
+		return true;
+	}
+	uint64_t hash = 0;
+	return HashFile(file.filePath, hash) && hash == file.hash;
+}
+
+//=============================================================================================================================
+//	表
+//=============================================================================================================================
+bool CookManifest::Load(const std::wstring& manifestPath) {
+	entries_.clear();
+
+	std::error_code error;
+	const uint64_t fileSize = std::filesystem::file_size(std::filesystem::path(manifestPath), error);
+	if (error) {
+		return false;
+	}
+	std::ifstream file(std::filesystem::path(manifestPath), std::ios::binary);
+	if (!file) {
+		return false;
+	}
+
+	CookManifestHeader header{};
+	if (!ReadValue(file, header) || header.magic != kCookManifestMagic || header.version != kCookManifestVersion) {
+		return false;
+	}
+
+	for (uint32_t index = 0; index < header.entryCount; ++index) {
+		CookManifestEntry entry;
+		uint32_t dependencyCount = 0;
+		if (!ReadSourceFile(file, fileSize, entry.source) || !ReadPath(file, fileSize, entry.cookedPath) || !ReadValue(file, dependencyCount) || dependencyCount > fileSize) {
+			entries_.clear();
+			return false;
+		}
+		entry.dependencies.resize(dependencyCount);
+		for (CookSourceFile& dependency : entry.dependencies) {
+			if (!ReadSourceFile(file, fileSize, dependency)) {
+				entries_.clear();
+				return false;
+			}
+		}
+		const std::wstring key = entry.source.filePath;
+		entries_[key] = std::move(entry);
+	}
+	return true;
+}
+
+bool CookManifest::Save(const std::wstring& manifestPath) const {
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(manifestPath).parent_path(), error);
+
+	// 途中で止まっても壊れた表が残らないように、一時ファイルに書いてから名前を変える
+	const std::wstring tempPath = manifestPath + L".tmp";
+	{
+		std::ofstream file(std::filesystem::path(tempPath), std::ios::binary | std::ios::trunc);
+		if (!file) {
+			return false;
+		}
+
+		CookManifestHeader header{};
+		header.magic = kCookManifestMagic;
+		header.version = kCookManifestVersion;
+		header.entryCount = uint32_t(entries_.size());
+		WriteValue(file, header);
+
+		for (const auto& [key, entry] : entries_) {
+			WriteSourceFile(file, entry.source);
+			WritePath(file, entry.cookedPath);
+			WriteValue(file, uint32_t(entry.dependencies.size()));
+			for (const CookSourceFile& dependency : entry.dependencies) {
+				WriteSourceFile(file, dependency);
+			}
+		}
+		if (!file) {
+			file.close();
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+	}
+
+	std::filesystem::rename(tempPath, manifestPath, error);
+	if (error) {
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+	return true;
+}
+
+void CookManifest::Set(const CookManifestEntry& entry) {
+	entries_[entry.source.filePath] = entry;
+}
+
+const CookManifestEntry* CookManifest::Find(const std::wstring& sourcePath) const {
+	auto it = entries_.find(NormalizeCookPath(sourcePath));
+	return it != entries_.end() ? &it->second : nullptr;
+}
+
+std::wstring CookManifest::Resolve(const std::wstring& sourcePath) const {
+	const CookManifestEntry* entry = Find(sourcePath);
+	if (!entry || !IsCookSourceUnchanged(entry->source)) {
+		return std::wstring();
+	}
+	for (const CookSourceFile& dependency : entry->dependencies) {
+		if (!IsCookSourceUnchanged(dependency)) {
+			return std::wstring();
+		}
+	}
+	std::error_code error;
+	if (!std::filesystem::exists(entry->cookedPath, error)) {
+		return std::wstring();
+	}
+	return entry->cookedPath;
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*================================================================================================
+AssetCookerが書く、元ファイル → 焼いたファイルの対応表(<キャッシュ>/manifest.bin)
+実行時は元ファイルの大きさと更新日時だけを比べて焼いたファイルを探す(内容のハッシュは、どちらかが違う時だけ取り直す)
+焼いた時の設定は表に載っているファイルで決まるので、実行時に設定を知らなくて良い
+==================================================================================================*/
+
+/// <summary>
+/// 焼いた時の元ファイル(依存ファイルも同じ形で持つ)
+/// </summary>
+struct CookSourceFile {
+	std::wstring filePath;			// NormalizeCookPathした形
+	uint64_t size = 0;
+	int64_t writeTime = 0;			// std::filesystem::last_write_timeの値
+	uint64_t hash = 0;				// 内容のハッシュ(HashFile)
+};
+
+/// <summary>
+/// 元ファイル1つ分
+/// </summary>
+struct CookManifestEntry {
+	CookSourceFile source;
+	std::vector<CookSourceFile> dependencies;	// 変わったら焼き直しが必要なファイル(OBJのmtl等)
+	std::wstring cookedPath;
+};
+
+/// <summary>
+/// 表のキー・記録に使うパスの形(作業ディレクトリからの相対、'/'区切り)
+/// </summary>
+std::wstring NormalizeCookPath(const std::wstring& filePath);
+
+/// <summary>
+/// 表の置き場所
+/// </summary>
+std::wstring GetCookManifestPath(const std::wstring& cacheDirectory);
+
+/// <summary>
+/// ファイルの今の大きさ・更新日時・内容のハッシュを取る
+/// </summary>
+/// <returns>読めなければfalse</returns>
+bool MakeCookSourceFile(const std::wstring& filePath, CookSourceFile& outFile);
+
+/// <summary>
+/// 記録した時から内容が変わっていないか
+/// 大きさと更新日時が同じなら読まずに変わっていないとみなし、違う時だけハッシュで比べる(触っただけなら変わっていない)
+/// </summary>
+bool IsCookSourceUnchanged(const CookSourceFile& file);
+
+/// <summary>
+/// 対応表。読み込んだ後は書き換えなければ複数のスレッドから引いて良い
+/// </summary>
+class CookManifest {
+public:
+
+	CookManifest() = default;
+	~CookManifest() = default;
+
+	/// <summary>
+	/// 読み込む(今の内容は捨てる)
+	/// </summary>
+	/// <returns>ファイルがない・壊れている・形式が古い場合はfalse(空になる)</returns>
+	bool Load(const std::wstring& manifestPath);
+
+	/// <summary>
+	/// 書き出す(一時ファイルに書いてから名前を変える)
+	/// </summary>
+	bool Save(const std::wstring& manifestPath) const;
+
+	/// <summary>
+	/// 追加する(同じ元ファイルがあれば置き換える)
+	/// </summary>
+	void Set(const CookManifestEntry& entry);
+
+	/// <summary>
+	/// 元ファイルの記録を探す(なければnullptr)
+	/// </summary>
+	const CookManifestEntry* Find(const std::wstring& sourcePath) const;
+
+	/// <summary>
+	/// 焼いたファイルが使えればそのパスを返す
+	/// 表にない・元ファイルか依存ファイルが変わった・焼いたファイルがない場合は空
+	/// </summary>
+	std::wstring Resolve(const std::wstring& sourcePath) const;
+
+public: // accessor
+
+	size_t GetEntryCount() const { return entries_.size(); }
+
+private:
+
+	// キーはNormalizeCookPathした元ファイルのパス
+	std::unordered_map<std::wstring, CookManifestEntry> entries_;
+};
@@ -0,0 +1,195 @@
+#include "CommandRecorder.h"
+#include <cassert>
+#include <cstring>
+
+namespace {
+
+template<typename T>
+bool IsSameArray(const T* cached, uint32_t cachedCount, const T* values, uint32_t count) {
+	return cachedCount == count && std::memcmp(cached, values, sizeof(T) * count) == 0;
+}
+
+bool IsSameView(const VertexBufferView& a, const VertexBufferView& b) {
+	return a.bufferLocation == b.bufferLocation && a.sizeInBytes == b.sizeInBytes && a.strideInBytes == b.strideInBytes;
+}
+
+}
+
+//=============================================================================================================================
+//	初期化・フレーム
+//=============================================================================================================================
+void StateFilter::Init(ICommandRecorder* next) {
+	assert(next);
+	next_ = next;
+	Invalidate();
+}
+
+void StateFilter::BeginFrame() {
+	Invalidate();
+	lastFrameStats_ = frameStats_;
+	frameStats_ = {};
+}
+
+void StateFilter::Invalidate() {
+	descriptorHeapCount_ = 0;
+	viewportCount_ = 0;
+	scissorRectCount_ = 0;
+	rootSignature_ = nullptr;
+	pipelineState_ = nullptr;
+	topology_ = PrimitiveTopology::Undefined;
+	validVertexBufferMask_ = 0;
+	isIndexBufferValid_ = false;
+	for (RootArgument& argument : rootArguments_) {
+		argument = {};
+	}
+}
+
+//=============================================================================================================================
+//	状態の設定
+//=============================================================================================================================
+void StateFilter::SetDescriptorHeaps(uint32_t count, ID3D12DescriptorHeap* const* heaps) {
+	assert(count <= kMaxDescriptorHeaps);
+	if (!Count(IsSameArray(descriptorHeaps_, descriptorHeapCount_, heaps, count))) {
+		return;
+	}
+	std::memcpy(descriptorHeaps_, heaps, sizeof(ID3D12DescriptorHeap*) * count);
+	descriptorHeapCount_ = count;
+	// ヒープが変わると設定済みのDescriptorTableは使えない
+	for (RootArgument& argument : rootArguments_) {
+		if (argument.type == RootArgumentType::DescriptorTable) {
+			argument = {};
+		}
+	}
+	next_->SetDescriptorHeaps(count, heaps);
+}
+
+void StateFilter::RSSetViewports(uint32_t count, const CommandViewport* viewports) {
+	assert(count <= kMaxViewports);
+	if (!Count(IsSameArray(viewports_, viewportCount_, viewports, count))) {
+		return;
+	}
+	std::memcpy(viewports_, viewports, sizeof(CommandViewport) * count);
+	viewportCount_ = count;
+	next_->RSSetViewports(count, viewports);
+}
+
+void StateFilter::RSSetScissorRects(uint32_t count, const CommandRect* rects) {
+	assert(count <= kMaxViewports);
+	if (!Count(IsSameArray(scissorRects_, scissorRectCount_, rects, count))) {
+		return;
+	}
+	std::memcpy(scissorRects_, rects, sizeof(CommandRect) * count);
+	scissorRectCount_ = count;
+	next_->RSSetScissorRects(count, rects);
+}
+
+void StateFilter::SetGraphicsRootSignature(ID3D12RootSignature* rootSignature) {
+	if (!Count(rootSignature_ == rootSignature && rootSignature)) {
+		return;
+	}
+	// 別のルートシグネチャにするとルート引数は全て設定し直しになる
+	rootSignature_ = rootSignature;
+	for (RootArgument& argument : rootArguments_) {
+		argument = {};
+	}
+	next_->SetGraphicsRootSignature(rootSignature);
+}
+
+void StateFilter::SetPipelineState(ID3D12PipelineState* pipelineState) {
+	if (!Count(pipelineState_ == pipelineState && pipelineState)) {
+		return;
+	}
+	pipelineState_ = pipelineState;
+	next_->SetPipelineState(pipelineState);
+}
+
+void StateFilter::IASetPrimitiveTopology(PrimitiveTopology topology) {
+	if (!Count(topology_ == topology && topology != PrimitiveTopology::Undefined)) {
+		return;
+	}
+	topology_ = topology;
+	next_->IASetPrimitiveTopology(topology);
+}
+
+void StateFilter::IASetVertexBuffers(uint32_t startSlot, uint32_t count, const VertexBufferView* views) {
+	assert(startSlot + count <= kMaxVertexBuffers);
+	bool isRedundant = views != nullptr;
+	for (uint32_t index = 0; index < count && isRedundant; ++index) {
+		const uint32_t slot = startSlot + index;
+		isRedundant = (validVertexBufferMask_ & (1u << slot)) && IsSameView(vertexBuffers_[slot], views[index]);
+	}
+	if (!Count(isRedundant)) {
+		return;
+	}
+	for (uint32_t index = 0; index < count; ++index) {
+		const uint32_t slot = startSlot + index;
+		// nullptrは外すだけなので覚えない
+		if (views) {
+			vertexBuffers_[slot] = views[index];
+			validVertexBufferMask_ |= 1u << slot;
+		} else {
+			validVertexBufferMask_ &= ~(1u << slot);
+		}
+	}
+	next_->IASetVertexBuffers(startSlot, count, views);
+}
+
+void StateFilter::IASetIndexBuffer(const IndexBufferView* view) {
+	const bool isRedundant = view && isIndexBufferValid_
+		&& indexBuffer_.bufferLocation == view->bufferLocation && indexBuffer_.sizeInBytes == view->sizeInBytes && indexBuffer_.format == view->format;
+	if (!Count(isRedundant)) {
+		return;
+	}
+	isIndexBufferValid_ = view != nullptr;
+	if (view) {
+		indexBuffer_ = *view;
+	}
+	next_->IASetIndexBuffer(view);
+}
+
+//=============================================================================================================================
+//	ルート引数
+//=============================================================================================================================
+bool StateFilter::UpdateRootArgument(uint32_t rootIndex, RootArgumentType type, uint64_t value) {
+	assert(rootIndex < kMaxRootParameters);
+	RootArgument& argument = rootArguments_[rootIndex];
+	if (!Count(argument.type == type && argument.value == value)) {
+		return false;
+	}
+	argument.type = type;
+	argument.value = value;
+	return true;
+}
+
+void StateFilter::SetGraphicsRootConstantBufferView(uint32_t rootIndex, GpuVirtualAddress address) {
+	if (UpdateRootArgument(rootIndex, RootArgumentType::ConstantBufferView, address)) {
+		next_->SetGraphicsRootConstantBufferView(rootIndex, address);
+	}
+}
+
+void StateFilter::SetGraphicsRootShaderResourceView(uint32_t rootIndex, GpuVirtualAddress address) {
+	if (UpdateRootArgument(rootIndex, RootArgumentType::ShaderResourceView, address)) {
+		next_->SetGraphicsRootShaderResourceView(rootIndex, address);
+	}
+}
+
+void StateFilter::SetGraphicsRootDescriptorTable(uint32_t rootIndex, GpuDescriptorHandle handle) {
+	if (UpdateRootArgument(rootIndex, RootArgumentType::DescriptorTable, handle.ptr)) {
+		next_->SetGraphicsRootDescriptorTable(rootIndex, handle);
+	}
+}
+
+//=============================================================================================================================
+//	描画(常に通す)
+//=============================================================================================================================
+void StateFilter::DrawInstanced(uint32_t vertexCount, uint32_t instanceCount, uint32_t startVertex, uint32_t startInstance) {
+	++frameStats_.issuedCount;
+	++frameStats_.drawCount;
+	next_->DrawInstanced(vertexCount, instanceCount, startVertex, startInstance);
+}
+
+void StateFilter::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) {
+	++frameStats_.issuedCount;
+	++frameStats_.drawCount;
+	next_->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+}
@@ -0,0 +1,223 @@
+#pragma once
+#include <cstdint>
+
+// D3D12のオブジェクトはポインタを比べて渡すだけなので、前方宣言で足りる
+struct ID3D12DescriptorHeap;
+struct ID3D12RootSignature;
+struct ID3D12PipelineState;
+
+//=============================================================================================================================
+//	D3D12の型と同じ並びの最小限の型(D3D12CommandRecorder.hで同じ並びであることを確かめて変換する)
+//=============================================================================================================================
+
+/// D3D12_GPU_VIRTUAL_ADDRESS
+using GpuVirtualAddress = uint64_t;
+
+/// D3D12_GPU_DESCRIPTOR_HANDLE
+struct GpuDescriptorHandle {
+	uint64_t ptr;
+};
+
+/// D3D12_VIEWPORT
+struct CommandViewport {
+	float topLeftX;
+	float topLeftY;
+	float width;
+	float height;
+	float minDepth;
+	float maxDepth;
+};
+
+/// D3D12_RECT
+struct CommandRect {
+	int32_t left;
+	int32_t top;
+	int32_t right;
+	int32_t bottom;
+};
+
+/// D3D12_VERTEX_BUFFER_VIEW
+struct VertexBufferView {
+	GpuVirtualAddress bufferLocation;
+	uint32_t sizeInBytes;
+	uint32_t strideInBytes;
+};
+
+/// D3D12_INDEX_BUFFER_VIEW(formatはDXGI_FORMATの値)
+struct IndexBufferView {
+	GpuVirtualAddress bufferLocation;
+	uint32_t sizeInBytes;
+	uint32_t format;
+};
+
+/// D3D12_PRIMITIVE_TOPOLOGY
+enum class PrimitiveTopology : uint32_t {
+	Undefined = 0,			// D3D_PRIMITIVE_TOPOLOGY_UNDEFINED
+	TriangleList = 4,		// D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST
+};
+
+/// <summary>
+/// 描画コマンドを積む所(ID3D12GraphicsCommandListのうち描画で使う分だけ)
+/// D3D12のヘッダに依存しない形にして、GPUなしで数えたり差し替えたりできるようにする
+/// コマンドリストに積むのはD3D12CommandRecorder(D3D12CommandRecorder.h)
+/// </summary>
+class ICommandRecorder {
+public:
+	virtual ~ICommandRecorder() = default;
+
+	virtual void SetDescriptorHeaps(uint32_t count, ID3D12DescriptorHeap* const* heaps) = 0;
+	virtual void RSSetViewports(uint32_t count, const CommandViewport* viewports) = 0;
+	virtual void RSSetScissorRects(uint32_t count, const CommandRect* rects) = 0;
+	virtual void SetGraphicsRootSignature(ID3D12RootSignature* rootSignature) = 0;
+	virtual void SetPipelineState(ID3D12PipelineState* pipelineState) = 0;
+	virtual void IASetPrimitiveTopology(PrimitiveTopology topology) = 0;
+	virtual void IASetVertexBuffers(uint32_t startSlot, uint32_t count, const VertexBufferView* views) = 0;
+	virtual void IASetIndexBuffer(const IndexBufferView* view) = 0;
+	virtual void SetGraphicsRootConstantBufferView(uint32_t rootIndex, GpuVirtualAddress address) = 0;
+	virtual void SetGraphicsRootShaderResourceView(uint32_t rootIndex, GpuVirtualAddress address) = 0;
+	virtual void SetGraphicsRootDescriptorTable(uint32_t rootIndex, GpuDescriptorHandle handle) = 0;
+	virtual void DrawInstanced(uint32_t vertexCount, uint32_t instanceCount, uint32_t startVertex, uint32_t startInstance) = 0;
+	virtual void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) = 0;
+};
+
+/// <summary>
+/// 積んだコマンドを数えるだけ(GPUなしでStateFilterの効果を確かめる用)
+/// </summary>
+class CommandCounter : public ICommandRecorder {
+public:
+
+	void SetDescriptorHeaps(uint32_t, ID3D12DescriptorHeap* const*) override { ++stateCount_; }
+	void RSSetViewports(uint32_t, const CommandViewport*) override { ++stateCount_; }
+	void RSSetScissorRects(uint32_t, const CommandRect*) override { ++stateCount_; }
+	void SetGraphicsRootSignature(ID3D12RootSignature*) override { ++stateCount_; }
+	void SetPipelineState(ID3D12PipelineState*) override { ++stateCount_; }
+	void IASetPrimitiveTopology(PrimitiveTopology) override { ++stateCount_; }
+	void IASetVertexBuffers(uint32_t, uint32_t, const VertexBufferView*) override { ++stateCount_; }
+	void IASetIndexBuffer(const IndexBufferView*) override { ++stateCount_; }
+	void SetGraphicsRootConstantBufferView(uint32_t, GpuVirtualAddress) override { ++stateCount_; }
+	void SetGraphicsRootShaderResourceView(uint32_t, GpuVirtualAddress) override { ++stateCount_; }
+	void SetGraphicsRootDescriptorTable(uint32_t, GpuDescriptorHandle) override { ++stateCount_; }
+	void DrawInstanced(uint32_t, uint32_t, uint32_t, uint32_t) override { ++drawCount_; }
+	void DrawIndexedInstanced(uint32_t, uint32_t, uint32_t, int32_t, uint32_t) override { ++drawCount_; }
+
+	void Reset() { stateCount_ = 0; drawCount_ = 0; }
+
+	uint64_t GetStateCount() const { return stateCount_; }
+	uint64_t GetDrawCount() const { return drawCount_; }
+
+private:
+	uint64_t stateCount_ = 0;
+	uint64_t drawCount_ = 0;
+};
+
+/// <summary>
+/// 今設定されている状態を覚えておき、同じ値を設定し直すコマンドを捨ててから次に渡す
+/// コマンドリストをResetした時(BeginFrame)や、これを通さずにコマンドリストを触った時はInvalidateする
+/// </summary>
+class StateFilter : public ICommandRecorder {
+public:
+
+	static const uint32_t kMaxViewports = 16;		// D3D12_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE
+	static const uint32_t kMaxVertexBuffers = 32;		// D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT
+	static const uint32_t kMaxRootParameters = 64;
+	static const uint32_t kMaxDescriptorHeaps = 2;
+
+	/// <summary>
+	/// 1フレームのコマンドの数
+	/// </summary>
+	struct Stats {
+		uint32_t issuedCount = 0;		// 次に渡した数(描画を含む)
+		uint32_t filteredCount = 0;		// 同じ値だったので捨てた数
+		uint32_t drawCount = 0;
+	};
+
+public:
+
+	void Init(ICommandRecorder* next);
+
+	/// <summary>
+	/// フレームの始め(コマンドリストのReset後)。覚えている状態を捨て、数を前のフレームの分として残す
+	/// </summary>
+	void BeginFrame();
+
+	/// <summary>
+	/// 覚えている状態を捨てる(次の設定は必ず通す)
+	/// </summary>
+	void Invalidate();
+
+	void SetDescriptorHeaps(uint32_t count, ID3D12DescriptorHeap* const* heaps) override;
+	void RSSetViewports(uint32_t count, const CommandViewport* viewports) override;
+	void RSSetScissorRects(uint32_t count, const CommandRect* rects) override;
+	void SetGraphicsRootSignature(ID3D12RootSignature* rootSignature) override;
+	void SetPipelineState(ID3D12PipelineState* pipelineState) override;
+	void IASetPrimitiveTopology(PrimitiveTopology topology) override;
+	void IASetVertexBuffers(uint32_t startSlot, uint32_t count, const VertexBufferView* views) override;
+	void IASetIndexBuffer(const IndexBufferView* view) override;
+	void SetGraphicsRootConstantBufferView(uint32_t rootIndex, GpuVirtualAddress address) override;
+	void SetGraphicsRootShaderResourceView(uint32_t rootIndex, GpuVirtualAddress address) override;
+	void SetGraphicsRootDescriptorTable(uint32_t rootIndex, GpuDescriptorHandle handle) override;
+	void DrawInstanced(uint32_t vertexCount, uint32_t instanceCount, uint32_t startVertex, uint32_t startInstance) override;
+	void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) override;
+
+public: // accessor
+
+	/// 今のフレームの数
+	const Stats& GetFrameStats() const { return frameStats_; }
+
+	/// 前のフレームの数
+	const Stats& GetLastFrameStats() const { return lastFrameStats_; }
+
+private:
+
+	enum class RootArgumentType : uint32_t {
+		None,
+		ConstantBufferView,
+		ShaderResourceView,
+		DescriptorTable,
+	};
+
+	struct RootArgument {
+		RootArgumentType type = RootArgumentType::None;
+		uint64_t value = 0;
+	};
+
+	/// <summary>
+	/// ルート引数を比べて、違えば覚える
+	/// </summary>
+	/// <returns>次に渡すべきか</returns>
+	bool UpdateRootArgument(uint32_t rootIndex, RootArgumentType type, uint64_t value);
+
+	/// <summary>
+	/// 捨てるか通すかを数える
+	/// </summary>
+	bool Count(bool isRedundant) {
+		if (isRedundant) {
+			++frameStats_.filteredCount;
+			return false;
+		}
+		++frameStats_.issuedCount;
+		return true;
+	}
+
+private:
+	ICommandRecorder* next_ = nullptr;
+
+	ID3D12DescriptorHeap* descriptorHeaps_[kMaxDescriptorHeaps] = {};
+	uint32_t descriptorHeapCount_ = 0;
+	CommandViewport viewports_[kMaxViewports] = {};
+	uint32_t viewportCount_ = 0;
+	CommandRect scissorRects_[kMaxViewports] = {};
+	uint32_t scissorRectCount_ = 0;
+	ID3D12RootSignature* rootSignature_ = nullptr;
+	ID3D12PipelineState* pipelineState_ = nullptr;
+	PrimitiveTopology topology_ = PrimitiveTopology::Undefined;
+	VertexBufferView vertexBuffers_[kMaxVertexBuffers] = {};
+	// 覚えている(一度でも設定した)スロット
+	uint32_t validVertexBufferMask_ = 0;
+	IndexBufferView indexBuffer_ = {};
+	bool isIndexBufferValid_ = false;
+	RootArgument rootArguments_[kMaxRootParameters] = {};
+
+	Stats frameStats_;
+	Stats lastFrameStats_;
+};
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+
+#include <d3d12.h>
+
+#include "DirectXCommon/CommandRecorder.h"
+
+//=============================================================================================================================
+//	CommandRecorder.hの型とD3D12の型の変換(同じ並びなので、ポインタはそのまま読み替える)
+//=============================================================================================================================
+static_assert(sizeof(GpuVirtualAddress) == sizeof(D3D12_GPU_VIRTUAL_ADDRESS));
+static_assert(sizeof(GpuDescriptorHandle) == sizeof(D3D12_GPU_DESCRIPTOR_HANDLE));
+static_assert(sizeof(CommandViewport) == sizeof(D3D12_VIEWPORT) && offsetof(CommandViewport, maxDepth) == offsetof(D3D12_VIEWPORT, MaxDepth));
+static_assert(sizeof(CommandRect) == sizeof(D3D12_RECT) && offsetof(CommandRect, bottom) == offsetof(D3D12_RECT, bottom));
+static_assert(sizeof(VertexBufferView) == sizeof(D3D12_VERTEX_BUFFER_VIEW)
+	&& offsetof(VertexBufferView, sizeInBytes) == offsetof(D3D12_VERTEX_BUFFER_VIEW, SizeInBytes)
+	&& offsetof(VertexBufferView, strideInBytes) == offsetof(D3D12_VERTEX_BUFFER_VIEW, StrideInBytes));
+static_assert(sizeof(IndexBufferView) == sizeof(D3D12_INDEX_BUFFER_VIEW)
+	&& offsetof(IndexBufferView, sizeInBytes) == offsetof(D3D12_INDEX_BUFFER_VIEW, SizeInBytes)
+	&& offsetof(IndexBufferView, format) == offsetof(D3D12_INDEX_BUFFER_VIEW, Format));
+static_assert(uint32_t(PrimitiveTopology::Undefined) == D3D_PRIMITIVE_TOPOLOGY_UNDEFINED);
+static_assert(uint32_t(PrimitiveTopology::TriangleList) == D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+static_assert(StateFilter::kMaxViewports == D3D12_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE);
+static_assert(StateFilter::kMaxVertexBuffers == D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
+
+inline const CommandViewport* ToCommand(const D3D12_VIEWPORT* viewports) { return reinterpret_cast<const CommandViewport*>(viewports); }
+inline const CommandRect* ToCommand(const D3D12_RECT* rects) { return reinterpret_cast<const CommandRect*>(rects); }
+inline const VertexBufferView* ToCommand(const D3D12_VERTEX_BUFFER_VIEW* views) { return reinterpret_cast<const VertexBufferView*>(views); }
+inline const IndexBufferView* ToCommand(const D3D12_INDEX_BUFFER_VIEW* view) { return reinterpret_cast<const IndexBufferView*>(view); }
+inline GpuDescriptorHandle ToCommand(D3D12_GPU_DESCRIPTOR_HANDLE handle) { return { handle.ptr }; }
+inline PrimitiveTopology ToCommand(D3D12_PRIMITIVE_TOPOLOGY topology) { return static_cast<PrimitiveTopology>(topology); }
+
+/// <summary>
+/// そのままID3D12GraphicsCommandListに積む
+/// </summary>
+class D3D12CommandRecorder : public ICommandRecorder {
+public:
+
+	void SetCommandList(ID3D12GraphicsCommandList* commandList) { commandList_ = commandList; }
+
+	void SetDescriptorHeaps(uint32_t count, ID3D12DescriptorHeap* const* heaps) override { commandList_->SetDescriptorHeaps(count, heaps); }
+	void RSSetViewports(uint32_t count, const CommandViewport* viewports) override { commandList_->RSSetViewports(count, reinterpret_cast<const D3D12_VIEWPORT*>(viewports)); }
+	void RSSetScissorRects(uint32_t count, const CommandRect* rects) override { commandList_->RSSetScissorRects(count, reinterpret_cast<const D3D12_RECT*>(rects)); }
+	void SetGraphicsRootSignature(ID3D12RootSignature* rootSignature) override { commandList_->SetGraphicsRootSignature(rootSignature); }
+	void SetPipelineState(ID3D12PipelineState* pipelineState) override { commandList_->SetPipelineState(pipelineState); }
+	void IASetPrimitiveTopology(PrimitiveTopology topology) override { commandList_->IASetPrimitiveTopology(static_cast<D3D12_PRIMITIVE_TOPOLOGY>(topology)); }
+	void IASetVertexBuffers(uint32_t startSlot, uint32_t count, const VertexBufferView* views) override { commandList_->IASetVertexBuffers(startSlot, count, reinterpret_cast<const D3D12_VERTEX_BUFFER_VIEW*>(views)); }
+	void IASetIndexBuffer(const IndexBufferView* view) override { commandList_->IASetIndexBuffer(reinterpret_cast<const D3D12_INDEX_BUFFER_VIEW*>(view)); }
+	void SetGraphicsRootConstantBufferView(uint32_t rootIndex, GpuVirtualAddress address) override { commandList_->SetGraphicsRootConstantBufferView(rootIndex, address); }
+	void SetGraphicsRootShaderResourceView(uint32_t rootIndex, GpuVirtualAddress address) override { commandList_->SetGraphicsRootShaderResourceView(rootIndex, address); }
+	void SetGraphicsRootDescriptorTable(uint32_t rootIndex, GpuDescriptorHandle handle) override { commandList_->SetGraphicsRootDescriptorTable(rootIndex, D3D12_GPU_DESCRIPTOR_HANDLE{ handle.ptr }); }
+	void DrawInstanced(uint32_t vertexCount, uint32_t instanceCount, uint32_t startVertex, uint32_t startInstance) override { commandList_->DrawInstanced(vertexCount, instanceCount, startVertex, startInstance); }
+	void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) override { commandList_->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance); }
+
+private:
+	ID3D12GraphicsCommandList* commandList_ = nullptr;
+};
@@ -0,0 +1,52 @@
+#include "DescriptorAllocator.h"
+#include <cassert>
+
+void DescriptorAllocator::Init(uint32_t persistentCount, uint32_t transientCount) {
+	assert(transientCount > 0);
+	persistentCount_ = persistentCount;
+
+	freeList_.resize(persistentCount);
+	for (uint32_t index = 0; index < persistentCount; ++index) {
+		freeList_[index] = persistentCount - 1 - index;
+	}
+	allocated_.assign(persistentCount, 0);
+
+	transient_.Init(transientCount);
+}
+
+//=============================================================================================================================
+//	常駐
+//=============================================================================================================================
+uint32_t DescriptorAllocator::AllocatePersistent() {
+	if (freeList_.empty()) {
+		return kInvalidIndex;
+	}
+	const uint32_t index = freeList_.back();
+	freeList_.pop_back();
+	allocated_[index] = 1;
+	return index;
+}
+
+void DescriptorAllocator::FreePersistent(uint32_t index) {
+	assert(index < persistentCount_);
+	// 二重解放
+	assert(allocated_[index] != 0);
+	allocated_[index] = 0;
+	freeList_.push_back(index);
+}
+
+//=============================================================================================================================
+//	一時
+//=============================================================================================================================
+uint32_t DescriptorAllocator::AllocateTransient(uint32_t count) {
+	const uint64_t offset = transient_.Allocate(count, 1);
+	if (offset == LinearRingAllocator::kInvalidOffset) {
+		return kInvalidIndex;
+	}
+	return persistentCount_ + static_cast<uint32_t>(offset);
+}
+
+void DescriptorAllocator::EndFrame(uint64_t fenceValue, uint64_t completedFenceValue) {
+	transient_.FinishFrame(fenceValue);
+	transient_.Retire(completedFenceValue);
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "DirectXCommon/LinearRingAllocator.h"
+
+/// <summary>
+/// ディスクリプタヒープの番号を管理する(D3D12に依存せず、番号だけを扱う)
+/// [0, persistentCount)       : 常駐。1つずつ確保・解放し、解放するまで番号は変わらない
+/// [persistentCount, 末尾)    : 一時。フレームごとに連続した範囲を確保し、フェンスが終わったら解放する
+/// </summary>
+class DescriptorAllocator {
+public:
+
+	static const uint32_t kInvalidIndex = UINT32_MAX;
+
+public:
+
+	DescriptorAllocator() = default;
+	~DescriptorAllocator() = default;
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="persistentCount">常駐させる数</param>
+	/// <param name="transientCount">フレームごとに使い捨てる数</param>
+	void Init(uint32_t persistentCount, uint32_t transientCount);
+
+	/// <summary>
+	/// 常駐するディスクリプタを1つ確保する
+	/// </summary>
+	/// <returns>ヒープ内の番号。空きがなければkInvalidIndex</returns>
+	uint32_t AllocatePersistent();
+
+	/// <summary>
+	/// 常駐するディスクリプタを解放する(GPUが使い終わっていること)
+	/// </summary>
+	/// <param name="index"></param>
+	void FreePersistent(uint32_t index);
+
+	/// <summary>
+	/// 今のフレームだけで使う連続したディスクリプタを確保する
+	/// </summary>
+	/// <param name="count"></param>
+	/// <returns>先頭の番号。空きがなければkInvalidIndex</returns>
+	uint32_t AllocateTransient(uint32_t count);
+
+	/// <summary>
+	/// 今のフレームの一時確保を締め切り、終わったフレームの分を解放する
+	/// </summary>
+	/// <param name="fenceValue">今のフレームのフェンス値</param>
+	/// <param name="completedFenceValue">GPUが終わらせたフェンス値</param>
+	void EndFrame(uint64_t fenceValue, uint64_t completedFenceValue);
+
+public: // accessor
+
+	uint32_t GetPersistentCount() const { return persistentCount_; }
+	uint32_t GetTransientCount() const { return static_cast<uint32_t>(transient_.GetCapacity()); }
+	uint32_t GetTotalCount() const { return persistentCount_ + GetTransientCount(); }
+
+	/// 使っている常駐ディスクリプタの数
+	uint32_t GetPersistentUsedCount() const { return persistentCount_ - static_cast<uint32_t>(freeList_.size()); }
+	/// 解放待ちを含めて使っている一時ディスクリプタの数
+	uint32_t GetTransientUsedCount() const { return static_cast<uint32_t>(transient_.GetUsedSize()); }
+
+	bool IsPersistentAllocated(uint32_t index) const { return index < persistentCount_ && allocated_[index] != 0; }
+
+private:
+
+	uint32_t persistentCount_ = 0;
+
+	// 空いている番号(後ろから取り出すので、小さい番号から使われるように逆順に積んでおく)
+	std::vector<uint32_t> freeList_;
+	// 二重解放を見つけるための確保済みフラグ
+	std::vector<uint8_t> allocated_;
+
+	// 一時確保は1ディスクリプタを1バイトとしてリングアロケータに任せる
+	LinearRingAllocator transient_;
+};
@@ -0,0 +1,81 @@
+#include "DescriptorHeap.h"
+#include "Function/DirectXUtils.h"
+
+void DescriptorHeap::Init(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE heapType, uint32_t persistentCount, uint32_t transientCount, bool shaderVisible) {
+	assert(device);
+	allocator_.Init(persistentCount, transientCount);
+
+	heap_ = CreateDescriptorHeap(device, heapType, allocator_.GetTotalCount(), shaderVisible);
+	descriptorSize_ = device->GetDescriptorHandleIncrementSize(heapType);
+	shaderVisible_ = shaderVisible;
+
+	cpuStart_ = heap_->GetCPUDescriptorHandleForHeapStart();
+	// シェーダーから見えないヒープはGPUハンドルを持たない
+	if (shaderVisible_) {
+		gpuStart_ = heap_->GetGPUDescriptorHandleForHeapStart();
+	}
+}
+
+void DescriptorHeap::Finalize() {
+	heap_->Release();
+	heap_ = nullptr;
+}
+
+//=============================================================================================================================
+//	確保・解放
+//=============================================================================================================================
+DescriptorHandle DescriptorHeap::AllocatePersistent() {
+	const uint32_t index = allocator_.AllocatePersistent();
+	// 空きがなければ無効なハンドルを返す(呼ぶ側で確かめる。続くようなら常駐の数を増やす)
+	if (index == DescriptorAllocator::kInvalidIndex) {
+		return DescriptorHandle{};
+	}
+	return MakeHandle(index);
+}
+
+void DescriptorHeap::Free(DescriptorHandle& handle) {
+	if (!handle.IsValid()) {
+		return;
+	}
+	allocator_.FreePersistent(handle.index);
+	handle = DescriptorHandle{};
+}
+
+DescriptorHandle DescriptorHeap::AllocateTransient(uint32_t count) {
+	const uint32_t index = allocator_.AllocateTransient(count);
+	// 空きがなければ無効なハンドルを返す(続くようなら一時の数を増やす)
+	if (index == DescriptorAllocator::kInvalidIndex) {
+		return DescriptorHandle{};
+	}
+	return MakeHandle(index);
+}
+
+void DescriptorHeap::EndFrame(uint64_t fenceValue, uint64_t completedFenceValue) {
+	allocator_.EndFrame(fenceValue, completedFenceValue);
+}
+
+//=============================================================================================================================
+//	ハンドル
+//=============================================================================================================================
+D3D12_CPU_DESCRIPTOR_HANDLE DescriptorHeap::GetCPUHandle(uint32_t index) const {
+	D3D12_CPU_DESCRIPTOR_HANDLE handle = cpuStart_;
+	handle.ptr += static_cast<SIZE_T>(descriptorSize_) * index;
+	return handle;
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE DescriptorHeap::GetGPUHandle(uint32_t index) const {
+	assert(shaderVisible_);
+	D3D12_GPU_DESCRIPTOR_HANDLE handle = gpuStart_;
+	handle.ptr += static_cast<UINT64>(descriptorSize_) * index;
+	return handle;
+}
+
+DescriptorHandle DescriptorHeap::MakeHandle(uint32_t index) const {
+	DescriptorHandle handle;
+	handle.index = index;
+	handle.cpu = GetCPUHandle(index);
+	if (shaderVisible_) {
+		handle.gpu = GetGPUHandle(index);
+	}
+	return handle;
+}
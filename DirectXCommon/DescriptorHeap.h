@@ -0,0 +1,87 @@
+#pragma once
+#include <d3d12.h>
+#include <cassert>
+
+#include "DirectXCommon/DescriptorAllocator.h"
+
+/// <summary>
+/// 確保したディスクリプタ
+/// </summary>
+struct DescriptorHandle {
+	uint32_t index = DescriptorAllocator::kInvalidIndex;	// ヒープ内の番号
+	D3D12_CPU_DESCRIPTOR_HANDLE cpu{};
+	D3D12_GPU_DESCRIPTOR_HANDLE gpu{};
+
+	bool IsValid() const { return index != DescriptorAllocator::kInvalidIndex; }
+};
+
+/// <summary>
+/// ID3D12DescriptorHeapとDescriptorAllocatorをまとめたもの
+/// </summary>
+class DescriptorHeap {
+public:
+
+	DescriptorHeap() = default;
+	~DescriptorHeap() = default;
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="device"></param>
+	/// <param name="heapType"></param>
+	/// <param name="persistentCount">常駐させる数</param>
+	/// <param name="transientCount">フレームごとに使い捨てる数</param>
+	/// <param name="shaderVisible"></param>
+	void Init(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE heapType, uint32_t persistentCount, uint32_t transientCount, bool shaderVisible);
+
+	void Finalize();
+
+	/// <summary>
+	/// 常駐するディスクリプタを確保する。解放するまで番号とハンドルは変わらない
+	/// </summary>
+	/// <returns>空きがなければ無効なハンドル(IsValidがfalse)</returns>
+	DescriptorHandle AllocatePersistent();
+
+	/// <summary>
+	/// 常駐するディスクリプタを解放する
+	/// </summary>
+	/// <param name="handle"></param>
+	void Free(DescriptorHandle& handle);
+
+	/// <summary>
+	/// 今のフレームだけで使う連続したディスクリプタを確保する(DescriptorTable用)
+	/// </summary>
+	/// <param name="count"></param>
+	/// <returns>先頭のハンドル。空きがなければ無効なハンドル</returns>
+	DescriptorHandle AllocateTransient(uint32_t count);
+
+	/// <summary>
+	/// 今のフレームのコマンドを送った後に呼ぶ
+	/// </summary>
+	/// <param name="fenceValue">今のフレームのフェンス値</param>
+	/// <param name="completedFenceValue">GPUが終わらせたフェンス値</param>
+	void EndFrame(uint64_t fenceValue, uint64_t completedFenceValue);
+
+public: // accessor
+
+	ID3D12DescriptorHeap* GetHeap() const { return heap_; }
+	const DescriptorAllocator& GetAllocator() const { return allocator_; }
+
+	D3D12_CPU_DESCRIPTOR_HANDLE GetCPUHandle(uint32_t index) const;
+	D3D12_GPU_DESCRIPTOR_HANDLE GetGPUHandle(uint32_t index) const;
+
+private:
+
+	DescriptorHandle MakeHandle(uint32_t index) const;
+
+private:
+
+	ID3D12DescriptorHeap* heap_ = nullptr;
+	uint32_t descriptorSize_ = 0;
+	bool shaderVisible_ = false;
+
+	D3D12_CPU_DESCRIPTOR_HANDLE cpuStart_{};
+	D3D12_GPU_DESCRIPTOR_HANDLE gpuStart_{};
+
+	DescriptorAllocator allocator_;
+};
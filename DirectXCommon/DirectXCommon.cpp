@@ -3,9 +3,26 @@
 #pragma comment(lib, "d3d12.lib")
 #pragma comment(lib, "dxgi.lib")
 #pragma comment(lib, "dxguid.lib")
-#pragma comment(lib, "dxcompiler.lib")
 
-#include "ImGuiManager.h"
+#include <algorithm>
+#include <chrono>
+
+#include "TextureManager.h"
+
+namespace {
+
+// 描画で使うリソース(シェーダーでの名前)
+const char* const kMeshParameters[] = { "gMaterial", "gTransfomationMatrix", "gTexture" };
+const char* const kInstancingParameters[] = { "gMaterial", "gTexture", "gInstances" };
+const char* const kSpriteParameters[] = { "gSpriteProjection", "gTexture" };
+
+bool HasParameters(const RootSignatureLayout& layout, std::span<const char* const> names) {
+	return std::all_of(names.begin(), names.end(), [&](const char* name) {
+		return layout.FindParameter(name) != RootSignatureLayout::kInvalidParameter;
+	});
+}
+
+}
 
 DirectXCommon* DirectXCommon::GetInstacne(){
 	static DirectXCommon instance;
@@ -13,39 +30,45 @@ DirectXCommon* DirectXCommon::GetInstacne(){
 }
 
 void DirectXCommon::Finalize() {
-	transformationMatrixResorce_->Release();
-	vertexResourceSprite_->Release();
+	// GPUが使い終わるまで待ってから解放する
+	frameScheduler_.WaitForIdle();
+	// 裏でPSOを作っている途中かもしれないので最初に止める
+	shaderHotReloader_.Finalize();
+
+	spriteBatch_.Finalize();
 
 	dsvDescriptorHeap_->Release();
 	depthStencilResource_->Release();
 
-	textureResource_->Release();
-	srvHeap_->Release();
+	srvHeap_.Finalize();
 
-	wvpResource_->Release();
+	uploadRing_.Finalize();
 	materialResource_->Release();
-	vertexResource_->Release();
+	mesh_.Finalize();
 	graphicsPipelineState_->Release();
+	instancingPipelineState_->Release();
+	spritePipelineState_->Release();
+	instanceRing_.Finalize();
+	// 新しく作ったPSOはライブラリに保存してから解放する
+	pipelineStateCache_.Finalize();
+	pipelineLibrary_.Finalize();
 	rootSigneture_->Release();
-	if (errorBlob_) {
-		errorBlob_->Release();
-	}
-	pixelShaderBlob_->Release();
-	vertexShaderBlob_->Release();
-	includeHandler_->Release();
-	dxcCompiler_->Release();
-	dxcUtils_->Release();
+	instancingRootSignature_->Release();
+	spriteRootSignature_->Release();
+	rootSignatureCache_.Finalize();
+	shaderCompileService_.Finalize();
 
 	//
-	CloseHandle(fenceEvent_);
-	fence_->Release();
-	swapChainResources_[0]->Release();
-	swapChainResources_[1]->Release();
+	fence_.Finalize();
+	for (UINT index = 0; index < bufferCount_; ++index) {
+		swapChainResources_[index]->Release();
+	}
 	rtvDescriptorHeap_->Release();
-	intermediateResource_->Release();
 	swapChain_->Release();
 	commandList_->Release();
-	commandAllocator_->Release();
+	for (UINT index = 0; index < bufferCount_; ++index) {
+		commandAllocators_[index]->Release();
+	}
 	commandQueue_->Release();
 	device_->Release();
 	useAdapter_->Release();
@@ -70,18 +93,19 @@ void DirectXCommon::Finalize() {
 /*=============================================================================================================================
 	初期化
 =============================================================================================================================*/
-void DirectXCommon::Initialize(WinApp* win, int32_t backBufferWidth, int32_t backBufferHeight){
+void DirectXCommon::Initialize(WinApp* win, int32_t backBufferWidth, int32_t backBufferHeight, uint32_t framesInFlight){
 	assert(win);
+	assert(framesInFlight >= 2 && framesInFlight <= FrameScheduler::kMaxFramesInFlight);
 	winApp_ = win;
 	kClientWidth_ = backBufferWidth;
 	kClientHeight_ = backBufferHeight;
 
 	// -----------------------------------
-	bufferCount_ = 2;
+	// バックバッファとフレームスロットの数を揃える
+	bufferCount_ = framesInFlight;
 
 	// -----------------------------------
 	transform_ = { {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f} };
-	transformSprite_ = { {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f} };
 	// -----------------------------------
 
 	// DirectXの初期化
@@ -90,20 +114,19 @@ void DirectXCommon::Initialize(WinApp* win, int32_t backBufferWidth, int32_t bac
 	InitializeScreen();
 	// CPUとGPUの同期を取るための
 	CreateFence();
+	// フレームごとに書き換える定数バッファ用
+	uploadRing_.Init(device_, kUploadRingSize);
+	instanceRing_.Init(device_, uint64_t(kMaxInstancesPerFrame) * sizeof(InstanceData) * (bufferCount_ + 1));
 	// DXC(DirectXShaderCompilerの初期化)
 	InitializeDXC();
 	// PSO(PipelineStateObject)の生成
 	CreatePSO();
 	// 頂点データの生成
 	CreateVertexResource();
-	// spriteの生成
-	CreateSprite();
-
-	// texture
-	CreateTexture();
-
-	// texture
-	intermediateResource_ = UploadTextureData(textureResource_, mipImage_, device_, commandList_);
+	// スプライトはテクスチャごとにまとめて描く(読み込み中は代わりのテクスチャになる)
+	spriteBatch_.Init(device_, kMaxSprites, bufferCount_, [](uint32_t textureHandle) {
+		return TextureManager::GetInstacne()->GetGPUHandle(textureHandle);
+	});
 }
 
 /*=============================================================================================================================
@@ -221,14 +244,10 @@ void DirectXCommon::InitializeDXGDevice(){
 	DXCの初期化
 =============================================================================================================================*/
 void DirectXCommon::InitializeDXC() {
-	HRESULT hr = S_FALSE;
-	hr = DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&dxcUtils_));
-	assert(SUCCEEDED(hr));
-	hr = DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&dxcCompiler_));
-
-	// includeに対応するための設定
-	hr = dxcUtils_->CreateDefaultIncludeHandler(&includeHandler_);
-	assert(SUCCEEDED(hr));
+	// コンパイル済みのシェーダーはキャッシュしておき、次回の起動ではコンパイルしない
+	shaderCache_.Init(kShaderCacheDirectory);
+	// コンパイラはワーカーごとに作る
+	shaderCompileService_.Init(&shaderCache_);
 }
 
 /*=============================================================================================================================
@@ -245,7 +264,7 @@ void DirectXCommon::InitializeScreen() {
 
 	// RTV(RenderTargetView)を作る
 	CreateRTV();
-	srvHeap_ = CreateDescriptorHeap(device_, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 128, true);
+	srvHeap_.Init(device_, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, kSrvPersistentCount, kSrvTransientCount, true);
 
 	// ---------------------
 	// 深度
@@ -300,8 +319,10 @@ void DirectXCommon::BeginFrame(){
 
 	commandList_->ClearDepthStencilView(dsvHandle, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
 
-	ID3D12DescriptorHeap* heaps[] = { srvHeap_ };
-	commandList_->SetDescriptorHeaps(1, heaps);
+	// コマンドリストはResetしたばかりなので覚えている状態を捨てる
+	stateFilter_.BeginFrame();
+	ID3D12DescriptorHeap* heaps[] = { srvHeap_.GetHeap() };
+	stateFilter_.SetDescriptorHeaps(1, heaps);
 
 	// -----------------------------------------------------------------
 
@@ -332,25 +353,27 @@ void DirectXCommon::EndFrame(){
 	swapChain_->Present(1, 0);
 
 	// 01_02 ---------------------------------------------
-	// Fenceの値を更新
-	fenceValue_++;
-	// GPUがここまでたどりついた時に、Fenceの値を指定した値に代入するようにsignalを送る
-	commandQueue_->Signal(fence_, fenceValue_);
-
-	// Fenceの値が指定したSignal値にたどりついているか確認する
-	// GetCompletedValueの初期値はFence作成時に渡した初期値
-	if (fence_->GetCompletedValue() < fenceValue_) {
-		// 指定下Signalにたどりついていないので、たどりつくまで松ようにイベントを設定する
-		fence_->SetEventOnCompletion(fenceValue_, fenceEvent_);
-		// イベントを待つ
-		WaitForSingleObject(fenceEvent_, INFINITE);
-	}
+	// Signalして次のフレームスロットへ進む
+	// 待つのはそのスロットの前回のフレームがまだGPUで実行中の時だけ
+	const uint64_t fenceValue = frameScheduler_.Advance();
+	// GPUが読み終わったフレームの定数バッファを解放する
+	uploadRing_.EndFrame(fenceValue, frameScheduler_.GetCompletedValue());
+	instanceRing_.EndFrame(fenceValue, frameScheduler_.GetCompletedValue());
+	lastFrameInstanceCount_ = frameInstanceCount_;
+	lastFrameDroppedInstanceCount_ = frameDroppedInstanceCount_;
+	frameInstanceCount_ = 0;
+	frameDroppedInstanceCount_ = 0;
+	spriteBatch_.EndFrame(fenceValue, frameScheduler_.GetCompletedValue());
+	srvHeap_.EndFrame(fenceValue, frameScheduler_.GetCompletedValue());
+	// 裏で作り直したPSOはフレームの区切りで差し替える
+	shaderHotReloader_.Update(fenceValue, frameScheduler_.GetCompletedValue());
 
 	// ---------------------------------------------------
 	// 次フレーム用のコマンドリストを準備
-	hr = commandAllocator_->Reset();
+	ID3D12CommandAllocator* commandAllocator = commandAllocators_[frameScheduler_.GetFrameIndex()];
+	hr = commandAllocator->Reset();
 	assert(SUCCEEDED(hr));
-	hr = commandList_->Reset(commandAllocator_, nullptr);
+	hr = commandList_->Reset(commandAllocator, nullptr);
 	assert(SUCCEEDED(hr));
 }
 
@@ -358,67 +381,141 @@ void DirectXCommon::EndFrame(){
 	FenceとEventの生成
 =============================================================================================================================*/
 void DirectXCommon::CreateFence() {
-	HRESULT hr = S_FALSE;
-	fenceValue_ = 0;
-	hr = device_->CreateFence(fenceValue_, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence_));
-	assert(SUCCEEDED(hr));
-
-	// Fenceのsignalを待つためのイベントを作成する
-	fenceEvent_ = CreateEvent(NULL, false, false, NULL);
-	assert(fenceEvent_ != nullptr);
+	fence_.Init(device_, commandQueue_);
+	frameScheduler_.Init(&fence_, bufferCount_);
 }
 
 /*=============================================================================================================================
 	 描画するコマンドを積む
 =============================================================================================================================*/
 void DirectXCommon::DrawCall() {
-	commandList_->RSSetViewports(1, &viewport_);
-	commandList_->RSSetScissorRects(1, &scissorRect_);
+	stateFilter_.RSSetViewports(1, ToCommand(&viewport_));
+	stateFilter_.RSSetScissorRects(1, ToCommand(&scissorRect_));
 	// RootSignatureを設定。PSOに設定しているけど別途設定が必要
-	commandList_->SetGraphicsRootSignature(rootSigneture_);
-	commandList_->SetPipelineState(graphicsPipelineState_);
-	commandList_->IASetVertexBuffers(0, 1, &vertexBufferView_);
+	stateFilter_.SetGraphicsRootSignature(rootSigneture_);
+	stateFilter_.SetPipelineState(graphicsPipelineState_);
+	stateFilter_.IASetVertexBuffers(0, 1, ToCommand(&mesh_.GetVertexBufferView()));
+	stateFilter_.IASetIndexBuffer(ToCommand(&mesh_.GetIndexBufferView()));
 	// 形状を設定。PSOに設定しているものとはまた別。
-	commandList_->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	stateFilter_.IASetPrimitiveTopology(PrimitiveTopology::TriangleList);
 	// 02_01 -------------------------
 	// マテリアルCBufferの場所を設定
-	commandList_->SetGraphicsRootConstantBufferView(0, materialResource_->GetGPUVirtualAddress());
+	stateFilter_.SetGraphicsRootConstantBufferView(materialRootIndex_, materialResource_->GetGPUVirtualAddress());
 	// 02_02 -------------------------
-	commandList_->SetGraphicsRootConstantBufferView(1, wvpResource_->GetGPUVirtualAddress());
+	// アップロード用のリングが一杯でWVPを書けなかったフレームは描かない
+	if (wvpAddress_ == 0) {
+		return;
+	}
+	stateFilter_.SetGraphicsRootConstantBufferView(transformRootIndex_, wvpAddress_);
 	// -------------------------------
-	commandList_->SetGraphicsRootDescriptorTable(2, srvHandleGPU_);
+	// 読み込みが終わっていなければ代わりのテクスチャが返る
+	stateFilter_.SetGraphicsRootDescriptorTable(textureRootIndex_, ToCommand(TextureManager::GetInstacne()->GetGPUHandle(textureHandle_)));
 	// 
-	// 描画
-	commandList_->DrawInstanced(6, 1, 0, 0);
+	// 描画(選んでいるLODのインデックスの範囲だけ)
+	const MeshLod& lod = mesh_.GetLod(meshLod_);
+	stateFilter_.DrawIndexedInstanced(lod.indexCount, 1, lod.firstIndex, 0, 0);
 }
 
 void DirectXCommon::SpriteDraw() {
-	commandList_->IASetVertexBuffers(0, 1, &vertexBufferViewSprite_);
-	commandList_->SetGraphicsRootConstantBufferView(1, transformationMatrixResorce_->GetGPUVirtualAddress());
-	commandList_->DrawInstanced(6, 1, 0, 0);
+	if (spriteBatch_.GetSpriteCount() == 0) {
+		return;
+	}
+	stateFilter_.RSSetViewports(1, ToCommand(&viewport_));
+	stateFilter_.RSSetScissorRects(1, ToCommand(&scissorRect_));
+	stateFilter_.SetGraphicsRootSignature(spriteRootSignature_);
+	stateFilter_.SetPipelineState(spritePipelineState_);
+	// 頂点はスクリーン座標なので行列は全スプライトで1つ
+	const Matrix4x4 projectionMatrix = MakeOrthograhicMatrix(0.0f, 0.0f, float(kClientWidth_), float(kClientHeight_), 0.0f, 100.0f);
+	const D3D12_GPU_VIRTUAL_ADDRESS projectionAddress = uploadRing_.PushConstant(projectionMatrix);
+	if (projectionAddress == 0) {
+		// 書けなかったフレームは描かずに捨てる
+		spriteBatch_.Clear();
+		return;
+	}
+	stateFilter_.SetGraphicsRootConstantBufferView(spriteProjectionRootIndex_, projectionAddress);
+	// 頂点・インデックス・テクスチャごとの描画はバッチが積む
+	spriteBatch_.Flush(&stateFilter_, spriteTextureRootIndex_);
+}
+
+void DirectXCommon::DrawInstances(const TransformBatch& transforms, const Matrix4x4& vpMatrix, const Vector4* colors) {
+	// リングは1フレームにkMaxInstancesPerFrame個分しか持たないので、フレームで合わせて超える分は描かない
+	const size_t requestedCount = transforms.GetSize();
+	const uint32_t instanceCount = static_cast<uint32_t>(std::min<size_t>(requestedCount, kMaxInstancesPerFrame - frameInstanceCount_));
+	frameDroppedInstanceCount_ += static_cast<uint32_t>(requestedCount - instanceCount);
+	if (instanceCount == 0) {
+		return;
+	}
+
+	// 今のフレームの領域にインスタンスの値を直接書き込む
+	UploadAllocation allocation = instanceRing_.Allocate(sizeof(InstanceData) * instanceCount);
+	if (!allocation.IsValid()) {
+		frameDroppedInstanceCount_ += instanceCount;
+		return;
+	}
+	frameInstanceCount_ += instanceCount;
+	PackInstances(transforms, instanceCount, vpMatrix, colors, static_cast<InstanceData*>(allocation.cpuAddress));
+
+	stateFilter_.RSSetViewports(1, ToCommand(&viewport_));
+	stateFilter_.RSSetScissorRects(1, ToCommand(&scissorRect_));
+	stateFilter_.SetGraphicsRootSignature(instancingRootSignature_);
+	stateFilter_.SetPipelineState(instancingPipelineState_);
+	stateFilter_.IASetVertexBuffers(0, 1, ToCommand(&mesh_.GetVertexBufferView()));
+	stateFilter_.IASetIndexBuffer(ToCommand(&mesh_.GetIndexBufferView()));
+	stateFilter_.IASetPrimitiveTopology(PrimitiveTopology::TriangleList);
+	stateFilter_.SetGraphicsRootConstantBufferView(instancingMaterialRootIndex_, materialResource_->GetGPUVirtualAddress());
+	stateFilter_.SetGraphicsRootShaderResourceView(instanceRootIndex_, allocation.gpuAddress);
+	stateFilter_.SetGraphicsRootDescriptorTable(instancingTextureRootIndex_, ToCommand(TextureManager::GetInstacne()->GetGPUHandle(textureHandle_)));
+	// 数によらず描画は1回
+	const MeshLod& lod = mesh_.GetLod(meshLod_);
+	stateFilter_.DrawIndexedInstanced(lod.indexCount, instanceCount, lod.firstIndex, 0, 0);
+}
+
+void DirectXCommon::SetMesh(const MeshData& meshData) {
+	frameScheduler_.WaitForIdle();
+	mesh_.Finalize();
+	mesh_.Init(device_, meshData);
+	meshLod_ = 0;
+	Log(std::format("Mesh: {} vertices, {} indices ({} bytes)\n", mesh_.GetVertexCount(), mesh_.GetIndexCount(), mesh_.GetByteSize()));
+}
+
+void DirectXCommon::SetMesh(const MappedMesh& mappedMesh) {
+	assert(mappedMesh.IsOpen());
+	frameScheduler_.WaitForIdle();
+	mesh_.Finalize();
+	mesh_.Init(device_, mappedMesh.GetVertices(), mappedMesh.GetVertexCount(), mappedMesh.GetIndices(), mappedMesh.GetIndexCount(), mappedMesh.GetIndexStride());
+	// LODの表はファイルのものを描画用の形に詰め直す
+	std::vector<MeshLod> lods(mappedMesh.GetLodCount());
+	for (uint32_t index = 0; index < mappedMesh.GetLodCount(); ++index) {
+		const MeshFileLod& fileLod = mappedMesh.GetLods()[index];
+		lods[index] = { fileLod.firstIndex, fileLod.indexCount, fileLod.error };
+	}
+	mesh_.SetLods(lods.data(), static_cast<uint32_t>(lods.size()));
+	meshLod_ = 0;
+	Log(std::format("Mesh: {} vertices, {} indices, {} lods ({} bytes)\n", mesh_.GetVertexCount(), mesh_.GetIndexCount(), mesh_.GetLodCount(), mesh_.GetByteSize()));
+}
+
+void DirectXCommon::SetMeshLod(uint32_t lod) {
+	meshLod_ = (std::min)(lod, mesh_.GetLodCount() - 1);
 }
 
 //=============================================================================================================================
 //	PSOの生成
 //=============================================================================================================================
 void DirectXCommon::CreatePSO() {
-	HRESULT hr = S_FALSE;
-
 	// ---------------------------------------------------------------------------------
-	D3D12_INPUT_ELEMENT_DESC inputElementDescs[2] = {};
-	inputElementDescs[0].SemanticName = "POSITION";
-	inputElementDescs[0].SemanticIndex = 0;
-	inputElementDescs[0].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
-	inputElementDescs[0].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+	// PSOを作り直す時もgraphicsPipelineStateDesc_から指すのでメンバに持つ
+	inputElementDescs_[0].SemanticName = "POSITION";
+	inputElementDescs_[0].SemanticIndex = 0;
+	inputElementDescs_[0].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+	inputElementDescs_[0].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
 	//
-	inputElementDescs[1].SemanticName = "TEXCORD";
-	inputElementDescs[1].SemanticIndex = 0;
-	inputElementDescs[1].Format = DXGI_FORMAT_R32G32_FLOAT;
-	inputElementDescs[1].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+	inputElementDescs_[1].SemanticName = "TEXCORD";
+	inputElementDescs_[1].SemanticIndex = 0;
+	inputElementDescs_[1].Format = DXGI_FORMAT_R32G32_FLOAT;
+	inputElementDescs_[1].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
 
-	D3D12_INPUT_LAYOUT_DESC inputLayoutDesc{};
-	inputLayoutDesc.pInputElementDescs = inputElementDescs;
-	inputLayoutDesc.NumElements = _countof(inputElementDescs);
+	inputLayoutDesc_.pInputElementDescs = inputElementDescs_;
+	inputLayoutDesc_.NumElements = _countof(inputElementDescs_);
 	// ----------------------------------------------------------------------------------
 
 	D3D12_DEPTH_STENCIL_DESC depthStencilDesc{};
@@ -428,12 +525,33 @@ void DirectXCommon::CreatePSO() {
 
 	// ----------------------------------------------------------------------------------
 
+	// 同じ設定のPSOは1つだけ作り、ドライバのコンパイル結果はファイルに残して次回の起動で使う
+	pipelineLibrary_.Init(device_);
+	pipelineStateCache_.Init(&pipelineLibrary_);
+	rootSignatureCache_.Init(device_);
+
 	ShaderCompile();
-	rootSigneture_ = CreateRootSignature();
-	graphicsPipelineStateDesc_.pRootSignature = rootSigneture_;
-	graphicsPipelineStateDesc_.InputLayout = inputLayoutDesc;
-	graphicsPipelineStateDesc_.VS = { vertexShaderBlob_->GetBufferPointer(), vertexShaderBlob_->GetBufferSize() };
-	graphicsPipelineStateDesc_.PS = { pixelShaderBlob_->GetBufferPointer(), pixelShaderBlob_->GetBufferSize() };
+	const ShaderCompileService::ShaderId vertexShader = vertexShader_.GetShader(0);
+	const ShaderCompileService::ShaderId instancingVertexShader = vertexShader_.GetShader(vertexShader_.GetFeatureBit(L"ENABLE_INSTANCING"));
+	const ShaderCompileService::ShaderId pixelShader = pixelShader_.GetShader(pixelShader_.GetFeatureBit(L"ENABLE_TEXTURE"));
+	const ShaderCompileService::ShaderId spriteVertexShader = spriteVertexShader_;
+	const ShaderCompileService::ShaderId spritePixelShader = spritePixelShader_;
+
+	// 描画で使うルートパラメータの番号(シェーダーでの名前で引く)
+	RootSignatureLayout layout;
+	rootSigneture_ = CreateRootSignature(vertexShader, pixelShader, layout);
+	assert(rootSigneture_);
+	SetRootSignatureLayout(layout);
+
+	instancingRootSignature_ = CreateRootSignature(instancingVertexShader, pixelShader, layout);
+	assert(instancingRootSignature_);
+	SetInstancingRootSignatureLayout(layout);
+
+	spriteRootSignature_ = CreateRootSignature(spriteVertexShader, spritePixelShader, layout);
+	assert(spriteRootSignature_);
+	SetSpriteRootSignatureLayout(layout);
+
+	graphicsPipelineStateDesc_.InputLayout = inputLayoutDesc_;
 	graphicsPipelineStateDesc_.BlendState = SetBlendState();
 	graphicsPipelineStateDesc_.RasterizerState = SetRasterizerState();
 
@@ -448,30 +566,123 @@ void DirectXCommon::CreatePSO() {
 	// どのように画面に色を打ち込むかの設定
 	graphicsPipelineStateDesc_.SampleDesc.Count = 1;
 	graphicsPipelineStateDesc_.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;
-	// 実際に生成
-	graphicsPipelineState_ = nullptr;
-	hr = device_->CreateGraphicsPipelineState(&graphicsPipelineStateDesc_, IID_PPV_ARGS(&graphicsPipelineState_));
-	assert(SUCCEEDED(hr));
+
+	// スプライト ------------------------------------------------------------------------
+	// SpriteVertexと同じ並び(色は8bitずつ詰めてある)
+	spriteInputElementDescs_[0].SemanticName = "POSITION";
+	spriteInputElementDescs_[0].SemanticIndex = 0;
+	spriteInputElementDescs_[0].Format = DXGI_FORMAT_R32G32_FLOAT;
+	spriteInputElementDescs_[0].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+	spriteInputElementDescs_[1].SemanticName = "TEXCOORD";
+	spriteInputElementDescs_[1].SemanticIndex = 0;
+	spriteInputElementDescs_[1].Format = DXGI_FORMAT_R32G32_FLOAT;
+	spriteInputElementDescs_[1].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+	spriteInputElementDescs_[2].SemanticName = "COLOR";
+	spriteInputElementDescs_[2].SemanticIndex = 0;
+	spriteInputElementDescs_[2].Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	spriteInputElementDescs_[2].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+
+	spritePipelineStateDesc_ = graphicsPipelineStateDesc_;
+	spritePipelineStateDesc_.InputLayout = { spriteInputElementDescs_, _countof(spriteInputElementDescs_) };
+	// 半透明にする
+	D3D12_RENDER_TARGET_BLEND_DESC& spriteBlend = spritePipelineStateDesc_.BlendState.RenderTarget[0];
+	spriteBlend.BlendEnable = true;
+	spriteBlend.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+	spriteBlend.DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+	spriteBlend.BlendOp = D3D12_BLEND_OP_ADD;
+	spriteBlend.SrcBlendAlpha = D3D12_BLEND_ONE;
+	spriteBlend.DestBlendAlpha = D3D12_BLEND_ZERO;
+	spriteBlend.BlendOpAlpha = D3D12_BLEND_OP_ADD;
+	// 回したスプライトが裏向きになっても描き、3Dより手前に描くので深度は使わない
+	spritePipelineStateDesc_.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+	spritePipelineStateDesc_.DepthStencilState.DepthEnable = false;
+	spritePipelineStateDesc_.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
+
+	// 実際に生成(前回の起動で保存していればライブラリから読む)
+	graphicsPipelineState_ = CreateGraphicsPipeline(graphicsPipelineStateDesc_, rootSigneture_, vertexShader, pixelShader);
+	assert(graphicsPipelineState_);
+	instancingPipelineState_ = CreateGraphicsPipeline(graphicsPipelineStateDesc_, instancingRootSignature_, instancingVertexShader, pixelShader);
+	assert(instancingPipelineState_);
+	spritePipelineState_ = CreateGraphicsPipeline(spritePipelineStateDesc_, spriteRootSignature_, spriteVertexShader, spritePixelShader);
+	assert(spritePipelineState_);
+	Log(std::format("PipelineLibrary: {} loaded, {} compiled\n", pipelineLibrary_.GetLoadCount(), pipelineLibrary_.GetCreateCount()));
+	// 途中で落ちても次の起動で使えるように、ここまでに作った分を保存しておく
+	pipelineLibrary_.Save();
+
+	// シェーダーを書き換えたら作り直す ------------------------------------------------
+	// リソースの宣言が変わってもよいように、ルートシグネチャも新しいリフレクションから作る
+	shaderHotReloader_.Init(&shaderCompileService_);
+	shaderHotReloader_.AddPipeline(&graphicsPipelineState_, &rootSigneture_, { vertexShader, pixelShader },
+		[this, vertexShader, pixelShader]() { return RebuildGraphicsPipeline(graphicsPipelineStateDesc_, vertexShader, pixelShader, kMeshParameters); },
+		[this](const RootSignatureLayout& newLayout) { SetRootSignatureLayout(newLayout); });
+	shaderHotReloader_.AddPipeline(&instancingPipelineState_, &instancingRootSignature_, { instancingVertexShader, pixelShader },
+		[this, instancingVertexShader, pixelShader]() { return RebuildGraphicsPipeline(graphicsPipelineStateDesc_, instancingVertexShader, pixelShader, kInstancingParameters); },
+		[this](const RootSignatureLayout& newLayout) { SetInstancingRootSignatureLayout(newLayout); });
+	shaderHotReloader_.AddPipeline(&spritePipelineState_, &spriteRootSignature_, { spriteVertexShader, spritePixelShader },
+		[this, spriteVertexShader, spritePixelShader]() { return RebuildGraphicsPipeline(spritePipelineStateDesc_, spriteVertexShader, spritePixelShader, kSpriteParameters); },
+		[this](const RootSignatureLayout& newLayout) { SetSpriteRootSignatureLayout(newLayout); });
+#ifdef _DEBUG
+	shaderHotReloader_.Start();
+#endif
+}
+
+ID3D12PipelineState* DirectXCommon::CreateGraphicsPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& baseDesc, ID3D12RootSignature* rootSignature, ShaderCompileService::ShaderId vertexShader, ShaderCompileService::ShaderId pixelShader) {
+	// 裏のスレッドで呼ばれるのでメンバのdescは書き換えない
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = baseDesc;
+	IDxcBlob* vertexShaderBlob = shaderCompileService_.GetBlob(vertexShader);
+	IDxcBlob* pixelShaderBlob = shaderCompileService_.GetBlob(pixelShader);
+	desc.pRootSignature = rootSignature;
+	desc.VS = { vertexShaderBlob->GetBufferPointer(), vertexShaderBlob->GetBufferSize() };
+	desc.PS = { pixelShaderBlob->GetBufferPointer(), pixelShaderBlob->GetBufferSize() };
+	return pipelineStateCache_.GetOrCreate(desc);
+}
+
+ShaderHotReloader::BuildResult DirectXCommon::RebuildGraphicsPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& baseDesc, ShaderCompileService::ShaderId vertexShader, ShaderCompileService::ShaderId pixelShader, std::span<const char* const> requiredParameters) {
+	ShaderHotReloader::BuildResult result;
+	result.rootSignature = CreateRootSignature(vertexShader, pixelShader, result.layout);
+	if (!result.rootSignature) {
+		return result;
+	}
+	// 描画で値を渡しているリソースが消えていたら、今のまま描画を続ける
+	if (!HasParameters(result.layout, requiredParameters)) {
+		Log("ShaderHotReloader: a resource used for drawing was removed from the shader\n");
+		return result;
+	}
+	result.pipelineState = CreateGraphicsPipeline(baseDesc, result.rootSignature, vertexShader, pixelShader);
+	return result;
+}
+
+void DirectXCommon::SetRootSignatureLayout(const RootSignatureLayout& layout) {
+	assert(HasParameters(layout, kMeshParameters));
+	rootSignatureLayout_ = layout;
+	materialRootIndex_ = layout.FindParameter("gMaterial");
+	transformRootIndex_ = layout.FindParameter("gTransfomationMatrix");
+	textureRootIndex_ = layout.FindParameter("gTexture");
+}
+
+void DirectXCommon::SetInstancingRootSignatureLayout(const RootSignatureLayout& layout) {
+	assert(HasParameters(layout, kInstancingParameters));
+	instancingRootSignatureLayout_ = layout;
+	instancingMaterialRootIndex_ = layout.FindParameter("gMaterial");
+	instancingTextureRootIndex_ = layout.FindParameter("gTexture");
+	instanceRootIndex_ = layout.FindParameter("gInstances");
+}
+
+void DirectXCommon::SetSpriteRootSignatureLayout(const RootSignatureLayout& layout) {
+	assert(HasParameters(layout, kSpriteParameters));
+	spriteRootSignatureLayout_ = layout;
+	spriteProjectionRootIndex_ = layout.FindParameter("gSpriteProjection");
+	spriteTextureRootIndex_ = layout.FindParameter("gTexture");
 }
 
 //=============================================================================================================================
 //	VertexResourceの生成
 //=============================================================================================================================
 void DirectXCommon::CreateVertexResource(){
-	vertexResource_ = CreateBufferResource(device_, sizeof(VertexData) * 6);
-
-	// VertexBufferViewを作成する ------------------------------------------------------------------------
-	// リソースの先頭のアドレスから使う
-	vertexBufferView_.BufferLocation = vertexResource_->GetGPUVirtualAddress();
-	// 使用するリソースのサイズは頂点3つ分のサイズ
-	vertexBufferView_.SizeInBytes = sizeof(VertexData) * 6;
-	// 1頂点当たりのサイズ
-	vertexBufferView_.StrideInBytes = sizeof(VertexData);
-
-	// Resourceにデータを書き込む -------------------------------------------------------------------------
-	VertexData* vertexData = nullptr;
-	// 書き込む溜めのアドレスを取得
-	vertexResource_->Map(0, nullptr, reinterpret_cast<void**>(&vertexData));
+	// 三角形を並べた頂点を書き、同じ頂点をまとめてインデックス付きにする -----------------------
+	MeshData meshData;
+	meshData.vertices.resize(6);
+	std::vector<VertexData>& vertexData = meshData.vertices;
 	// 1枚目 ------------------------------------------
 	// 左下
 	vertexData[0].pos = { -0.5f, -0.5f, 0.0f, 1.0f };
@@ -493,6 +704,12 @@ void DirectXCommon::CreateVertexResource(){
 	vertexData[5].pos = { 0.5f, -0.5f, -0.5f, 1.0f };
 	vertexData[5].texcord = { 1.0f, 1.0f };
 
+	const size_t sourceVertexCount = meshData.vertices.size();
+	WeldVertices(meshData);
+	mesh_.Init(device_, meshData);
+	Log(std::format("Mesh: {} -> {} vertices, {} indices ({} -> {} bytes)\n",
+		sourceVertexCount, mesh_.GetVertexCount(), mesh_.GetIndexCount(), sizeof(VertexData) * sourceVertexCount, mesh_.GetByteSize()));
+
 	// 02_01 -----------------------------------------------------------------------------------------
 	materialResource_ = CreateBufferResource(device_, sizeof(Vector4));
 	// マテリアルにデータを書き込む
@@ -503,13 +720,8 @@ void DirectXCommon::CreateVertexResource(){
 	*materialData = Vector4(1.0f, 1.0f, 1.0f, 1.0f);
 
 	// 02_02 -----------------------------------------------------------------------------------------
-	wvpResource_ = CreateBufferResource(device_, sizeof(Matrix4x4));
-
-	Matrix4x4* wvpData = nullptr;
-	wvpResource_->Map(0, nullptr, reinterpret_cast<void**>(&wvpData));
+	// WVPは毎フレームuploadRing_から確保する(CreateWVPResource)
 	transform_.rotate.y += 0.03f;
-	Matrix4x4 worldMatrix = MakeAffineMatrix(transform_.scalel, transform_.rotate, transform_.translate);
-	*wvpData = worldMatrix;
 
 	// ViewportとScissor ------------------------------------------------------------------------------
 	// ビューポート
@@ -529,50 +741,6 @@ void DirectXCommon::CreateVertexResource(){
 	scissorRect_.bottom = static_cast<LONG>(kClientHeight_);
 }
 
-//=============================================================================================================================
-//	VertexResourceSpriteの生成
-//=============================================================================================================================
-void DirectXCommon::CreateSprite() {
-	// sprite用の頂点リソースを作る ---------------------------------------------------------------------
-	vertexResourceSprite_ = CreateBufferResource(device_, sizeof(VertexData) * 6);
-
-	// 頂点バッファビューを作る
-	// 先頭のアドレスから
-	vertexBufferViewSprite_.BufferLocation = vertexResourceSprite_->GetGPUVirtualAddress();
-	// 使用するサイズは頂点6つ分
-	vertexBufferViewSprite_.SizeInBytes = sizeof(VertexData) * 6;
-	// 1頂点当たり
-	vertexBufferViewSprite_.StrideInBytes = sizeof(VertexData);
-
-	/// 頂点データを設定する ---------------------------------------------------------------------
-	VertexData* vertexDataSprite = nullptr;
-	vertexResourceSprite_->Map(0, nullptr, reinterpret_cast<void**>(&vertexDataSprite));
-
-	// 1枚目
-	vertexDataSprite[0].pos = { 0.0f, 360.0f, 0.0f, 1.0f };
-	vertexDataSprite[0].texcord = { 0.0f, 1.0f };
-	vertexDataSprite[1].pos = { 0.0f, 0.0f, 0.0f, 1.0f, };
-	vertexDataSprite[1].texcord = { 0.0f, 0.0f };
-	vertexDataSprite[2].pos = { 640.0f, 360.0f, 0.0f, 1.0f };
-	vertexDataSprite[2].texcord = { 1.0f, 1.0f };
-
-	// 2枚目
-	vertexDataSprite[3].pos = { 0.0f, 0.0f, 0.0f, 1.0f };
-	vertexDataSprite[3].texcord = { 0.0f, 0.0f };
-	vertexDataSprite[4].pos = { 640.0f, 0.0f, 0.0f, 1.0f, };
-	vertexDataSprite[4].texcord = { 1.0f, 0.0f };
-	vertexDataSprite[5].pos = { 640.0f, 360.0f, 0.0f, 1.0f };
-	vertexDataSprite[5].texcord = { 1.0f, 1.0f };
-
-	// Transform ---------------------------------------------------------------------
-	transformationMatrixResorce_ = CreateBufferResource(device_, sizeof(Matrix4x4));
-	// アドレスを取得
-	transformationMatrixResorce_->Map(0, nullptr, reinterpret_cast<void**>(&transformationMatrixData_));
-	// 単位行列を書き込んで置く
-	*transformationMatrixData_ = MakeIdentity4x4();
-
-}
-
 // ↓初期化に関するメンバ関数 ---------------------------------------------------------------------------------------------------------------------------
 //ID3D12Resource* DirectXCommon::CreateBufferResource(ID3D12Device* device, size_t sizeInBytes) {
 //	HRESULT hr = S_FALSE;
@@ -611,13 +779,17 @@ void DirectXCommon::CreateCommand() {
 	assert(SUCCEEDED(hr));
 
 	// CommandAllocatorの生成 --------------------------------
-	// コマンドアロケータを生成する
-	hr = device_->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&commandAllocator_));
-	assert(SUCCEEDED(hr));
+	// GPUが実行中のフレームのコマンドを消さないように、フレームスロットごとにコマンドアロケータを生成する
+	for (UINT index = 0; index < bufferCount_; ++index) {
+		hr = device_->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&commandAllocators_[index]));
+		assert(SUCCEEDED(hr));
+	}
 
 	// コマンドリストを生成する ----------------------------
-	hr = device_->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator_, nullptr, IID_PPV_ARGS(&commandList_));
+	hr = device_->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocators_[0], nullptr, IID_PPV_ARGS(&commandList_));
 	assert(SUCCEEDED(hr));
+	commandRecorder_.SetCommandList(commandList_);
+	stateFilter_.Init(&commandRecorder_);
 }
 
 /// <summary>
@@ -631,7 +803,7 @@ void DirectXCommon::SwapChainCreate() {
 	swapChainDesc_.Format = DXGI_FORMAT_R8G8B8A8_UNORM;				// 色の形式
 	swapChainDesc_.SampleDesc.Count = 1;								// マルチサンプルしない
 	swapChainDesc_.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;	// 描画のターゲットとして利用する
-	swapChainDesc_.BufferCount = 2;									// ダブルバッファ
+	swapChainDesc_.BufferCount = bufferCount_;						// フレームスロットの数だけ用意する
 	swapChainDesc_.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;		// モニタに移したら、中身を破棄
 	// コマンドキュー、ウィンドウハンドル、設定を渡して生成する
 	hr = dxgiFactory_->CreateSwapChainForHwnd(commandQueue_, winApp_->GetHwnd(), &swapChainDesc_, nullptr, nullptr, reinterpret_cast<IDXGISwapChain1**>(&swapChain_));
@@ -644,14 +816,14 @@ void DirectXCommon::SwapChainCreate() {
 void DirectXCommon::CreateRTVHeap() {
 	HRESULT hr = S_FALSE;
 
-	rtvDescriptorHeap_ = CreateDescriptorHeap(device_, D3D12_DESCRIPTOR_HEAP_TYPE_RTV, 2, false);
+	rtvDescriptorHeap_ = CreateDescriptorHeap(device_, D3D12_DESCRIPTOR_HEAP_TYPE_RTV, bufferCount_, false);
 
 	// swapChainからResorceを引っ張ってくる -----------------------------------
-	hr = swapChain_->GetBuffer(0, IID_PPV_ARGS(&swapChainResources_[0]));
-	// うまく取得出来なければ起動できない
-	assert(SUCCEEDED(hr));
-	hr = swapChain_->GetBuffer(1, IID_PPV_ARGS(&swapChainResources_[1]));
-	assert(SUCCEEDED(hr));
+	for (UINT index = 0; index < bufferCount_; ++index) {
+		hr = swapChain_->GetBuffer(index, IID_PPV_ARGS(&swapChainResources_[index]));
+		// うまく取得出来なければ起動できない
+		assert(SUCCEEDED(hr));
+	}
 }
 
 /// <summary>
@@ -664,79 +836,42 @@ void DirectXCommon::CreateRTV(){
 
 	// ディスクリプタの先頭を取得する
 	D3D12_CPU_DESCRIPTOR_HANDLE rtvStartHandle = rtvDescriptorHeap_->GetCPUDescriptorHandleForHeapStart();
-	// まず1つめを作る。最初のところに作る。作る場所を指定して上げる必要がある
-	rtvHandles_[0] = rtvStartHandle;
-	device_->CreateRenderTargetView(swapChainResources_[0], &rtvDesc_, rtvHandles_[0]);
-	// 2つめのディスクリプタハンドルを得る
-	rtvHandles_[1].ptr = rtvHandles_[0].ptr + device_->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
-	// 2つめを作る
-	device_->CreateRenderTargetView(swapChainResources_[1], &rtvDesc_, rtvHandles_[1]);
+	// 先頭から順番にバックバッファの数だけ作る。作る場所を指定して上げる必要がある
+	for (UINT index = 0; index < bufferCount_; ++index) {
+		rtvHandles_[index].ptr = rtvStartHandle.ptr + index * device_->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
+		device_->CreateRenderTargetView(swapChainResources_[index], &rtvDesc_, rtvHandles_[index]);
+	}
 }
 
 /// <summary>
 /// ShaderとResourceをどのように関連付けるかをしるしたオブジェクト
 /// </summary>
 /// <returns></returns>
-ID3D12RootSignature* DirectXCommon::CreateRootSignature(){
-	HRESULT hr = S_FALSE;
-	D3D12_ROOT_SIGNATURE_DESC descriptionRootSignature{};
-	descriptionRootSignature.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
-
-	// textureを読むための
-	D3D12_DESCRIPTOR_RANGE descriptorRange[1]{};
-	descriptorRange[0].BaseShaderRegister = 0;
-	descriptorRange[0].NumDescriptors = 1;
-	descriptorRange[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
-	descriptorRange[0].OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
-
-	// 02_01 -------------------------------------
-	// RootParameter作成。複数設定できるので配列。
-	D3D12_ROOT_PARAMETER rootParameters[3] = {};
-	rootParameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;	// CBVを使う
-	rootParameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;	// PixelShaderで使う
-	rootParameters[0].Descriptor.ShaderRegister = 0;					// レジスタ番号0とバインド
-
-	// 02_02 -------------------------------------
-	rootParameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
-	rootParameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
-	rootParameters[1].Descriptor.ShaderRegister = 0;
-
-	// 02_04 -------------------------------------
-	rootParameters[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
-	rootParameters[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
-	rootParameters[2].DescriptorTable.pDescriptorRanges = descriptorRange;
-	rootParameters[2].DescriptorTable.NumDescriptorRanges = _countof(descriptorRange);
-
-	descriptionRootSignature.pParameters = rootParameters;				// ルートパラメータ配列へのポインタ
-	descriptionRootSignature.NumParameters = _countof(rootParameters);	// 配列の長さ
-
-	// Samplerの設定 -------------------------------------------
-	D3D12_STATIC_SAMPLER_DESC staticSamplers[1] = {};
-	staticSamplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
-	staticSamplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
-	staticSamplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
-	staticSamplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
-	staticSamplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
-	staticSamplers[0].MaxLOD = D3D12_FLOAT32_MAX;
-	staticSamplers[0].ShaderRegister = 0;
-	staticSamplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
-	
-	descriptionRootSignature.pStaticSamplers = staticSamplers;
-	descriptionRootSignature.NumStaticSamplers = _countof(staticSamplers);
-
-	// シリアライズしてバイナリにする
-	ID3DBlob* signatureBlob = nullptr;
-	hr = D3D12SerializeRootSignature(&descriptionRootSignature,
-		D3D_ROOT_SIGNATURE_VERSION_1, &signatureBlob, &errorBlob_);
-	if (FAILED(hr)) {
-		Log(reinterpret_cast<char*>(errorBlob_->GetBufferPointer()));
-		assert(false);
-	}
-	// バイナリを元に生成
-	ID3D12RootSignature* result = nullptr;
-	hr = device_->CreateRootSignature(0, signatureBlob->GetBufferPointer(), signatureBlob->GetBufferSize(), IID_PPV_ARGS(&result));
+ID3D12RootSignature* DirectXCommon::CreateRootSignature(ShaderCompileService::ShaderId vertexShader, ShaderCompileService::ShaderId pixelShader, RootSignatureLayout& outLayout){
+	IDxcUtils* dxcUtils = nullptr;
+	HRESULT hr = DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&dxcUtils));
 	assert(SUCCEEDED(hr));
 
+	// シェーダーが使っているリソース(register(b0)等)を集める ----------------------------
+	std::vector<ShaderBinding> bindings;
+	bool isReflected = ReflectShaderBindings(dxcUtils, shaderCompileService_.GetReflection(vertexShader), D3D12_SHADER_VISIBILITY_VERTEX, bindings);
+	isReflected &= ReflectShaderBindings(dxcUtils, shaderCompileService_.GetReflection(pixelShader), D3D12_SHADER_VISIBILITY_PIXEL, bindings);
+	dxcUtils->Release();
+	if (!isReflected) {
+		Log("RootSignature: failed to read shader reflection\n");
+		return nullptr;
+	}
+
+	// 同じ形のルートシグネチャは1つだけ作る ----------------------------------------------
+	outLayout = BuildRootSignatureLayout(bindings);
+	ID3D12RootSignature* result = rootSignatureCache_.GetOrCreate(outLayout);
+	if (!result) {
+		return nullptr;
+	}
+	// PSOのキャッシュのキーにはポインタではなく形のハッシュを使う
+	pipelineStateCache_.RegisterRootSignature(result, outLayout.hash);
+	Log(std::format("RootSignature: {} parameters, {} static samplers\n", outLayout.parameters.size(), outLayout.staticSamplers.size()));
+
 	return result;
 }
 
@@ -784,219 +919,38 @@ D3D12_RASTERIZER_DESC DirectXCommon::SetRasterizerState() {
 	return rasterizerDesc;
 }
 
-/// <summary>
-/// 
-/// </summary>
-void DirectXCommon::SetDescTable() {
-	// SRVを作成するDescriptorHeapの場所を求める
-	srvHandleCPU_ = srvHeap_->GetCPUDescriptorHandleForHeapStart();
-	srvHandleGPU_ = srvHeap_->GetGPUDescriptorHandleForHeapStart();
-	// 先頭はImGuiが使っている溜めその次を使う
-	srvHandleCPU_.ptr += device_->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-	srvHandleGPU_.ptr += device_->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-}
-
 /// <summary>
 /// Shaderをコンパイルする
 /// </summary>
 void  DirectXCommon::ShaderCompile() {
-	vertexShaderBlob_ = CompilerShader(L"Object3D.VS.hlsl", L"vs_6_0", dxcUtils_, dxcCompiler_, includeHandler_);
-	assert(vertexShaderBlob_ != nullptr);
-
-	pixelShaderBlob_ = CompilerShader(L"Object3D.PS.hlsl", L"ps_6_0", dxcUtils_, dxcCompiler_, includeHandler_);
-	assert(pixelShaderBlob_ != nullptr);
-}
-
-/// <summary>
-/// 
-/// </summary>
-/// <param name="filePath"></param>
-/// <param name="profile"></param>
-/// <param name="dxcUtils"></param>
-/// <param name="dxcCompiler"></param>
-/// <param name="includeHandler"></param>
-/// <returns></returns>
-IDxcBlob* DirectXCommon::CompilerShader(
-	const std::wstring& filePath,
-	const wchar_t* profile,
-	IDxcUtils* dxcUtils,
-	IDxcCompiler3* dxcCompiler,
-	IDxcIncludeHandler* includeHandler) {
-
-	// 1.-----------------------------------------------------------------------------------------
-	// これからシェーダーをコンパイルする旨えおログに出す
-	Log(ConvertString(std::format(L"Begin compileShader, path:{}\n", filePath, profile)));
-	// hlslファイルを読む
-	IDxcBlobEncoding* shaderSource = nullptr;
-	HRESULT hr = dxcUtils->LoadFile(filePath.c_str(), nullptr, &shaderSource);
-	// 読めなかったら止める
-	assert(SUCCEEDED(hr));
-	DxcBuffer shaderSourceBuffer{};
-	shaderSourceBuffer.Ptr = shaderSource->GetBufferPointer();
-	shaderSourceBuffer.Size = shaderSource->GetBufferSize();
-	shaderSourceBuffer.Encoding = DXC_CP_UTF8;
-
-	// 2.-----------------------------------------------------------------------------------------
-	LPCWSTR arguments[] = {
-		filePath.c_str(),			// コンパイル対象のhlslファイル
-		L"-E", L"main",				// エントリーポイントの指定。基本的にmian以外にしない
-		L"-T", profile,				// shaderProfileの設定
-		L"-Zi", L"-Qembed_debug",	// デバック用に情報を埋め込む
-		L"-Od",						// 最適化を外して置く
-		L"-Zpr",					// メモリレイアウトは行優先
-	};
-	// 実際にshaderをコンパイルする
-	IDxcResult* shaderResult = nullptr;
-	hr = dxcCompiler->Compile(
-		&shaderSourceBuffer,		// 読み込んだファイル
-		arguments,					// コンパイルオプション
-		_countof(arguments),		// コンパイルオプションの数
-		includeHandler,				// includeが含まれた諸々
-		IID_PPV_ARGS(&shaderResult)	// コンパイル結果
-	);
-	// コンパイルエラーではなくdxcが起動できないなど致命的な状況
-	assert(SUCCEEDED(hr));
+	const auto start = std::chrono::steady_clock::now();
 
-	// 3.-----------------------------------------------------------------------------------------
-	// 警告,エラーが出たらログに出して止める
-	IDxcBlobUtf8* shaderError = nullptr;
-	shaderResult->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&shaderError), nullptr);
-	if (shaderError != nullptr && shaderError->GetStringLength() != 0) {
-		Log(shaderError->GetStringPointer());
-		assert(false);
-	}
+	vertexShader_.Init(&shaderCompileService_, { L"Object3D.VS.hlsl", L"vs_6_0", L"main", { L"ENABLE_INSTANCING" } });
+	pixelShader_.Init(&shaderCompileService_, { L"Object3D.PS.hlsl", L"ps_6_0", L"main", { L"ENABLE_TEXTURE" } });
+	spriteVertexShader_ = shaderCompileService_.Register({ L"Sprite.VS.hlsl", L"vs_6_0" });
+	spritePixelShader_ = shaderCompileService_.Register({ L"Sprite.PS.hlsl", L"ps_6_0" });
 
-	// 4.-----------------------------------------------------------------------------------------
-	// コンパイル結果から実行用のバイナリ部分を取得
-	IDxcBlob* shaderBlob = nullptr;
-	hr = shaderResult->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&shaderBlob), nullptr);
-	assert(SUCCEEDED(hr));
-	// 成功したらログを出す
-	Log(ConvertString(std::format(L"Compile Succeeded, path:{}\n", filePath, profile)));
-	// もう使わないリソースを解放
-	shaderSource->Release();
-	shaderResult->Release();
+	// 登録した分をワーカーでまとめてコンパイルする
+	const bool isSucceeded = shaderCompileService_.CompileAll();
+	assert(isSucceeded);
+	vertexShader_.LogStatistics();
+	pixelShader_.LogStatistics();
 
-	return shaderBlob;
+	const float time = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	Log(std::format("ShaderCompile: {:.1f}ms ({} cached, {} compiled)\n", time, shaderCache_.GetHitCount(), shaderCache_.GetMissCount()));
 }
 
 /// <summary>
 /// 移動用のの頂点の生成
 /// </summary>
 void DirectXCommon::CreateWVPResource(const Matrix4x4& vpMatrix){
-	Matrix4x4* wvpData = nullptr;
-	wvpResource_->Map(0, nullptr, reinterpret_cast<void**>(&wvpData));
 	transform_.rotate.y += 0.01f;
 	Matrix4x4 worldMatrix = MakeAffineMatrix(transform_.scalel, transform_.rotate, transform_.translate);
 	Matrix4x4 wvpMatrix = Multiply(worldMatrix, vpMatrix);
-	*wvpData = wvpMatrix;
+	// 今のフレームの領域を確保して書き込む
+	wvpAddress_ = uploadRing_.PushConstant(wvpMatrix);
 }
 
-/// <summary>
-/// 移動用のの頂点の生成
-/// </summary>
-void DirectXCommon::CreateaWVPSpriteRespirce(){
-	ImGui::Begin("sprite");
-	ImGui::SliderFloat3("translate", &transformSprite_.translate.x, 0, 1280);
-	ImGui::End();
-	Matrix4x4 worldMatrixSprite = MakeAffineMatrix(transformSprite_.scalel, transformSprite_.rotate, transformSprite_.translate);
-	Matrix4x4 viewMatrixSprite = MakeIdentity4x4();
-	Matrix4x4 projectMatrixSprite = MakeOrthograhicMatrix(0.0f, 0.0f, float(kClientWidth_), float(kClientHeight_), 0.0f, 100.0f);
-	Matrix4x4 worldViewProjectionMatrix = Multiply(worldMatrixSprite, Multiply(viewMatrixSprite, projectMatrixSprite));
-	*transformationMatrixData_ = worldViewProjectionMatrix;
-}
-
-// ======================================================================================================================================================
-void DirectXCommon::CreateTexture() {
-	mipImage_ = LoadTextrue("Resource/uvChecker.png");
-	const DirectX::TexMetadata& metadata = mipImage_.GetMetadata();
-	textureResource_ = CreateTextureResource(device_, metadata);
-	/*UploadTextureData(textureResource_, mipImage_);*/
-
-	// ------------------------------------------------------------
-	// metadataを元にSRVの設定
-	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
-	srvDesc.Format = metadata.format;
-	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-	srvDesc.Texture2D.MipLevels = UINT(metadata.mipLevels);
-
-	// ------------------------------------------------------------
-	// SRVを作成するDescriptorHeapの場所を求める
-	srvHandleCPU_ = srvHeap_->GetCPUDescriptorHandleForHeapStart();
-	srvHandleGPU_ = srvHeap_->GetGPUDescriptorHandleForHeapStart();
-	// 先頭はImGuiが使っている溜めその次を使う
-	srvHandleCPU_.ptr += device_->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-	srvHandleGPU_.ptr += device_->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-
-	// 生成
-	device_->CreateShaderResourceView(textureResource_, &srvDesc, srvHandleCPU_);
-}
-
-DirectX::ScratchImage DirectXCommon::LoadTextrue(const std::string& filePath){
-	DirectX::ScratchImage image{};
-	std::wstring filePathW = ConvertWString(filePath);
-	HRESULT hr = DirectX::LoadFromWICFile(filePathW.c_str(), DirectX::WIC_FLAGS_FORCE_SRGB, nullptr, image);
-	assert(SUCCEEDED(hr));
-
-	// ミニマップの作成
-	DirectX::ScratchImage mipImages{};
-	hr = DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(), image.GetMetadata(), DirectX::TEX_FILTER_SRGB, 0, mipImages);
-	assert(SUCCEEDED(hr));
-
-	return mipImages;
-}
-
-ID3D12Resource* DirectXCommon::CreateTextureResource(ID3D12Device* device, const DirectX::TexMetadata& metadata){
-	// metadataを元にResourceの設定
-	D3D12_RESOURCE_DESC desc{};
-	desc.Width = UINT(metadata.width);								// Textureの幅
-	desc.Height = UINT(metadata.height);							// Textureの高さ
-	desc.MipLevels = UINT16(metadata.mipLevels);					// mipmapの数
-	desc.DepthOrArraySize = UINT16(metadata.arraySize);				// 奥行き　or 配列Textureの配数
-	desc.Format = metadata.format;									// TextureのFormat
-	desc.SampleDesc.Count = 1;										// サンプリングカウント
-	desc.Dimension = D3D12_RESOURCE_DIMENSION(metadata.dimension);	// Textureの次元数
-
-	// 利用するheapの設定。非常に特殊な運用。exで一般的
-	D3D12_HEAP_PROPERTIES heapProperties{};
-	heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
-
-	// resourceを生成する
-	ID3D12Resource* resource = nullptr;
-	HRESULT hr = device->CreateCommittedResource(
-		&heapProperties,					// Heapの設定
-		D3D12_HEAP_FLAG_NONE,				// Heapの特殊の設定
-		&desc,								// Resourceの設定
-		D3D12_RESOURCE_STATE_COPY_DEST,	// 初回のResourceState Textureは木基本読むだけ
-		nullptr,							// clear最適地。使わない
-		IID_PPV_ARGS(&resource)				// 作成するResourceポインタへのポインタ
-	);
-	assert(SUCCEEDED(hr));
-
-	return resource;
-}
-
-[[nodiscard]]
-ID3D12Resource* DirectXCommon::UploadTextureData(ID3D12Resource* texture, const DirectX::ScratchImage& mipImages, ID3D12Device* device, ID3D12GraphicsCommandList* commandList){
-	
-	std::vector<D3D12_SUBRESOURCE_DATA> subresource;
-	DirectX::PrepareUpload(device, mipImages.GetImages(), mipImages.GetImageCount(), mipImages.GetMetadata(), subresource);
-	uint64_t intermediateSize = GetRequiredIntermediateSize(texture, 0, UINT(subresource.size()));
-	ID3D12Resource* intermediateResource = CreateBufferResource(device, intermediateSize);
-	UpdateSubresources(commandList, texture, intermediateResource, 0, 0, UINT(subresource.size()), subresource.data());
-
-	D3D12_RESOURCE_BARRIER barrier{};
-	barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-	barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-	barrier.Transition.pResource = texture;
-	barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-	barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
-	barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_GENERIC_READ;
-	commandList->ResourceBarrier(1, &barrier);
-
-	return intermediateResource;
-}
 // ============================================================================================
 
 void DirectXCommon::Log(const std::string& message) {
@@ -9,16 +9,33 @@
 
 // dxc
 #include <dxcapi.h>
+#include <span>
 #include <vector>
 
 #include "Function/Convert.h"
 #include "Function/DirectXUtils.h"
 #include "Window/WinApp.h"
+#include "DirectXCommon/FrameScheduler.h"
+#include "DirectXCommon/GpuFence.h"
+#include "DirectXCommon/UploadRingBuffer.h"
+#include "DirectXCommon/DescriptorHeap.h"
+#include "DirectXCommon/D3D12CommandRecorder.h"
+#include "DirectXCommon/InstanceData.h"
+#include "DirectXCommon/Mesh.h"
+#include "MeshFile.h"
+#include "DirectXCommon/SpriteBatch.h"
+#include "DirectXCommon/PipelineStateCache.h"
+#include "DirectXCommon/RootSignatureCache.h"
+#include "Shader/ShaderCache.h"
+#include "Shader/ShaderCompileService.h"
+#include "Shader/ShaderPermutation.h"
+#include "Shader/ShaderHotReloader.h"
 
 // lib
 #include "VertexData.h"
 #include "MyMatrix.h"
 #include "Transform.h"
+#include "TransformBatch.h"
 
 /// <summary>
 /// DirectX汎用
@@ -38,14 +55,67 @@ public: // メンバ関数
 
 	ID3D12GraphicsCommandList* GetCommandList() const { return commandList_; }
 
-	ID3D12DescriptorHeap* GetSRVHeap() const { return srvHeap_; }
+	/// <summary>
+	/// 描画コマンドはここに積む(同じ状態の設定し直しは捨てられる)
+	/// コマンドリストに直接状態を設定した後はGetStateFilter()->Invalidate()する
+	/// </summary>
+	ICommandRecorder* GetCommandRecorder() { return &stateFilter_; }
+
+	StateFilter* GetStateFilter() { return &stateFilter_; }
+
+	ID3D12DescriptorHeap* GetSRVHeap() const { return srvHeap_.GetHeap(); }
+
+	DescriptorHeap* GetSRVDescriptorHeap() { return &srvHeap_; }
+
+	const FrameScheduler& GetFrameScheduler() const { return frameScheduler_; }
+
+	UploadRingBuffer* GetUploadRing() { return &uploadRing_; }
+
+	/// 前のフレームでDrawInstancesが描いたインスタンスの数
+	uint32_t GetLastFrameInstanceCount() const { return lastFrameInstanceCount_; }
+
+	/// 前のフレームで1フレームの上限を超えたため描かなかったインスタンスの数
+	uint32_t GetLastFrameDroppedInstanceCount() const { return lastFrameDroppedInstanceCount_; }
+
+	static uint32_t GetMaxInstancesPerFrame() { return kMaxInstancesPerFrame; }
+
+	/// <summary>
+	/// スプライトはここに追加し、SpriteDraw()でまとめて描く
+	/// </summary>
+	SpriteBatch* GetSpriteBatch() { return &spriteBatch_; }
+
+	/// <summary>
+	/// 送ったコマンドがすべて終わるまで待つ
+	/// </summary>
+	void WaitForGpu() { frameScheduler_.WaitForIdle(); }
 
-	D3D12_CPU_DESCRIPTOR_HANDLE GetSrvHandleCPU() const { return srvHandleCPU_; }
+	/// <summary>
+	/// 描画に使うテクスチャ(TextureManagerのハンドル)
+	/// </summary>
+	void SetTexture(uint32_t textureHandle) { textureHandle_ = textureHandle; }
+
+	/// <summary>
+	/// 描画するメッシュを差し替える(GPUが今のメッシュを使い終わるまで待つ)
+	/// </summary>
+	void SetMesh(const MeshData& meshData);
+
+	/// <summary>
+	/// 焼いたメッシュ(マップしたファイル)から差し替える。ファイルの中身をそのままコピーする
+	/// </summary>
+	void SetMesh(const MappedMesh& mappedMesh);
+
+	/// <summary>
+	/// 描画に使うLOD(0が元の形。段数を超えたら一番粗い段。メッシュを差し替えると0に戻る)
+	/// </summary>
+	void SetMeshLod(uint32_t lod);
+	uint32_t GetMeshLod() const { return meshLod_; }
+	const Mesh& GetMesh() const { return mesh_; }
  
 	/// <summary>
 	/// 初期化
 	/// </summary>
-	void Initialize(WinApp* win, int32_t backBufferWidth, int32_t backBufferHeight);
+	/// <param name="framesInFlight">同時にGPUに積むフレーム数(2 or 3)</param>
+	void Initialize(WinApp* win, int32_t backBufferWidth, int32_t backBufferHeight, uint32_t framesInFlight = 2);
 
 	void Finalize();
 
@@ -62,37 +132,92 @@ private: // メンバ変数
 	IDXGIAdapter4* useAdapter_ = nullptr;
 	ID3D12Device* device_ = nullptr;
 	ID3D12CommandQueue* commandQueue_ = nullptr;
-	ID3D12CommandAllocator* commandAllocator_ = nullptr;
+	ID3D12CommandAllocator* commandAllocators_[FrameScheduler::kMaxFramesInFlight] = { nullptr };
 	ID3D12GraphicsCommandList* commandList_ = nullptr;
+	// 描画コマンドはstateFilter_ → commandRecorder_ → commandList_ の順に渡る
+	D3D12CommandRecorder commandRecorder_;
+	StateFilter stateFilter_;
 	IDXGISwapChain4* swapChain_ = nullptr;
 	ID3D12DescriptorHeap* rtvDescriptorHeap_ = nullptr;
-	ID3D12Resource* swapChainResources_[2] = { nullptr };
-	ID3D12Fence* fence_ = nullptr;
-	IDxcUtils* dxcUtils_ = nullptr;
-	IDxcCompiler3* dxcCompiler_ = nullptr;
-	IDxcIncludeHandler* includeHandler_ = nullptr;
-	IDxcBlob* vertexShaderBlob_ = nullptr;
-	IDxcBlob* pixelShaderBlob_ = nullptr;
-	ID3DBlob* errorBlob_ = nullptr;
+	ID3D12Resource* swapChainResources_[FrameScheduler::kMaxFramesInFlight] = { nullptr };
+	ShaderCache shaderCache_;
+	ShaderCompileService shaderCompileService_;
+	// ENABLE_INSTANCING の有無で2通り
+	ShaderPermutation vertexShader_;
+	// ENABLE_TEXTURE の有無で2通り
+	ShaderPermutation pixelShader_;
+	ShaderCompileService::ShaderId spriteVertexShader_ = ShaderCompileService::kInvalidShader;
+	ShaderCompileService::ShaderId spritePixelShader_ = ShaderCompileService::kInvalidShader;
+	// デバッグ時はシェーダーを書き換えるとPSOを作り直す
+	ShaderHotReloader shaderHotReloader_;
 	ID3D12RootSignature* rootSigneture_ = nullptr;
+	// シェーダーのリフレクションから作ったルートシグネチャの形と、描画で使うルートパラメータの番号
+	RootSignatureCache rootSignatureCache_;
+	RootSignatureLayout rootSignatureLayout_;
+	uint32_t materialRootIndex_ = RootSignatureLayout::kInvalidParameter;
+	uint32_t transformRootIndex_ = RootSignatureLayout::kInvalidParameter;
+	uint32_t textureRootIndex_ = RootSignatureLayout::kInvalidParameter;
 	ID3D12PipelineState* graphicsPipelineState_ = nullptr;
-	ID3D12Resource* vertexResource_ = nullptr;
+	// インスタンス描画(インスタンスごとの値はStructuredBufferで渡す)
+	ID3D12RootSignature* instancingRootSignature_ = nullptr;
+	RootSignatureLayout instancingRootSignatureLayout_;
+	uint32_t instancingMaterialRootIndex_ = RootSignatureLayout::kInvalidParameter;
+	uint32_t instancingTextureRootIndex_ = RootSignatureLayout::kInvalidParameter;
+	uint32_t instanceRootIndex_ = RootSignatureLayout::kInvalidParameter;
+	ID3D12PipelineState* instancingPipelineState_ = nullptr;
+	// スプライト(頂点はスクリーン座標で、射影行列だけを定数バッファで渡す)
+	ID3D12RootSignature* spriteRootSignature_ = nullptr;
+	RootSignatureLayout spriteRootSignatureLayout_;
+	uint32_t spriteProjectionRootIndex_ = RootSignatureLayout::kInvalidParameter;
+	uint32_t spriteTextureRootIndex_ = RootSignatureLayout::kInvalidParameter;
+	ID3D12PipelineState* spritePipelineState_ = nullptr;
+	PipelineLibrary pipelineLibrary_;
+	PipelineStateCache pipelineStateCache_;
+	// 描画するメッシュ(インデックス付き)
+	Mesh mesh_;
+	uint32_t meshLod_ = 0;
 	ID3D12Resource* materialResource_ = nullptr;
-	ID3D12Resource* wvpResource_;
-
-	ID3D12DescriptorHeap* srvHeap_ = nullptr;
+	D3D12_GPU_VIRTUAL_ADDRESS wvpAddress_ = 0;
+
+	// SRV(常駐はテクスチャ等、一時はフレームごとに組み立てるDescriptorTable用)
+	static const uint32_t kSrvPersistentCount = 1024;
+	static const uint32_t kSrvTransientCount = 1024;
+	DescriptorHeap srvHeap_;
+
+	// フレームごとの同期
+	GpuFence fence_;
+	FrameScheduler frameScheduler_;
+
+	// フレームごとに使い捨てる定数バッファ(256byteの定数バッファなら3フレーム分を積んでも1フレーム約4000個)
+	static const uint64_t kUploadRingSize = 3 * 1024 * 1024;
+	UploadRingBuffer uploadRing_;
+
+	// インスタンスの値は量が多いので定数バッファとは別のリングから確保する
+	// (フレーム数+1の分を持つのは、末尾に収まらず先頭に戻った時の隙間の分)
+	static const uint32_t kMaxInstancesPerFrame = 65536;
+	UploadRingBuffer instanceRing_;
+	// 今のフレームで描いた・上限を超えて描かなかったインスタンスの数(PostDrawで前のフレームの分にする)
+	uint32_t frameInstanceCount_ = 0;
+	uint32_t frameDroppedInstanceCount_ = 0;
+	uint32_t lastFrameInstanceCount_ = 0;
+	uint32_t lastFrameDroppedInstanceCount_ = 0;
+
+	// 1フレームに描けるスプライトの数
+	static const uint32_t kMaxSprites = 65536;
+	SpriteBatch spriteBatch_;
 
-	uint64_t fenceValue_ = 0;
-	HANDLE fenceEvent_;
 	DXGI_SWAP_CHAIN_DESC1 swapChainDesc_;
 	D3D12_RENDER_TARGET_VIEW_DESC rtvDesc_;
-	D3D12_CPU_DESCRIPTOR_HANDLE rtvHandles_[2];
+	D3D12_CPU_DESCRIPTOR_HANDLE rtvHandles_[FrameScheduler::kMaxFramesInFlight];
 	D3D12_RESOURCE_BARRIER barrier_;
+	D3D12_INPUT_ELEMENT_DESC inputElementDescs_[2] = {};
 	D3D12_INPUT_LAYOUT_DESC inputLayoutDesc_;
 	D3D12_BLEND_DESC blendDesc_;
 	D3D12_RASTERIZER_DESC rasterizerDesc_;
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC graphicsPipelineStateDesc_;
-	D3D12_VERTEX_BUFFER_VIEW vertexBufferView_{};
+	// スプライト用(入力レイアウト・半透明・深度なしだけが違う)
+	D3D12_INPUT_ELEMENT_DESC spriteInputElementDescs_[3] = {};
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC spritePipelineStateDesc_;
 	D3D12_VIEWPORT viewport_{};
 	D3D12_RECT scissorRect_{};
 
@@ -102,26 +227,14 @@ private: // メンバ変数
 	//
 	kTransform transform_;
 
-	// 
-	D3D12_CPU_DESCRIPTOR_HANDLE srvHandleCPU_;
-	D3D12_GPU_DESCRIPTOR_HANDLE srvHandleGPU_;
-
-	DirectX::ScratchImage mipImage_;
-	ID3D12Resource* textureResource_ = nullptr;
-	ID3D12Resource* intermediateResource_ = nullptr;
+	// TextureManagerのハンドル
+	uint32_t textureHandle_ = 0;
 
 	// 深度
 	ID3D12Resource* depthStencilResource_ = nullptr;
 
 	ID3D12DescriptorHeap* dsvDescriptorHeap_ = nullptr;
 
-	// スプライト
-	ID3D12Resource* vertexResourceSprite_ = nullptr;
-	D3D12_VERTEX_BUFFER_VIEW vertexBufferViewSprite_{};
-	kTransform transformSprite_;
-	Matrix4x4* transformationMatrixData_ = nullptr;
-	ID3D12Resource* transformationMatrixResorce_ = nullptr;
-	
 public: // メンバ関数
 	DirectXCommon() = default;
 	~DirectXCommon() = default;
@@ -152,10 +265,19 @@ public: // メンバ関数
 	void DrawCall();
 
 	/// <summary>
-	/// 
+	/// GetSpriteBatch()に追加されたスプライトを描く(3Dの後に呼ぶ)
 	/// </summary>
 	void SpriteDraw();
 
+	/// <summary>
+	/// transformsの数だけメッシュを1回の描画で描く
+	/// 1フレームで合わせてkMaxInstancesPerFrameを超える分は描かない(GetLastFrameDroppedInstanceCountで数が分かる)
+	/// </summary>
+	/// <param name="transforms"></param>
+	/// <param name="vpMatrix"></param>
+	/// <param name="colors">transformsと同じ数の色。nullptrなら全て白</param>
+	void DrawInstances(const TransformBatch& transforms, const Matrix4x4& vpMatrix, const Vector4* colors = nullptr);
+
 public: // メンバ関数(関数内の細かい関数)
 
 	/// <summary>
@@ -194,82 +316,60 @@ public: // メンバ関数(関数内の細かい関数)
 	void CreateVertexResource();
 
 	/// <summary>
-	/// RootSignatureの生成
+	/// RootSignatureの生成(シェーダーのリフレクションから作る)
 	/// </summary>
-	ID3D12RootSignature* CreateRootSignature();
+	/// <param name="vertexShader"></param>
+	/// <param name="pixelShader"></param>
+	/// <param name="outLayout">作ったルートシグネチャの形(ルートパラメータの番号を引くのに使う)</param>
+	/// <returns>失敗したらnullptr(裏のスレッドから呼んでもよい)</returns>
+	ID3D12RootSignature* CreateRootSignature(ShaderCompileService::ShaderId vertexShader, ShaderCompileService::ShaderId pixelShader, RootSignatureLayout& outLayout);
 
 	/// <summary>
-	/// InoutLayoutの設定
+	/// baseDescのルートシグネチャとシェーダーを差し替えてPSOを取得する(裏のスレッドから呼んでもよい)
 	/// </summary>
-	D3D12_INPUT_LAYOUT_DESC SetInputLayoutDesc();
+	ID3D12PipelineState* CreateGraphicsPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& baseDesc, ID3D12RootSignature* rootSignature, ShaderCompileService::ShaderId vertexShader, ShaderCompileService::ShaderId pixelShader);
 
 	/// <summary>
-	/// BlendStateの設定
+	/// シェーダーを書き換えた時に、新しいリフレクションからルートシグネチャとPSOを作り直す(裏のスレッドで呼ばれる)
 	/// </summary>
-	D3D12_BLEND_DESC SetBlendState();
+	/// <param name="requiredParameters">描画で使うリソースの名前(1つでもなくなっていたら作り直さない)</param>
+	ShaderHotReloader::BuildResult RebuildGraphicsPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& baseDesc, ShaderCompileService::ShaderId vertexShader, ShaderCompileService::ShaderId pixelShader, std::span<const char* const> requiredParameters);
 
 	/// <summary>
-	/// RasterizerStateの設定
+	/// ルートシグネチャの形を覚え、描画で使うルートパラメータの番号を引く
 	/// </summary>
-	D3D12_RASTERIZER_DESC SetRasterizerState();
+	void SetRootSignatureLayout(const RootSignatureLayout& layout);
 
-	void SetDescTable();
+	void SetInstancingRootSignatureLayout(const RootSignatureLayout& layout);
 
-	/// <summary>
-	/// CompileShader
-	/// </summary>
-	/// <param name=""></param>
-	IDxcBlob* CompilerShader(
-		const std::wstring& filePath,
-		const wchar_t* profile,
-		IDxcUtils* dxcUtils,
-		IDxcCompiler3* dxcCompiler,
-		IDxcIncludeHandler* includeHandler
-	);
+	void SetSpriteRootSignatureLayout(const RootSignatureLayout& layout);
 
 	/// <summary>
-	/// Shaderをコンパイルする
+	/// InoutLayoutの設定
 	/// </summary>
-	void ShaderCompile();
+	D3D12_INPUT_LAYOUT_DESC SetInputLayoutDesc();
 
 	/// <summary>
-	/// 
+	/// BlendStateの設定
 	/// </summary>
-	void CreateWVPResource(const Matrix4x4& vpMatrix);
-
-	void CreateaWVPSpriteRespirce();
-
-	void CreateSprite();
-
-public: // textureにかかわるもの
-
-	/// <summary>
-/// 
-/// </summary>
-	void CreateTexture();
+	D3D12_BLEND_DESC SetBlendState();
 
 	/// <summary>
-	/// Textrueデータを読む
+	/// RasterizerStateの設定
 	/// </summary>
-	/// <returns></returns>
-	DirectX::ScratchImage LoadTextrue(const std::string& filePath);
+	D3D12_RASTERIZER_DESC SetRasterizerState();
 
 	/// <summary>
-	/// Textureを読んで使えるようにする流れ
+	/// Shaderをコンパイルする(キャッシュがあれば読むだけ)
 	/// </summary>
-	/// <param name="device"></param>
-	/// <param name="metaData"></param>
-	/// <returns></returns>
-	ID3D12Resource* CreateTextureResource(ID3D12Device* device, const DirectX::TexMetadata& metaData);
+	void ShaderCompile();
 
 	/// <summary>
-	/// TextureResourceにデータを転送する
+	/// 
 	/// </summary>
-	/// <param name="texture"></param>
-	/// <param name="mipImages"></param>
-	[[nodiscard]]
-	ID3D12Resource* UploadTextureData(ID3D12Resource* texture, const DirectX::ScratchImage& mipImages, ID3D12Device* device, ID3D12GraphicsCommandList* commandList);
+	void CreateWVPResource(const Matrix4x4& vpMatrix);
 
+public:
 
 	void Log(const std::string& message);
 };
@@ -0,0 +1,47 @@
+#include "FrameScheduler.h"
+#include <cassert>
+#include <chrono>
+
+void FrameScheduler::Init(IFrameFence* fence, uint32_t framesInFlight) {
+	assert(fence);
+	assert(framesInFlight >= 1 && framesInFlight <= kMaxFramesInFlight);
+	fence_ = fence;
+	framesInFlight_ = framesInFlight;
+	frameIndex_ = 0;
+	nextFenceValue_ = fence_->GetCompletedValue() + 1;
+	slotFenceValues_.fill(0);
+	waitHistory_.fill(0.0f);
+	waitHistoryOffset_ = 0;
+}
+
+//=============================================================================================================================
+//	次のフレームへ進む
+//=============================================================================================================================
+uint64_t FrameScheduler::Advance() {
+	// 今のフレームが終わったら書き込まれる値を予約する
+	const uint64_t signaledValue = nextFenceValue_++;
+	fence_->Signal(signaledValue);
+	slotFenceValues_[frameIndex_] = signaledValue;
+
+	// 次のスロットへ。前回そのスロットで送ったフレームが終わっていなければ待つ
+	frameIndex_ = (frameIndex_ + 1) % framesInFlight_;
+	const uint64_t waitValue = slotFenceValues_[frameIndex_];
+
+	float waitTime = 0.0f;
+	if (fence_->GetCompletedValue() < waitValue) {
+		auto start = std::chrono::steady_clock::now();
+		fence_->Wait(waitValue);
+		waitTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	waitHistory_[waitHistoryOffset_] = waitTime;
+	waitHistoryOffset_ = (waitHistoryOffset_ + 1) % kWaitHistoryCount;
+
+	return signaledValue;
+}
+
+void FrameScheduler::WaitForIdle() {
+	const uint64_t value = nextFenceValue_++;
+	fence_->Signal(value);
+	fence_->Wait(value);
+}
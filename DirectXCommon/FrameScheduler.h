@@ -0,0 +1,96 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+/// <summary>
+/// フレームの完了を待つためのフェンス(D3D12に依存しない形にしてテスト用の偽物に差し替えられるようにする)
+/// </summary>
+class IFrameFence {
+public:
+	virtual ~IFrameFence() = default;
+
+	/// <summary>
+	/// ここまでのコマンドが終わったらvalueを書き込むように要求する
+	/// </summary>
+	/// <param name="value"></param>
+	virtual void Signal(uint64_t value) = 0;
+
+	/// <summary>
+	/// GPUが書き込み終わった値
+	/// </summary>
+	/// <returns></returns>
+	virtual uint64_t GetCompletedValue() const = 0;
+
+	/// <summary>
+	/// valueが書き込まれるまでCPUを待たせる
+	/// </summary>
+	/// <param name="value"></param>
+	virtual void Wait(uint64_t value) = 0;
+};
+
+/// <summary>
+/// 複数フレームをGPUに積んでおくためのフレームスロット管理
+/// スロットを再利用するときだけ、そのスロットの前回のフレームの完了を待つ
+/// </summary>
+class FrameScheduler {
+public:
+
+	static const uint32_t kMaxFramesInFlight = 3;
+	static const uint32_t kWaitHistoryCount = 120;
+
+public:
+
+	FrameScheduler() = default;
+	~FrameScheduler() = default;
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="fence"></param>
+	/// <param name="framesInFlight">同時にGPUに積むフレーム数(1～kMaxFramesInFlight)</param>
+	void Init(IFrameFence* fence, uint32_t framesInFlight);
+
+	/// <summary>
+	/// 今のフレームのコマンドを送った後に呼ぶ
+	/// Signalしてから次のスロットに進み、そのスロットがまだGPUで使われていれば終わるまで待つ
+	/// </summary>
+	/// <returns>今のフレームに割り当てたフェンスの値</returns>
+	uint64_t Advance();
+
+	/// <summary>
+	/// 送ったフレームがすべて終わるまで待つ(終了処理やリソースの作り直し用)
+	/// </summary>
+	void WaitForIdle();
+
+public: // accessor
+
+	uint32_t GetFrameIndex() const { return frameIndex_; }
+	uint32_t GetFramesInFlight() const { return framesInFlight_; }
+
+	/// 最後にSignalした値
+	uint64_t GetLastSignaledValue() const { return nextFenceValue_ - 1; }
+	/// 今のフレームのコマンドが終わった時にSignalされる値
+	uint64_t GetCurrentFenceValue() const { return nextFenceValue_; }
+	/// GPUが終わらせた値
+	uint64_t GetCompletedValue() const { return fence_->GetCompletedValue(); }
+
+	/// 直前のAdvanceでCPUが待った時間(ミリ秒)
+	float GetLastWaitTime() const { return waitHistory_[(waitHistoryOffset_ + kWaitHistoryCount - 1) % kWaitHistoryCount]; }
+	/// 待ち時間の履歴(古い順に並べるにはGetWaitHistoryOffsetから読む)
+	const std::array<float, kWaitHistoryCount>& GetWaitHistory() const { return waitHistory_; }
+	uint32_t GetWaitHistoryOffset() const { return waitHistoryOffset_; }
+
+private:
+
+	IFrameFence* fence_ = nullptr;
+	uint32_t framesInFlight_ = 1;
+	uint32_t frameIndex_ = 0;
+
+	// 次にSignalする値(0はフェンスの初期値なので1から)
+	uint64_t nextFenceValue_ = 1;
+	// スロットごとの、最後にそのスロットで送ったフレームのフェンス値
+	std::array<uint64_t, kMaxFramesInFlight> slotFenceValues_{};
+
+	std::array<float, kWaitHistoryCount> waitHistory_{};
+	uint32_t waitHistoryOffset_ = 0;
+};
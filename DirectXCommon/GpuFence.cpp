@@ -0,0 +1,39 @@
+#include "GpuFence.h"
+
+void GpuFence::Init(ID3D12Device* device, ID3D12CommandQueue* commandQueue) {
+	assert(device);
+	assert(commandQueue);
+	commandQueue_ = commandQueue;
+
+	HRESULT hr = device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence_));
+	assert(SUCCEEDED(hr));
+
+	// Fenceのsignalを待つためのイベントを作成する
+	fenceEvent_ = CreateEvent(NULL, false, false, NULL);
+	assert(fenceEvent_ != nullptr);
+}
+
+void GpuFence::Finalize() {
+	CloseHandle(fenceEvent_);
+	fence_->Release();
+}
+
+void GpuFence::Signal(uint64_t value) {
+	// GPUがここまでたどりついた時に、Fenceの値を指定した値に代入するようにsignalを送る
+	HRESULT hr = commandQueue_->Signal(fence_, value);
+	assert(SUCCEEDED(hr));
+}
+
+uint64_t GpuFence::GetCompletedValue() const {
+	return fence_->GetCompletedValue();
+}
+
+void GpuFence::Wait(uint64_t value) {
+	// Fenceの値が指定したSignal値にたどりついているか確認する
+	if (fence_->GetCompletedValue() < value) {
+		// 指定したSignalにたどりついていないので、たどりつくまで待つようにイベントを設定する
+		fence_->SetEventOnCompletion(value, fenceEvent_);
+		// イベントを待つ
+		WaitForSingleObject(fenceEvent_, INFINITE);
+	}
+}
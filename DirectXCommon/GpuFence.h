@@ -0,0 +1,31 @@
+#pragma once
+#include <d3d12.h>
+#include <cassert>
+
+#include "DirectXCommon/FrameScheduler.h"
+
+/// <summary>
+/// ID3D12FenceをFrameSchedulerから使うためのクラス
+/// </summary>
+class GpuFence : public IFrameFence {
+public:
+
+	GpuFence() = default;
+	~GpuFence() override = default;
+
+	void Init(ID3D12Device* device, ID3D12CommandQueue* commandQueue);
+
+	void Finalize();
+
+	void Signal(uint64_t value) override;
+
+	uint64_t GetCompletedValue() const override;
+
+	void Wait(uint64_t value) override;
+
+private:
+
+	ID3D12CommandQueue* commandQueue_ = nullptr;
+	ID3D12Fence* fence_ = nullptr;
+	HANDLE fenceEvent_ = nullptr;
+};
@@ -0,0 +1,19 @@
+#include "InstanceData.h"
+#include <cassert>
+
+void PackInstances(const TransformBatch& transforms, size_t count, const Matrix4x4& vpMatrix, const Vector4* colors, InstanceData* out) {
+	assert(out);
+	// 行列はInstanceDataの間隔で直接書き込む
+	transforms.ComputeWorldMatrices(count, vpMatrix, &out->WVP, &out->World, sizeof(InstanceData));
+
+	if (colors) {
+		for (size_t index = 0; index < count; ++index) {
+			out[index].color = colors[index];
+		}
+	} else {
+		const Vector4 white = { 1.0f, 1.0f, 1.0f, 1.0f };
+		for (size_t index = 0; index < count; ++index) {
+			out[index].color = white;
+		}
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+
+#include "Matrix4x4.h"
+#include "Vector4.h"
+#include "TransformBatch.h"
+
+/// <summary>
+/// インスタンス描画で1インスタンスごとにシェーダーへ渡す値
+/// Object3d.VS.hlsl(ENABLE_INSTANCING)のInstanceDataと同じ並びにする
+/// </summary>
+struct InstanceData {
+	Matrix4x4 WVP;
+	Matrix4x4 World;
+	Vector4 color;
+};
+
+// StructuredBufferは詰めて並ぶのでパディングを入れない
+static_assert(sizeof(InstanceData) == 144, "InstanceData must match the HLSL layout");
+
+/// <summary>
+/// TransformBatchの先頭からcount個のインスタンスの値をまとめて書き込む
+/// 書き込み先から読み戻さないので、Mapしたアップロードヒープを直接渡して良い
+/// </summary>
+/// <param name="transforms"></param>
+/// <param name="count">transforms.GetSize()以下</param>
+/// <param name="vpMatrix">ViewProjection行列</param>
+/// <param name="colors">transformsと同じ数の色。nullptrなら全て白</param>
+/// <param name="out">count個分の書き込み先</param>
+void PackInstances(const TransformBatch& transforms, size_t count, const Matrix4x4& vpMatrix, const Vector4* colors, InstanceData* out);
@@ -0,0 +1,63 @@
+#include "LinearRingAllocator.h"
+#include <cassert>
+
+void LinearRingAllocator::Init(uint64_t capacity) {
+	assert(capacity > 0);
+	capacity_ = capacity;
+	Reset();
+}
+
+//=============================================================================================================================
+//	確保
+//=============================================================================================================================
+uint64_t LinearRingAllocator::Allocate(uint64_t size, uint64_t alignment) {
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+	assert(capacity_ % alignment == 0);
+	if (size == 0 || size > capacity_) {
+		return kInvalidOffset;
+	}
+
+	// capacity_がalignmentの倍数なので、実際の位置をそろえれば先頭からのオフセットもそろう
+	uint64_t offset = (headOffset_ + alignment - 1) & ~(alignment - 1);
+	uint64_t start = head_ + (offset - headOffset_);
+	if (offset + size > capacity_) {
+		// 末尾に収まらないので余りは捨てて先頭から
+		start = head_ + (capacity_ - headOffset_);
+		offset = 0;
+	}
+
+	// 解放されていない領域に追いついたら確保できない
+	if (start + size - tail_ > capacity_) {
+		return kInvalidOffset;
+	}
+
+	head_ = start + size;
+	headOffset_ = offset + size;
+	return offset;
+}
+
+void LinearRingAllocator::FinishFrame(uint64_t fenceValue) {
+	assert(frames_.empty() || frames_.back().fenceValue <= fenceValue);
+	frames_.push_back({ fenceValue, head_ });
+
+	if (peakFrameUsedSize_ < head_ - frameStart_) {
+		peakFrameUsedSize_ = head_ - frameStart_;
+	}
+	frameStart_ = head_;
+}
+
+void LinearRingAllocator::Retire(uint64_t completedFenceValue) {
+	while (!frames_.empty() && frames_.front().fenceValue <= completedFenceValue) {
+		tail_ = frames_.front().head;
+		frames_.pop_front();
+	}
+}
+
+void LinearRingAllocator::Reset() {
+	head_ = 0;
+	headOffset_ = 0;
+	tail_ = 0;
+	frameStart_ = 0;
+	peakFrameUsedSize_ = 0;
+	frames_.clear();
+}
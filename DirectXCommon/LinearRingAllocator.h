@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+
+/// <summary>
+/// フレームごとに使い捨てる領域を切り出すリングアロケータ(D3D12に依存せず、オフセットだけを管理する)
+/// 確保はheadを進めるだけで、解放はフレーム単位でフェンスが終わった分をまとめて行う
+/// </summary>
+class LinearRingAllocator {
+public:
+
+	static const uint64_t kInvalidOffset = UINT64_MAX;
+
+public:
+
+	LinearRingAllocator() = default;
+	~LinearRingAllocator() = default;
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="capacity">管理するバイト数(使うアライメントの倍数にする)</param>
+	void Init(uint64_t capacity);
+
+	/// <summary>
+	/// 確保する。末尾に収まらない場合は先頭に戻る
+	/// </summary>
+	/// <param name="size"></param>
+	/// <param name="alignment">2のべき乗</param>
+	/// <returns>先頭からのオフセット。空きがなければkInvalidOffset</returns>
+	uint64_t Allocate(uint64_t size, uint64_t alignment);
+
+	/// <summary>
+	/// 今のフレームの確保を締め切る。fenceValueが終わったらこのフレームの分を解放できる
+	/// </summary>
+	/// <param name="fenceValue"></param>
+	void FinishFrame(uint64_t fenceValue);
+
+	/// <summary>
+	/// completedFenceValueまでに終わったフレームの領域を解放する
+	/// </summary>
+	/// <param name="completedFenceValue"></param>
+	void Retire(uint64_t completedFenceValue);
+
+	/// <summary>
+	/// すべて解放する(GPUが止まっている時だけ呼ぶ)
+	/// </summary>
+	void Reset();
+
+public: // accessor
+
+	uint64_t GetCapacity() const { return capacity_; }
+	/// 解放待ちを含めて使っているバイト数
+	uint64_t GetUsedSize() const { return head_ - tail_; }
+	/// 今のフレームで確保したバイト数
+	uint64_t GetFrameUsedSize() const { return head_ - frameStart_; }
+	/// 1フレームで使った最大のバイト数
+	uint64_t GetPeakFrameUsedSize() const { return peakFrameUsedSize_; }
+
+private:
+
+	/// <summary>
+	/// フレームの終わりの位置と、そのフレームのフェンス値
+	/// </summary>
+	struct FrameMarker {
+		uint64_t fenceValue;
+		uint64_t head;
+	};
+
+	uint64_t capacity_ = 0;
+	// head_とtail_は折り返さずに増え続ける値で持つ(差が使っているバイト数になる)
+	uint64_t head_ = 0;
+	// head_の実際の位置(head_ % capacity_)
+	uint64_t headOffset_ = 0;
+	uint64_t tail_ = 0;
+	uint64_t frameStart_ = 0;
+	uint64_t peakFrameUsedSize_ = 0;
+
+	std::deque<FrameMarker> frames_;
+};
@@ -0,0 +1,94 @@
+#include "Mesh.h"
+
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+#include "Function/DirectXUtils.h"
+
+//=============================================================================================================================
+//	初期化
+//=============================================================================================================================
+void Mesh::Init(ID3D12Device* device, const MeshData& data) {
+	assert(!data.vertices.empty() && !data.indices.empty());
+	const uint32_t vertexCount = static_cast<uint32_t>(data.vertices.size());
+	const uint32_t indexCount = static_cast<uint32_t>(data.indices.size());
+
+	// 頂点数が少なければ16bitに詰める
+	if (GetIndexStride(vertexCount) == sizeof(uint16_t)) {
+		std::vector<uint16_t> indices16(indexCount);
+		for (uint32_t index = 0; index < indexCount; ++index) {
+			assert(data.indices[index] < vertexCount);
+			indices16[index] = static_cast<uint16_t>(data.indices[index]);
+		}
+		Init(device, data.vertices.data(), vertexCount, indices16.data(), indexCount, sizeof(uint16_t));
+	} else {
+		Init(device, data.vertices.data(), vertexCount, data.indices.data(), indexCount, sizeof(uint32_t));
+	}
+}
+
+void Mesh::Init(ID3D12Device* device, const VertexData* vertices, uint32_t vertexCount, const void* indices, uint32_t indexCount, uint32_t indexStride) {
+	assert(device);
+	assert(vertices && vertexCount != 0 && indices && indexCount != 0);
+	assert(indexStride == sizeof(uint16_t) || indexStride == sizeof(uint32_t));
+	vertexCount_ = vertexCount;
+	indexCount_ = indexCount;
+
+	// 頂点 ---------------------------------------------------------------------------------
+	const UINT vertexSize = static_cast<UINT>(sizeof(VertexData) * vertexCount_);
+	vertexResource_ = CreateBufferResource(device, vertexSize);
+	void* vertexData = nullptr;
+	vertexResource_->Map(0, nullptr, &vertexData);
+	std::memcpy(vertexData, vertices, vertexSize);
+	vertexResource_->Unmap(0, nullptr);
+	vertexBufferView_.BufferLocation = vertexResource_->GetGPUVirtualAddress();
+	vertexBufferView_.SizeInBytes = vertexSize;
+	vertexBufferView_.StrideInBytes = sizeof(VertexData);
+
+	// インデックス -------------------------------------------------------------------------
+	const UINT indexSize = indexStride * indexCount_;
+	indexResource_ = CreateBufferResource(device, indexSize);
+	void* indexData = nullptr;
+	indexResource_->Map(0, nullptr, &indexData);
+	std::memcpy(indexData, indices, indexSize);
+	indexResource_->Unmap(0, nullptr);
+	indexBufferView_.BufferLocation = indexResource_->GetGPUVirtualAddress();
+	indexBufferView_.SizeInBytes = indexSize;
+	indexBufferView_.Format = indexStride == sizeof(uint16_t) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+
+	SetLods(nullptr, 0);
+}
+
+void Mesh::Finalize() {
+	if (vertexResource_) {
+		vertexResource_->Release();
+		vertexResource_ = nullptr;
+	}
+	if (indexResource_) {
+		indexResource_->Release();
+		indexResource_ = nullptr;
+	}
+	lods_.clear();
+}
+
+//=============================================================================================================================
+//	LOD
+//=============================================================================================================================
+void Mesh::SetLods(const MeshLod* lods, uint32_t lodCount) {
+	lods_.clear();
+	if (lodCount == 0) {
+		lods_.push_back({ 0, indexCount_, 0.0f });
+		return;
+	}
+	assert(lods);
+	lods_.assign(lods, lods + lodCount);
+	for (const MeshLod& lod : lods_) {
+		assert(uint64_t(lod.firstIndex) + lod.indexCount <= indexCount_);
+		(void)lod;
+	}
+}
+
+const MeshLod& Mesh::GetLod(uint32_t lod) const {
+	assert(lod < lods_.size());
+	return lods_[lod];
+}
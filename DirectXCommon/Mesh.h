@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include <d3d12.h>
+
+#include "MeshData.h"
+
+/// <summary>
+/// GPUに置いたインデックス付きメッシュ(頂点バッファ + インデックスバッファ)
+/// インデックスは頂点数が0xFFFF以下なら16bit、それより多ければ32bitにする
+/// LODはインデックスバッファの範囲で持つ(Initの直後はインデックス全体の1段だけ)
+/// </summary>
+class Mesh {
+public:
+
+	Mesh() = default;
+	~Mesh() = default;
+	Mesh(const Mesh&) = delete;
+	const Mesh& operator=(const Mesh&) = delete;
+
+	/// <summary>
+	/// 初期化(dataは溶接済みを想定。コピーするのでこの後は捨てて良い)
+	/// </summary>
+	/// <param name="device"></param>
+	/// <param name="data"></param>
+	void Init(ID3D12Device* device, const MeshData& data);
+
+	/// <summary>
+	/// 初期化(GPUに置く形のまま持っているデータから。焼いたファイルのマップ等)
+	/// </summary>
+	/// <param name="device"></param>
+	/// <param name="vertices"></param>
+	/// <param name="vertexCount"></param>
+	/// <param name="indices">indexStrideの幅で詰めたインデックス</param>
+	/// <param name="indexCount"></param>
+	/// <param name="indexStride">2 or 4</param>
+	void Init(ID3D12Device* device, const VertexData* vertices, uint32_t vertexCount, const void* indices, uint32_t indexCount, uint32_t indexStride);
+
+	void Finalize();
+
+	/// <summary>
+	/// LODを設定する(0段目が元の形。範囲はInitで渡したインデックスの中)
+	/// </summary>
+	/// <param name="lods"></param>
+	/// <param name="lodCount">0ならインデックス全体の1段に戻す</param>
+	void SetLods(const MeshLod* lods, uint32_t lodCount);
+
+public: // accessor
+
+	const D3D12_VERTEX_BUFFER_VIEW& GetVertexBufferView() const { return vertexBufferView_; }
+	const D3D12_INDEX_BUFFER_VIEW& GetIndexBufferView() const { return indexBufferView_; }
+
+	uint32_t GetVertexCount() const { return vertexCount_; }
+	uint32_t GetIndexCount() const { return indexCount_; }
+
+	uint32_t GetLodCount() const { return static_cast<uint32_t>(lods_.size()); }
+	const MeshLod& GetLod(uint32_t lod) const;
+	const MeshLod* GetLods() const { return lods_.data(); }
+
+	/// 頂点とインデックスのバイト数の合計
+	uint64_t GetByteSize() const { return uint64_t(vertexBufferView_.SizeInBytes) + indexBufferView_.SizeInBytes; }
+
+private:
+
+	ID3D12Resource* vertexResource_ = nullptr;
+	ID3D12Resource* indexResource_ = nullptr;
+	D3D12_VERTEX_BUFFER_VIEW vertexBufferView_{};
+	D3D12_INDEX_BUFFER_VIEW indexBufferView_{};
+	uint32_t vertexCount_ = 0;
+	uint32_t indexCount_ = 0;
+	std::vector<MeshLod> lods_;
+};
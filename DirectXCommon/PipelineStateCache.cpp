@@ -0,0 +1,366 @@
+#include "PipelineStateCache.h"
+#include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string_view>
+#include <type_traits>
+
+#include "Function/DirectXUtils.h"
+#include "Function/Hash.h"
+
+namespace {
+
+/// <summary>
+/// 設定を1つずつ混ぜていく(構造体のパディングやポインタを含めないように)
+/// </summary>
+class PipelineHasher {
+public:
+
+	explicit PipelineHasher(uint64_t seed) : hash_(seed) {}
+
+	template<typename T>
+	void Add(T value) {
+		static_assert(std::is_integral_v<T> || std::is_enum_v<T>);
+		hash_ = HashCombine(hash_, uint64_t(value));
+	}
+
+	void Add(float value) {
+		uint32_t bits = 0;
+		std::memcpy(&bits, &value, sizeof(bits));
+		Add(bits);
+	}
+
+	void AddString(const char* str) {
+		const std::string_view view = str ? str : "";
+		Add(view.size());
+		hash_ = HashString(view, hash_);
+	}
+
+	void AddShader(const D3D12_SHADER_BYTECODE& shader) {
+		Add(shader.BytecodeLength);
+		hash_ = HashBytes(shader.pShaderBytecode, shader.pShaderBytecode ? shader.BytecodeLength : 0, hash_);
+	}
+
+	uint64_t GetHash() const { return hash_; }
+
+private:
+	uint64_t hash_;
+};
+
+void AddBlend(PipelineHasher& hasher, const D3D12_RENDER_TARGET_BLEND_DESC& blend) {
+	hasher.Add(blend.BlendEnable);
+	if (blend.BlendEnable) {
+		hasher.Add(blend.SrcBlend);
+		hasher.Add(blend.DestBlend);
+		hasher.Add(blend.BlendOp);
+		hasher.Add(blend.SrcBlendAlpha);
+		hasher.Add(blend.DestBlendAlpha);
+		hasher.Add(blend.BlendOpAlpha);
+	}
+	hasher.Add(blend.LogicOpEnable);
+	if (blend.LogicOpEnable) {
+		hasher.Add(blend.LogicOp);
+	}
+	hasher.Add(blend.RenderTargetWriteMask);
+}
+
+void AddStencilOp(PipelineHasher& hasher, const D3D12_DEPTH_STENCILOP_DESC& op) {
+	hasher.Add(op.StencilFailOp);
+	hasher.Add(op.StencilDepthFailOp);
+	hasher.Add(op.StencilPassOp);
+	hasher.Add(op.StencilFunc);
+}
+
+}
+
+//=============================================================================================================================
+//	ハッシュ
+//=============================================================================================================================
+uint64_t HashGraphicsPipelineDesc(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, uint64_t rootSignatureHash) {
+	PipelineHasher hasher(rootSignatureHash);
+
+	// シェーダー ------------------------------------------------
+	hasher.AddShader(desc.VS);
+	hasher.AddShader(desc.PS);
+	hasher.AddShader(desc.DS);
+	hasher.AddShader(desc.HS);
+	hasher.AddShader(desc.GS);
+
+	hasher.Add(desc.StreamOutput.NumEntries);
+	for (UINT index = 0; index < desc.StreamOutput.NumEntries; ++index) {
+		const D3D12_SO_DECLARATION_ENTRY& entry = desc.StreamOutput.pSODeclaration[index];
+		hasher.Add(entry.Stream);
+		hasher.AddString(entry.SemanticName);
+		hasher.Add(entry.SemanticIndex);
+		hasher.Add(entry.StartComponent);
+		hasher.Add(entry.ComponentCount);
+		hasher.Add(entry.OutputSlot);
+	}
+	hasher.Add(desc.StreamOutput.NumStrides);
+	for (UINT index = 0; index < desc.StreamOutput.NumStrides; ++index) {
+		hasher.Add(desc.StreamOutput.pBufferStrides[index]);
+	}
+	hasher.Add(desc.StreamOutput.RasterizedStream);
+
+	// ブレンド --------------------------------------------------
+	// IndependentBlendEnableがfalseならRenderTarget[0]が全てに使われる
+	hasher.Add(desc.BlendState.AlphaToCoverageEnable);
+	hasher.Add(desc.BlendState.IndependentBlendEnable);
+	const UINT blendCount = desc.BlendState.IndependentBlendEnable ? desc.NumRenderTargets : 1;
+	for (UINT index = 0; index < blendCount; ++index) {
+		AddBlend(hasher, desc.BlendState.RenderTarget[index]);
+	}
+	hasher.Add(desc.SampleMask);
+
+	// ラスタライザ ----------------------------------------------
+	hasher.Add(desc.RasterizerState.FillMode);
+	hasher.Add(desc.RasterizerState.CullMode);
+	hasher.Add(desc.RasterizerState.FrontCounterClockwise);
+	hasher.Add(desc.RasterizerState.DepthBias);
+	hasher.Add(desc.RasterizerState.DepthBiasClamp);
+	hasher.Add(desc.RasterizerState.SlopeScaledDepthBias);
+	hasher.Add(desc.RasterizerState.DepthClipEnable);
+	hasher.Add(desc.RasterizerState.MultisampleEnable);
+	hasher.Add(desc.RasterizerState.AntialiasedLineEnable);
+	hasher.Add(desc.RasterizerState.ForcedSampleCount);
+	hasher.Add(desc.RasterizerState.ConservativeRaster);
+
+	// 深度・ステンシル ------------------------------------------
+	hasher.Add(desc.DepthStencilState.DepthEnable);
+	if (desc.DepthStencilState.DepthEnable) {
+		hasher.Add(desc.DepthStencilState.DepthWriteMask);
+		hasher.Add(desc.DepthStencilState.DepthFunc);
+	}
+	hasher.Add(desc.DepthStencilState.StencilEnable);
+	if (desc.DepthStencilState.StencilEnable) {
+		hasher.Add(desc.DepthStencilState.StencilReadMask);
+		hasher.Add(desc.DepthStencilState.StencilWriteMask);
+		AddStencilOp(hasher, desc.DepthStencilState.FrontFace);
+		AddStencilOp(hasher, desc.DepthStencilState.BackFace);
+	}
+
+	// 入力レイアウト --------------------------------------------
+	hasher.Add(desc.InputLayout.NumElements);
+	for (UINT index = 0; index < desc.InputLayout.NumElements; ++index) {
+		const D3D12_INPUT_ELEMENT_DESC& element = desc.InputLayout.pInputElementDescs[index];
+		hasher.AddString(element.SemanticName);
+		hasher.Add(element.SemanticIndex);
+		hasher.Add(element.Format);
+		hasher.Add(element.InputSlot);
+		hasher.Add(element.AlignedByteOffset);
+		hasher.Add(element.InputSlotClass);
+		hasher.Add(element.InstanceDataStepRate);
+	}
+	hasher.Add(desc.IBStripCutValue);
+	hasher.Add(desc.PrimitiveTopologyType);
+
+	// 書き込み先 ------------------------------------------------
+	hasher.Add(desc.NumRenderTargets);
+	for (UINT index = 0; index < desc.NumRenderTargets; ++index) {
+		hasher.Add(desc.RTVFormats[index]);
+	}
+	hasher.Add(desc.DSVFormat);
+	hasher.Add(desc.SampleDesc.Count);
+	hasher.Add(desc.SampleDesc.Quality);
+	hasher.Add(desc.NodeMask);
+	hasher.Add(desc.Flags);
+	return hasher.GetHash();
+}
+
+//=============================================================================================================================
+//	PipelineLibrary
+//=============================================================================================================================
+PipelineLibrary::~PipelineLibrary() {
+	Finalize();
+}
+
+void PipelineLibrary::Init(ID3D12Device* device, const std::wstring& filePath) {
+	assert(device);
+	device_ = device;
+	filePath_ = filePath;
+
+	ID3D12Device1* device1 = nullptr;
+	if (FAILED(device->QueryInterface(IID_PPV_ARGS(&device1)))) {
+		Log("PipelineLibrary: ID3D12Device1 is not supported\n");
+		return;
+	}
+
+	// 前回保存した分を読む ------------------------------------------------
+	std::ifstream file(std::filesystem::path(filePath), std::ios::binary | std::ios::ate);
+	if (file) {
+		serializedData_.resize(size_t(file.tellg()));
+		file.seekg(0);
+		file.read(serializedData_.data(), serializedData_.size());
+		if (!file) {
+			serializedData_.clear();
+		}
+	}
+
+	HRESULT hr = E_FAIL;
+	if (!serializedData_.empty()) {
+		hr = device1->CreatePipelineLibrary(serializedData_.data(), serializedData_.size(), IID_PPV_ARGS(&library_));
+		if (FAILED(hr)) {
+			// ドライバ・GPUが変わった、ファイルが壊れている等。作り直す
+			Log(std::format("PipelineLibrary: discard saved library (hr = {:#x})\n", uint32_t(hr)));
+			serializedData_.clear();
+		}
+	}
+	if (FAILED(hr)) {
+		hr = device1->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(&library_));
+		if (FAILED(hr)) {
+			Log(std::format("PipelineLibrary: not supported (hr = {:#x})\n", uint32_t(hr)));
+			library_ = nullptr;
+		}
+	}
+	device1->Release();
+}
+
+void PipelineLibrary::Finalize() {
+	if (!device_) {
+		return;
+	}
+	Save();
+	if (library_) {
+		library_->Release();
+		library_ = nullptr;
+	}
+	serializedData_.clear();
+	device_ = nullptr;
+}
+
+void PipelineLibrary::Save() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (!library_ || !isDirty_) {
+		return;
+	}
+
+	std::vector<char> data(library_->GetSerializedSize());
+	HRESULT hr = library_->Serialize(data.data(), data.size());
+	if (FAILED(hr)) {
+		Log(std::format("PipelineLibrary: failed to serialize (hr = {:#x})\n", uint32_t(hr)));
+		return;
+	}
+
+	// 途中で落ちても壊れたファイルが残らないように、一時ファイルに書いてから置き換える
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(filePath_).parent_path(), error);
+	const std::wstring tempPath = filePath_ + L".tmp";
+	{
+		std::ofstream file(std::filesystem::path(tempPath), std::ios::binary | std::ios::trunc);
+		file.write(data.data(), data.size());
+		if (!file) {
+			file.close();
+			std::filesystem::remove(tempPath, error);
+			return;
+		}
+	}
+	std::filesystem::rename(tempPath, filePath_, error);
+	if (error) {
+		std::filesystem::remove(tempPath, error);
+		return;
+	}
+	isDirty_ = false;
+	Log(std::format("PipelineLibrary: saved {} bytes\n", data.size()));
+}
+
+ID3D12PipelineState* PipelineLibrary::CreateGraphicsPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, uint64_t key) {
+	assert(device_);
+	const std::wstring name = HashToHexString(key);
+	ID3D12PipelineState* pipelineState = nullptr;
+
+	// 保存してあればドライバのコンパイルなしで作れる ------------------------------
+	if (library_ && SUCCEEDED(library_->LoadGraphicsPipeline(name.c_str(), &desc, IID_PPV_ARGS(&pipelineState)))) {
+		++loadCount_;
+		return pipelineState;
+	}
+
+	HRESULT hr = device_->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&pipelineState));
+	if (FAILED(hr)) {
+		Log(std::format("PipelineLibrary: failed to create pipeline (hr = {:#x})\n", uint32_t(hr)));
+		return nullptr;
+	}
+	++createCount_;
+
+	if (library_) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		// 同じ名前が既にある(descが食い違っている)場合は失敗するが、PSOは使える
+		if (SUCCEEDED(library_->StorePipeline(name.c_str(), pipelineState))) {
+			isDirty_ = true;
+		}
+	}
+	return pipelineState;
+}
+
+//=============================================================================================================================
+//	PipelineStateCache
+//=============================================================================================================================
+PipelineStateCache::~PipelineStateCache() {
+	Finalize();
+}
+
+void PipelineStateCache::Init(IPipelineStateSource* source) {
+	assert(source);
+	source_ = source;
+}
+
+void PipelineStateCache::Finalize() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	for (auto& [key, pipelineState] : pipelines_) {
+		pipelineState->Release();
+	}
+	pipelines_.clear();
+	rootSignatureHashes_.clear();
+}
+
+void PipelineStateCache::RegisterRootSignature(ID3D12RootSignature* rootSignature, const void* serializedData, size_t size) {
+	assert(rootSignature);
+	std::lock_guard<std::mutex> lock(mutex_);
+	rootSignatureHashes_[rootSignature] = HashBytes(serializedData, size);
+}
+
+void PipelineStateCache::RegisterRootSignature(ID3D12RootSignature* rootSignature, uint64_t hash) {
+	assert(rootSignature);
+	std::lock_guard<std::mutex> lock(mutex_);
+	rootSignatureHashes_[rootSignature] = hash;
+}
+
+ID3D12PipelineState* PipelineStateCache::GetOrCreate(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc) {
+	assert(source_);
+	uint64_t key = 0;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto rootSignature = rootSignatureHashes_.find(desc.pRootSignature);
+		assert(rootSignature != rootSignatureHashes_.end());
+		key = HashGraphicsPipelineDesc(desc, rootSignature->second);
+
+		auto it = pipelines_.find(key);
+		if (it != pipelines_.end()) {
+			++hitCount_;
+			it->second->AddRef();
+			return it->second;
+		}
+	}
+
+	// 作るのは時間がかかるのでロックの外で行う
+	ID3D12PipelineState* pipelineState = source_->CreateGraphicsPipeline(desc, key);
+	if (!pipelineState) {
+		return nullptr;
+	}
+	++missCount_;
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto [it, isInserted] = pipelines_.emplace(key, pipelineState);
+	if (!isInserted) {
+		// 別のスレッドが先に作っていた
+		pipelineState->Release();
+	}
+	it->second->AddRef();
+	return it->second;
+}
+
+size_t PipelineStateCache::GetPipelineCount() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return pipelines_.size();
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <d3d12.h>
+
+/// PSOライブラリの保存先(シェーダーのキャッシュと同じく消しても作り直される)
+static const wchar_t* const kPipelineLibraryPath = L"Resource/ShaderCache/Pipelines.bin";
+
+/// <summary>
+/// PSOの設定のハッシュ
+/// ポインタではなく中身(シェーダーのバイトコード・セマンティクス名など)を見て、
+/// 無効になっている設定(ブレンドしない時のブレンド係数など)は含めないので、同じ結果になる設定は同じ値になる
+/// </summary>
+/// <param name="desc"></param>
+/// <param name="rootSignatureHash">ルートシグネチャのシリアライズ結果のハッシュ(ポインタは実行ごとに変わるため)</param>
+/// <returns></returns>
+uint64_t HashGraphicsPipelineDesc(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, uint64_t rootSignatureHash);
+
+/// <summary>
+/// PSOを実際に作る所(D3D12に依存しない形にしてテスト用の偽物に差し替えられるようにする)
+/// </summary>
+class IPipelineStateSource {
+public:
+	virtual ~IPipelineStateSource() = default;
+
+	/// <summary>
+	/// PSOを作る
+	/// </summary>
+	/// <param name="desc"></param>
+	/// <param name="key">HashGraphicsPipelineDescの値</param>
+	/// <returns>作ったPSO(参照を1つ持って返す)。失敗したらnullptr</returns>
+	virtual ID3D12PipelineState* CreateGraphicsPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, uint64_t key) = 0;
+};
+
+/// <summary>
+/// ID3D12PipelineLibraryを使ってPSOを作る
+/// 前回の実行で保存したPSOはドライバのコンパイルを飛ばして読み込む
+/// </summary>
+class PipelineLibrary : public IPipelineStateSource {
+public:
+
+	PipelineLibrary() = default;
+	~PipelineLibrary() override;
+	PipelineLibrary(const PipelineLibrary&) = delete;
+	const PipelineLibrary& operator=(const PipelineLibrary&) = delete;
+
+	/// <summary>
+	/// 保存したライブラリを読み込む(ない・ドライバが変わった場合は空から作る)
+	/// </summary>
+	/// <param name="device"></param>
+	/// <param name="filePath"></param>
+	void Init(ID3D12Device* device, const std::wstring& filePath = kPipelineLibraryPath);
+
+	/// <summary>
+	/// 新しく作ったPSOがあれば保存して解放する
+	/// </summary>
+	void Finalize();
+
+	/// <summary>
+	/// ライブラリをファイルに書き出す(新しく作ったPSOがない場合は何もしない)
+	/// </summary>
+	void Save();
+
+	ID3D12PipelineState* CreateGraphicsPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, uint64_t key) override;
+
+public: // accessor
+
+	/// ライブラリから読み込めた数
+	uint32_t GetLoadCount() const { return loadCount_.load(); }
+
+	/// ドライバがコンパイルした数
+	uint32_t GetCreateCount() const { return createCount_.load(); }
+
+private:
+	ID3D12Device* device_ = nullptr;
+	// Windows 10 1607より前など、ライブラリが使えない場合はnullptr
+	ID3D12PipelineLibrary* library_ = nullptr;
+	std::wstring filePath_;
+	// ライブラリが参照しているので、ライブラリより長く持っておく
+	std::vector<char> serializedData_;
+
+	// ライブラリはスレッドセーフだが、保存との間は排他にする
+	std::mutex mutex_;
+	bool isDirty_ = false;
+
+	std::atomic<uint32_t> loadCount_ = 0;
+	std::atomic<uint32_t> createCount_ = 0;
+};
+
+/// <summary>
+/// PSOの設定のハッシュ → PSO
+/// 同じ設定で何度頼まれても1つだけ作る
+/// </summary>
+class PipelineStateCache {
+public:
+
+	PipelineStateCache() = default;
+	~PipelineStateCache();
+	PipelineStateCache(const PipelineStateCache&) = delete;
+	const PipelineStateCache& operator=(const PipelineStateCache&) = delete;
+
+	void Init(IPipelineStateSource* source);
+
+	void Finalize();
+
+	/// <summary>
+	/// ルートシグネチャのハッシュを覚える(PSOのキーに使う)
+	/// </summary>
+	/// <param name="rootSignature"></param>
+	/// <param name="serializedData">D3D12SerializeRootSignatureの結果</param>
+	/// <param name="size"></param>
+	void RegisterRootSignature(ID3D12RootSignature* rootSignature, const void* serializedData, size_t size);
+
+	/// <summary>
+	/// ルートシグネチャのハッシュを覚える(RootSignatureLayout::hash等、実行ごとに変わらない値を渡す)
+	/// </summary>
+	void RegisterRootSignature(ID3D12RootSignature* rootSignature, uint64_t hash);
+
+	/// <summary>
+	/// PSOを取得する。なければ作る(どのスレッドから呼んでもよい)
+	/// </summary>
+	/// <param name="desc">pRootSignatureはRegisterRootSignatureしたもの</param>
+	/// <returns>PSO(参照を1つ持って返すので使い終わったらRelease)。失敗したらnullptr</returns>
+	ID3D12PipelineState* GetOrCreate(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc);
+
+public: // accessor
+
+	uint32_t GetHitCount() const { return hitCount_.load(); }
+
+	uint32_t GetMissCount() const { return missCount_.load(); }
+
+	size_t GetPipelineCount() const;
+
+private:
+	IPipelineStateSource* source_ = nullptr;
+
+	mutable std::mutex mutex_;
+	std::unordered_map<const ID3D12RootSignature*, uint64_t> rootSignatureHashes_;
+	// シェーダーを作り直すと増えていく(古いPSOはFinalizeまで残る)
+	std::unordered_map<uint64_t, ID3D12PipelineState*> pipelines_;
+
+	std::atomic<uint32_t> hitCount_ = 0;
+	std::atomic<uint32_t> missCount_ = 0;
+};
@@ -0,0 +1,238 @@
+#include "RootSignatureCache.h"
+#include <algorithm>
+#include <cassert>
+#include <format>
+#include <string>
+#include <tuple>
+
+#include "Function/DirectXUtils.h"
+#include "Function/Hash.h"
+
+namespace {
+
+/// <summary>
+/// 並べ替えの間だけ名前を一緒に持っておく
+/// </summary>
+struct NamedParameter {
+	RootParameterLayout parameter;
+	std::string name;
+};
+
+bool IsSameResource(const NamedParameter& entry, const ShaderBinding& binding) {
+	return entry.parameter.type == binding.type
+		&& entry.parameter.shaderRegister == binding.shaderRegister
+		&& entry.parameter.registerSpace == binding.registerSpace
+		&& entry.parameter.count == binding.count
+		&& entry.name == binding.name;
+}
+
+auto MakeSortKey(const NamedParameter& entry) {
+	const RootParameterLayout& parameter = entry.parameter;
+	return std::make_tuple(parameter.IsDescriptorTable(), parameter.type, parameter.registerSpace, parameter.shaderRegister, parameter.visibility, std::string_view(entry.name));
+}
+
+uint64_t HashParameter(uint64_t hash, const RootParameterLayout& parameter) {
+	hash = HashCombine(hash, parameter.type);
+	hash = HashCombine(hash, parameter.shaderRegister);
+	hash = HashCombine(hash, parameter.registerSpace);
+	hash = HashCombine(hash, parameter.count);
+	return HashCombine(hash, parameter.visibility);
+}
+
+D3D12_DESCRIPTOR_RANGE_TYPE ToRangeType(ShaderBindingType type) {
+	switch (type) {
+	case ShaderBindingType::ConstantBuffer:
+		return D3D12_DESCRIPTOR_RANGE_TYPE_CBV;
+	case ShaderBindingType::RWBuffer:
+	case ShaderBindingType::RWTexture:
+		return D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+	default:
+		return D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+	}
+}
+
+D3D12_ROOT_PARAMETER_TYPE ToRootParameterType(ShaderBindingType type) {
+	switch (type) {
+	case ShaderBindingType::ConstantBuffer:
+		return D3D12_ROOT_PARAMETER_TYPE_CBV;
+	case ShaderBindingType::RWBuffer:
+		return D3D12_ROOT_PARAMETER_TYPE_UAV;
+	default:
+		return D3D12_ROOT_PARAMETER_TYPE_SRV;
+	}
+}
+
+}
+
+//=============================================================================================================================
+//	RootSignatureLayout
+//=============================================================================================================================
+uint32_t RootSignatureLayout::FindParameter(uint64_t nameHash) const {
+	auto it = std::lower_bound(bindings.begin(), bindings.end(), nameHash, [](const RootBinding& binding, uint64_t value) {
+		return binding.nameHash < value;
+	});
+	if (it == bindings.end() || it->nameHash != nameHash) {
+		return kInvalidParameter;
+	}
+	return it->parameterIndex;
+}
+
+uint32_t RootSignatureLayout::FindParameter(std::string_view name) const {
+	return FindParameter(HashString(name));
+}
+
+RootSignatureLayout BuildRootSignatureLayout(const std::vector<ShaderBinding>& bindings) {
+	// ステージをまたいで同じリソースをまとめる ------------------------------------------
+	std::vector<NamedParameter> parameters;
+	std::vector<NamedParameter> samplers;
+	for (const ShaderBinding& binding : bindings) {
+		std::vector<NamedParameter>& entries = binding.type == ShaderBindingType::Sampler ? samplers : parameters;
+		auto it = std::find_if(entries.begin(), entries.end(), [&](const NamedParameter& entry) { return IsSameResource(entry, binding); });
+		if (it != entries.end()) {
+			if (it->parameter.visibility != binding.visibility) {
+				it->parameter.visibility = D3D12_SHADER_VISIBILITY_ALL;
+			}
+			continue;
+		}
+		NamedParameter& entry = entries.emplace_back();
+		entry.parameter.type = binding.type;
+		entry.parameter.shaderRegister = binding.shaderRegister;
+		entry.parameter.registerSpace = binding.registerSpace;
+		entry.parameter.count = binding.count;
+		entry.parameter.visibility = binding.visibility;
+		entry.name = binding.name;
+	}
+
+	// 宣言順によらない並びにする ------------------------------------------------------
+	auto less = [](const NamedParameter& a, const NamedParameter& b) { return MakeSortKey(a) < MakeSortKey(b); };
+	std::sort(parameters.begin(), parameters.end(), less);
+	std::sort(samplers.begin(), samplers.end(), less);
+
+	RootSignatureLayout layout;
+	uint64_t hash = HashCombine(kHashOffsetBasis, parameters.size());
+	for (const NamedParameter& entry : parameters) {
+		layout.bindings.push_back({ HashString(entry.name), uint32_t(layout.parameters.size()) });
+		layout.parameters.push_back(entry.parameter);
+		hash = HashParameter(hash, entry.parameter);
+	}
+	hash = HashCombine(hash, samplers.size());
+	for (const NamedParameter& entry : samplers) {
+		layout.staticSamplers.push_back(entry.parameter);
+		hash = HashParameter(hash, entry.parameter);
+	}
+	layout.hash = hash;
+
+	std::sort(layout.bindings.begin(), layout.bindings.end(), [](const RootBinding& a, const RootBinding& b) {
+		return a.nameHash < b.nameHash;
+	});
+	return layout;
+}
+
+//=============================================================================================================================
+//	RootSignatureCache
+//=============================================================================================================================
+RootSignatureCache::~RootSignatureCache() {
+	Finalize();
+}
+
+void RootSignatureCache::Init(ID3D12Device* device) {
+	assert(device);
+	device_ = device;
+}
+
+void RootSignatureCache::Finalize() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	for (auto& [hash, rootSignature] : rootSignatures_) {
+		rootSignature->Release();
+	}
+	rootSignatures_.clear();
+	device_ = nullptr;
+}
+
+ID3D12RootSignature* RootSignatureCache::GetOrCreate(const RootSignatureLayout& layout) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	assert(device_);
+	auto it = rootSignatures_.find(layout.hash);
+	if (it != rootSignatures_.end()) {
+		it->second->AddRef();
+		return it->second;
+	}
+
+	// ルートパラメータ ------------------------------------------------------------------
+	std::vector<D3D12_ROOT_PARAMETER> rootParameters(layout.parameters.size());
+	// DescriptorTableは1つのレンジを指す(途中で配列の大きさを変えないので指したままでよい)
+	std::vector<D3D12_DESCRIPTOR_RANGE> descriptorRanges(layout.parameters.size());
+	for (size_t index = 0; index < layout.parameters.size(); ++index) {
+		const RootParameterLayout& parameter = layout.parameters[index];
+		D3D12_ROOT_PARAMETER& rootParameter = rootParameters[index];
+		rootParameter.ShaderVisibility = parameter.visibility;
+		if (parameter.IsDescriptorTable()) {
+			D3D12_DESCRIPTOR_RANGE& range = descriptorRanges[index];
+			range.RangeType = ToRangeType(parameter.type);
+			// 大きさ指定のない配列はヒープの終わりまで
+			range.NumDescriptors = parameter.count == 0 ? UINT_MAX : parameter.count;
+			range.BaseShaderRegister = parameter.shaderRegister;
+			range.RegisterSpace = parameter.registerSpace;
+			range.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+			rootParameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+			rootParameter.DescriptorTable.pDescriptorRanges = &range;
+			rootParameter.DescriptorTable.NumDescriptorRanges = 1;
+		} else {
+			rootParameter.ParameterType = ToRootParameterType(parameter.type);
+			rootParameter.Descriptor.ShaderRegister = parameter.shaderRegister;
+			rootParameter.Descriptor.RegisterSpace = parameter.registerSpace;
+		}
+	}
+
+	// Samplerの設定 -------------------------------------------------------------------
+	std::vector<D3D12_STATIC_SAMPLER_DESC> staticSamplers(layout.staticSamplers.size());
+	for (size_t index = 0; index < layout.staticSamplers.size(); ++index) {
+		D3D12_STATIC_SAMPLER_DESC& sampler = staticSamplers[index];
+		sampler.Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+		sampler.AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+		sampler.AddressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+		sampler.AddressW = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+		sampler.ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+		sampler.MaxLOD = D3D12_FLOAT32_MAX;
+		sampler.ShaderRegister = layout.staticSamplers[index].shaderRegister;
+		sampler.RegisterSpace = layout.staticSamplers[index].registerSpace;
+		sampler.ShaderVisibility = layout.staticSamplers[index].visibility;
+	}
+
+	D3D12_ROOT_SIGNATURE_DESC descriptionRootSignature{};
+	descriptionRootSignature.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+	descriptionRootSignature.pParameters = rootParameters.data();
+	descriptionRootSignature.NumParameters = UINT(rootParameters.size());
+	descriptionRootSignature.pStaticSamplers = staticSamplers.data();
+	descriptionRootSignature.NumStaticSamplers = UINT(staticSamplers.size());
+
+	// シリアライズしてバイナリにする ----------------------------------------------------
+	ID3DBlob* signatureBlob = nullptr;
+	ID3DBlob* errorBlob = nullptr;
+	HRESULT hr = D3D12SerializeRootSignature(&descriptionRootSignature, D3D_ROOT_SIGNATURE_VERSION_1, &signatureBlob, &errorBlob);
+	if (FAILED(hr)) {
+		if (errorBlob) {
+			Log(reinterpret_cast<char*>(errorBlob->GetBufferPointer()));
+			errorBlob->Release();
+		}
+		return nullptr;
+	}
+
+	// バイナリを元に生成
+	ID3D12RootSignature* rootSignature = nullptr;
+	hr = device_->CreateRootSignature(0, signatureBlob->GetBufferPointer(), signatureBlob->GetBufferSize(), IID_PPV_ARGS(&rootSignature));
+	signatureBlob->Release();
+	if (FAILED(hr)) {
+		Log(std::format("RootSignatureCache: failed to create root signature (hr = {:#x})\n", uint32_t(hr)));
+		return nullptr;
+	}
+
+	rootSignatures_.emplace(layout.hash, rootSignature);
+	rootSignature->AddRef();
+	return rootSignature;
+}
+
+size_t RootSignatureCache::GetRootSignatureCount() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return rootSignatures_.size();
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <d3d12.h>
+
+#include "Shader/ShaderReflection.h"
+
+/// <summary>
+/// ルートパラメータ1つ分
+/// </summary>
+struct RootParameterLayout {
+	ShaderBindingType type = ShaderBindingType::ConstantBuffer;
+	uint32_t shaderRegister = 0;
+	uint32_t registerSpace = 0;
+	uint32_t count = 1;
+	D3D12_SHADER_VISIBILITY visibility = D3D12_SHADER_VISIBILITY_ALL;
+
+	/// DescriptorTableにするか(テクスチャと、配列のバッファ)
+	bool IsDescriptorTable() const {
+		return type == ShaderBindingType::Texture || type == ShaderBindingType::RWTexture || count != 1;
+	}
+};
+
+/// <summary>
+/// リソースの名前のハッシュ → ルートパラメータの番号
+/// </summary>
+struct RootBinding {
+	uint64_t nameHash;
+	uint32_t parameterIndex;
+};
+
+/// <summary>
+/// シェーダーのリフレクションから決めたルートシグネチャの形
+/// </summary>
+struct RootSignatureLayout {
+
+	static const uint32_t kInvalidParameter = UINT32_MAX;
+
+	// ルート定数バッファ・ルートSRV/UAV を先に、DescriptorTableを後に並べる
+	std::vector<RootParameterLayout> parameters;
+	// サンプラーは全て線形補間・WRAPのStaticSamplerにする
+	std::vector<RootParameterLayout> staticSamplers;
+	// nameHashの順に並べる
+	std::vector<RootBinding> bindings;
+	// parametersとstaticSamplersのハッシュ(名前は含めないので、名前だけが違うシェーダーとは同じ値になる)
+	uint64_t hash = 0;
+
+	/// <summary>
+	/// リソースの名前からルートパラメータの番号を引く(ない場合はkInvalidParameter)
+	/// </summary>
+	uint32_t FindParameter(uint64_t nameHash) const;
+
+	uint32_t FindParameter(std::string_view name) const;
+};
+
+/// <summary>
+/// 全ステージのリソースからルートシグネチャの形を決める
+/// 同じ名前・レジスタのリソースが複数のステージにあれば1つにまとめてVisibilityをALLにする
+/// 並びはリソースの宣言順によらず決まるので、同じリソースを使うシェーダーは同じハッシュになる
+/// </summary>
+/// <param name="bindings">ReflectShaderBindingsで集めたもの</param>
+/// <returns></returns>
+RootSignatureLayout BuildRootSignatureLayout(const std::vector<ShaderBinding>& bindings);
+
+/// <summary>
+/// ルートシグネチャの形 → ルートシグネチャ
+/// 同じ形のものは1つだけ作るので、シェーダーが違ってもルートシグネチャを切り替えずに済む
+/// </summary>
+class RootSignatureCache {
+public:
+
+	RootSignatureCache() = default;
+	~RootSignatureCache();
+	RootSignatureCache(const RootSignatureCache&) = delete;
+	const RootSignatureCache& operator=(const RootSignatureCache&) = delete;
+
+	void Init(ID3D12Device* device);
+
+	void Finalize();
+
+	/// <summary>
+	/// ルートシグネチャを取得する。なければ作る
+	/// </summary>
+	/// <param name="layout"></param>
+	/// <returns>参照を1つ持って返すので使い終わったらRelease。失敗したらnullptr</returns>
+	ID3D12RootSignature* GetOrCreate(const RootSignatureLayout& layout);
+
+public: // accessor
+
+	size_t GetRootSignatureCount() const;
+
+private:
+	ID3D12Device* device_ = nullptr;
+
+	mutable std::mutex mutex_;
+	std::unordered_map<uint64_t, ID3D12RootSignature*> rootSignatures_;
+};
@@ -0,0 +1,284 @@
+#include "SpriteBatch.h"
+#include "MathSimd.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "Function/DirectXUtils.h"
+#include "DirectXCommon/D3D12CommandRecorder.h"
+
+namespace {
+
+/// <summary>
+/// 中心・大きさの半分・回転から四隅(左上・右上・左下・右下)を求める
+/// </summary>
+template<typename T>
+void ExpandCorners(T centerX, T centerY, T halfWidth, T halfHeight, T rotation, T (&x)[4], T (&y)[4]) {
+	T sinR, cosR;
+	SinCos(rotation, &sinR, &cosR);
+	// 回転したスプライトの右向き・下向きの半分の長さ
+	const T rightX = halfWidth * cosR;
+	const T rightY = halfWidth * sinR;
+	const T downX = -(halfHeight * sinR);
+	const T downY = halfHeight * cosR;
+
+	x[0] = centerX - rightX - downX;
+	y[0] = centerY - rightY - downY;
+	x[1] = centerX + rightX - downX;
+	y[1] = centerY + rightY - downY;
+	x[2] = centerX - rightX + downX;
+	y[2] = centerY - rightY + downY;
+	x[3] = centerX + rightX + downX;
+	y[3] = centerY + rightY + downY;
+}
+
+uint32_t PackColor(const Vector4& color) {
+	auto toByte = [](float value) {
+		return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+	};
+	return toByte(color.x) | (toByte(color.y) << 8) | (toByte(color.z) << 16) | (toByte(color.w) << 24);
+}
+
+#if defined(MYMATH_USE_SSE)
+uint32_t PackColor(__m128 color) {
+	color = _mm_min_ps(_mm_max_ps(color, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+	__m128i bytes = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(color, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+	bytes = _mm_packs_epi32(bytes, bytes);
+	bytes = _mm_packus_epi16(bytes, bytes);
+	return static_cast<uint32_t>(_mm_cvtsi128_si32(bytes));
+}
+#endif
+
+}
+
+//=============================================================================================================================
+//	初期化
+//=============================================================================================================================
+void SpriteBatch::Init(ID3D12Device* device, uint32_t maxSprites, uint32_t framesInFlight, const TextureResolver& resolver) {
+	assert(device);
+	assert(resolver);
+	maxSprites_ = maxSprites;
+	resolver_ = resolver;
+	sprites_.reserve(maxSprites);
+	sortKeys_.reserve(maxSprites);
+
+	// 四角形の並びは変わらないので最初に全部作る -----------------------------------------------
+	const uint32_t indexCount = maxSprites * kIndicesPerSprite;
+	indexResource_ = CreateBufferResource(device, sizeof(uint32_t) * indexCount);
+	uint32_t* indexData = nullptr;
+	indexResource_->Map(0, nullptr, reinterpret_cast<void**>(&indexData));
+	for (uint32_t sprite = 0; sprite < maxSprites; ++sprite) {
+		const uint32_t vertex = sprite * kVerticesPerSprite;
+		uint32_t* index = indexData + sprite * kIndicesPerSprite;
+		index[0] = vertex + 0;
+		index[1] = vertex + 1;
+		index[2] = vertex + 2;
+		index[3] = vertex + 2;
+		index[4] = vertex + 1;
+		index[5] = vertex + 3;
+	}
+	indexResource_->Unmap(0, nullptr);
+	indexBufferView_.BufferLocation = indexResource_->GetGPUVirtualAddress();
+	indexBufferView_.SizeInBytes = sizeof(uint32_t) * indexCount;
+	indexBufferView_.Format = DXGI_FORMAT_R32_UINT;
+
+	// 頂点はフレームごとに使い捨てる(フレーム数+1の分を持つのは、末尾に収まらず先頭に戻った時の隙間の分)
+	const uint64_t frameSize = uint64_t(sizeof(SpriteVertex)) * kVerticesPerSprite * maxSprites;
+	const uint64_t alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
+	vertexRing_.Init(device, (frameSize * (framesInFlight + 1) + alignment - 1) / alignment * alignment);
+}
+
+void SpriteBatch::Finalize() {
+	vertexRing_.Finalize();
+	indexResource_->Release();
+	indexResource_ = nullptr;
+	sprites_.clear();
+}
+
+void SpriteBatch::Clear() {
+	droppedCount_ += GetSpriteCount();
+	sprites_.clear();
+	lastSpriteCount_ = 0;
+	lastDrawCount_ = 0;
+	lastDroppedCount_ = droppedCount_;
+	droppedCount_ = 0;
+}
+
+void SpriteBatch::EndFrame(uint64_t fenceValue, uint64_t completedFenceValue) {
+	vertexRing_.EndFrame(fenceValue, completedFenceValue);
+}
+
+//=============================================================================================================================
+//	頂点を作る
+//=============================================================================================================================
+void SpriteBatch::Build(SpriteVertex* outVertices) {
+	const uint32_t count = GetSpriteCount();
+
+	// テクスチャの順に並べる -----------------------------------------------------------------
+	sortKeys_.resize(count);
+	sortTemp_.resize(count);
+	uint32_t usedBits = 0;
+	for (uint32_t index = 0; index < count; ++index) {
+		sortKeys_[index] = (uint64_t(sprites_[index].textureHandle) << 32) | index;
+		usedBits |= sprites_[index].textureHandle;
+	}
+	// ハンドルは小さい値なので、使っている桁だけ8bitずつ基数ソートする(追加順はそのまま保たれる)
+	for (uint32_t shift = 32; shift < 64 && (usedBits >> (shift - 32)) != 0; shift += 8) {
+		uint32_t offsets[256] = {};
+		for (uint64_t key : sortKeys_) {
+			++offsets[(key >> shift) & 0xff];
+		}
+		uint32_t sum = 0;
+		for (uint32_t& offset : offsets) {
+			const uint32_t bucketCount = offset;
+			offset = sum;
+			sum += bucketCount;
+		}
+		for (uint64_t key : sortKeys_) {
+			sortTemp_[offsets[(key >> shift) & 0xff]++] = key;
+		}
+		sortKeys_.swap(sortTemp_);
+	}
+
+	drawRanges_.clear();
+	for (uint32_t index = 0; index < count; ++index) {
+		const uint32_t textureHandle = static_cast<uint32_t>(sortKeys_[index] >> 32);
+		if (drawRanges_.empty() || drawRanges_.back().textureHandle != textureHandle) {
+			drawRanges_.push_back({ textureHandle, index, 0 });
+		}
+		++drawRanges_.back().spriteCount;
+	}
+
+	// 頂点を作る(書き込みは先頭から順に行う) ---------------------------------------------
+	uint32_t index = 0;
+
+#if defined(MYMATH_USE_SSE)
+	// 4枚ずつ、1レーン1枚として計算する
+	const __m128 half = _mm_set1_ps(0.5f);
+	for (; index + 4 <= count; index += 4) {
+		const Sprite* sprites[4];
+		for (int lane = 0; lane < 4; ++lane) {
+			sprites[lane] = &sprites_[static_cast<uint32_t>(sortKeys_[index + lane])];
+		}
+
+		// 1枚の値の並びからレーンの並びに転置する
+		// (位置x, 位置y, 幅, 高さ) と (u0, v0, u1, v1)
+		__m128 geometry[4];
+		__m128 uv[4];
+		for (int lane = 0; lane < 4; ++lane) {
+			geometry[lane] = _mm_loadu_ps(&sprites[lane]->position.x);
+			uv[lane] = _mm_loadu_ps(&sprites[lane]->uvMin.x);
+		}
+		_MM_TRANSPOSE4_PS(geometry[0], geometry[1], geometry[2], geometry[3]);
+		_MM_TRANSPOSE4_PS(uv[0], uv[1], uv[2], uv[3]);
+		const __m128 u0 = uv[0];
+		const __m128 v0 = uv[1];
+		const __m128 u1 = uv[2];
+		const __m128 v1 = uv[3];
+		const Lane4 rotation = { _mm_set_ps(sprites[3]->rotation, sprites[2]->rotation, sprites[1]->rotation, sprites[0]->rotation) };
+
+		Lane4 x[4], y[4];
+		ExpandCorners<Lane4>({ geometry[0] }, { geometry[1] }, { _mm_mul_ps(geometry[2], half) }, { _mm_mul_ps(geometry[3], half) }, rotation, x, y);
+
+		// 頂点ごとに(x, y, u, v)の並びに戻す
+		const __m128 cornerU[4] = { u0, u1, u0, u1 };
+		const __m128 cornerV[4] = { v0, v0, v1, v1 };
+		__m128 corners[4][4];
+		for (int corner = 0; corner < 4; ++corner) {
+			__m128 c0 = x[corner].v;
+			__m128 c1 = y[corner].v;
+			__m128 c2 = cornerU[corner];
+			__m128 c3 = cornerV[corner];
+			_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+			corners[0][corner] = c0;
+			corners[1][corner] = c1;
+			corners[2][corner] = c2;
+			corners[3][corner] = c3;
+		}
+
+		SpriteVertex* vertex = outVertices + size_t(index) * kVerticesPerSprite;
+		for (int lane = 0; lane < 4; ++lane) {
+			const uint32_t color = PackColor(_mm_loadu_ps(&sprites[lane]->color.x));
+			for (int corner = 0; corner < 4; ++corner, ++vertex) {
+				_mm_storeu_ps(&vertex->position.x, corners[lane][corner]);
+				vertex->color = color;
+			}
+		}
+	}
+#endif
+
+	// 残り(SIMDが使えない場合は全部) ----------------------------------------------------------
+	for (; index < count; ++index) {
+		const Sprite& sprite = sprites_[static_cast<uint32_t>(sortKeys_[index])];
+		float x[4], y[4];
+		ExpandCorners(sprite.position.x, sprite.position.y, sprite.size.x * 0.5f, sprite.size.y * 0.5f, sprite.rotation, x, y);
+
+		const uint32_t color = PackColor(sprite.color);
+		SpriteVertex* vertex = outVertices + size_t(index) * kVerticesPerSprite;
+		for (int corner = 0; corner < 4; ++corner) {
+			vertex[corner].position = { x[corner], y[corner] };
+			vertex[corner].texcoord = { (corner & 1) ? sprite.uvMax.x : sprite.uvMin.x, (corner & 2) ? sprite.uvMax.y : sprite.uvMin.y };
+			vertex[corner].color = color;
+		}
+	}
+}
+
+//=============================================================================================================================
+//	描画
+//=============================================================================================================================
+void SpriteBatch::Flush(ICommandRecorder* recorder, uint32_t textureRootIndex) {
+	const uint32_t count = GetSpriteCount();
+	if (count == 0) {
+		Clear();
+		return;
+	}
+	// Addで上限を超える分は捨てているので、インデックスの範囲を超えることはない
+	assert(count <= maxSprites_);
+
+	UploadAllocation allocation = vertexRing_.Allocate(uint64_t(sizeof(SpriteVertex)) * kVerticesPerSprite * count);
+	if (!allocation.IsValid()) {
+		// 頂点を書く場所がなければこのフレームの分は描かない
+		Clear();
+		return;
+	}
+	lastSpriteCount_ = count;
+	lastDrawCount_ = 0;
+	lastDroppedCount_ = droppedCount_;
+	droppedCount_ = 0;
+	Build(static_cast<SpriteVertex*>(allocation.cpuAddress));
+
+	VertexBufferView vertexBufferView{};
+	vertexBufferView.bufferLocation = allocation.gpuAddress;
+	vertexBufferView.sizeInBytes = static_cast<uint32_t>(allocation.size);
+	vertexBufferView.strideInBytes = sizeof(SpriteVertex);
+	recorder->IASetVertexBuffers(0, 1, &vertexBufferView);
+	recorder->IASetIndexBuffer(ToCommand(&indexBufferView_));
+	recorder->IASetPrimitiveTopology(PrimitiveTopology::TriangleList);
+
+	// 並びは続いているので、同じDescriptorになる範囲(読み込み中の代わりのテクスチャ等)はまとめて描く
+	D3D12_GPU_DESCRIPTOR_HANDLE currentHandle{};
+	uint32_t firstSprite = 0;
+	uint32_t spriteCount = 0;
+	auto draw = [&]() {
+		if (spriteCount == 0) {
+			return;
+		}
+		recorder->SetGraphicsRootDescriptorTable(textureRootIndex, ToCommand(currentHandle));
+		recorder->DrawIndexedInstanced(spriteCount * kIndicesPerSprite, 1, firstSprite * kIndicesPerSprite, 0, 0);
+		++lastDrawCount_;
+	};
+	for (const SpriteDrawRange& range : drawRanges_) {
+		const D3D12_GPU_DESCRIPTOR_HANDLE handle = resolver_(range.textureHandle);
+		if (spriteCount != 0 && handle.ptr == currentHandle.ptr) {
+			spriteCount += range.spriteCount;
+			continue;
+		}
+		draw();
+		currentHandle = handle;
+		firstSprite = range.firstSprite;
+		spriteCount = range.spriteCount;
+	}
+	draw();
+
+	sprites_.clear();
+}
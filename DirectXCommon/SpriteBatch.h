@@ -0,0 +1,157 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <d3d12.h>
+
+#include "Vector2.h"
+#include "Vector4.h"
+#include "DirectXCommon/CommandRecorder.h"
+#include "DirectXCommon/UploadRingBuffer.h"
+
+/// <summary>
+/// スプライト1枚分
+/// </summary>
+struct Sprite {
+	Vector2 position;							// 中心のスクリーン座標(ピクセル。左上が原点)
+	Vector2 size;								// 幅と高さ(ピクセル)
+	Vector2 uvMin = { 0.0f, 0.0f };				// 左上のUV
+	Vector2 uvMax = { 1.0f, 1.0f };				// 右下のUV
+	Vector4 color = { 1.0f, 1.0f, 1.0f, 1.0f };
+	float rotation = 0.0f;						// 中心で回す角度(ラジアン)
+	uint32_t textureHandle = 0;					// TextureManagerのハンドル
+};
+
+// 頂点を作る時に position,size と uvMin,uvMax をそれぞれ16byteで読む
+static_assert(offsetof(Sprite, size) == offsetof(Sprite, position) + 8, "Sprite layout");
+static_assert(offsetof(Sprite, uvMin) == 16 && offsetof(Sprite, uvMax) == 24, "Sprite layout");
+
+/// <summary>
+/// スプライトの頂点(Sprite.VS.hlslのSpriteVertexInputと同じ並び)
+/// </summary>
+struct SpriteVertex {
+	Vector2 position;		// スクリーン座標
+	Vector2 texcoord;
+	uint32_t color;			// R8G8B8A8_UNORM
+};
+
+static_assert(sizeof(SpriteVertex) == 20, "SpriteVertex must match the input layout");
+
+/// <summary>
+/// 同じテクスチャが続く範囲(並べ替えた後の番号)
+/// </summary>
+struct SpriteDrawRange {
+	uint32_t textureHandle;
+	uint32_t firstSprite;
+	uint32_t spriteCount;
+};
+
+/// <summary>
+/// 1フレームに大量のスプライトを追加し、テクスチャごとにまとめて描く
+/// 頂点はMapしたままのアップロードヒープに直接書き、インデックスは最初に作った四角形の並びを使い回す
+/// テクスチャの順に並べ替えるので、違うテクスチャのスプライト同士の前後は追加順にならない(同じテクスチャの中は追加順)
+/// </summary>
+class SpriteBatch {
+public:
+
+	/// テクスチャのハンドル → DescriptorTableに渡すハンドル
+	using TextureResolver = std::function<D3D12_GPU_DESCRIPTOR_HANDLE(uint32_t textureHandle)>;
+
+	static const uint32_t kVerticesPerSprite = 4;
+	static const uint32_t kIndicesPerSprite = 6;
+
+public:
+
+	SpriteBatch() = default;
+	~SpriteBatch() = default;
+	SpriteBatch(const SpriteBatch&) = delete;
+	const SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="device"></param>
+	/// <param name="maxSprites">1フレームに描ける数</param>
+	/// <param name="framesInFlight"></param>
+	/// <param name="resolver"></param>
+	void Init(ID3D12Device* device, uint32_t maxSprites, uint32_t framesInFlight, const TextureResolver& resolver);
+
+	void Finalize();
+
+	/// <summary>
+	/// 追加する(描くのはFlush)
+	/// 頂点・インデックスは1フレームにmaxSprites枚分しか持たないので、超える分は追加せずに数えておく
+	/// </summary>
+	/// <returns>追加できたか</returns>
+	bool Add(const Sprite& sprite) {
+		if (sprites_.size() >= maxSprites_) {
+			++droppedCount_;
+			return false;
+		}
+		sprites_.push_back(sprite);
+		return true;
+	}
+
+	/// <summary>
+	/// 追加された分をテクスチャの順に並べ、頂点を作る(GPUは使わない)
+	/// </summary>
+	/// <param name="outVertices">GetSpriteCount() * kVerticesPerSprite 個分の書き込み先(読み戻さないのでMapしたバッファで良い)</param>
+	void Build(SpriteVertex* outVertices);
+
+	/// <summary>
+	/// 追加された分を描くコマンドを積んで空にする
+	/// ルートシグネチャ・PSO・射影行列は呼ぶ側で設定しておく
+	/// </summary>
+	/// <param name="recorder"></param>
+	/// <param name="textureRootIndex">テクスチャのDescriptorTableのルートパラメータの番号</param>
+	void Flush(ICommandRecorder* recorder, uint32_t textureRootIndex);
+
+	/// <summary>
+	/// 描かずに空にする(空にした分は描かなかった数に入れる)
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// 今のフレームのコマンドを送った後に呼ぶ
+	/// </summary>
+	void EndFrame(uint64_t fenceValue, uint64_t completedFenceValue);
+
+public: // accessor
+
+	uint32_t GetSpriteCount() const { return static_cast<uint32_t>(sprites_.size()); }
+
+	/// Buildで決まった描画の範囲
+	const std::vector<SpriteDrawRange>& GetDrawRanges() const { return drawRanges_; }
+
+	/// 前回のFlushで描いた数と描画の回数
+	uint32_t GetLastSpriteCount() const { return lastSpriteCount_; }
+	uint32_t GetLastDrawCount() const { return lastDrawCount_; }
+
+	/// 前回のFlush・Clearまでに、上限を超えた・頂点を書く場所がなかったため描かなかった数
+	uint32_t GetLastDroppedCount() const { return lastDroppedCount_; }
+
+	uint32_t GetMaxSprites() const { return maxSprites_; }
+
+private:
+
+	std::vector<Sprite> sprites_;
+	// テクスチャ << 32 | 追加順 (並べ替えても同じテクスチャの中は追加順のまま)
+	std::vector<uint64_t> sortKeys_;
+	std::vector<uint64_t> sortTemp_;
+	std::vector<SpriteDrawRange> drawRanges_;
+
+	uint32_t maxSprites_ = 0;
+	TextureResolver resolver_;
+
+	ID3D12Resource* indexResource_ = nullptr;
+	D3D12_INDEX_BUFFER_VIEW indexBufferView_{};
+	UploadRingBuffer vertexRing_;
+
+	uint32_t lastSpriteCount_ = 0;
+	uint32_t lastDrawCount_ = 0;
+	// 次のFlush・Clearまでに描かなかった数
+	uint32_t droppedCount_ = 0;
+	uint32_t lastDroppedCount_ = 0;
+};
@@ -0,0 +1,46 @@
+#include "UploadRingBuffer.h"
+#include "Function/DirectXUtils.h"
+
+void UploadRingBuffer::Init(ID3D12Device* device, uint64_t capacity) {
+	assert(device);
+	assert(capacity % D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT == 0);
+
+	resource_ = CreateBufferResource(device, static_cast<size_t>(capacity));
+	// アップロードヒープはMapしたままで良いので、最初に一度だけMapする
+	HRESULT hr = resource_->Map(0, nullptr, reinterpret_cast<void**>(&mappedData_));
+	assert(SUCCEEDED(hr));
+	gpuAddress_ = resource_->GetGPUVirtualAddress();
+
+	allocator_.Init(capacity);
+}
+
+void UploadRingBuffer::Finalize() {
+	resource_->Unmap(0, nullptr);
+	resource_->Release();
+	resource_ = nullptr;
+	mappedData_ = nullptr;
+}
+
+//=============================================================================================================================
+//	確保
+//=============================================================================================================================
+UploadAllocation UploadRingBuffer::Allocate(uint64_t size, uint64_t alignment) {
+	UploadAllocation result;
+	const uint64_t offset = allocator_.Allocate(size, alignment);
+	if (offset == LinearRingAllocator::kInvalidOffset) {
+		// GPUが読み終わっていない領域は上書きできないので空を返す(続くようなら容量を増やす)
+		++failedAllocationCount_;
+		return result;
+	}
+
+	result.cpuAddress = mappedData_ + offset;
+	result.gpuAddress = gpuAddress_ + offset;
+	result.offset = offset;
+	result.size = size;
+	return result;
+}
+
+void UploadRingBuffer::EndFrame(uint64_t fenceValue, uint64_t completedFenceValue) {
+	allocator_.FinishFrame(fenceValue);
+	allocator_.Retire(completedFenceValue);
+}
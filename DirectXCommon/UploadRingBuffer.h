@@ -0,0 +1,81 @@
+#pragma once
+#include <d3d12.h>
+#include <cassert>
+
+#include "DirectXCommon/LinearRingAllocator.h"
+
+/// <summary>
+/// UploadRingBufferから切り出した領域(空きがなければ空のまま返るので、IsValidを確かめてから使う)
+/// </summary>
+struct UploadAllocation {
+	void* cpuAddress = nullptr;						// 書き込み先
+	D3D12_GPU_VIRTUAL_ADDRESS gpuAddress = 0;		// SetGraphicsRootConstantBufferView等に渡すアドレス
+	uint64_t offset = 0;							// リソースの先頭からのオフセット
+	uint64_t size = 0;
+
+	bool IsValid() const { return cpuAddress != nullptr; }
+};
+
+/// <summary>
+/// Mapしたままのアップロードヒープを、フレームごとに使い捨てる定数バッファ・動的頂点バッファとして切り出す
+/// </summary>
+class UploadRingBuffer {
+public:
+
+	UploadRingBuffer() = default;
+	~UploadRingBuffer() = default;
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="device"></param>
+	/// <param name="capacity">バイト数(256の倍数)</param>
+	void Init(ID3D12Device* device, uint64_t capacity);
+
+	void Finalize();
+
+	/// <summary>
+	/// 今のフレームで使う領域を確保する
+	/// </summary>
+	/// <param name="size"></param>
+	/// <param name="alignment">定数バッファは256、頂点バッファなら頂点のサイズ程度で良い</param>
+	/// <returns>空きがなければ空(IsValidがfalse)。GPUが読み終わっていない領域は上書きできないので、呼ぶ側はそのフレームの描画を諦める</returns>
+	UploadAllocation Allocate(uint64_t size, uint64_t alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+	/// <summary>
+	/// 定数バッファを1つ確保して値を書き込む
+	/// </summary>
+	/// <returns>GPUアドレス。空きがなければ0</returns>
+	template<typename T>
+	D3D12_GPU_VIRTUAL_ADDRESS PushConstant(const T& data) {
+		UploadAllocation allocation = Allocate(sizeof(T));
+		if (!allocation.IsValid()) {
+			return 0;
+		}
+		*static_cast<T*>(allocation.cpuAddress) = data;
+		return allocation.gpuAddress;
+	}
+
+	/// <summary>
+	/// 今のフレームのコマンドを送った後に呼ぶ
+	/// </summary>
+	/// <param name="fenceValue">今のフレームのフェンス値</param>
+	/// <param name="completedFenceValue">GPUが終わらせたフェンス値</param>
+	void EndFrame(uint64_t fenceValue, uint64_t completedFenceValue);
+
+public: // accessor
+
+	ID3D12Resource* GetResource() const { return resource_; }
+	const LinearRingAllocator& GetAllocator() const { return allocator_; }
+	/// 空きがなくて確保できなかった回数(起動してからの合計)
+	uint64_t GetFailedAllocationCount() const { return failedAllocationCount_; }
+
+private:
+
+	ID3D12Resource* resource_ = nullptr;
+	uint8_t* mappedData_ = nullptr;
+	D3D12_GPU_VIRTUAL_ADDRESS gpuAddress_ = 0;
+
+	LinearRingAllocator allocator_;
+	uint64_t failedAllocationCount_ = 0;
+};
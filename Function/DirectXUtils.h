@@ -4,25 +4,10 @@
 #include <dxgi1_6.h>
 #include <cassert>
 #include <dxgidebug.h>
-
-// dxc
-#include <dxcapi.h>
 #include <vector>
 
 #include "Function/Convert.h"
 
-/// <summary>
-/// CompileShader
-/// </summary>
-/// <param name=""></param>
-IDxcBlob* CompilerShader(
-	const std::wstring& filePath,
-	const wchar_t* profile,
-	IDxcUtils* dxcUtils,
-	IDxcCompiler3* dxcCompiler,
-	IDxcIncludeHandler* includeHandler
-);
-
 /// <summary>
 /// DiscriptorHeapの作成
 /// </summary>
@@ -41,6 +26,15 @@ ID3D12DescriptorHeap* CreateDescriptorHeap(ID3D12Device* device, D3D12_DESCRIPTO
 /// <returns></returns>
 ID3D12Resource* CreateBufferResource(ID3D12Device* device, size_t sizeInBytes);
 
+/// <summary>
+/// アップロードヒープのバッファを作る(失敗してもassertしない。ワーカースレッドで作って失敗を呼び出し元に返す時用)
+/// </summary>
+/// <param name="device"></param>
+/// <param name="sizeInBytes"></param>
+/// <param name="outResource">失敗した時はnullptr</param>
+/// <returns></returns>
+HRESULT CreateBufferResource(ID3D12Device* device, size_t sizeInBytes, ID3D12Resource** outResource);
+
 /// <summary>
 /// 深度情報を格納するリソースの生成
 /// </summary>
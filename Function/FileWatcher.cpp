@@ -0,0 +1,38 @@
+#include "FileWatcher.h"
+
+void FileWatcher::SetFiles(const std::vector<std::wstring>& files) {
+	std::unordered_map<std::wstring, FileState> newFiles;
+	for (const std::wstring& filePath : files) {
+		auto it = files_.find(filePath);
+		newFiles[filePath] = it != files_.end() ? it->second : GetFileState(filePath);
+	}
+	files_ = std::move(newFiles);
+}
+
+std::vector<std::wstring> FileWatcher::Poll() {
+	std::vector<std::wstring> changedFiles;
+	for (auto& [filePath, state] : files_) {
+		const FileState current = GetFileState(filePath);
+		// 消えている間は前の状態のままにしておく
+		if (!current.exists) {
+			continue;
+		}
+		if (!state.exists || current.writeTime != state.writeTime || current.size != state.size) {
+			changedFiles.push_back(filePath);
+		}
+		state = current;
+	}
+	return changedFiles;
+}
+
+FileWatcher::FileState FileWatcher::GetFileState(const std::wstring& filePath) {
+	FileState state;
+	std::error_code error;
+	state.writeTime = std::filesystem::last_write_time(filePath, error);
+	if (error) {
+		return state;
+	}
+	state.size = std::filesystem::file_size(filePath, error);
+	state.exists = !error;
+	return state;
+}
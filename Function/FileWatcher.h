@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// ファイルの更新を検出する(更新日時と大きさを定期的に見るだけなのでOSに依存しない)
+/// </summary>
+class FileWatcher {
+public:
+
+	/// <summary>
+	/// 監視するファイルを設定する。既に監視していたファイルは前の状態を引き継ぐ
+	/// </summary>
+	/// <param name="files"></param>
+	void SetFiles(const std::vector<std::wstring>& files);
+
+	/// <summary>
+	/// 前回から変わったファイルを返す
+	/// エディタが保存の途中で一時的に消している場合は、次に現れた時に変更として扱う
+	/// </summary>
+	/// <returns></returns>
+	std::vector<std::wstring> Poll();
+
+	size_t GetFileCount() const { return files_.size(); }
+
+private:
+
+	struct FileState {
+		std::filesystem::file_time_type writeTime{};
+		uintmax_t size = 0;
+		bool exists = false;
+	};
+
+	static FileState GetFileState(const std::wstring& filePath);
+
+private:
+	std::unordered_map<std::wstring, FileState> files_;
+};
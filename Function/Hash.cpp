@@ -0,0 +1,27 @@
+#include "Hash.h"
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+bool HashFile(const std::wstring& filePath, uint64_t& outHash, uint64_t* outSize) {
+	std::ifstream file(std::filesystem::path(filePath), std::ios::binary);
+	if (!file) {
+		return false;
+	}
+
+	uint64_t hash = kHashOffsetBasis;
+	uint64_t size = 0;
+	std::vector<char> buffer(1 << 16);
+	while (file) {
+		file.read(buffer.data(), buffer.size());
+		const std::streamsize readSize = file.gcount();
+		hash = HashBytes(buffer.data(), static_cast<size_t>(readSize), hash);
+		size += static_cast<uint64_t>(readSize);
+	}
+
+	outHash = hash;
+	if (outSize) {
+		*outSize = size;
+	}
+	return true;
+}
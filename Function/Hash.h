@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/*================================================================================================
+キャッシュのキー等に使う64bitハッシュ(FNV-1a)
+暗号用途ではないが、ファイル内容・設定の変化を検出するには十分
+==================================================================================================*/
+
+static const uint64_t kHashOffsetBasis = 14695981039346656037ull;
+static const uint64_t kHashPrime = 1099511628211ull;
+
+/// <summary>
+/// バイト列のハッシュ
+/// </summary>
+/// <param name="data"></param>
+/// <param name="size"></param>
+/// <param name="seed">続けてハッシュする場合は前の結果を渡す</param>
+/// <returns></returns>
+inline uint64_t HashBytes(const void* data, size_t size, uint64_t seed = kHashOffsetBasis) {
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	uint64_t hash = seed;
+	for (size_t index = 0; index < size; ++index) {
+		hash ^= bytes[index];
+		hash *= kHashPrime;
+	}
+	return hash;
+}
+
+inline uint64_t HashString(std::string_view str, uint64_t seed = kHashOffsetBasis) {
+	return HashBytes(str.data(), str.size(), seed);
+}
+
+inline uint64_t HashString(std::wstring_view str, uint64_t seed = kHashOffsetBasis) {
+	return HashBytes(str.data(), str.size() * sizeof(wchar_t), seed);
+}
+
+/// <summary>
+/// 値をハッシュに混ぜる
+/// </summary>
+template<typename T>
+inline uint64_t HashCombine(uint64_t seed, const T& value) {
+	return HashBytes(&value, sizeof(T), seed);
+}
+
+/// <summary>
+/// ハッシュを16桁の16進数にする(ファイル名用)
+/// </summary>
+/// <param name="hash"></param>
+/// <returns></returns>
+inline std::wstring HashToHexString(uint64_t hash) {
+	static const wchar_t kDigits[] = L"0123456789abcdef";
+	std::wstring result(16, L'0');
+	for (int index = 15; index >= 0; --index) {
+		result[index] = kDigits[hash & 0xF];
+		hash >>= 4;
+	}
+	return result;
+}
+
+/// <summary>
+/// ファイルの内容のハッシュ
+/// </summary>
+/// <param name="filePath"></param>
+/// <param name="outHash"></param>
+/// <param name="outSize">ファイルサイズ(不要ならnullptr)</param>
+/// <returns></returns>
+bool HashFile(const std::wstring& filePath, uint64_t& outHash, uint64_t* outSize = nullptr);
@@ -0,0 +1,108 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+	Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::wstring& filePath) {
+	Close();
+
+	// 先頭から順に読むのでキャッシュマネージャに先読みさせる
+	HANDLE file = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	file_ = file;
+
+	LARGE_INTEGER fileSize{};
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0 || static_cast<uint64_t>(fileSize.QuadPart) > SIZE_MAX) {
+		Close();
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping) {
+		Close();
+		return false;
+	}
+	mapping_ = mapping;
+
+	data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!data_) {
+		Close();
+		return false;
+	}
+	size_ = static_cast<size_t>(fileSize.QuadPart);
+	return true;
+}
+
+void MappedFile::Close() {
+	if (data_) {
+		UnmapViewOfFile(data_);
+		data_ = nullptr;
+	}
+	if (mapping_) {
+		CloseHandle(static_cast<HANDLE>(mapping_));
+		mapping_ = nullptr;
+	}
+	if (file_) {
+		CloseHandle(static_cast<HANDLE>(file_));
+		file_ = nullptr;
+	}
+	size_ = 0;
+}
+
+#else
+
+bool MappedFile::Open(const std::wstring& filePath) {
+	Close();
+
+	file_ = open(std::filesystem::path(filePath).c_str(), O_RDONLY);
+	if (file_ < 0) {
+		return false;
+	}
+
+	struct stat status{};
+	if (fstat(file_, &status) != 0 || status.st_size <= 0) {
+		Close();
+		return false;
+	}
+
+	void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file_, 0);
+	if (data == MAP_FAILED) {
+		Close();
+		return false;
+	}
+	// 先頭から順に読むので先読みさせる
+	madvise(data, static_cast<size_t>(status.st_size), MADV_SEQUENTIAL);
+
+	data_ = static_cast<const uint8_t*>(data);
+	size_ = static_cast<size_t>(status.st_size);
+	return true;
+}
+
+void MappedFile::Close() {
+	if (data_) {
+		munmap(const_cast<uint8_t*>(data_), size_);
+		data_ = nullptr;
+	}
+	if (file_ >= 0) {
+		close(file_);
+		file_ = -1;
+	}
+	size_ = 0;
+}
+
+#endif
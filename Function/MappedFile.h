@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// <summary>
+/// 読み取り専用でファイルをメモリにマップする
+/// ファイルの中身をヒープに読み込まず、OSのページキャッシュを直接参照する
+/// </summary>
+class MappedFile {
+public:
+
+	MappedFile() = default;
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	const MappedFile& operator=(const MappedFile&) = delete;
+
+	/// <summary>
+	/// ファイルを開いてマップする(空のファイルは失敗扱い)
+	/// </summary>
+	/// <param name="filePath"></param>
+	/// <returns></returns>
+	bool Open(const std::wstring& filePath);
+
+	/// <summary>
+	/// マップを解除してファイルを閉じる
+	/// </summary>
+	void Close();
+
+public: // accessor
+
+	const uint8_t* GetData() const { return data_; }
+	size_t GetSize() const { return size_; }
+	bool IsOpen() const { return data_ != nullptr; }
+
+private:
+	const uint8_t* data_ = nullptr;
+	size_t size_ = 0;
+
+#ifdef _WIN32
+	void* file_ = nullptr;
+	void* mapping_ = nullptr;
+#else
+	int file_ = -1;
+#endif
+};
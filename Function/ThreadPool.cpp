@@ -0,0 +1,104 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+
+namespace {
+thread_local uint32_t tWorkerIndex = ThreadPool::kInvalidWorkerIndex;
+}
+
+ThreadPool::~ThreadPool() {
+	Finalize();
+}
+
+void ThreadPool::Init(uint32_t threadCount, ThreadCallback onThreadStart, ThreadCallback onThreadExit) {
+	assert(workers_.empty());
+	if (threadCount == 0) {
+		// メインスレッドの分を空けておく
+		const uint32_t hardwareCount = std::thread::hardware_concurrency();
+		threadCount = (std::max)(hardwareCount, 2u) - 1;
+	}
+
+	onThreadStart_ = std::move(onThreadStart);
+	onThreadExit_ = std::move(onThreadExit);
+	stop_ = false;
+
+	workers_.reserve(threadCount);
+	for (uint32_t index = 0; index < threadCount; ++index) {
+		workers_.emplace_back(&ThreadPool::WorkerMain, this, index);
+	}
+}
+
+void ThreadPool::Finalize() {
+	if (workers_.empty()) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	jobCondition_.notify_all();
+
+	for (std::thread& worker : workers_) {
+		worker.join();
+	}
+	workers_.clear();
+}
+
+//=============================================================================================================================
+//	ジョブ
+//=============================================================================================================================
+void ThreadPool::Submit(Job job) {
+	assert(!workers_.empty());
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		jobs_.push_back(std::move(job));
+		++pendingCount_;
+	}
+	jobCondition_.notify_one();
+}
+
+void ThreadPool::WaitIdle() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	idleCondition_.wait(lock, [this] { return pendingCount_ == 0; });
+}
+
+uint32_t ThreadPool::GetWorkerIndex() {
+	return tWorkerIndex;
+}
+
+void ThreadPool::WorkerMain(uint32_t workerIndex) {
+	tWorkerIndex = workerIndex;
+	if (onThreadStart_) {
+		onThreadStart_(workerIndex);
+	}
+
+	for (;;) {
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			jobCondition_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+			// 止める時も積まれている分は処理してから抜ける
+			if (jobs_.empty()) {
+				break;
+			}
+			job = std::move(jobs_.front());
+			jobs_.pop_front();
+		}
+
+		job();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			--pendingCount_;
+			if (pendingCount_ == 0) {
+				idleCondition_.notify_all();
+			}
+		}
+	}
+
+	if (onThreadExit_) {
+		onThreadExit_(workerIndex);
+	}
+	tWorkerIndex = kInvalidWorkerIndex;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// 固定数のワーカースレッドでジョブを処理する
+/// </summary>
+class ThreadPool {
+public:
+
+	using Job = std::function<void()>;
+	/// ワーカーの開始時・終了時に呼ばれる(COMの初期化など)。引数はワーカー番号
+	using ThreadCallback = std::function<void(uint32_t)>;
+
+	static const uint32_t kInvalidWorkerIndex = UINT32_MAX;
+
+public:
+
+	ThreadPool() = default;
+	~ThreadPool();
+	ThreadPool(const ThreadPool&) = delete;
+	const ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/// <summary>
+	/// ワーカーを起動する
+	/// </summary>
+	/// <param name="threadCount">0ならハードウェアスレッド数-1(最低1)</param>
+	/// <param name="onThreadStart"></param>
+	/// <param name="onThreadExit"></param>
+	void Init(uint32_t threadCount = 0, ThreadCallback onThreadStart = nullptr, ThreadCallback onThreadExit = nullptr);
+
+	/// <summary>
+	/// 残っているジョブを全て処理してからワーカーを止める
+	/// </summary>
+	void Finalize();
+
+	/// <summary>
+	/// ジョブを積む
+	/// </summary>
+	/// <param name="job"></param>
+	void Submit(Job job);
+
+	/// <summary>
+	/// 積んだジョブが全て終わるまで待つ
+	/// </summary>
+	void WaitIdle();
+
+public: // accessor
+
+	uint32_t GetThreadCount() const { return static_cast<uint32_t>(workers_.size()); }
+
+	/// 呼び出したスレッドのワーカー番号(ワーカー以外ではkInvalidWorkerIndex)
+	static uint32_t GetWorkerIndex();
+
+private:
+
+	void WorkerMain(uint32_t workerIndex);
+
+private:
+
+	std::vector<std::thread> workers_;
+	ThreadCallback onThreadStart_;
+	ThreadCallback onThreadExit_;
+
+	std::mutex mutex_;
+	// ジョブが積まれた・止める時に起こす
+	std::condition_variable jobCondition_;
+	// 全て終わった時に起こす
+	std::condition_variable idleCondition_;
+	std::deque<Job> jobs_;
+	// 積まれてまだ終わっていないジョブの数(実行中を含む)
+	uint32_t pendingCount_ = 0;
+	bool stop_ = false;
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+/*================================================================================================
+行列演算のSIMDバックエンドの選択(コンパイル時)
+
+・/arch:AVX2 (gcc/clangでは -mavx2) でビルドした場合 → AVX2版
+・x64(MSVC) もしくは SSE2 が有効な環境             → SSE版
+・それ以外、または MYMATH_FORCE_SCALAR を定義した場合 → スカラー版
+
+どのバックエンドでもFMAは使わず、スカラー版と同じ順番で乗算と加算を行うので
+結果はスカラー版とビット単位で一致する(FP contractionが無効な /fp:precise の場合)
+==================================================================================================*/
+
+#if !defined(MYMATH_FORCE_SCALAR)
+#if defined(__AVX2__)
+#define MYMATH_USE_AVX2 1
+#define MYMATH_USE_SSE 1
+#elif defined(_M_X64) || defined(__SSE2__)
+#define MYMATH_USE_SSE 1
+#endif
+#endif
+
+#if defined(MYMATH_USE_AVX2)
+#include <immintrin.h>
+#elif defined(MYMATH_USE_SSE)
+#include <emmintrin.h>
+#endif
+
+#include <cmath>
+
+#if defined(MYMATH_USE_SSE)
+/// <summary>
+/// 4つの値の同じ要素をまとめて扱うための型(floatと同じ式で書けるようにする)
+/// </summary>
+struct Lane4 {
+	__m128 v;
+};
+
+inline Lane4 operator+(Lane4 a, Lane4 b) { return { _mm_add_ps(a.v, b.v) }; }
+inline Lane4 operator-(Lane4 a, Lane4 b) { return { _mm_sub_ps(a.v, b.v) }; }
+inline Lane4 operator*(Lane4 a, Lane4 b) { return { _mm_mul_ps(a.v, b.v) }; }
+inline Lane4 operator-(Lane4 a) { return { _mm_sub_ps(_mm_setzero_ps(), a.v) }; }
+inline Lane4 Reciprocal(Lane4 a) { return { _mm_div_ps(_mm_set1_ps(1.0f), a.v) }; }
+
+/// <summary>
+/// 4つのsin,cosをまとめて求める(Cephesの多項式近似。|x| < 8192で誤差は約1e-7)
+/// </summary>
+/// <param name="x">ラジアン</param>
+/// <param name="outSin"></param>
+/// <param name="outCos"></param>
+inline void SinCos(Lane4 x, Lane4* outSin, Lane4* outCos) {
+	const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000)));
+
+	// 符号を外して π/4 単位の象限を求める
+	__m128 signSin = _mm_and_ps(x.v, signMask);
+	__m128 ax = _mm_andnot_ps(signMask, x.v);
+	__m128i quadrant = _mm_cvttps_epi32(_mm_mul_ps(ax, _mm_set1_ps(1.27323954473516f)));
+	quadrant = _mm_and_si128(_mm_add_epi32(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+	__m128 y = _mm_cvtepi32_ps(quadrant);
+
+	// sin,cosそれぞれの符号と、どちらの多項式を使うか
+	__m128 swapSignSin = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(4)), 29));
+	__m128 polyMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), _mm_setzero_si128()));
+	__m128 signCos = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(quadrant, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+	signSin = _mm_xor_ps(signSin, swapSignSin);
+
+	// 3分割したπ/4で精度を落とさずに範囲を縮める
+	ax = _mm_add_ps(ax, _mm_mul_ps(y, _mm_set1_ps(-0.78515625f)));
+	ax = _mm_add_ps(ax, _mm_mul_ps(y, _mm_set1_ps(-2.4187564849853515625e-4f)));
+	ax = _mm_add_ps(ax, _mm_mul_ps(y, _mm_set1_ps(-3.77489497744594108e-8f)));
+	const __m128 z = _mm_mul_ps(ax, ax);
+
+	// cosの多項式
+	__m128 polyCos = _mm_set1_ps(2.443315711809948e-5f);
+	polyCos = _mm_add_ps(_mm_mul_ps(polyCos, z), _mm_set1_ps(-1.388731625493765e-3f));
+	polyCos = _mm_add_ps(_mm_mul_ps(polyCos, z), _mm_set1_ps(4.166664568298827e-2f));
+	polyCos = _mm_mul_ps(_mm_mul_ps(polyCos, z), z);
+	polyCos = _mm_sub_ps(polyCos, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+	polyCos = _mm_add_ps(polyCos, _mm_set1_ps(1.0f));
+
+	// sinの多項式
+	__m128 polySin = _mm_set1_ps(-1.9515295891e-4f);
+	polySin = _mm_add_ps(_mm_mul_ps(polySin, z), _mm_set1_ps(8.3321608736e-3f));
+	polySin = _mm_add_ps(_mm_mul_ps(polySin, z), _mm_set1_ps(-1.6666654611e-1f));
+	polySin = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(polySin, z), ax), ax);
+
+	// 象限に合わせて入れ替える
+	const __m128 sinValue = _mm_or_ps(_mm_and_ps(polyMask, polySin), _mm_andnot_ps(polyMask, polyCos));
+	const __m128 cosValue = _mm_or_ps(_mm_and_ps(polyMask, polyCos), _mm_andnot_ps(polyMask, polySin));
+	outSin->v = _mm_xor_ps(sinValue, signSin);
+	outCos->v = _mm_xor_ps(cosValue, signCos);
+}
+#endif
+
+inline float Reciprocal(float a) { return 1.0f / a; }
+
+inline void SinCos(float x, float* outSin, float* outCos) {
+	*outSin = std::sin(x);
+	*outCos = std::cos(x);
+}
@@ -1,4 +1,6 @@
 #include "MyMatrix.h"
+#include "MathSimd.h"
+#include "MyQuaternion.h"
 
 /// <summary>
 /// 加算
@@ -43,6 +45,40 @@ Matrix4x4 Subtract(const Matrix4x4& m1, const Matrix4x4& m2) {
 Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2) {
     Matrix4x4 result{};
 
+#if defined(MYMATH_USE_AVX2)
+    // m2の各行を上下128bitに複製しておき、m1の2行分をまとめて計算する
+    const __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[0]));
+    const __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[1]));
+    const __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[2]));
+    const __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[3]));
+
+    for (int row = 0; row < 4; row += 2) {
+        const __m256 a = _mm256_loadu_ps(m1.m[row]);
+        // スカラー版と同じく0から順に足していく(-0の符号まで一致させるため)
+        __m256 r = _mm256_setzero_ps();
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_permute_ps(a, _MM_SHUFFLE(0, 0, 0, 0)), b0));
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_permute_ps(a, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_permute_ps(a, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_permute_ps(a, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+        _mm256_storeu_ps(result.m[row], r);
+    }
+#elif defined(MYMATH_USE_SSE)
+    const __m128 b0 = _mm_loadu_ps(m2.m[0]);
+    const __m128 b1 = _mm_loadu_ps(m2.m[1]);
+    const __m128 b2 = _mm_loadu_ps(m2.m[2]);
+    const __m128 b3 = _mm_loadu_ps(m2.m[3]);
+
+    for (int row = 0; row < 4; row++) {
+        const __m128 a = _mm_loadu_ps(m1.m[row]);
+        // スカラー版と同じく0から順に足していく(-0の符号まで一致させるため)
+        __m128 r = _mm_setzero_ps();
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), b0));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+        _mm_storeu_ps(result.m[row], r);
+    }
+#else
     for (int row = 0; row < 4; row++) {
         for (int col = 0; col < 4; col++) {
             for (int oi = 0; oi < 4; oi++) {
@@ -50,6 +86,7 @@ Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2) {
             }
         }
     }
+#endif
 
     return result;
 }
@@ -60,6 +97,106 @@ Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2) {
 /// <param name="m"></param>
 /// <returns></returns>
 Matrix4x4 Inverse(Matrix4x4 matrix) {
+#if defined(MYMATH_USE_SSE)
+    // 行の操作をSIMDで行う。手順はスカラー版と同じなので結果も一致する
+#if defined(MYMATH_USE_AVX2)
+    // 下位128bitに元の行列、上位128bitに単位行列の行を並べて同時に操作する
+    __m256 rows[4];
+    for (int i = 0; i < 4; ++i) {
+        float identityRow[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        identityRow[i] = 1.0f;
+        rows[i] = _mm256_set_m128(_mm_loadu_ps(identityRow), _mm_loadu_ps(matrix.m[i]));
+    }
+    auto Element = [&](int row, int col) {
+        alignas(32) float tmp[8];
+        _mm256_store_ps(tmp, rows[row]);
+        return tmp[col];
+    };
+    auto Scale = [&](int row, float scalar) {
+        rows[row] = _mm256_mul_ps(rows[row], _mm256_set1_ps(scalar));
+    };
+    auto AddScaled = [&](int target, int source, float scalar) {
+        rows[target] = _mm256_add_ps(rows[target], _mm256_mul_ps(_mm256_set1_ps(scalar), rows[source]));
+    };
+    auto Swap = [&](int row1, int row2) {
+        __m256 temp = rows[row1];
+        rows[row1] = rows[row2];
+        rows[row2] = temp;
+    };
+#else
+    __m128 rows[4];
+    __m128 results[4];
+    for (int i = 0; i < 4; ++i) {
+        float identityRow[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        identityRow[i] = 1.0f;
+        rows[i] = _mm_loadu_ps(matrix.m[i]);
+        results[i] = _mm_loadu_ps(identityRow);
+    }
+    auto Element = [&](int row, int col) {
+        alignas(16) float tmp[4];
+        _mm_store_ps(tmp, rows[row]);
+        return tmp[col];
+    };
+    auto Scale = [&](int row, float scalar) {
+        const __m128 s = _mm_set1_ps(scalar);
+        rows[row] = _mm_mul_ps(rows[row], s);
+        results[row] = _mm_mul_ps(results[row], s);
+    };
+    auto AddScaled = [&](int target, int source, float scalar) {
+        const __m128 s = _mm_set1_ps(scalar);
+        rows[target] = _mm_add_ps(rows[target], _mm_mul_ps(s, rows[source]));
+        results[target] = _mm_add_ps(results[target], _mm_mul_ps(s, results[source]));
+    };
+    auto Swap = [&](int row1, int row2) {
+        __m128 temp = rows[row1];
+        rows[row1] = rows[row2];
+        rows[row2] = temp;
+        temp = results[row1];
+        results[row1] = results[row2];
+        results[row2] = temp;
+    };
+#endif
+
+    // 前進消去
+    for (int i = 0; i < 4; ++i) {
+        // ピボットが0ならば行の入れ替えを行う
+        if (Element(i, i) == 0.0f) {
+            for (int j = i + 1; j < 4; ++j) {
+                if (Element(j, i) != 0.0f) {
+                    Swap(i, j);
+                    break;
+                }
+            }
+        }
+
+        // ピボットを1にする
+        float pivot = Element(i, i);
+        Scale(i, 1.0f / pivot);
+
+        // ピボット以下の要素を0にする
+        for (int j = i + 1; j < 4; ++j) {
+            AddScaled(j, i, -Element(j, i));
+        }
+    }
+
+    // 後退代入
+    for (int i = 3; i > 0; --i) {
+        for (int j = i - 1; j >= 0; --j) {
+            AddScaled(j, i, -Element(j, i));
+        }
+    }
+
+    // 逆行列を結果にコピー
+    for (int i = 0; i < 4; ++i) {
+#if defined(MYMATH_USE_AVX2)
+        _mm_storeu_ps(matrix.m[i], _mm256_extractf128_ps(rows[i], 1));
+#else
+        _mm_storeu_ps(matrix.m[i], results[i]);
+#endif
+    }
+
+    return matrix;
+#else
     Matrix4x4 result;
 
     // 単位行列を初期化
@@ -108,6 +245,181 @@ Matrix4x4 Inverse(Matrix4x4 matrix) {
     matrix = result;
 
     return matrix;
+#endif
+}
+
+namespace {
+
+/// <summary>
+/// 2x2の小行列式を使った余因子展開で逆行列を求める
+/// </summary>
+template<typename T>
+void CofactorInverse(const T (&a)[4][4], T (&b)[4][4]) {
+    // 上2行と下2行の2x2小行列式
+    const T s0 = a[0][0] * a[1][1] - a[1][0] * a[0][1];
+    const T s1 = a[0][0] * a[1][2] - a[1][0] * a[0][2];
+    const T s2 = a[0][0] * a[1][3] - a[1][0] * a[0][3];
+    const T s3 = a[0][1] * a[1][2] - a[1][1] * a[0][2];
+    const T s4 = a[0][1] * a[1][3] - a[1][1] * a[0][3];
+    const T s5 = a[0][2] * a[1][3] - a[1][2] * a[0][3];
+
+    const T c5 = a[2][2] * a[3][3] - a[3][2] * a[2][3];
+    const T c4 = a[2][1] * a[3][3] - a[3][1] * a[2][3];
+    const T c3 = a[2][1] * a[3][2] - a[3][1] * a[2][2];
+    const T c2 = a[2][0] * a[3][3] - a[3][0] * a[2][3];
+    const T c1 = a[2][0] * a[3][2] - a[3][0] * a[2][2];
+    const T c0 = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+
+    // 行列式
+    const T det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    const T invDet = Reciprocal(det);
+
+    b[0][0] = (a[1][1] * c5 - a[1][2] * c4 + a[1][3] * c3) * invDet;
+    b[0][1] = (-a[0][1] * c5 + a[0][2] * c4 - a[0][3] * c3) * invDet;
+    b[0][2] = (a[3][1] * s5 - a[3][2] * s4 + a[3][3] * s3) * invDet;
+    b[0][3] = (-a[2][1] * s5 + a[2][2] * s4 - a[2][3] * s3) * invDet;
+
+    b[1][0] = (-a[1][0] * c5 + a[1][2] * c2 - a[1][3] * c1) * invDet;
+    b[1][1] = (a[0][0] * c5 - a[0][2] * c2 + a[0][3] * c1) * invDet;
+    b[1][2] = (-a[3][0] * s5 + a[3][2] * s2 - a[3][3] * s1) * invDet;
+    b[1][3] = (a[2][0] * s5 - a[2][2] * s2 + a[2][3] * s1) * invDet;
+
+    b[2][0] = (a[1][0] * c4 - a[1][1] * c2 + a[1][3] * c0) * invDet;
+    b[2][1] = (-a[0][0] * c4 + a[0][1] * c2 - a[0][3] * c0) * invDet;
+    b[2][2] = (a[3][0] * s4 - a[3][1] * s2 + a[3][3] * s0) * invDet;
+    b[2][3] = (-a[2][0] * s4 + a[2][1] * s2 - a[2][3] * s0) * invDet;
+
+    b[3][0] = (-a[1][0] * c3 + a[1][1] * c1 - a[1][2] * c0) * invDet;
+    b[3][1] = (a[0][0] * c3 - a[0][1] * c1 + a[0][2] * c0) * invDet;
+    b[3][2] = (-a[3][0] * s3 + a[3][1] * s1 - a[3][2] * s0) * invDet;
+    b[3][3] = (a[2][0] * s3 - a[2][1] * s1 + a[2][2] * s0) * invDet;
+}
+
+/// <summary>
+/// 3x3の逆行列を余因子で求める
+/// </summary>
+void Inverse3x3(const Matrix4x4& m, float (&out)[3][3]) {
+    const float c00 = m.m[1][1] * m.m[2][2] - m.m[1][2] * m.m[2][1];
+    const float c01 = m.m[1][2] * m.m[2][0] - m.m[1][0] * m.m[2][2];
+    const float c02 = m.m[1][0] * m.m[2][1] - m.m[1][1] * m.m[2][0];
+    const float invDet = 1.0f / (m.m[0][0] * c00 + m.m[0][1] * c01 + m.m[0][2] * c02);
+
+    out[0][0] = c00 * invDet;
+    out[0][1] = (m.m[0][2] * m.m[2][1] - m.m[0][1] * m.m[2][2]) * invDet;
+    out[0][2] = (m.m[0][1] * m.m[1][2] - m.m[0][2] * m.m[1][1]) * invDet;
+    out[1][0] = c01 * invDet;
+    out[1][1] = (m.m[0][0] * m.m[2][2] - m.m[0][2] * m.m[2][0]) * invDet;
+    out[1][2] = (m.m[0][2] * m.m[1][0] - m.m[0][0] * m.m[1][2]) * invDet;
+    out[2][0] = c02 * invDet;
+    out[2][1] = (m.m[0][1] * m.m[2][0] - m.m[0][0] * m.m[2][1]) * invDet;
+    out[2][2] = (m.m[0][0] * m.m[1][1] - m.m[0][1] * m.m[1][0]) * invDet;
+}
+
+/// <summary>
+/// 3x3部分と平行移動から逆行列を組み立てる(行ベクトルなので -t * A^-1 が平行移動になる)
+/// </summary>
+Matrix4x4 ComposeInverse(const float (&inv)[3][3], const Matrix4x4& m) {
+    Matrix4x4 result;
+    for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < 3; ++col) {
+            result.m[row][col] = inv[row][col];
+        }
+        result.m[row][3] = 0.0f;
+    }
+    for (int col = 0; col < 3; ++col) {
+        result.m[3][col] = -(m.m[3][0] * inv[0][col] + m.m[3][1] * inv[1][col] + m.m[3][2] * inv[2][col]);
+    }
+    result.m[3][3] = 1.0f;
+    return result;
+}
+
+}
+
+/// <summary>
+/// アフィン変換行列の逆行列
+/// </summary>
+/// <param name="m"></param>
+/// <returns></returns>
+Matrix4x4 InverseAffine(const Matrix4x4& m) {
+    float inv[3][3];
+    Inverse3x3(m, inv);
+    return ComposeInverse(inv, m);
+}
+
+/// <summary>
+/// 回転と平行移動だけの行列の逆行列
+/// </summary>
+/// <param name="m"></param>
+/// <returns></returns>
+Matrix4x4 InverseRigid(const Matrix4x4& m) {
+    // 回転行列の逆行列は転置
+    float inv[3][3];
+    for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < 3; ++col) {
+            inv[row][col] = m.m[col][row];
+        }
+    }
+    return ComposeInverse(inv, m);
+}
+
+/// <summary>
+/// 余因子展開による逆行列
+/// </summary>
+/// <param name="m"></param>
+/// <returns></returns>
+Matrix4x4 InverseCofactor(const Matrix4x4& m) {
+    Matrix4x4 result;
+    CofactorInverse(m.m, result.m);
+    return result;
+}
+
+/// <summary>
+/// 逆行列をまとめて求める
+/// </summary>
+/// <param name="src"></param>
+/// <param name="dst"></param>
+/// <param name="count"></param>
+void InverseN(const Matrix4x4* src, Matrix4x4* dst, size_t count) {
+    size_t index = 0;
+
+#if defined(MYMATH_USE_SSE)
+    // 4つの行列を転置して「同じ要素を4つ並べたレーン」に並べ替えてから計算する
+    for (; index + 4 <= count; index += 4) {
+        Lane4 a[4][4];
+        for (int row = 0; row < 4; ++row) {
+            __m128 r0 = _mm_loadu_ps(src[index + 0].m[row]);
+            __m128 r1 = _mm_loadu_ps(src[index + 1].m[row]);
+            __m128 r2 = _mm_loadu_ps(src[index + 2].m[row]);
+            __m128 r3 = _mm_loadu_ps(src[index + 3].m[row]);
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            a[row][0].v = r0;
+            a[row][1].v = r1;
+            a[row][2].v = r2;
+            a[row][3].v = r3;
+        }
+
+        Lane4 b[4][4];
+        CofactorInverse(a, b);
+
+        // 元の並びに戻して書き込む
+        for (int row = 0; row < 4; ++row) {
+            __m128 r0 = b[row][0].v;
+            __m128 r1 = b[row][1].v;
+            __m128 r2 = b[row][2].v;
+            __m128 r3 = b[row][3].v;
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            _mm_storeu_ps(dst[index + 0].m[row], r0);
+            _mm_storeu_ps(dst[index + 1].m[row], r1);
+            _mm_storeu_ps(dst[index + 2].m[row], r2);
+            _mm_storeu_ps(dst[index + 3].m[row], r3);
+        }
+    }
+#endif
+
+    // 残り
+    for (; index < count; ++index) {
+        dst[index] = InverseCofactor(src[index]);
+    }
 }
 
 void swapRows(Matrix4x4& matrix, int row1, int row2) {
@@ -137,12 +449,25 @@ void addScaledRow(Matrix4x4& matrix, int targetRow, int sourceRow, float scalar)
 Matrix4x4 Transpose(const Matrix4x4& matrix) {
     Matrix4x4 result;
 
+#if defined(MYMATH_USE_SSE)
+    __m128 row0 = _mm_loadu_ps(matrix.m[0]);
+    __m128 row1 = _mm_loadu_ps(matrix.m[1]);
+    __m128 row2 = _mm_loadu_ps(matrix.m[2]);
+    __m128 row3 = _mm_loadu_ps(matrix.m[3]);
+    // 行と列を入れ替える
+    _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+    _mm_storeu_ps(result.m[0], row0);
+    _mm_storeu_ps(result.m[1], row1);
+    _mm_storeu_ps(result.m[2], row2);
+    _mm_storeu_ps(result.m[3], row3);
+#else
     for (int i = 0; i < 4; ++i) {
         for (int j = 0; j < 4; ++j) {
             // 行と列を入れ替える
             result.m[i][j] = matrix.m[j][i];
         }
     }
+#endif
 
     return result;
 }
@@ -291,6 +616,29 @@ Matrix4x4 MakeAffineMatrix(const kTransform& transform) {
     return affineMatrix;
 }
 
+/// <summary>
+/// 3次元アフィン変換(Quaternion)
+/// </summary>
+/// <param name="scale"></param>
+/// <param name="rotate"></param>
+/// <param name="translate"></param>
+/// <returns></returns>
+Matrix4x4 MakeAffineMatrixQuat(const Vector3& scale, const Quaternion& rotate, const Vector3& translate) {
+    // S * R * T は回転行列の各行を拡縮して、4行目に平行移動を入れたものになる
+    Matrix4x4 result = MakeRotateMatrix(rotate);
+    const float scales[3] = { scale.x, scale.y, scale.z };
+    for (int row = 0; row < 3; ++row) {
+        result.m[row][0] *= scales[row];
+        result.m[row][1] *= scales[row];
+        result.m[row][2] *= scales[row];
+    }
+    result.m[3][0] = translate.x;
+    result.m[3][1] = translate.y;
+    result.m[3][2] = translate.z;
+
+    return result;
+}
+
 /// <summary>
 /// 座標変換
 /// </summary>
@@ -299,6 +647,21 @@ Matrix4x4 MakeAffineMatrix(const kTransform& transform) {
 /// <returns></returns>
 Vector3 Transform(const Vector3& vector, const Matrix4x4& matrix) {
     Vector3 result;
+#if defined(MYMATH_USE_SSE)
+    // x*row0 + y*row1 + z*row2 + 1*row3 をスカラー版と同じ順番で計算する
+    __m128 r = _mm_mul_ps(_mm_set1_ps(vector.x), _mm_loadu_ps(matrix.m[0]));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(vector.y), _mm_loadu_ps(matrix.m[1])));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(vector.z), _mm_loadu_ps(matrix.m[2])));
+    r = _mm_add_ps(r, _mm_loadu_ps(matrix.m[3]));
+
+    alignas(16) float v[4];
+    _mm_store_ps(v, r);
+    assert(v[3] != 0.0f);
+    _mm_store_ps(v, _mm_div_ps(r, _mm_set1_ps(v[3])));
+    result.x = v[0];
+    result.y = v[1];
+    result.z = v[2];
+#else
     result.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + 1.0f * matrix.m[3][0];
     result.y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + 1.0f * matrix.m[3][1];
     result.z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + 1.0f * matrix.m[3][2];
@@ -308,6 +671,7 @@ Vector3 Transform(const Vector3& vector, const Matrix4x4& matrix) {
     result.x /= w;
     result.y /= w;
     result.z /= w;
+#endif
 
     return result;
 }
@@ -1,8 +1,10 @@
 #pragma once
 #include <Matrix4x4.h>
 #include <Vector3.h>
+#include <Quaternion.h>
 #include <assert.h>
 #include <cmath>
+#include <cstddef>
 
 #include "Transform.h"
 
@@ -37,6 +39,37 @@ Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2);
 /// <returns></returns>
 Matrix4x4 Inverse(Matrix4x4 matrix);
 
+/// <summary>
+/// アフィン変換行列の逆行列(左上3x3を逆行列にし、平行移動を打ち消す)
+/// 4列目が(0,0,0,1)の行列専用
+/// </summary>
+/// <param name="m"></param>
+/// <returns></returns>
+Matrix4x4 InverseAffine(const Matrix4x4& m);
+
+/// <summary>
+/// 回転と平行移動だけの行列の逆行列(回転を転置し、平行移動を打ち消す)
+/// 拡縮が1の行列専用
+/// </summary>
+/// <param name="m"></param>
+/// <returns></returns>
+Matrix4x4 InverseRigid(const Matrix4x4& m);
+
+/// <summary>
+/// 余因子展開による逆行列。分岐が無いので行列式が0の場合はinf/nanになる
+/// </summary>
+/// <param name="m"></param>
+/// <returns></returns>
+Matrix4x4 InverseCofactor(const Matrix4x4& m);
+
+/// <summary>
+/// 逆行列をまとめて求める(余因子展開。SIMDが使える場合は4つずつ計算する)
+/// </summary>
+/// <param name="src">元の行列の配列</param>
+/// <param name="dst">逆行列の書き込み先(srcと同じでも良い)</param>
+/// <param name="count">行列の数</param>
+void InverseN(const Matrix4x4* src, Matrix4x4* dst, size_t count);
+
 void swapRows(Matrix4x4& matrix, int row1, int row2);
 void scaleRow(Matrix4x4& matrix, int row, float scalar);
 void addScaledRow(Matrix4x4& matrix, int targetRow, int sourceRow, float scalar);
@@ -90,6 +123,15 @@ Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Ve
 
 Matrix4x4 MakeAffineMatrix(const kTransform& transform);
 
+/// <summary>
+/// 三次元アフィン変換行列(回転をQuaternionで指定する。行列の積を使わずに直接組み立てる)
+/// </summary>
+/// <param name="scale"></param>
+/// <param name="rotate">正規化されたQuaternion</param>
+/// <param name="translate"></param>
+/// <returns></returns>
+Matrix4x4 MakeAffineMatrixQuat(const Vector3& scale, const Quaternion& rotate, const Vector3& translate);
+
 /// <summary>
 /// 座標変換
 /// </summary>
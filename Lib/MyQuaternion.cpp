@@ -0,0 +1,311 @@
+#include "MyQuaternion.h"
+#include "MathSimd.h"
+
+namespace {
+
+/// <summary>
+/// 補間係数tをSlerpに近づけるように補正する(Nlerpの角速度のずれを多項式で打ち消す)
+/// 係数は回転角の誤差の最大値が小さくなるように当てはめたもの
+/// </summary>
+/// <param name="t"></param>
+/// <param name="absDot">|dot(q0, q1)|</param>
+/// <returns></returns>
+template<typename T>
+T CorrectSlerpFactor(T t, T absDot, T half, T one) {
+	const T a = T{ 1.05182f } + absDot * (T{ -3.03223f } + absDot * (T{ 4.07432f } - absDot * T{ 2.49011f }));
+	const T b = T{ 0.851077f } + absDot * (T{ -1.11215f } + absDot * T{ 0.293567f });
+	const T k = a * (t - half) * (t - half) + b;
+	return t + t * (t - half) * (t - one) * k;
+}
+
+#if defined(MYMATH_USE_SSE)
+// Lane4をfloatと同じように定数で初期化するための特殊化
+template<>
+Lane4 CorrectSlerpFactor<Lane4>(Lane4 t, Lane4 absDot, Lane4 half, Lane4 one) {
+	auto C = [](float value) { return Lane4{ _mm_set1_ps(value) }; };
+	const Lane4 a = C(1.05182f) + absDot * (C(-3.03223f) + absDot * (C(4.07432f) - absDot * C(2.49011f)));
+	const Lane4 b = C(0.851077f) + absDot * (C(-1.11215f) + absDot * C(0.293567f));
+	const Lane4 k = a * (t - half) * (t - half) + b;
+	return t + t * (t - half) * (t - one) * k;
+}
+#endif
+
+Quaternion ApproximateSlerp(const Quaternion& q0, const Quaternion& q1, float t) {
+	const float dot = Dot(q0, q1);
+	const float factor = CorrectSlerpFactor(t, std::fabs(dot), 0.5f, 1.0f);
+	// 最短経路で補間するため、内積が負なら片方を反転させる
+	const float t1 = dot < 0.0f ? -factor : factor;
+	const float t0 = 1.0f - factor;
+	return Normalize({ q0.x * t0 + q1.x * t1, q0.y * t0 + q1.y * t1, q0.z * t0 + q1.z * t1, q0.w * t0 + q1.w * t1 });
+}
+
+}
+
+/// <summary>
+/// 単位Quaternion
+/// </summary>
+/// <returns></returns>
+Quaternion IdentityQuaternion() {
+	return { 0.0f, 0.0f, 0.0f, 1.0f };
+}
+
+/// <summary>
+/// 積
+/// </summary>
+/// <param name="lhs"></param>
+/// <param name="rhs"></param>
+/// <returns></returns>
+Quaternion Multiply(const Quaternion& lhs, const Quaternion& rhs) {
+	Quaternion result;
+	result.x = lhs.w * rhs.x + lhs.x * rhs.w + lhs.y * rhs.z - lhs.z * rhs.y;
+	result.y = lhs.w * rhs.y - lhs.x * rhs.z + lhs.y * rhs.w + lhs.z * rhs.x;
+	result.z = lhs.w * rhs.z + lhs.x * rhs.y - lhs.y * rhs.x + lhs.z * rhs.w;
+	result.w = lhs.w * rhs.w - lhs.x * rhs.x - lhs.y * rhs.y - lhs.z * rhs.z;
+	return result;
+}
+
+/// <summary>
+/// 共役
+/// </summary>
+/// <param name="q"></param>
+/// <returns></returns>
+Quaternion Conjugate(const Quaternion& q) {
+	return { -q.x, -q.y, -q.z, q.w };
+}
+
+/// <summary>
+/// 内積
+/// </summary>
+/// <param name="q0"></param>
+/// <param name="q1"></param>
+/// <returns></returns>
+float Dot(const Quaternion& q0, const Quaternion& q1) {
+	return q0.x * q1.x + q0.y * q1.y + q0.z * q1.z + q0.w * q1.w;
+}
+
+/// <summary>
+/// ノルム
+/// </summary>
+/// <param name="q"></param>
+/// <returns></returns>
+float Norm(const Quaternion& q) {
+	return std::sqrt(Dot(q, q));
+}
+
+/// <summary>
+/// 正規化
+/// </summary>
+/// <param name="q"></param>
+/// <returns></returns>
+Quaternion Normalize(const Quaternion& q) {
+	float norm = Norm(q);
+	if (norm == 0.0f) {
+		return q;
+	}
+	float invNorm = 1.0f / norm;
+	return { q.x * invNorm, q.y * invNorm, q.z * invNorm, q.w * invNorm };
+}
+
+/// <summary>
+/// 逆Quaternion
+/// </summary>
+/// <param name="q"></param>
+/// <returns></returns>
+Quaternion Inverse(const Quaternion& q) {
+	float invNormSq = 1.0f / Dot(q, q);
+	Quaternion conjugate = Conjugate(q);
+	return { conjugate.x * invNormSq, conjugate.y * invNormSq, conjugate.z * invNormSq, conjugate.w * invNormSq };
+}
+
+/// <summary>
+/// 任意軸回転のQuaternion
+/// </summary>
+/// <param name="axis"></param>
+/// <param name="angle"></param>
+/// <returns></returns>
+Quaternion MakeRotateAxisAngleQuaternion(const Vector3& axis, float angle) {
+	float s = std::sin(angle * 0.5f);
+	return { axis.x * s, axis.y * s, axis.z * s, std::cos(angle * 0.5f) };
+}
+
+/// <summary>
+/// オイラー角からQuaternionを作る
+/// </summary>
+/// <param name="radian"></param>
+/// <returns></returns>
+Quaternion MakeRotateQuaternion(const Vector3& radian) {
+	// X → Y → Z の順に回すので Z * Y * X
+	Quaternion qx = MakeRotateAxisAngleQuaternion({ 1.0f, 0.0f, 0.0f }, radian.x);
+	Quaternion qy = MakeRotateAxisAngleQuaternion({ 0.0f, 1.0f, 0.0f }, radian.y);
+	Quaternion qz = MakeRotateAxisAngleQuaternion({ 0.0f, 0.0f, 1.0f }, radian.z);
+	return Multiply(qz, Multiply(qy, qx));
+}
+
+/// <summary>
+/// ベクトルを回転させる
+/// </summary>
+/// <param name="vector"></param>
+/// <param name="q"></param>
+/// <returns></returns>
+Vector3 RotateVector(const Vector3& vector, const Quaternion& q) {
+	// q * v * q^-1 を展開した式 (t = 2 * cross(q.xyz, v), v' = v + w * t + cross(q.xyz, t))
+	Vector3 t = {
+		2.0f * (q.y * vector.z - q.z * vector.y),
+		2.0f * (q.z * vector.x - q.x * vector.z),
+		2.0f * (q.x * vector.y - q.y * vector.x)
+	};
+	return {
+		vector.x + q.w * t.x + (q.y * t.z - q.z * t.y),
+		vector.y + q.w * t.y + (q.z * t.x - q.x * t.z),
+		vector.z + q.w * t.z + (q.x * t.y - q.y * t.x)
+	};
+}
+
+/// <summary>
+/// 回転行列に変換する
+/// </summary>
+/// <param name="q"></param>
+/// <returns></returns>
+Matrix4x4 MakeRotateMatrix(const Quaternion& q) {
+	const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+	const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+	const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+	// 行ベクトルに掛ける形なので、列ベクトル用の式を転置したもの
+	Matrix4x4 result;
+	result.m[0][0] = 1.0f - 2.0f * (yy + zz);
+	result.m[0][1] = 2.0f * (xy + wz);
+	result.m[0][2] = 2.0f * (xz - wy);
+	result.m[0][3] = 0.0f;
+
+	result.m[1][0] = 2.0f * (xy - wz);
+	result.m[1][1] = 1.0f - 2.0f * (xx + zz);
+	result.m[1][2] = 2.0f * (yz + wx);
+	result.m[1][3] = 0.0f;
+
+	result.m[2][0] = 2.0f * (xz + wy);
+	result.m[2][1] = 2.0f * (yz - wx);
+	result.m[2][2] = 1.0f - 2.0f * (xx + yy);
+	result.m[2][3] = 0.0f;
+
+	result.m[3][0] = 0.0f;
+	result.m[3][1] = 0.0f;
+	result.m[3][2] = 0.0f;
+	result.m[3][3] = 1.0f;
+
+	return result;
+}
+
+/// <summary>
+/// 線形補間して正規化する
+/// </summary>
+/// <param name="q0"></param>
+/// <param name="q1"></param>
+/// <param name="t"></param>
+/// <returns></returns>
+Quaternion Nlerp(const Quaternion& q0, const Quaternion& q1, float t) {
+	// 最短経路で補間するため、内積が負なら片方を反転させる
+	float t1 = Dot(q0, q1) < 0.0f ? -t : t;
+	float t0 = 1.0f - t;
+	return Normalize({ q0.x * t0 + q1.x * t1, q0.y * t0 + q1.y * t1, q0.z * t0 + q1.z * t1, q0.w * t0 + q1.w * t1 });
+}
+
+/// <summary>
+/// 球面線形補間
+/// </summary>
+/// <param name="q0"></param>
+/// <param name="q1"></param>
+/// <param name="t"></param>
+/// <returns></returns>
+Quaternion Slerp(const Quaternion& q0, const Quaternion& q1, float t) {
+	float dot = Dot(q0, q1);
+	Quaternion target = q1;
+	// 最短経路で補間するため、内積が負なら片方を反転させる
+	if (dot < 0.0f) {
+		target = { -q1.x, -q1.y, -q1.z, -q1.w };
+		dot = -dot;
+	}
+
+	// ほぼ同じ向きの場合はsinθが0に近く不安定になるのでNlerpにする
+	if (dot >= 1.0f - 0.0005f) {
+		return Nlerp(q0, target, t);
+	}
+
+	float theta = std::acos(dot);
+	float invSin = 1.0f / std::sin(theta);
+	float scale0 = std::sin((1.0f - t) * theta) * invSin;
+	float scale1 = std::sin(t * theta) * invSin;
+
+	return {
+		q0.x * scale0 + target.x * scale1,
+		q0.y * scale0 + target.y * scale1,
+		q0.z * scale0 + target.z * scale1,
+		q0.w * scale0 + target.w * scale1
+	};
+}
+
+/// <summary>
+/// 球面線形補間をまとめて行う
+/// </summary>
+/// <param name="q0"></param>
+/// <param name="q1"></param>
+/// <param name="t"></param>
+/// <param name="out"></param>
+/// <param name="count"></param>
+void SlerpN(const Quaternion* q0, const Quaternion* q1, float t, Quaternion* out, size_t count) {
+	size_t index = 0;
+
+#if defined(MYMATH_USE_SSE)
+	// 4つのQuaternionを転置して x,y,z,w ごとのレーンにしてから計算する
+	const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000)));
+	const Lane4 laneT = { _mm_set1_ps(t) };
+	const Lane4 half = { _mm_set1_ps(0.5f) };
+	const Lane4 one = { _mm_set1_ps(1.0f) };
+
+	for (; index + 4 <= count; index += 4) {
+		__m128 ax = _mm_loadu_ps(&q0[index + 0].x);
+		__m128 ay = _mm_loadu_ps(&q0[index + 1].x);
+		__m128 az = _mm_loadu_ps(&q0[index + 2].x);
+		__m128 aw = _mm_loadu_ps(&q0[index + 3].x);
+		_MM_TRANSPOSE4_PS(ax, ay, az, aw);
+		__m128 bx = _mm_loadu_ps(&q1[index + 0].x);
+		__m128 by = _mm_loadu_ps(&q1[index + 1].x);
+		__m128 bz = _mm_loadu_ps(&q1[index + 2].x);
+		__m128 bw = _mm_loadu_ps(&q1[index + 3].x);
+		_MM_TRANSPOSE4_PS(bx, by, bz, bw);
+
+		__m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+		const __m128 dotSign = _mm_and_ps(dot, signMask);
+		const Lane4 absDot = { _mm_andnot_ps(signMask, dot) };
+
+		const Lane4 factor = CorrectSlerpFactor(laneT, absDot, half, one);
+		// 内積が負なら補間先を反転させる
+		const __m128 t1 = _mm_xor_ps(factor.v, dotSign);
+		const __m128 t0 = _mm_sub_ps(one.v, factor.v);
+
+		__m128 rx = _mm_add_ps(_mm_mul_ps(ax, t0), _mm_mul_ps(bx, t1));
+		__m128 ry = _mm_add_ps(_mm_mul_ps(ay, t0), _mm_mul_ps(by, t1));
+		__m128 rz = _mm_add_ps(_mm_mul_ps(az, t0), _mm_mul_ps(bz, t1));
+		__m128 rw = _mm_add_ps(_mm_mul_ps(aw, t0), _mm_mul_ps(bw, t1));
+
+		// 正規化
+		const __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)), _mm_add_ps(_mm_mul_ps(rz, rz), _mm_mul_ps(rw, rw)));
+		const __m128 invLength = _mm_div_ps(one.v, _mm_sqrt_ps(lengthSq));
+		rx = _mm_mul_ps(rx, invLength);
+		ry = _mm_mul_ps(ry, invLength);
+		rz = _mm_mul_ps(rz, invLength);
+		rw = _mm_mul_ps(rw, invLength);
+
+		_MM_TRANSPOSE4_PS(rx, ry, rz, rw);
+		_mm_storeu_ps(&out[index + 0].x, rx);
+		_mm_storeu_ps(&out[index + 1].x, ry);
+		_mm_storeu_ps(&out[index + 2].x, rz);
+		_mm_storeu_ps(&out[index + 3].x, rw);
+	}
+#endif
+
+	// 残り
+	for (; index < count; ++index) {
+		out[index] = ApproximateSlerp(q0[index], q1[index], t);
+	}
+}
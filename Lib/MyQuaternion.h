@@ -0,0 +1,116 @@
+#pragma once
+#include <Quaternion.h>
+#include <Matrix4x4.h>
+#include <Vector3.h>
+#include <cmath>
+#include <cstddef>
+
+/// <summary>
+/// 単位Quaternion
+/// </summary>
+/// <returns></returns>
+Quaternion IdentityQuaternion();
+
+/// <summary>
+/// 積(rhsの回転の後にlhsの回転をかける)
+/// </summary>
+/// <param name="lhs"></param>
+/// <param name="rhs"></param>
+/// <returns></returns>
+Quaternion Multiply(const Quaternion& lhs, const Quaternion& rhs);
+
+/// <summary>
+/// 共役
+/// </summary>
+/// <param name="q"></param>
+/// <returns></returns>
+Quaternion Conjugate(const Quaternion& q);
+
+/// <summary>
+/// 内積
+/// </summary>
+/// <param name="q0"></param>
+/// <param name="q1"></param>
+/// <returns></returns>
+float Dot(const Quaternion& q0, const Quaternion& q1);
+
+/// <summary>
+/// ノルム
+/// </summary>
+/// <param name="q"></param>
+/// <returns></returns>
+float Norm(const Quaternion& q);
+
+/// <summary>
+/// 正規化
+/// </summary>
+/// <param name="q"></param>
+/// <returns></returns>
+Quaternion Normalize(const Quaternion& q);
+
+/// <summary>
+/// 逆Quaternion
+/// </summary>
+/// <param name="q"></param>
+/// <returns></returns>
+Quaternion Inverse(const Quaternion& q);
+
+/// <summary>
+/// 任意軸回転のQuaternion
+/// </summary>
+/// <param name="axis">正規化された軸</param>
+/// <param name="angle">ラジアン</param>
+/// <returns></returns>
+Quaternion MakeRotateAxisAngleQuaternion(const Vector3& axis, float angle);
+
+/// <summary>
+/// オイラー角からQuaternionを作る(MakeRotateXYZMatrixと同じ回転になる)
+/// </summary>
+/// <param name="radian"></param>
+/// <returns></returns>
+Quaternion MakeRotateQuaternion(const Vector3& radian);
+
+/// <summary>
+/// ベクトルを回転させる
+/// </summary>
+/// <param name="vector"></param>
+/// <param name="q"></param>
+/// <returns></returns>
+Vector3 RotateVector(const Vector3& vector, const Quaternion& q);
+
+/// <summary>
+/// 回転行列に変換する
+/// </summary>
+/// <param name="q">正規化されたQuaternion</param>
+/// <returns></returns>
+Matrix4x4 MakeRotateMatrix(const Quaternion& q);
+
+/// <summary>
+/// 線形補間して正規化する(速いが角速度は一定にならない)
+/// </summary>
+/// <param name="q0"></param>
+/// <param name="q1"></param>
+/// <param name="t"></param>
+/// <returns></returns>
+Quaternion Nlerp(const Quaternion& q0, const Quaternion& q1, float t);
+
+/// <summary>
+/// 球面線形補間
+/// </summary>
+/// <param name="q0"></param>
+/// <param name="q1"></param>
+/// <param name="t"></param>
+/// <returns></returns>
+Quaternion Slerp(const Quaternion& q0, const Quaternion& q1, float t);
+
+/// <summary>
+/// 球面線形補間をまとめて行う(アニメーションのブレンド用)
+/// tを補正したNlerpでSlerpを近似する。Slerpとの差は回転角で最大5.1e-4ラジアン
+/// (|dot|を0~1、tを0~1で細かく振り、倍精度のSlerpと比べた値。|dot|が0に近いほど大きい)
+/// </summary>
+/// <param name="q0">補間元の配列</param>
+/// <param name="q1">補間先の配列</param>
+/// <param name="t">全要素共通の補間係数</param>
+/// <param name="out">書き込み先(q0,q1と同じでも良い)</param>
+/// <param name="count">要素数</param>
+void SlerpN(const Quaternion* q0, const Quaternion* q1, float t, Quaternion* out, size_t count);
@@ -0,0 +1,8 @@
+#pragma once
+
+struct Quaternion final {
+	float x;
+	float y;
+	float z;
+	float w;
+};
@@ -0,0 +1,195 @@
+#include "TransformBatch.h"
+#include "MathSimd.h"
+
+#include <cassert>
+
+namespace {
+
+/// <summary>
+/// S * Rx * Ry * Rz * T を展開してWorld行列の左3列を作る(4列目は(0,0,0,1)で固定)
+/// </summary>
+template<typename T>
+void ComposeWorld(const T (&scale)[3], const T (&rotate)[3], const T (&translate)[3], T (&world)[4][3]) {
+	T sinX, cosX, sinY, cosY, sinZ, cosZ;
+	SinCos(rotate[0], &sinX, &cosX);
+	SinCos(rotate[1], &sinY, &cosY);
+	SinCos(rotate[2], &sinZ, &cosZ);
+
+	// MakeRotateXYZMatrixと同じ回転
+	const T sinXsinY = sinX * sinY;
+	const T cosXsinY = cosX * sinY;
+
+	world[0][0] = scale[0] * (cosY * cosZ);
+	world[0][1] = scale[0] * (cosY * sinZ);
+	world[0][2] = scale[0] * (-sinY);
+
+	world[1][0] = scale[1] * (sinXsinY * cosZ - cosX * sinZ);
+	world[1][1] = scale[1] * (sinXsinY * sinZ + cosX * cosZ);
+	world[1][2] = scale[1] * (sinX * cosY);
+
+	world[2][0] = scale[2] * (cosXsinY * cosZ + sinX * sinZ);
+	world[2][1] = scale[2] * (cosXsinY * sinZ - sinX * cosZ);
+	world[2][2] = scale[2] * (cosX * cosY);
+
+	world[3][0] = translate[0];
+	world[3][1] = translate[1];
+	world[3][2] = translate[2];
+}
+
+/// <summary>
+/// World * VP (Worldの4列目が(0,0,0,1)である前提で掛け算を減らしている)
+/// </summary>
+template<typename T>
+void MultiplyVP(const T (&world)[4][3], const T (&vp)[4][4], T (&wvp)[4][4]) {
+	for (int row = 0; row < 3; ++row) {
+		for (int col = 0; col < 4; ++col) {
+			wvp[row][col] = world[row][0] * vp[0][col] + world[row][1] * vp[1][col] + world[row][2] * vp[2][col];
+		}
+	}
+	for (int col = 0; col < 4; ++col) {
+		wvp[3][col] = world[3][0] * vp[0][col] + world[3][1] * vp[1][col] + world[3][2] * vp[2][col] + vp[3][col];
+	}
+}
+
+Matrix4x4* At(Matrix4x4* base, size_t index, size_t stride) {
+	return reinterpret_cast<Matrix4x4*>(reinterpret_cast<char*>(base) + index * stride);
+}
+
+}
+
+uint32_t TransformBatch::Add(const kTransform& transform) {
+	scale_.x.push_back(transform.scalel.x);
+	scale_.y.push_back(transform.scalel.y);
+	scale_.z.push_back(transform.scalel.z);
+	rotate_.x.push_back(transform.rotate.x);
+	rotate_.y.push_back(transform.rotate.y);
+	rotate_.z.push_back(transform.rotate.z);
+	translate_.x.push_back(transform.translate.x);
+	translate_.y.push_back(transform.translate.y);
+	translate_.z.push_back(transform.translate.z);
+
+	return static_cast<uint32_t>(GetSize() - 1);
+}
+
+void TransformBatch::Set(uint32_t index, const kTransform& transform) {
+	assert(index < GetSize());
+	scale_.x[index] = transform.scalel.x;
+	scale_.y[index] = transform.scalel.y;
+	scale_.z[index] = transform.scalel.z;
+	rotate_.x[index] = transform.rotate.x;
+	rotate_.y[index] = transform.rotate.y;
+	rotate_.z[index] = transform.rotate.z;
+	translate_.x[index] = transform.translate.x;
+	translate_.y[index] = transform.translate.y;
+	translate_.z[index] = transform.translate.z;
+}
+
+kTransform TransformBatch::Get(uint32_t index) const {
+	assert(index < GetSize());
+	return {
+		{ scale_.x[index], scale_.y[index], scale_.z[index] },
+		{ rotate_.x[index], rotate_.y[index], rotate_.z[index] },
+		{ translate_.x[index], translate_.y[index], translate_.z[index] }
+	};
+}
+
+void TransformBatch::Reserve(size_t capacity) {
+	for (Vector3Array* array : { &scale_, &rotate_, &translate_ }) {
+		array->x.reserve(capacity);
+		array->y.reserve(capacity);
+		array->z.reserve(capacity);
+	}
+}
+
+void TransformBatch::Clear() {
+	for (Vector3Array* array : { &scale_, &rotate_, &translate_ }) {
+		array->x.clear();
+		array->y.clear();
+		array->z.clear();
+	}
+}
+
+//=============================================================================================================================
+//	World行列とWVP行列をまとめて計算する
+//=============================================================================================================================
+void TransformBatch::ComputeWorldMatrices(const Matrix4x4& vpMatrix, Matrix4x4* outWvp, Matrix4x4* outWorld, size_t stride) const {
+	ComputeWorldMatrices(GetSize(), vpMatrix, outWvp, outWorld, stride);
+}
+
+void TransformBatch::ComputeWorldMatrices(size_t count, const Matrix4x4& vpMatrix, Matrix4x4* outWvp, Matrix4x4* outWorld, size_t stride) const {
+	assert(outWvp);
+	assert(stride >= sizeof(Matrix4x4));
+	assert(count <= GetSize());
+	size_t index = 0;
+
+#if defined(MYMATH_USE_SSE)
+	// 4つずつ、1レーン1要素として計算する ----------------------------------------------------
+	Lane4 vp[4][4];
+	for (int row = 0; row < 4; ++row) {
+		for (int col = 0; col < 4; ++col) {
+			vp[row][col].v = _mm_set1_ps(vpMatrix.m[row][col]);
+		}
+	}
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+
+	for (; index + 4 <= count; index += 4) {
+		const Lane4 scale[3] = { { _mm_loadu_ps(&scale_.x[index]) }, { _mm_loadu_ps(&scale_.y[index]) }, { _mm_loadu_ps(&scale_.z[index]) } };
+		const Lane4 rotate[3] = { { _mm_loadu_ps(&rotate_.x[index]) }, { _mm_loadu_ps(&rotate_.y[index]) }, { _mm_loadu_ps(&rotate_.z[index]) } };
+		const Lane4 translate[3] = { { _mm_loadu_ps(&translate_.x[index]) }, { _mm_loadu_ps(&translate_.y[index]) }, { _mm_loadu_ps(&translate_.z[index]) } };
+
+		Lane4 world[4][3];
+		ComposeWorld(scale, rotate, translate, world);
+		Lane4 wvp[4][4];
+		MultiplyVP(world, vp, wvp);
+
+		// レーンの並びから行列の並びに転置して書き込む
+		for (int row = 0; row < 4; ++row) {
+			__m128 c0 = wvp[row][0].v;
+			__m128 c1 = wvp[row][1].v;
+			__m128 c2 = wvp[row][2].v;
+			__m128 c3 = wvp[row][3].v;
+			_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+			_mm_storeu_ps(At(outWvp, index + 0, stride)->m[row], c0);
+			_mm_storeu_ps(At(outWvp, index + 1, stride)->m[row], c1);
+			_mm_storeu_ps(At(outWvp, index + 2, stride)->m[row], c2);
+			_mm_storeu_ps(At(outWvp, index + 3, stride)->m[row], c3);
+		}
+
+		if (outWorld) {
+			for (int row = 0; row < 4; ++row) {
+				__m128 c0 = world[row][0].v;
+				__m128 c1 = world[row][1].v;
+				__m128 c2 = world[row][2].v;
+				__m128 c3 = row == 3 ? one : zero;
+				_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+				_mm_storeu_ps(At(outWorld, index + 0, stride)->m[row], c0);
+				_mm_storeu_ps(At(outWorld, index + 1, stride)->m[row], c1);
+				_mm_storeu_ps(At(outWorld, index + 2, stride)->m[row], c2);
+				_mm_storeu_ps(At(outWorld, index + 3, stride)->m[row], c3);
+			}
+		}
+	}
+#endif
+
+	// 残り(SIMDが使えない場合は全部) ----------------------------------------------------------
+	for (; index < count; ++index) {
+		const float scale[3] = { scale_.x[index], scale_.y[index], scale_.z[index] };
+		const float rotate[3] = { rotate_.x[index], rotate_.y[index], rotate_.z[index] };
+		const float translate[3] = { translate_.x[index], translate_.y[index], translate_.z[index] };
+
+		float world[4][3];
+		ComposeWorld(scale, rotate, translate, world);
+		MultiplyVP(world, vpMatrix.m, At(outWvp, index, stride)->m);
+
+		if (outWorld) {
+			Matrix4x4* out = At(outWorld, index, stride);
+			for (int row = 0; row < 4; ++row) {
+				out->m[row][0] = world[row][0];
+				out->m[row][1] = world[row][1];
+				out->m[row][2] = world[row][2];
+				out->m[row][3] = row == 3 ? 1.0f : 0.0f;
+			}
+		}
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Matrix4x4.h"
+#include "Transform.h"
+
+/// <summary>
+/// Vector3をSoA(要素ごとの配列)で持つ
+/// </summary>
+struct Vector3Array {
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> z;
+};
+
+/// <summary>
+/// 大量のTransformをSoAで持ち、World行列とWVP行列をまとめて作る
+/// </summary>
+class TransformBatch {
+public:
+
+	TransformBatch() = default;
+	~TransformBatch() = default;
+
+	/// <summary>
+	/// 追加する
+	/// </summary>
+	/// <param name="transform"></param>
+	/// <returns>追加した要素の番号</returns>
+	uint32_t Add(const kTransform& transform);
+
+	/// <summary>
+	/// 上書きする
+	/// </summary>
+	/// <param name="index"></param>
+	/// <param name="transform"></param>
+	void Set(uint32_t index, const kTransform& transform);
+
+	/// <summary>
+	/// 取得する
+	/// </summary>
+	/// <param name="index"></param>
+	/// <returns></returns>
+	kTransform Get(uint32_t index) const;
+
+	void Reserve(size_t capacity);
+
+	void Clear();
+
+	/// <summary>
+	/// World行列とWVP行列をまとめて計算する
+	/// MakeAffineMatrixを展開した式で計算するため、結果はMakeAffineMatrix→Multiplyと丸め誤差程度ずれる
+	/// </summary>
+	/// <param name="vpMatrix">ViewProjection行列</param>
+	/// <param name="outWvp">WVP行列の書き込み先(Mapしたバッファを直接渡して良い)</param>
+	/// <param name="outWorld">World行列の書き込み先。不要ならnullptr</param>
+	/// <param name="stride">書き込み先の1要素あたりのバイト数</param>
+	void ComputeWorldMatrices(const Matrix4x4& vpMatrix, Matrix4x4* outWvp, Matrix4x4* outWorld = nullptr, size_t stride = sizeof(Matrix4x4)) const;
+
+	/// <summary>
+	/// 先頭からcount個だけWorld行列とWVP行列を計算する
+	/// </summary>
+	/// <param name="count">GetSize()以下</param>
+	void ComputeWorldMatrices(size_t count, const Matrix4x4& vpMatrix, Matrix4x4* outWvp, Matrix4x4* outWorld = nullptr, size_t stride = sizeof(Matrix4x4)) const;
+
+public: // accessor
+
+	size_t GetSize() const { return scale_.x.size(); }
+
+	/// 配列をまとめて書き換えるときに使う
+	Vector3Array& GetScale() { return scale_; }
+	Vector3Array& GetRotate() { return rotate_; }
+	Vector3Array& GetTranslate() { return translate_; }
+
+	const Vector3Array& GetScale() const { return scale_; }
+	const Vector3Array& GetRotate() const { return rotate_; }
+	const Vector3Array& GetTranslate() const { return translate_; }
+
+private:
+
+	Vector3Array scale_;
+	Vector3Array rotate_;
+	Vector3Array translate_;
+};
@@ -1,4 +1,5 @@
 #include "ImGuiManager.h"
+#include <cstdlib>
 
 #include "Window/WinApp.h"
 
@@ -23,7 +24,14 @@ void ImGuiManager::Init(WinApp* winApp, DirectXCommon* dxCommon){
 	winApp_ = winApp;
 	dxCommon_ = dxCommon;
 
-	srvHeap_ = dxCommon_->GetSRVHeap();
+	// フォントのSRVは他と同じようにアロケータから確保する
+	DescriptorHeap* srvHeap = dxCommon_->GetSRVDescriptorHeap();
+	fontSrvHandle_ = srvHeap->AllocatePersistent();
+	// 起動直後で取れないのはヒープの数の設定が間違っている。ImGuiはフォントなしでは動かないので止める
+	if (!fontSrvHandle_.IsValid()) {
+		OutputDebugStringA("ImGuiManager: no free SRV descriptor for the font\n");
+		std::abort();
+	}
 
 	IMGUI_CHECKVERSION();
 	ImGui::CreateContext();
@@ -33,9 +41,9 @@ void ImGuiManager::Init(WinApp* winApp, DirectXCommon* dxCommon){
 		dxCommon->GetDevice(),
 		dxCommon->GetBufferCount(),
 		DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
-		srvHeap_,
-		srvHeap_->GetCPUDescriptorHandleForHeapStart(),
-		srvHeap_->GetGPUDescriptorHandleForHeapStart()
+		srvHeap->GetHeap(),
+		fontSrvHandle_.cpu,
+		fontSrvHandle_.gpu
 	);
 
 }
@@ -45,7 +53,8 @@ void ImGuiManager::Finalize(){
 	ImGui_ImplWin32_Shutdown();
 	ImGui::DestroyContext();
 
-	srvHeap_->Release();
+	// ヒープ自体はDirectXCommonが解放する
+	dxCommon_->GetSRVDescriptorHeap()->Free(fontSrvHandle_);
 }
 
 void ImGuiManager::Begin(){
@@ -60,4 +69,6 @@ void ImGuiManager::End(){
 
 void ImGuiManager::Draw(){
 	ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), dxCommon_->GetCommandList());
+	// ImGuiはコマンドリストに直接状態を設定するので、覚えている状態は使えなくなる
+	dxCommon_->GetStateFilter()->Invalidate();
 }
@@ -41,7 +41,8 @@ private:
 	WinApp* winApp_;
 	DirectXCommon* dxCommon_;
 
-	ID3D12DescriptorHeap* srvHeap_;
+	// フォント用のSRV
+	DescriptorHandle fontSrvHandle_;
 
 };
 
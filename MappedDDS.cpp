@@ -0,0 +1,121 @@
+#include "MappedDDS.h"
+#include <DDS.h>
+#include <algorithm>
+
+namespace {
+
+/// <summary>
+/// サブリソース(Image)の数
+/// </summary>
+size_t CountImages(const DirectX::TexMetadata& metadata) {
+	if (metadata.dimension != DirectX::TEX_DIMENSION_TEXTURE3D) {
+		return metadata.arraySize * metadata.mipLevels;
+	}
+	// 3Dはミップごとに奥行きの分だけある
+	size_t count = 0;
+	size_t depth = metadata.depth;
+	for (size_t level = 0; level < metadata.mipLevels; ++level) {
+		count += depth;
+		depth = (std::max<size_t>)(depth >> 1, 1);
+	}
+	return count;
+}
+
+}
+
+HRESULT MappedDDS::Open(const std::wstring& filePath) {
+	Close();
+
+	if (!file_.Open(filePath)) {
+		return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+	}
+	const uint8_t* data = file_.GetData();
+	const size_t size = file_.GetSize();
+
+	// ヘッダ --------------------------------------------------------------------------
+	// 展開が必要な形式はここで弾かれる
+	HRESULT hr = DirectX::GetMetadataFromDDSMemory(data, size, DirectX::DDS_FLAGS_NO_LEGACY_EXPANSION, metadata_);
+	if (FAILED(hr)) {
+		Close();
+		return hr;
+	}
+
+	const DirectX::DDS_HEADER* header = reinterpret_cast<const DirectX::DDS_HEADER*>(data + sizeof(uint32_t));
+	const bool hasDX10Header = (header->ddspf.flags & DDS_FOURCC) && header->ddspf.fourCC == MAKEFOURCC('D', 'X', '1', '0');
+	// 古いヘッダのRGBマスク指定の形式は、読み込み時にスウィズルやアルファの補完をすることがあるので、
+	// そのまま参照できると分かっている DX10ヘッダ と FourCC指定 の形式だけにする
+	if (!hasDX10Header && !(header->ddspf.flags & DDS_FOURCC)) {
+		Close();
+		return E_NOTIMPL;
+	}
+	size_t offset = sizeof(uint32_t) + sizeof(DirectX::DDS_HEADER);
+	if (hasDX10Header) {
+		offset += sizeof(DirectX::DDS_HEADER_DXT10);
+	}
+
+	// ファイル内のピクセルデータを指すImageを作る ------------------------------------------
+	// 並びはDirectXTexと同じ(配列要素ごとにミップ、3Dはミップごとに奥行き分)
+	images_.reserve(CountImages(metadata_));
+
+	const size_t pixelStart = offset;
+	auto addImage = [&](size_t width, size_t height) -> bool {
+		size_t rowPitch = 0;
+		size_t slicePitch = 0;
+		if (FAILED(DirectX::ComputePitch(metadata_.format, width, height, rowPitch, slicePitch))) {
+			return false;
+		}
+		// 途中で切れているファイル
+		if (slicePitch > size - offset) {
+			return false;
+		}
+		DirectX::Image& image = images_.emplace_back();
+		image.width = width;
+		image.height = height;
+		image.format = metadata_.format;
+		image.rowPitch = rowPitch;
+		image.slicePitch = slicePitch;
+		// Imageはconstでないポインタを持つが、ここで作ったものは読むだけ
+		image.pixels = const_cast<uint8_t*>(data + offset);
+		offset += slicePitch;
+		return true;
+	};
+
+	bool isValid = true;
+	if (metadata_.dimension == DirectX::TEX_DIMENSION_TEXTURE3D) {
+		size_t width = metadata_.width;
+		size_t height = metadata_.height;
+		size_t depth = metadata_.depth;
+		for (size_t level = 0; level < metadata_.mipLevels && isValid; ++level) {
+			for (size_t slice = 0; slice < depth && isValid; ++slice) {
+				isValid = addImage(width, height);
+			}
+			width = (std::max<size_t>)(width >> 1, 1);
+			height = (std::max<size_t>)(height >> 1, 1);
+			depth = (std::max<size_t>)(depth >> 1, 1);
+		}
+	} else {
+		for (size_t item = 0; item < metadata_.arraySize && isValid; ++item) {
+			size_t width = metadata_.width;
+			size_t height = metadata_.height;
+			for (size_t level = 0; level < metadata_.mipLevels && isValid; ++level) {
+				isValid = addImage(width, height);
+				width = (std::max<size_t>)(width >> 1, 1);
+				height = (std::max<size_t>)(height >> 1, 1);
+			}
+		}
+	}
+	if (!isValid) {
+		Close();
+		return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+	}
+
+	pixelSize_ = offset - pixelStart;
+	return S_OK;
+}
+
+void MappedDDS::Close() {
+	images_.clear();
+	metadata_ = DirectX::TexMetadata{};
+	pixelSize_ = 0;
+	file_.Close();
+}
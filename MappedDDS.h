@@ -0,0 +1,47 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <DirectXTex.h>
+
+#include "Function/MappedFile.h"
+
+/*================================================================================================
+DDSファイルをメモリにマップし、ファイル内のピクセルデータをそのままImageとして参照する
+ScratchImageへのコピーを挟まないので、アップロード用バッファへはマップから直接memcpyできる
+(Imageはこのクラスが開いている間だけ有効)
+==================================================================================================*/
+
+class MappedDDS {
+public:
+
+	MappedDDS() = default;
+	~MappedDDS() = default;
+	MappedDDS(const MappedDDS&) = delete;
+	const MappedDDS& operator=(const MappedDDS&) = delete;
+
+	/// <summary>
+	/// マップしてヘッダを読み、サブリソースごとのImageを作る
+	/// 読み込み時に変換が必要な古い形式(24bpp・パレット等)はE_NOTIMPLを返すので、
+	/// その場合はDecodeTextureで読む
+	/// </summary>
+	/// <param name="filePath"></param>
+	/// <returns></returns>
+	HRESULT Open(const std::wstring& filePath);
+
+	void Close();
+
+public: // accessor
+
+	const DirectX::TexMetadata& GetMetadata() const { return metadata_; }
+	const DirectX::Image* GetImages() const { return images_.data(); }
+	size_t GetImageCount() const { return images_.size(); }
+
+	/// ピクセルデータの合計サイズ(ヘッダを除く)
+	size_t GetPixelSize() const { return pixelSize_; }
+
+private:
+	MappedFile file_;
+	DirectX::TexMetadata metadata_{};
+	std::vector<DirectX::Image> images_;
+	size_t pixelSize_ = 0;
+};
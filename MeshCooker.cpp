@@ -0,0 +1,278 @@
+#include "MeshCooker.h"
+#include "MeshFile.h"
+#include "MeshletBuilder.h"
+#include "MeshSimplifier.h"
+#include "ObjLoader.h"
+#include "Function/Hash.h"
+#include "Function/ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+
+namespace {
+
+/// 焼き方を変えた時に上げる(古いキャッシュを使わないようにする)
+const uint32_t kMeshCookerVersion = 4;
+
+using Clock = std::chrono::steady_clock;
+
+float ElapsedMs(Clock::time_point start) {
+	return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+}
+
+uint64_t MakeCookKey(uint64_t sourceHash, const std::vector<CookSourceFile>& dependencies, const MeshCookSettings& settings) {
+	uint64_t key = HashCombine(sourceHash, kMeshCookerVersion);
+	for (const CookSourceFile& dependency : dependencies) {
+		key = HashCombine(key, dependency.hash);
+	}
+	key = HashCombine(key, kMeshFileVersion);
+	key = HashCombine(key, settings.optimize);
+	key = HashCombine(key, settings.overdrawThreshold);
+	key = HashCombine(key, settings.lodCount);
+	key = HashCombine(key, settings.lodReduction);
+	key = HashCombine(key, settings.lodMaxError);
+	key = HashCombine(key, settings.buildMeshlets);
+	key = HashCombine(key, settings.meshletConeWeight);
+	return key;
+}
+
+/// <summary>
+/// 三角形をマテリアルの範囲ごとに並べ替える
+/// </summary>
+void OptimizeTriangles(ObjModel& model, const MeshCookSettings& settings) {
+	MeshData& mesh = model.mesh;
+	for (const ObjSubmesh& submesh : model.submeshes) {
+		uint32_t* indices = mesh.indices.data() + submesh.firstIndex;
+		OptimizeVertexCache(indices, submesh.indexCount, mesh.vertices.size());
+		if (settings.overdrawThreshold > 0.0f) {
+			OptimizeOverdraw(indices, submesh.indexCount, mesh.vertices.data(), mesh.vertices.size(), settings.overdrawThreshold);
+		}
+	}
+}
+
+/// <summary>
+/// サブメッシュごとの処理を(あれば)ワーカーで回す
+/// </summary>
+template<typename Function>
+void ForEachSubmesh(size_t submeshCount, ThreadPool* threadPool, const Function& function) {
+	if (!threadPool || submeshCount == 1) {
+		for (size_t index = 0; index < submeshCount; ++index) {
+			function(index);
+		}
+		return;
+	}
+	for (size_t index = 0; index < submeshCount; ++index) {
+		threadPool->Submit([&function, index]() { function(index); });
+	}
+	threadPool->WaitIdle();
+}
+
+/// <summary>
+/// 簡略化したサブメッシュ1つ分
+/// </summary>
+struct SimplifiedSubmesh {
+	std::vector<uint32_t> indices;
+	float error = 0.0f;
+};
+
+/// <summary>
+/// 1つ前の段を簡略化してLODを作り、インデックスの後ろに足していく
+/// 減り方が1割に届かない・誤差を使い切った所で止める
+/// 段の中のサブメッシュは互いに関係ないので、threadPoolがあれば1つずつワーカーで簡略化する
+/// </summary>
+std::vector<MeshFileLodSource> GenerateLods(ObjModel& model, const MeshCookSettings& settings, ThreadPool* threadPool) {
+	MeshData& mesh = model.mesh;
+	std::vector<MeshFileLodSource> lods;
+	lods.push_back({ 0.0f, model.submeshes, {} });
+
+	const MeshBounds bounds = ComputeMeshBounds(mesh.vertices.data(), mesh.vertices.size());
+	const float maxError = settings.lodMaxError * bounds.sphereRadius;
+	std::vector<SimplifiedSubmesh> simplified;
+	for (uint32_t level = 1; level < settings.lodCount; ++level) {
+		const MeshFileLodSource& previous = lods.back();
+		const float errorBudget = maxError - previous.error;
+		if (errorBudget <= 0.0f) {
+			break;
+		}
+
+		// ワーカーは前の段のインデックスを読むだけで、mesh.indicesへの追加は全て終わってから行う
+		simplified.resize(previous.submeshes.size());
+		ForEachSubmesh(previous.submeshes.size(), threadPool, [&](size_t index) {
+			const ObjSubmesh& submesh = previous.submeshes[index];
+			SimplifiedSubmesh& result = simplified[index];
+			const size_t targetIndexCount = static_cast<size_t>(submesh.indexCount * settings.lodReduction) / 3 * 3;
+			result.indices.resize(submesh.indexCount);
+			result.error = 0.0f;
+			const size_t indexCount = SimplifyMesh(result.indices.data(), mesh.indices.data() + submesh.firstIndex, submesh.indexCount,
+				mesh.vertices.data(), mesh.vertices.size(), targetIndexCount, errorBudget, &result.error);
+			result.indices.resize(indexCount);
+			if (settings.optimize != 0 && indexCount != 0) {
+				OptimizeVertexCache(result.indices.data(), indexCount, mesh.vertices.size());
+			}
+		});
+
+		const size_t levelStart = mesh.indices.size();
+		size_t previousIndexCount = 0;
+		float levelError = 0.0f;
+		MeshFileLodSource lod;
+		for (size_t index = 0; index < previous.submeshes.size(); ++index) {
+			const ObjSubmesh& submesh = previous.submeshes[index];
+			const SimplifiedSubmesh& result = simplified[index];
+			previousIndexCount += submesh.indexCount;
+			if (result.indices.empty()) {
+				continue;
+			}
+			levelError = (std::max)(levelError, result.error);
+			lod.submeshes.push_back({ submesh.materialIndex, static_cast<uint32_t>(mesh.indices.size()), static_cast<uint32_t>(result.indices.size()) });
+			mesh.indices.insert(mesh.indices.end(), result.indices.begin(), result.indices.end());
+		}
+
+		// ほとんど減らなかった段は捨てる(これ以上は形を崩さずに減らせない)
+		const size_t indexCount = mesh.indices.size() - levelStart;
+		if (indexCount == 0 || indexCount * 10 > previousIndexCount * 9) {
+			mesh.indices.resize(levelStart);
+			break;
+		}
+		lod.error = previous.error + levelError;
+		lods.push_back(std::move(lod));
+	}
+	return lods;
+}
+
+/// <summary>
+/// LOD・サブメッシュの順にメッシュレットを作る(頂点の並べ替えの後に呼ぶ)
+/// </summary>
+MeshletData BuildModelMeshlets(const ObjModel& model, std::vector<MeshFileLodSource>& lods, const MeshCookSettings& settings) {
+	const MeshData& mesh = model.mesh;
+	MeshletData meshlets;
+	for (MeshFileLodSource& lod : lods) {
+		lod.meshletCounts.clear();
+		for (const ObjSubmesh& submesh : lod.submeshes) {
+			const size_t count = BuildMeshlets(meshlets, mesh.indices.data() + submesh.firstIndex, submesh.indexCount,
+				mesh.vertices.data(), mesh.vertices.size(), settings.meshletConeWeight);
+			lod.meshletCounts.push_back(static_cast<uint32_t>(count));
+		}
+	}
+	return meshlets;
+}
+
+}
+
+//=============================================================================================================================
+//	キャッシュ
+//=============================================================================================================================
+std::wstring GetCookedMeshPath(const std::wstring& sourcePath, uint64_t sourceHash, const std::vector<CookSourceFile>& dependencies, const MeshCookSettings& settings, const std::wstring& cacheDirectory) {
+	const std::wstring stem = std::filesystem::path(sourcePath).stem().wstring();
+	const std::filesystem::path cookedPath = std::filesystem::path(cacheDirectory) / (stem + L"_" + HashToHexString(MakeCookKey(sourceHash, dependencies, settings)) + L".mesh");
+	return cookedPath.generic_wstring();
+}
+
+std::wstring FindCookedMesh(const std::wstring& sourcePath, const std::wstring& cacheDirectory) {
+	CookManifest manifest;
+	if (!manifest.Load(GetCookManifestPath(cacheDirectory))) {
+		return std::wstring();
+	}
+	return manifest.Resolve(sourcePath);
+}
+
+//=============================================================================================================================
+//	焼く
+//=============================================================================================================================
+bool CookMesh(const std::wstring& sourcePath, const MeshCookSettings& settings, MeshCookResult& outResult, const std::wstring& cacheDirectory, bool force, ThreadPool* threadPool) {
+	outResult = MeshCookResult{};
+
+	// キャッシュの確認 ------------------------------------------------------------
+	Clock::time_point start = Clock::now();
+	CookManifestEntry& manifestEntry = outResult.manifestEntry;
+	if (!MakeCookSourceFile(sourcePath, manifestEntry.source)) {
+		return false;
+	}
+	// MTLだけ変えた時も焼き直すように依存ファイルにする(ない・読めないMTLはLoadObjも読まないので含めない)
+	std::vector<std::wstring> materialLibraries;
+	FindObjMaterialLibraries(sourcePath, materialLibraries);
+	for (const std::wstring& library : materialLibraries) {
+		CookSourceFile dependency;
+		if (MakeCookSourceFile(library, dependency)) {
+			manifestEntry.dependencies.push_back(std::move(dependency));
+		}
+	}
+	outResult.sourceSize = manifestEntry.source.size;
+	outResult.cookedPath = GetCookedMeshPath(sourcePath, manifestEntry.source.hash, manifestEntry.dependencies, settings, cacheDirectory);
+	manifestEntry.cookedPath = NormalizeCookPath(outResult.cookedPath);
+	outResult.hashTime = ElapsedMs(start);
+
+	std::error_code error;
+	if (!force && std::filesystem::exists(outResult.cookedPath, error)) {
+		outResult.isCached = true;
+		outResult.cookedSize = std::filesystem::file_size(outResult.cookedPath, error);
+		return true;
+	}
+
+	// 読み込み --------------------------------------------------------------------
+	start = Clock::now();
+	ObjModel model;
+	ObjLoadStats loadStats;
+	if (!LoadObj(sourcePath, model, threadPool, &loadStats)) {
+		return false;
+	}
+	outResult.importTime = ElapsedMs(start);
+	outResult.skippedLineCount = loadStats.skippedLineCount;
+	outResult.skippedTriangleCount = loadStats.skippedTriangleCount;
+	outResult.firstSkippedLine = std::move(loadStats.firstSkippedLine);
+	outResult.vertexCount = static_cast<uint32_t>(model.mesh.vertices.size());
+	outResult.triangleCount = static_cast<uint32_t>(model.mesh.indices.size() / 3);
+
+	// 三角形の並べ替え -------------------------------------------------------------
+	// LODは並べ替え済みの0段目から作るので、先に並べ替える
+	const MeshData& mesh = model.mesh;
+	const size_t lod0IndexCount = mesh.indices.size();
+	outResult.cacheBefore = AnalyzeVertexCache(mesh.indices.data(), lod0IndexCount, mesh.vertices.size());
+	outResult.fetchBefore = AnalyzeVertexFetch(mesh.indices.data(), lod0IndexCount, mesh.vertices.size(), sizeof(VertexData));
+	start = Clock::now();
+	if (settings.optimize != 0) {
+		OptimizeTriangles(model, settings);
+	}
+	outResult.optimizeTime = ElapsedMs(start);
+
+	// LOD ------------------------------------------------------------------------
+	start = Clock::now();
+	std::vector<MeshFileLodSource> lods = GenerateLods(model, settings, threadPool);
+	outResult.lodTime = ElapsedMs(start);
+	for (const MeshFileLodSource& lod : lods) {
+		uint32_t indexCount = 0;
+		for (const ObjSubmesh& submesh : lod.submeshes) {
+			indexCount += submesh.indexCount;
+		}
+		outResult.lodTriangleCounts.push_back(indexCount / 3);
+		outResult.lodErrors.push_back(lod.error);
+	}
+
+	// 頂点の並べ替え(全ての段のインデックスを付け直す) --------------------------------
+	start = Clock::now();
+	if (settings.optimize != 0) {
+		OptimizeVertexFetch(model.mesh);
+	}
+	outResult.optimizeTime += ElapsedMs(start);
+	outResult.cacheAfter = AnalyzeVertexCache(mesh.indices.data(), lod0IndexCount, mesh.vertices.size());
+	outResult.fetchAfter = AnalyzeVertexFetch(mesh.indices.data(), lod0IndexCount, mesh.vertices.size(), sizeof(VertexData));
+
+	// メッシュレット -----------------------------------------------------------------
+	start = Clock::now();
+	MeshletData meshlets;
+	if (settings.buildMeshlets != 0) {
+		meshlets = BuildModelMeshlets(model, lods, settings);
+	}
+	outResult.meshletTime = ElapsedMs(start);
+	outResult.meshletCount = static_cast<uint32_t>(meshlets.meshlets.size());
+
+	// 保存 ------------------------------------------------------------------------
+	start = Clock::now();
+	if (!WriteMeshFile(outResult.cookedPath, model, lods, settings.buildMeshlets != 0 ? &meshlets : nullptr)) {
+		return false;
+	}
+	outResult.saveTime = ElapsedMs(start);
+	outResult.cookedSize = std::filesystem::file_size(outResult.cookedPath, error);
+
+	return true;
+}
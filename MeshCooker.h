@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CookManifest.h"
+#include "MeshOptimizer.h"
+
+class ThreadPool;
+
+/*================================================================================================
+OBJを.mesh(MeshFile.h)にしてキャッシュに保存する(オフライン用)
+キャッシュのファイル名はOBJ・MTLの内容と設定のハッシュで決まるので、どれかが変われば自動的に作り直しになる
+(テクスチャはパスを持つだけなので含まない)
+実行時は焼いた時の対応表(CookManifest)から引くので、OBJの中身を読まずに探せる
+焼く時にLODを作り(MeshSimplifier.h)、インデックス・頂点を並べ替え(MeshOptimizer.h)、
+LOD・サブメッシュごとにメッシュレットに分ける(MeshletBuilder.h)
+==================================================================================================*/
+
+/// <summary>
+/// 焼く時の設定(ハッシュに含まれるので、変えたらキャッシュも変わる)
+/// </summary>
+struct MeshCookSettings {
+	uint32_t optimize = 1;				// 頂点キャッシュ・頂点の読み込みの順に並べ替えるか
+	float overdrawThreshold = 1.05f;	// オーバードローを減らす並べ替えで許すACMRの悪化(0なら並べ替えない)
+	uint32_t lodCount = 4;				// 元の形を含むLODの段数の上限(1ならLODを作らない)
+	float lodReduction = 0.5f;			// 1段ごとに三角形をこの割合まで減らす
+	float lodMaxError = 0.02f;			// 許す誤差の合計(バウンディングスフィアの半径との比)
+	uint32_t buildMeshlets = 1;			// メッシュレットを作るか
+	float meshletConeWeight = 0.25f;	// メッシュレットの向きをそろえる強さ(BuildMeshlets)
+};
+
+/// <summary>
+/// 焼いた結果と、各工程にかかった時間(ミリ秒)
+/// </summary>
+struct MeshCookResult {
+	std::wstring cookedPath;
+	bool isCached = false;			// 既にキャッシュがあったので何もしなかった
+	float hashTime = 0.0f;
+	float importTime = 0.0f;		// OBJ・MTLの読み込み
+	float lodTime = 0.0f;
+	float optimizeTime = 0.0f;
+	float meshletTime = 0.0f;
+	float saveTime = 0.0f;
+	uint64_t sourceSize = 0;
+	uint64_t cookedSize = 0;
+	uint32_t vertexCount = 0;
+	uint32_t triangleCount = 0;
+	uint32_t skippedLineCount = 0;			// OBJの読めなかった行(ObjLoadStats)
+	uint32_t skippedTriangleCount = 0;		// 範囲外の番号を使うので捨てた三角形
+	std::string firstSkippedLine;
+	std::vector<uint32_t> lodTriangleCounts;	// 0段目(元の形)から
+	std::vector<float> lodErrors;
+	uint32_t meshletCount = 0;		// 全てのLODの分
+	VertexCacheStats cacheBefore;	// 0段目の並べ替えの前後(並べ替えない時は同じ)
+	VertexCacheStats cacheAfter;
+	VertexFetchStats fetchBefore;
+	VertexFetchStats fetchAfter;
+	CookManifestEntry manifestEntry;	// 成功したら(キャッシュがあった場合も)対応表に載せる内容(MTLは依存ファイル)
+};
+
+/// キャッシュの既定の置き場所
+static const wchar_t* const kMeshCacheDirectory = L"Resource/Cooked";
+
+/// <summary>
+/// 焼いたファイルのパス(<cacheDirectory>/<元のファイル名>_<ハッシュ>.mesh)
+/// </summary>
+/// <param name="sourcePath"></param>
+/// <param name="sourceHash"></param>
+/// <param name="dependencies">OBJが使うMTL(ハッシュに含める)</param>
+/// <param name="settings"></param>
+/// <param name="cacheDirectory"></param>
+/// <returns></returns>
+std::wstring GetCookedMeshPath(const std::wstring& sourcePath, uint64_t sourceHash, const std::vector<CookSourceFile>& dependencies, const MeshCookSettings& settings, const std::wstring& cacheDirectory = kMeshCacheDirectory);
+
+/// <summary>
+/// 対応表から焼いたファイルを探す(なければ空)
+/// OBJ・MTLは大きさと更新日時だけ比べるので、中身は読まない。いくつも探す時はCookManifestを読んで直接引く
+/// </summary>
+std::wstring FindCookedMesh(const std::wstring& sourcePath, const std::wstring& cacheDirectory = kMeshCacheDirectory);
+
+/// <summary>
+/// 焼く。キャッシュがあれば何もしない
+/// </summary>
+/// <param name="sourcePath"></param>
+/// <param name="settings"></param>
+/// <param name="outResult"></param>
+/// <param name="cacheDirectory"></param>
+/// <param name="force">キャッシュがあっても焼き直す</param>
+/// <param name="threadPool">OBJの解析・サブメッシュごとの簡略化を並列にするワーカー(nullptrなら呼んだスレッドだけで焼く)
+/// 中でWaitIdleするので、同じThreadPoolのジョブの中からは渡さないこと</param>
+/// <returns>OBJが読めない・書き込めない場合はfalse</returns>
+bool CookMesh(const std::wstring& sourcePath, const MeshCookSettings& settings, MeshCookResult& outResult, const std::wstring& cacheDirectory = kMeshCacheDirectory, bool force = false, ThreadPool* threadPool = nullptr);
@@ -0,0 +1,147 @@
+#include "MeshData.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+static const uint32_t kEmptySlot = UINT32_MAX;
+
+/// <summary>
+/// 比べる・ハッシュする用に値をそろえる(-0を+0にする)
+/// </summary>
+VertexData Canonicalize(const VertexData& vertex) {
+	VertexData result = vertex;
+	float* values = &result.pos.x;
+	for (size_t index = 0; index < sizeof(VertexData) / sizeof(float); ++index) {
+		if (values[index] == 0.0f) {
+			values[index] = 0.0f;
+		}
+	}
+	return result;
+}
+
+/// <summary>
+/// 頂点のハッシュ(8byteずつ混ぜる。頂点数が多いのでバイト単位のFNVより速いものを使う)
+/// </summary>
+uint64_t HashVertex(const VertexData& vertex) {
+	static_assert(sizeof(VertexData) % sizeof(uint64_t) == 0, "VertexData must be a multiple of 8 bytes");
+	uint64_t words[sizeof(VertexData) / sizeof(uint64_t)];
+	std::memcpy(words, &vertex, sizeof(VertexData));
+	uint64_t hash = 0x9E3779B97F4A7C15ull;
+	for (uint64_t word : words) {
+		hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+		hash ^= hash >> 32;
+	}
+	return hash;
+}
+
+}
+
+//=============================================================================================================================
+//	同じ頂点をまとめる
+//=============================================================================================================================
+void WeldVertices(MeshData& mesh) {
+	const size_t sourceCount = mesh.indices.empty() ? mesh.vertices.size() : mesh.indices.size();
+	if (sourceCount == 0) {
+		return;
+	}
+
+	// ハッシュテーブル(上位32bitにハッシュ、下位32bitに頂点の番号+1。0は空き)
+	// まとめた後の頂点数に合わせて広げるので、重複が多いほど小さく済む
+	std::vector<uint64_t> table(1024, 0);
+	size_t mask = table.size() - 1;
+	auto insert = [&](uint64_t entry) {
+		size_t slot = static_cast<size_t>(entry >> 32) & mask;
+		while (table[slot] != 0) {
+			slot = (slot + 1) & mask;
+		}
+		table[slot] = entry;
+	};
+
+	// 元の頂点の番号 → まとめた後の番号(インデックスがある時だけ使う)
+	std::vector<uint32_t> remap(mesh.indices.empty() ? 0 : mesh.vertices.size(), kEmptySlot);
+	std::vector<VertexData> welded;
+	welded.reserve(mesh.vertices.size());
+
+	auto weld = [&](uint32_t source) {
+		const VertexData vertex = Canonicalize(mesh.vertices[source]);
+		const uint64_t hash = HashVertex(vertex) >> 32;
+		size_t slot = static_cast<size_t>(hash) & mask;
+		// 線形探査で同じ頂点か空きを探す(ハッシュが違えば頂点は比べない)
+		while (table[slot] != 0) {
+			const uint32_t candidate = static_cast<uint32_t>(table[slot]) - 1;
+			if ((table[slot] >> 32) == hash && std::memcmp(&welded[candidate], &vertex, sizeof(VertexData)) == 0) {
+				return candidate;
+			}
+			slot = (slot + 1) & mask;
+		}
+		const uint32_t result = static_cast<uint32_t>(welded.size());
+		welded.push_back(vertex);
+		table[slot] = (hash << 32) | (result + 1);
+
+		// 半分埋まったら倍にする
+		if (welded.size() * 2 > table.size()) {
+			std::vector<uint64_t> old(table.size() * 2, 0);
+			old.swap(table);
+			mask = table.size() - 1;
+			for (uint64_t entry : old) {
+				if (entry != 0) {
+					insert(entry);
+				}
+			}
+		}
+		return result;
+	};
+
+	std::vector<uint32_t> indices(sourceCount);
+	if (mesh.indices.empty()) {
+		for (size_t index = 0; index < sourceCount; ++index) {
+			indices[index] = weld(static_cast<uint32_t>(index));
+		}
+	} else {
+		for (size_t index = 0; index < sourceCount; ++index) {
+			const uint32_t source = mesh.indices[index];
+			assert(source < mesh.vertices.size());
+			if (remap[source] == kEmptySlot) {
+				remap[source] = weld(source);
+			}
+			indices[index] = remap[source];
+		}
+	}
+
+	welded.shrink_to_fit();
+	mesh.vertices.swap(welded);
+	mesh.indices.swap(indices);
+}
+
+//=============================================================================================================================
+//	範囲
+//=============================================================================================================================
+MeshBounds ComputeMeshBounds(const VertexData* vertices, size_t vertexCount) {
+	MeshBounds bounds{};
+	if (vertexCount == 0) {
+		return bounds;
+	}
+	bounds.min = { vertices[0].pos.x, vertices[0].pos.y, vertices[0].pos.z };
+	bounds.max = bounds.min;
+	for (size_t index = 1; index < vertexCount; ++index) {
+		const Vector4& pos = vertices[index].pos;
+		bounds.min = { (std::min)(bounds.min.x, pos.x), (std::min)(bounds.min.y, pos.y), (std::min)(bounds.min.z, pos.z) };
+		bounds.max = { (std::max)(bounds.max.x, pos.x), (std::max)(bounds.max.y, pos.y), (std::max)(bounds.max.z, pos.z) };
+	}
+	bounds.sphereCenter = { (bounds.min.x + bounds.max.x) * 0.5f, (bounds.min.y + bounds.max.y) * 0.5f, (bounds.min.z + bounds.max.z) * 0.5f };
+	// 箱の中心から一番遠い頂点までの距離
+	float radiusSquared = 0.0f;
+	for (size_t index = 0; index < vertexCount; ++index) {
+		const Vector4& pos = vertices[index].pos;
+		const float x = pos.x - bounds.sphereCenter.x;
+		const float y = pos.y - bounds.sphereCenter.y;
+		const float z = pos.z - bounds.sphereCenter.z;
+		radiusSquared = (std::max)(radiusSquared, x * x + y * y + z * z);
+	}
+	bounds.sphereRadius = std::sqrt(radiusSquared);
+	return bounds;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "VertexData.h"
+#include "Vector3.h"
+
+/*================================================================================================
+CPU上のメッシュ(インデックス付きの三角形リスト)
+D3D12を使わないのでローダーやAssetCookerからも使える。GPUに送るのはMesh(DirectXCommon/Mesh.h)
+==================================================================================================*/
+
+/// <summary>
+/// 頂点とインデックス(3つで1三角形)
+/// </summary>
+struct MeshData {
+	std::vector<VertexData> vertices;
+	std::vector<uint32_t> indices;
+};
+
+/// <summary>
+/// 頂点を囲む箱と球
+/// </summary>
+struct MeshBounds {
+	Vector3 min;
+	Vector3 max;
+	Vector3 sphereCenter;		// 箱の中心
+	float sphereRadius;
+};
+
+/// <summary>
+/// LODの1段(インデックスバッファの範囲。全ての段で頂点バッファを共有する)
+/// </summary>
+struct MeshLod {
+	uint32_t firstIndex;
+	uint32_t indexCount;
+	float error;				// 元の形からのずれの目安(モデルの座標の単位。0段目は0)
+};
+
+/// 16bitのインデックスで表せる頂点数の上限(0xFFFFはストリップの区切りに使われるので含めない)
+static const size_t kMaxIndex16VertexCount = 0xFFFF;
+
+/// <summary>
+/// 同じ頂点(全ての値がビット単位で等しい。-0と+0は同じとみなす)を1つにまとめ、インデックスを付け直す
+/// indicesが空なら頂点を順に並べた三角形リストとして扱う。頂点は最初に出てきた順に残る
+/// </summary>
+/// <param name="mesh"></param>
+void WeldVertices(MeshData& mesh);
+
+/// <summary>
+/// 頂点の位置(pos.xyz)を囲む箱と球を求める(頂点がなければ全て0)
+/// </summary>
+MeshBounds ComputeMeshBounds(const VertexData* vertices, size_t vertexCount);
+
+/// <summary>
+/// 頂点数から決まるインデックス1つのバイト数(2 or 4)
+/// </summary>
+inline uint32_t GetIndexStride(size_t vertexCount) {
+	return vertexCount <= kMaxIndex16VertexCount ? 2 : 4;
+}
+
+/// <summary>
+/// GPUに置いた時のバイト数(頂点 + 頂点数に合わせた幅のインデックス)
+/// </summary>
+inline size_t GetMeshByteSize(const MeshData& mesh) {
+	return mesh.vertices.size() * sizeof(VertexData) + mesh.indices.size() * GetIndexStride(mesh.vertices.size());
+}
@@ -0,0 +1,266 @@
+#include "MeshFile.h"
+#include "ObjLoader.h"
+
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+uint64_t AlignUp(uint64_t value) {
+	return (value + kMeshFileAlignment - 1) & ~(kMeshFileAlignment - 1);
+}
+
+/// <summary>
+/// 区画がファイルに収まっていて、先頭が境界にそろっているか
+/// </summary>
+bool IsValidSection(uint64_t offset, uint64_t count, uint64_t stride, uint64_t fileSize) {
+	if (offset % kMeshFileAlignment != 0 || offset > fileSize) {
+		return false;
+	}
+	return count * stride <= fileSize - offset;
+}
+
+/// <summary>
+/// 文字列区画に足して位置を返す(空文字列は先頭の'\0'を指す)
+/// </summary>
+uint32_t AddString(std::vector<char>& strings, const std::string& str) {
+	if (str.empty()) {
+		return 0;
+	}
+	const uint32_t offset = static_cast<uint32_t>(strings.size());
+	strings.insert(strings.end(), str.begin(), str.end());
+	strings.push_back('\0');
+	return offset;
+}
+
+}
+
+//=============================================================================================================================
+//	書き出し
+//=============================================================================================================================
+bool WriteMeshFile(const std::wstring& filePath, const ObjModel& model, const std::vector<MeshFileLodSource>& lods, const MeshletData* meshlets) {
+	const MeshData& mesh = model.mesh;
+	if (mesh.vertices.empty() || mesh.indices.empty()) {
+		return false;
+	}
+
+	// マテリアルと文字列 ---------------------------------------------------------------
+	std::vector<char> strings(1, '\0');
+	std::vector<MeshFileMaterial> materials(model.materials.size());
+	for (size_t index = 0; index < model.materials.size(); ++index) {
+		materials[index].diffuseColor = model.materials[index].diffuseColor;
+		materials[index].nameOffset = AddString(strings, model.materials[index].name);
+		materials[index].diffuseTextureOffset = AddString(strings, model.materials[index].diffuseTexture);
+	}
+
+	// LODとサブメッシュ(LODがなければ元の形の1段だけ) ------------------------------------------
+	std::vector<MeshFileLodSource> defaultLods;
+	if (lods.empty()) {
+		defaultLods.push_back({ 0.0f, model.submeshes, {} });
+	}
+	const std::vector<MeshFileLodSource>& sourceLods = lods.empty() ? defaultLods : lods;
+	std::vector<MeshFileLod> fileLods(sourceLods.size());
+	std::vector<MeshFileSubmesh> submeshes;
+	uint32_t meshletCount = 0;
+	for (size_t lodIndex = 0; lodIndex < sourceLods.size(); ++lodIndex) {
+		const MeshFileLodSource& source = sourceLods[lodIndex];
+		MeshFileLod& lod = fileLods[lodIndex];
+		lod.firstIndex = source.submeshes.empty() ? 0 : source.submeshes.front().firstIndex;
+		lod.firstSubmesh = static_cast<uint32_t>(submeshes.size());
+		lod.submeshCount = static_cast<uint32_t>(source.submeshes.size());
+		lod.error = source.error;
+		lod.firstMeshlet = meshletCount;
+		if (meshlets && source.meshletCounts.size() != source.submeshes.size()) {
+			return false;
+		}
+		for (size_t submeshIndex = 0; submeshIndex < source.submeshes.size(); ++submeshIndex) {
+			const ObjSubmesh& sourceSubmesh = source.submeshes[submeshIndex];
+			// 1段のサブメッシュはインデックスの上で続いている必要がある
+			if (sourceSubmesh.firstIndex != lod.firstIndex + lod.indexCount) {
+				return false;
+			}
+			MeshFileSubmesh submesh{};
+			submesh.materialIndex = sourceSubmesh.materialIndex;
+			submesh.firstIndex = sourceSubmesh.firstIndex;
+			submesh.indexCount = sourceSubmesh.indexCount;
+			submesh.firstMeshlet = meshletCount;
+			submesh.meshletCount = meshlets ? source.meshletCounts[submeshIndex] : 0;
+			submeshes.push_back(submesh);
+			lod.indexCount += sourceSubmesh.indexCount;
+			lod.meshletCount += submesh.meshletCount;
+			meshletCount += submesh.meshletCount;
+		}
+		if (uint64_t(lod.firstIndex) + lod.indexCount > mesh.indices.size()) {
+			return false;
+		}
+	}
+
+	if (meshlets && (meshlets->meshlets.size() != meshletCount || meshlets->bounds.size() != meshletCount || meshlets->triangles.size() % 3 != 0)) {
+		return false;
+	}
+	static const MeshletData kEmptyMeshlets;
+	const MeshletData& meshletData = meshlets ? *meshlets : kEmptyMeshlets;
+
+	// 配置 -------------------------------------------------------------------------
+	MeshFileHeader header{};
+	header.magic = kMeshFileMagic;
+	header.version = kMeshFileVersion;
+	header.vertexStride = sizeof(VertexData);
+	header.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+	header.indexStride = GetIndexStride(mesh.vertices.size());
+	header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+	header.submeshCount = static_cast<uint32_t>(submeshes.size());
+	header.materialCount = static_cast<uint32_t>(materials.size());
+	header.lodCount = static_cast<uint32_t>(fileLods.size());
+	header.meshletCount = meshletCount;
+	header.meshletVertexCount = static_cast<uint32_t>(meshletData.vertices.size());
+	header.meshletTriangleCount = static_cast<uint32_t>(meshletData.triangles.size() / 3);
+	header.vertexOffset = AlignUp(sizeof(MeshFileHeader));
+	header.indexOffset = AlignUp(header.vertexOffset + uint64_t(header.vertexStride) * header.vertexCount);
+	header.lodOffset = AlignUp(header.indexOffset + uint64_t(header.indexStride) * header.indexCount);
+	header.submeshOffset = AlignUp(header.lodOffset + sizeof(MeshFileLod) * fileLods.size());
+	header.materialOffset = AlignUp(header.submeshOffset + sizeof(MeshFileSubmesh) * submeshes.size());
+	header.meshletOffset = AlignUp(header.materialOffset + sizeof(MeshFileMaterial) * materials.size());
+	header.meshletBoundsOffset = AlignUp(header.meshletOffset + sizeof(Meshlet) * meshletData.meshlets.size());
+	header.meshletVertexOffset = AlignUp(header.meshletBoundsOffset + sizeof(MeshletBounds) * meshletData.bounds.size());
+	header.meshletTriangleOffset = AlignUp(header.meshletVertexOffset + sizeof(uint32_t) * meshletData.vertices.size());
+	header.stringOffset = AlignUp(header.meshletTriangleOffset + meshletData.triangles.size());
+	header.stringSize = strings.size();
+	header.bounds = ComputeMeshBounds(mesh.vertices.data(), mesh.vertices.size());
+	header.fileSize = header.stringOffset + header.stringSize;
+
+	// 書き込み ---------------------------------------------------------------------
+	// 途中で止まっても壊れたファイルが残らないように、一時ファイルに書いてから名前を変える
+	const std::filesystem::path path(filePath);
+	const std::filesystem::path tempPath(filePath + L".tmp");
+	std::error_code error;
+	if (path.has_parent_path()) {
+		std::filesystem::create_directories(path.parent_path(), error);
+	}
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			return false;
+		}
+		uint64_t position = 0;
+		auto write = [&](uint64_t offset, const void* data, uint64_t size) {
+			// 区画の間は0で埋める
+			static const char kZeros[kMeshFileAlignment] = {};
+			assert(offset >= position && offset - position < kMeshFileAlignment);
+			file.write(kZeros, static_cast<std::streamsize>(offset - position));
+			file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+			position = offset + size;
+		};
+
+		write(0, &header, sizeof(header));
+		write(header.vertexOffset, mesh.vertices.data(), uint64_t(header.vertexStride) * header.vertexCount);
+		if (header.indexStride == sizeof(uint16_t)) {
+			std::vector<uint16_t> indices16(mesh.indices.begin(), mesh.indices.end());
+			write(header.indexOffset, indices16.data(), sizeof(uint16_t) * indices16.size());
+		} else {
+			write(header.indexOffset, mesh.indices.data(), sizeof(uint32_t) * mesh.indices.size());
+		}
+		write(header.lodOffset, fileLods.data(), sizeof(MeshFileLod) * fileLods.size());
+		write(header.submeshOffset, submeshes.data(), sizeof(MeshFileSubmesh) * submeshes.size());
+		write(header.materialOffset, materials.data(), sizeof(MeshFileMaterial) * materials.size());
+		write(header.meshletOffset, meshletData.meshlets.data(), sizeof(Meshlet) * meshletData.meshlets.size());
+		write(header.meshletBoundsOffset, meshletData.bounds.data(), sizeof(MeshletBounds) * meshletData.bounds.size());
+		write(header.meshletVertexOffset, meshletData.vertices.data(), sizeof(uint32_t) * meshletData.vertices.size());
+		write(header.meshletTriangleOffset, meshletData.triangles.data(), meshletData.triangles.size());
+		write(header.stringOffset, strings.data(), strings.size());
+		if (!file) {
+			file.close();
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+	}
+	std::filesystem::rename(tempPath, path, error);
+	if (error) {
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+	return true;
+}
+
+//=============================================================================================================================
+//	読み込み
+//=============================================================================================================================
+bool MappedMesh::Open(const std::wstring& filePath) {
+	Close();
+
+	if (!file_.Open(filePath)) {
+		return false;
+	}
+	const uint64_t size = file_.GetSize();
+	if (size < sizeof(MeshFileHeader)) {
+		Close();
+		return false;
+	}
+	const MeshFileHeader* header = reinterpret_cast<const MeshFileHeader*>(file_.GetData());
+
+	// ヘッダ --------------------------------------------------------------------------
+	bool isValid = header->magic == kMeshFileMagic && header->version == kMeshFileVersion
+		&& header->vertexStride == sizeof(VertexData)
+		&& (header->indexStride == sizeof(uint16_t) || header->indexStride == sizeof(uint32_t))
+		&& header->vertexCount != 0 && header->indexCount != 0 && header->indexCount % 3 == 0 && header->lodCount != 0
+		&& header->fileSize == size;
+
+	// 区画の範囲 ----------------------------------------------------------------------
+	isValid = isValid
+		&& IsValidSection(header->vertexOffset, header->vertexCount, header->vertexStride, size)
+		&& IsValidSection(header->indexOffset, header->indexCount, header->indexStride, size)
+		&& IsValidSection(header->lodOffset, header->lodCount, sizeof(MeshFileLod), size)
+		&& IsValidSection(header->submeshOffset, header->submeshCount, sizeof(MeshFileSubmesh), size)
+		&& IsValidSection(header->materialOffset, header->materialCount, sizeof(MeshFileMaterial), size)
+		&& IsValidSection(header->meshletOffset, header->meshletCount, sizeof(Meshlet), size)
+		&& IsValidSection(header->meshletBoundsOffset, header->meshletCount, sizeof(MeshletBounds), size)
+		&& IsValidSection(header->meshletVertexOffset, header->meshletVertexCount, sizeof(uint32_t), size)
+		&& IsValidSection(header->meshletTriangleOffset, header->meshletTriangleCount, 3, size)
+		&& IsValidSection(header->stringOffset, header->stringSize, 1, size)
+		&& header->stringSize != 0 && file_.GetData()[header->stringOffset + header->stringSize - 1] == '\0';
+	if (!isValid) {
+		Close();
+		return false;
+	}
+
+	// LOD・サブメッシュ・メッシュレット・マテリアルが範囲内を指しているか --------------------------
+	header_ = header;
+	for (uint32_t index = 0; index < header->lodCount && isValid; ++index) {
+		const MeshFileLod& lod = GetLods()[index];
+		isValid = uint64_t(lod.firstIndex) + lod.indexCount <= header->indexCount && lod.indexCount % 3 == 0
+			&& uint64_t(lod.firstSubmesh) + lod.submeshCount <= header->submeshCount
+			&& uint64_t(lod.firstMeshlet) + lod.meshletCount <= header->meshletCount;
+	}
+	for (uint32_t index = 0; index < header->submeshCount && isValid; ++index) {
+		const MeshFileSubmesh& submesh = GetSubmeshes()[index];
+		isValid = submesh.materialIndex < header->materialCount && uint64_t(submesh.firstIndex) + submesh.indexCount <= header->indexCount
+			&& uint64_t(submesh.firstMeshlet) + submesh.meshletCount <= header->meshletCount;
+	}
+	for (uint32_t index = 0; index < header->meshletCount && isValid; ++index) {
+		const Meshlet& meshlet = GetMeshlets()[index];
+		isValid = meshlet.vertexCount <= kMeshletMaxVertices && meshlet.triangleCount <= kMeshletMaxTriangles
+			&& uint64_t(meshlet.vertexOffset) + meshlet.vertexCount <= header->meshletVertexCount
+			&& meshlet.triangleOffset % 3 == 0 && uint64_t(meshlet.triangleOffset) / 3 + meshlet.triangleCount <= header->meshletTriangleCount;
+	}
+	for (uint32_t index = 0; index < header->materialCount && isValid; ++index) {
+		const MeshFileMaterial& material = GetMaterial(index);
+		isValid = material.nameOffset < header->stringSize && material.diffuseTextureOffset < header->stringSize;
+	}
+	if (!isValid) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void MappedMesh::Close() {
+	header_ = nullptr;
+	file_.Close();
+}
+
+const MeshFileMaterial& MappedMesh::GetMaterial(uint32_t index) const {
+	assert(index < header_->materialCount);
+	return reinterpret_cast<const MeshFileMaterial*>(file_.GetData() + header_->materialOffset)[index];
+}
@@ -0,0 +1,190 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MeshData.h"
+#include "MeshletBuilder.h"
+#include "ObjLoader.h"
+#include "Vector4.h"
+#include "Function/MappedFile.h"
+
+/*================================================================================================
+焼いたメッシュ(.mesh)のファイル形式
+GPUに置く時と同じ並び(頂点はVertexDataのまま、インデックスは頂点数に合わせた16/32bit)で保存するので、
+マップしたファイルからアップロード用バッファへそのままmemcpyでき、読み込み時の解析がない
+
+	MeshFileHeader
+	頂点           VertexData * vertexCount
+	インデックス    indexStride * indexCount(全てのLODの分を続けて置く)
+	LOD            MeshFileLod * lodCount(0段目が元の形)
+	サブメッシュ    MeshFileSubmesh * submeshCount(LODごとに続けて置く)
+	メッシュレット  Meshlet * meshletCount(LOD・サブメッシュの順に続けて置く。なくても良い)
+	               MeshletBounds * meshletCount
+	               uint32_t * meshletVertexCount(メッシュの頂点番号)
+	               uint8_t * 3 * meshletTriangleCount(メッシュレットの中の頂点番号)
+	マテリアル      MeshFileMaterial * materialCount
+	文字列         '\0'区切りのUTF-8(マテリアル名・テクスチャのパス)
+
+各区画の先頭は16byte境界にそろえる。リトルエンディアン
+==================================================================================================*/
+
+/// ファイルの先頭4byte("MESH")
+static const uint32_t kMeshFileMagic = 0x4853454D;
+/// 形式を変えた時に上げる(違うバージョンのファイルは開かない)
+static const uint32_t kMeshFileVersion = 3;
+/// 区画の先頭をそろえる境界
+static const uint64_t kMeshFileAlignment = 16;
+
+/// <summary>
+/// ファイルの先頭
+/// </summary>
+struct MeshFileHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t vertexStride;			// sizeof(VertexData)
+	uint32_t vertexCount;
+	uint32_t indexStride;			// 2 or 4
+	uint32_t indexCount;
+	uint32_t submeshCount;
+	uint32_t materialCount;
+	uint32_t lodCount;
+	uint32_t meshletCount;
+	uint32_t meshletVertexCount;
+	uint32_t meshletTriangleCount;
+	uint64_t vertexOffset;			// 各区画のファイル先頭からの位置
+	uint64_t indexOffset;
+	uint64_t lodOffset;
+	uint64_t submeshOffset;
+	uint64_t materialOffset;
+	uint64_t meshletOffset;
+	uint64_t meshletBoundsOffset;
+	uint64_t meshletVertexOffset;
+	uint64_t meshletTriangleOffset;
+	uint64_t stringOffset;
+	uint64_t stringSize;
+	MeshBounds bounds;
+	uint64_t fileSize;
+};
+static_assert(sizeof(MeshFileHeader) == 184, "MeshFileHeader must be 184 bytes");
+
+/// <summary>
+/// LODの1段(インデックス・サブメッシュ・メッシュレットの範囲)
+/// </summary>
+struct MeshFileLod {
+	uint32_t firstIndex;
+	uint32_t indexCount;
+	uint32_t firstSubmesh;
+	uint32_t submeshCount;
+	float error;					// 元の形からのずれの目安(モデルの座標の単位)
+	uint32_t firstMeshlet;
+	uint32_t meshletCount;
+	uint32_t reserved;
+};
+static_assert(sizeof(MeshFileLod) == 32, "MeshFileLod must be 32 bytes");
+
+/// <summary>
+/// 同じマテリアルが続くインデックスの範囲(と、それを分けたメッシュレットの範囲)
+/// </summary>
+struct MeshFileSubmesh {
+	uint32_t materialIndex;
+	uint32_t firstIndex;
+	uint32_t indexCount;
+	uint32_t firstMeshlet;
+	uint32_t meshletCount;
+	uint32_t reserved[3];
+};
+static_assert(sizeof(MeshFileSubmesh) == 32, "MeshFileSubmesh must be 32 bytes");
+
+/// <summary>
+/// マテリアル(名前・パスは文字列区画の先頭からの位置)
+/// </summary>
+struct MeshFileMaterial {
+	Vector4 diffuseColor;
+	uint32_t nameOffset;
+	uint32_t diffuseTextureOffset;	// テクスチャがなければ空文字列を指す
+	uint32_t reserved[2];
+};
+static_assert(sizeof(MeshFileMaterial) == 32, "MeshFileMaterial must be 32 bytes");
+
+/// <summary>
+/// 書き出すLODの1段(submeshesはmodel.mesh.indicesの範囲で、前の段の後ろに続けて置く)
+/// </summary>
+struct MeshFileLodSource {
+	float error = 0.0f;
+	std::vector<ObjSubmesh> submeshes;
+	std::vector<uint32_t> meshletCounts;	// サブメッシュごとのメッシュレットの数(メッシュレットを書かない時は空)
+};
+
+/// <summary>
+/// モデルを.meshに書き出す(一時ファイルに書いてから名前を変える)
+/// </summary>
+/// <param name="filePath"></param>
+/// <param name="model">頂点は溶接済みを想定</param>
+/// <param name="lods">空ならmodel.submeshesを0段目だけのLODとして書く</param>
+/// <param name="meshlets">LOD・サブメッシュの順に作ったメッシュレット(書かないならnullptr)</param>
+/// <returns>頂点・インデックスがない、メッシュレットの数が合わない、書き込めない場合はfalse</returns>
+bool WriteMeshFile(const std::wstring& filePath, const ObjModel& model, const std::vector<MeshFileLodSource>& lods = {}, const MeshletData* meshlets = nullptr);
+
+/// <summary>
+/// .meshをメモリにマップし、ファイル内の頂点・インデックスをそのまま参照する
+/// (ポインタはこのクラスが開いている間だけ有効)
+/// </summary>
+class MappedMesh {
+public:
+
+	MappedMesh() = default;
+	~MappedMesh() = default;
+	MappedMesh(const MappedMesh&) = delete;
+	const MappedMesh& operator=(const MappedMesh&) = delete;
+
+	/// <summary>
+	/// マップしてヘッダと各区画の範囲を確かめる(インデックスの値までは見ない)
+	/// </summary>
+	/// <param name="filePath"></param>
+	/// <returns>開けない・形式やバージョンが違う・途中で切れている場合はfalse</returns>
+	bool Open(const std::wstring& filePath);
+
+	void Close();
+
+public: // accessor
+
+	const MeshFileHeader& GetHeader() const { return *header_; }
+	const MeshBounds& GetBounds() const { return header_->bounds; }
+
+	const VertexData* GetVertices() const { return reinterpret_cast<const VertexData*>(file_.GetData() + header_->vertexOffset); }
+	uint32_t GetVertexCount() const { return header_->vertexCount; }
+
+	/// 16bitか32bitかはGetIndexStrideで分かる
+	const void* GetIndices() const { return file_.GetData() + header_->indexOffset; }
+	uint32_t GetIndexStride() const { return header_->indexStride; }
+	uint32_t GetIndexCount() const { return header_->indexCount; }
+
+	/// 0段目が元の形
+	const MeshFileLod* GetLods() const { return reinterpret_cast<const MeshFileLod*>(file_.GetData() + header_->lodOffset); }
+	uint32_t GetLodCount() const { return header_->lodCount; }
+
+	/// 全てのLODの分(LODごとの範囲はMeshFileLodのfirstSubmesh, submeshCount)
+	const MeshFileSubmesh* GetSubmeshes() const { return reinterpret_cast<const MeshFileSubmesh*>(file_.GetData() + header_->submeshOffset); }
+	uint32_t GetSubmeshCount() const { return header_->submeshCount; }
+
+	/// LOD・サブメッシュの順(範囲はMeshFileLod・MeshFileSubmeshのfirstMeshlet, meshletCount)
+	const Meshlet* GetMeshlets() const { return reinterpret_cast<const Meshlet*>(file_.GetData() + header_->meshletOffset); }
+	const MeshletBounds* GetMeshletBounds() const { return reinterpret_cast<const MeshletBounds*>(file_.GetData() + header_->meshletBoundsOffset); }
+	uint32_t GetMeshletCount() const { return header_->meshletCount; }
+	const uint32_t* GetMeshletVertices() const { return reinterpret_cast<const uint32_t*>(file_.GetData() + header_->meshletVertexOffset); }
+	const uint8_t* GetMeshletTriangles() const { return file_.GetData() + header_->meshletTriangleOffset; }
+
+	const MeshFileMaterial& GetMaterial(uint32_t index) const;
+	uint32_t GetMaterialCount() const { return header_->materialCount; }
+
+	/// 文字列区画の位置から文字列を得る(MeshFileMaterialのオフセットを渡す)
+	const char* GetString(uint32_t offset) const { return reinterpret_cast<const char*>(file_.GetData() + header_->stringOffset + offset); }
+
+	bool IsOpen() const { return header_ != nullptr; }
+
+private:
+	MappedFile file_;
+	const MeshFileHeader* header_ = nullptr;
+};
@@ -0,0 +1,33 @@
+#include "MeshLodSelector.h"
+#include "Camera.h"
+
+#include <algorithm>
+#include <cmath>
+
+float ComputeLodPixelScale(const Camera& camera, float viewportWidth, float viewportHeight) {
+	// NDCの幅2がビューポートの幅になる。縦横で違えば大きい方(細かく見える方)に合わせる
+	const Matrix4x4 projection = camera.GetProjectionMatrix();
+	return (std::max)(projection.m[0][0] * viewportWidth, projection.m[1][1] * viewportHeight) * 0.5f;
+}
+
+float ComputeLodDistance(const Camera& camera, const Vector3& center, float radius) {
+	const Vector3 eye = camera.GetTranslate();
+	const float dx = center.x - eye.x;
+	const float dy = center.y - eye.y;
+	const float dz = center.z - eye.z;
+	const float distance = std::sqrt(dx * dx + dy * dy + dz * dz) - radius;
+	return (std::max)(distance, camera.GetNearClip());
+}
+
+uint32_t SelectMeshLod(const MeshLod* lods, uint32_t lodCount, float scale, float distance, float pixelScale, float maxPixelError) {
+	// 画面上のずれを距離1の所のずれにしておけば、段ごとの比較は掛け算1回で済む
+	const float maxError = maxPixelError * distance / (scale * pixelScale);
+	uint32_t result = 0;
+	for (uint32_t lod = 1; lod < lodCount; ++lod) {
+		if (lods[lod].error > maxError) {
+			break;
+		}
+		result = lod;
+	}
+	return result;
+}
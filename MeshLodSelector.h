@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+
+#include "MeshData.h"
+#include "Vector3.h"
+
+class Camera;
+
+/*================================================================================================
+実行時のLODの選び方
+LODの誤差(モデルの座標でのずれ)を画面に映した大きさ(ピクセル)にして、許す大きさに収まる一番粗い段を選ぶ
+	pixelError = error * scale * pixelScale / distance
+pixelScaleはカメラの射影とビューポートだけで決まるので、1フレームに1回求めれば良い
+==================================================================================================*/
+
+/// <summary>
+/// 距離1の所にある長さ1が画面上で何ピクセルになるか
+/// 射影行列の拡大率(視野角・アスペクト比から作ったもの)を使うので、実際に描かれる大きさと一致する
+/// </summary>
+/// <param name="camera"></param>
+/// <param name="viewportWidth"></param>
+/// <param name="viewportHeight"></param>
+/// <returns></returns>
+float ComputeLodPixelScale(const Camera& camera, float viewportWidth, float viewportHeight);
+
+/// <summary>
+/// カメラからバウンディングスフィアの一番近い所までの距離(中に入っていればニアクリップの距離)
+/// </summary>
+/// <param name="camera"></param>
+/// <param name="center">ワールド座標の中心</param>
+/// <param name="radius">ワールド座標の半径</param>
+/// <returns></returns>
+float ComputeLodDistance(const Camera& camera, const Vector3& center, float radius);
+
+/// <summary>
+/// 画面上のずれがmaxPixelError以下に収まる一番粗いLODを選ぶ
+/// </summary>
+/// <param name="lods">0段目が元の形で、後ろほど粗い</param>
+/// <param name="lodCount"></param>
+/// <param name="scale">モデルの拡大率(誤差をワールド座標にする)</param>
+/// <param name="distance">ComputeLodDistanceの距離</param>
+/// <param name="pixelScale">ComputeLodPixelScaleの値</param>
+/// <param name="maxPixelError">許す画面上のずれ(ピクセル)</param>
+/// <returns>LODの段(lodCountが0なら0)</returns>
+uint32_t SelectMeshLod(const MeshLod* lods, uint32_t lodCount, float scale, float distance, float pixelScale, float maxPixelError = 1.0f);
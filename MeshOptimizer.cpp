@@ -0,0 +1,321 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+static const uint32_t kInvalidIndex = UINT32_MAX;
+
+/// <summary>
+/// 頂点ごとの、その頂点を使う三角形の一覧
+/// </summary>
+struct TriangleAdjacency {
+	std::vector<uint32_t> offsets;		// 頂点ごとの先頭(vertexCount + 1個)
+	std::vector<uint32_t> triangles;
+	std::vector<uint32_t> liveCounts;	// まだ並べていない三角形の数
+
+	void Build(const uint32_t* indices, size_t indexCount, size_t vertexCount) {
+		offsets.assign(vertexCount + 1, 0);
+		liveCounts.assign(vertexCount, 0);
+		for (size_t index = 0; index < indexCount; ++index) {
+			assert(indices[index] < vertexCount);
+			++liveCounts[indices[index]];
+		}
+		for (size_t vertex = 0; vertex < vertexCount; ++vertex) {
+			offsets[vertex + 1] = offsets[vertex] + liveCounts[vertex];
+		}
+		triangles.resize(indexCount);
+		std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+		for (size_t index = 0; index < indexCount; ++index) {
+			triangles[cursors[indices[index]]++] = static_cast<uint32_t>(index / 3);
+		}
+	}
+};
+
+/// <summary>
+/// 範囲の頂点キャッシュのミスの数(timestampsは範囲の前から引き継ぐ)
+/// </summary>
+uint32_t CountCacheMisses(const uint32_t* indices, size_t indexCount, std::vector<uint32_t>& timestamps, uint32_t& time, uint32_t cacheSize) {
+	uint32_t misses = 0;
+	for (size_t index = 0; index < indexCount; ++index) {
+		const uint32_t vertex = indices[index];
+		if (time - timestamps[vertex] > cacheSize) {
+			timestamps[vertex] = time++;
+			++misses;
+		}
+	}
+	return misses;
+}
+
+}
+
+//=============================================================================================================================
+//	シミュレーション
+//=============================================================================================================================
+VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize) {
+	VertexCacheStats stats;
+	if (indexCount == 0 || vertexCount == 0) {
+		return stats;
+	}
+	// 時刻 - 入った時刻 がcacheSize以下ならキャッシュにある(最初はどれも入っていない)
+	std::vector<uint32_t> timestamps(vertexCount, 0);
+	uint32_t time = cacheSize + 1;
+	stats.transformedCount = CountCacheMisses(indices, indexCount, timestamps, time, cacheSize);
+	stats.acmr = float(stats.transformedCount) / float(indexCount / 3);
+	stats.atvr = float(stats.transformedCount) / float(vertexCount);
+	return stats;
+}
+
+VertexFetchStats AnalyzeVertexFetch(const uint32_t* indices, size_t indexCount, size_t vertexCount, size_t vertexStride) {
+	VertexFetchStats stats;
+	if (indexCount == 0 || vertexCount == 0) {
+		return stats;
+	}
+	const size_t lineCount = (vertexCount * vertexStride + kVertexFetchCacheLineSize - 1) / kVertexFetchCacheLineSize;
+	std::vector<uint32_t> timestamps(lineCount, 0);
+	uint32_t time = kVertexFetchCacheLineCount + 1;
+	for (size_t index = 0; index < indexCount; ++index) {
+		// 頂点がまたがるラインを全て読む
+		const size_t begin = indices[index] * vertexStride;
+		const size_t firstLine = begin / kVertexFetchCacheLineSize;
+		const size_t lastLine = (begin + vertexStride - 1) / kVertexFetchCacheLineSize;
+		for (size_t line = firstLine; line <= lastLine; ++line) {
+			if (time - timestamps[line] > kVertexFetchCacheLineCount) {
+				timestamps[line] = time++;
+				stats.bytesFetched += kVertexFetchCacheLineSize;
+			}
+		}
+	}
+	stats.overfetch = float(stats.bytesFetched) / float(vertexCount * vertexStride);
+	return stats;
+}
+
+//=============================================================================================================================
+//	頂点キャッシュ
+//=============================================================================================================================
+void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize) {
+	assert(indexCount % 3 == 0);
+	const size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0) {
+		return;
+	}
+
+	TriangleAdjacency adjacency;
+	adjacency.Build(indices, indexCount, vertexCount);
+
+	std::vector<uint32_t> timestamps(vertexCount, 0);
+	std::vector<bool> isEmitted(triangleCount, false);
+	// 使った頂点を積んでおき、行き詰まった時にそこから再開する
+	std::vector<uint32_t> deadEnds;
+	deadEnds.reserve(indexCount);
+	std::vector<uint32_t> candidates;
+	std::vector<uint32_t> result;
+	result.reserve(indexCount);
+
+	uint32_t time = cacheSize + 1;
+	uint32_t cursor = 0;
+	uint32_t fanning = indices[0];
+	while (fanning != kInvalidIndex) {
+		// 今の頂点を囲む三角形を全て出す --------------------------------------------------
+		candidates.clear();
+		for (uint32_t at = adjacency.offsets[fanning]; at < adjacency.offsets[fanning + 1]; ++at) {
+			const uint32_t triangle = adjacency.triangles[at];
+			if (isEmitted[triangle]) {
+				continue;
+			}
+			isEmitted[triangle] = true;
+			for (uint32_t corner = 0; corner < 3; ++corner) {
+				const uint32_t vertex = indices[triangle * 3 + corner];
+				result.push_back(vertex);
+				deadEnds.push_back(vertex);
+				candidates.push_back(vertex);
+				--adjacency.liveCounts[vertex];
+				if (time - timestamps[vertex] > cacheSize) {
+					timestamps[vertex] = time++;
+				}
+			}
+		}
+
+		// 次の頂点 ----------------------------------------------------------------------
+		// 囲む三角形を全て出してもキャッシュに残っていそうな頂点のうち、一番古いもの
+		uint32_t next = kInvalidIndex;
+		int32_t bestPriority = -1;
+		for (uint32_t vertex : candidates) {
+			if (adjacency.liveCounts[vertex] == 0) {
+				continue;
+			}
+			int32_t priority = 0;
+			const uint32_t age = time - timestamps[vertex];
+			if (age + 2 * adjacency.liveCounts[vertex] <= cacheSize) {
+				priority = static_cast<int32_t>(age);
+			}
+			if (priority > bestPriority) {
+				bestPriority = priority;
+				next = vertex;
+			}
+		}
+		// 行き詰まったら最近使った頂点、それもなければ番号順に残っている頂点
+		while (next == kInvalidIndex && !deadEnds.empty()) {
+			const uint32_t vertex = deadEnds.back();
+			deadEnds.pop_back();
+			if (adjacency.liveCounts[vertex] != 0) {
+				next = vertex;
+			}
+		}
+		while (next == kInvalidIndex && cursor < vertexCount) {
+			if (adjacency.liveCounts[cursor] != 0) {
+				next = cursor;
+			}
+			++cursor;
+		}
+		fanning = next;
+	}
+
+	assert(result.size() == indexCount);
+	std::copy(result.begin(), result.end(), indices);
+}
+
+//=============================================================================================================================
+//	オーバードロー
+//=============================================================================================================================
+void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const VertexData* vertices, size_t vertexCount, float threshold, uint32_t cacheSize) {
+	assert(indexCount % 3 == 0);
+	const size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0) {
+		return;
+	}
+
+	// 塊に分ける --------------------------------------------------------------------------
+	// キャッシュが入れ替わる所(3頂点ともミスする三角形)で必ず区切り、
+	// その中でも、そこまでのACMRが塊全体のthreshold倍以下に収まる所で細かく区切る
+	// (塊ごとにキャッシュを空にするのは、時刻をキャッシュの大きさより進めて済ませる)
+	std::vector<uint32_t> timestamps(vertexCount, 0);
+	uint32_t time = cacheSize + 1;
+	std::vector<uint32_t> hardBoundaries;
+	for (size_t triangle = 0; triangle < triangleCount; ++triangle) {
+		if (CountCacheMisses(indices + triangle * 3, 3, timestamps, time, cacheSize) == 3) {
+			hardBoundaries.push_back(static_cast<uint32_t>(triangle));
+		}
+	}
+	hardBoundaries.push_back(static_cast<uint32_t>(triangleCount));
+
+	std::vector<uint32_t> clusters;	// 塊の先頭の三角形
+	for (size_t hard = 0; hard + 1 < hardBoundaries.size(); ++hard) {
+		const uint32_t begin = hardBoundaries[hard];
+		const uint32_t end = hardBoundaries[hard + 1];
+		time += cacheSize + 1;
+		const float clusterAcmr = float(CountCacheMisses(indices + begin * 3, (end - begin) * 3, timestamps, time, cacheSize)) / float(end - begin);
+
+		uint32_t start = begin;
+		while (start < end) {
+			clusters.push_back(start);
+			time += cacheSize + 1;
+			uint32_t misses = 0;
+			uint32_t triangle = start;
+			for (; triangle < end; ++triangle) {
+				misses += CountCacheMisses(indices + triangle * 3, 3, timestamps, time, cacheSize);
+				const uint32_t count = triangle - start + 1;
+				// 小さすぎる塊は並べ替えの効果より、キャッシュが落ちる分が大きい
+				if (count >= 8 && float(misses) / float(count) <= clusterAcmr * threshold && triangle + 1 < end) {
+					++triangle;
+					break;
+				}
+			}
+			start = triangle;
+		}
+	}
+	clusters.push_back(static_cast<uint32_t>(triangleCount));
+
+	// 塊の向き ----------------------------------------------------------------------------
+	// 面積で重み付けした法線と重心。メッシュの中心から外を向いているほど先に描く
+	auto getPos = [&](uint32_t vertex) {
+		assert(vertex < vertexCount);
+		return vertices[vertex].pos;
+	};
+	float meshCenter[3] = {};
+	float meshArea = 0.0f;
+	const size_t clusterCount = clusters.size() - 1;
+	std::vector<float> clusterNormals(clusterCount * 3, 0.0f);
+	std::vector<float> clusterCenters(clusterCount * 3, 0.0f);
+	for (size_t cluster = 0; cluster < clusterCount; ++cluster) {
+		float clusterArea = 0.0f;
+		float* normal = &clusterNormals[cluster * 3];
+		float* center = &clusterCenters[cluster * 3];
+		for (uint32_t triangle = clusters[cluster]; triangle < clusters[cluster + 1]; ++triangle) {
+			const Vector4 a = getPos(indices[triangle * 3 + 0]);
+			const Vector4 b = getPos(indices[triangle * 3 + 1]);
+			const Vector4 c = getPos(indices[triangle * 3 + 2]);
+			const float ab[3] = { b.x - a.x, b.y - a.y, b.z - a.z };
+			const float ac[3] = { c.x - a.x, c.y - a.y, c.z - a.z };
+			// 時計回りが表(左手系)なので、ab × ac が外向き。長さは面積の2倍
+			const float cross[3] = { ab[1] * ac[2] - ab[2] * ac[1], ab[2] * ac[0] - ab[0] * ac[2], ab[0] * ac[1] - ab[1] * ac[0] };
+			const float area = std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+			const float triangleCenter[3] = { (a.x + b.x + c.x) / 3.0f, (a.y + b.y + c.y) / 3.0f, (a.z + b.z + c.z) / 3.0f };
+			for (int axis = 0; axis < 3; ++axis) {
+				normal[axis] += cross[axis];
+				center[axis] += triangleCenter[axis] * area;
+				meshCenter[axis] += triangleCenter[axis] * area;
+			}
+			clusterArea += area;
+		}
+		meshArea += clusterArea;
+		if (clusterArea > 0.0f) {
+			for (int axis = 0; axis < 3; ++axis) {
+				center[axis] /= clusterArea;
+			}
+		}
+	}
+	if (meshArea > 0.0f) {
+		for (int axis = 0; axis < 3; ++axis) {
+			meshCenter[axis] /= meshArea;
+		}
+	}
+
+	std::vector<float> sortKeys(clusterCount);
+	for (size_t cluster = 0; cluster < clusterCount; ++cluster) {
+		const float* normal = &clusterNormals[cluster * 3];
+		const float* center = &clusterCenters[cluster * 3];
+		const float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		float dot = 0.0f;
+		for (int axis = 0; axis < 3; ++axis) {
+			dot += (center[axis] - meshCenter[axis]) * normal[axis];
+		}
+		sortKeys[cluster] = length > 0.0f ? dot / length : 0.0f;
+	}
+
+	// 並べ替え ----------------------------------------------------------------------------
+	std::vector<uint32_t> order(clusterCount);
+	for (uint32_t cluster = 0; cluster < clusterCount; ++cluster) {
+		order[cluster] = cluster;
+	}
+	std::stable_sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) { return sortKeys[lhs] > sortKeys[rhs]; });
+
+	std::vector<uint32_t> result;
+	result.reserve(indexCount);
+	for (uint32_t cluster : order) {
+		result.insert(result.end(), indices + clusters[cluster] * 3, indices + clusters[cluster + 1] * 3);
+	}
+	std::copy(result.begin(), result.end(), indices);
+}
+
+//=============================================================================================================================
+//	頂点の読み込み
+//=============================================================================================================================
+void OptimizeVertexFetch(MeshData& mesh) {
+	std::vector<uint32_t> remap(mesh.vertices.size(), kInvalidIndex);
+	std::vector<VertexData> vertices;
+	vertices.reserve(mesh.vertices.size());
+	for (uint32_t& index : mesh.indices) {
+		assert(index < mesh.vertices.size());
+		if (remap[index] == kInvalidIndex) {
+			remap[index] = static_cast<uint32_t>(vertices.size());
+			vertices.push_back(mesh.vertices[index]);
+		}
+		index = remap[index];
+	}
+	vertices.shrink_to_fit();
+	mesh.vertices.swap(vertices);
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "MeshData.h"
+
+/*================================================================================================
+インデックス・頂点の並べ替え(焼く時・読み込み時用。D3D12は使わない)
+	1. OptimizeVertexCache  頂点シェーダの結果のキャッシュに当たりやすい三角形の順にする(Tipsify)
+	2. OptimizeOverdraw     1.の並びを塊に分け、外を向いた塊から描くように並べ替える(任意)
+	3. OptimizeVertexFetch  頂点を使われる順に並べ替え、頂点バッファの読み込みを連続させる
+三角形の並べ替え(1, 2)はマテリアルの範囲ごとに、頂点の並べ替え(3)はメッシュ全体で行う
+効果はAnalyzeVertexCache / AnalyzeVertexFetch(CPUでのキャッシュのシミュレーション)で確かめられる
+==================================================================================================*/
+
+/// シミュレーション・並べ替えで想定する頂点キャッシュ(FIFO)の大きさ
+static const uint32_t kVertexCacheSize = 16;
+/// 頂点の読み込みのシミュレーションのキャッシュライン
+static const uint32_t kVertexFetchCacheLineSize = 64;
+/// 頂点の読み込みのシミュレーションのキャッシュライン数(FIFO)
+static const uint32_t kVertexFetchCacheLineCount = 64;
+
+/// <summary>
+/// 頂点キャッシュのシミュレーション結果
+/// </summary>
+struct VertexCacheStats {
+	uint32_t transformedCount = 0;	// 頂点シェーダが走る回数(キャッシュミス)
+	float acmr = 0.0f;				// 三角形あたりの回数(0.5 ~ 3。小さいほど良い)
+	float atvr = 0.0f;				// 頂点あたりの回数(1が最小)
+};
+
+/// <summary>
+/// 頂点の読み込みのシミュレーション結果
+/// </summary>
+struct VertexFetchStats {
+	uint64_t bytesFetched = 0;		// メモリから読んだバイト数(キャッシュラインの単位)
+	float overfetch = 0.0f;			// 頂点バッファの大きさとの比(1が最小)
+};
+
+/// <summary>
+/// 頂点キャッシュ(FIFO)を通して描いた時にシェーダが走る回数を数える
+/// </summary>
+/// <param name="indices"></param>
+/// <param name="indexCount"></param>
+/// <param name="vertexCount"></param>
+/// <param name="cacheSize"></param>
+/// <returns></returns>
+VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = kVertexCacheSize);
+
+/// <summary>
+/// 頂点をキャッシュライン単位(FIFO)で読んだ時のバイト数を数える
+/// </summary>
+/// <param name="indices"></param>
+/// <param name="indexCount"></param>
+/// <param name="vertexCount"></param>
+/// <param name="vertexStride"></param>
+/// <returns></returns>
+VertexFetchStats AnalyzeVertexFetch(const uint32_t* indices, size_t indexCount, size_t vertexCount, size_t vertexStride);
+
+/// <summary>
+/// 三角形を頂点キャッシュに当たりやすい順に並べ替える(Tipsify。インデックスの数に比例する時間で済む)
+/// </summary>
+/// <param name="indices">並べ替えるインデックス(3つで1三角形)</param>
+/// <param name="indexCount"></param>
+/// <param name="vertexCount">インデックスが指す頂点の数</param>
+/// <param name="cacheSize"></param>
+void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = kVertexCacheSize);
+
+/// <summary>
+/// OptimizeVertexCache済みの並びを塊に分け、外を向いた塊が先になるように並べ替える
+/// 塊の中の並びは変えないので、キャッシュの効率はthresholdの分までしか落ちない
+/// </summary>
+/// <param name="indices">OptimizeVertexCache済みのインデックス</param>
+/// <param name="indexCount"></param>
+/// <param name="vertices"></param>
+/// <param name="vertexCount"></param>
+/// <param name="threshold">塊を細かくする時に許すACMRの悪化(1.05なら5%)</param>
+/// <param name="cacheSize"></param>
+void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const VertexData* vertices, size_t vertexCount, float threshold, uint32_t cacheSize = kVertexCacheSize);
+
+/// <summary>
+/// 頂点をインデックスで最初に使われる順に並べ替え、インデックスを付け直す(使われない頂点は消す)
+/// </summary>
+/// <param name="mesh"></param>
+void OptimizeVertexFetch(MeshData& mesh);
@@ -0,0 +1,451 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+static const uint32_t kInvalidIndex = UINT32_MAX;
+/// 端の形を保つための拘束の重み(面の誤差に対して)
+static const double kBorderWeight = 10.0;
+
+/// <summary>
+/// 頂点の動かし方
+/// </summary>
+enum class VertexKind : uint8_t {
+	Manifold,	// どの隣にも寄せられる
+	Border,		// 端の辺に沿ってだけ寄せられる
+	Locked,		// 動かさない(UVの継ぎ目・端が入り組んだ所)
+};
+
+/// <summary>
+/// 点から平面(の集まり)までの距離の2乗を表す二次形式 (p^T A p + 2 b^T p + c) / weight
+/// </summary>
+struct Quadric {
+	double a00 = 0.0, a11 = 0.0, a22 = 0.0, a10 = 0.0, a20 = 0.0, a21 = 0.0;
+	double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+	double c = 0.0;
+	double weight = 0.0;
+
+	/// 平面 n・p + d = 0 (nは単位ベクトル)
+	static Quadric FromPlane(double nx, double ny, double nz, double d, double weight) {
+		Quadric q;
+		q.a00 = nx * nx * weight;
+		q.a11 = ny * ny * weight;
+		q.a22 = nz * nz * weight;
+		q.a10 = ny * nx * weight;
+		q.a20 = nz * nx * weight;
+		q.a21 = nz * ny * weight;
+		q.b0 = nx * d * weight;
+		q.b1 = ny * d * weight;
+		q.b2 = nz * d * weight;
+		q.c = d * d * weight;
+		q.weight = weight;
+		return q;
+	}
+
+	void Add(const Quadric& other) {
+		a00 += other.a00; a11 += other.a11; a22 += other.a22;
+		a10 += other.a10; a20 += other.a20; a21 += other.a21;
+		b0 += other.b0; b1 += other.b1; b2 += other.b2;
+		c += other.c;
+		weight += other.weight;
+	}
+
+	/// 重みで割る前の値(2つの和の誤差は (Ea + Eb) / (wa + wb) で求まる)
+	double EvaluateRaw(const double p[3]) const {
+		const double rx = a00 * p[0] + a10 * p[1] + a20 * p[2];
+		const double ry = a10 * p[0] + a11 * p[1] + a21 * p[2];
+		const double rz = a20 * p[0] + a21 * p[1] + a22 * p[2];
+		return rx * p[0] + ry * p[1] + rz * p[2] + 2.0 * (b0 * p[0] + b1 * p[1] + b2 * p[2]) + c;
+	}
+};
+
+/// <summary>
+/// 縮める辺の候補
+/// </summary>
+struct Collapse {
+	uint32_t from;
+	uint32_t to;
+	float error;
+};
+
+/// <summary>
+/// 頂点ごとの、その頂点を使う三角形の一覧
+/// </summary>
+struct VertexAdjacency {
+	std::vector<uint32_t> offsets;
+	std::vector<uint32_t> triangles;
+
+	void Build(const uint32_t* indices, size_t indexCount, size_t vertexCount) {
+		offsets.assign(vertexCount + 1, 0);
+		for (size_t index = 0; index < indexCount; ++index) {
+			++offsets[indices[index] + 1];
+		}
+		for (size_t vertex = 0; vertex < vertexCount; ++vertex) {
+			offsets[vertex + 1] += offsets[vertex];
+		}
+		triangles.resize(indexCount);
+		std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+		for (size_t index = 0; index < indexCount; ++index) {
+			triangles[cursors[indices[index]]++] = static_cast<uint32_t>(index / 3);
+		}
+	}
+};
+
+/// <summary>
+/// 位置が同じ頂点が他にあるか(あればUVの継ぎ目)。usedVerticesの並びで返す
+/// </summary>
+std::vector<bool> FindSharedPositions(const VertexData* vertices, const std::vector<uint32_t>& usedVertices) {
+	const size_t count = usedVertices.size();
+	// 位置だけのハッシュテーブル(usedVerticesの番号+1。0は空き)
+	size_t tableSize = 1;
+	while (tableSize < count * 2) {
+		tableSize <<= 1;
+	}
+	std::vector<uint32_t> table(tableSize, 0);
+	std::vector<uint32_t> owners(count);
+	std::vector<uint32_t> counts(count, 0);
+	auto key = [&](uint32_t local, uint32_t out[3]) {
+		const Vector4& pos = vertices[usedVertices[local]].pos;
+		const float position[3] = { pos.x, pos.y, pos.z };
+		for (int axis = 0; axis < 3; ++axis) {
+			// -0と+0は同じとみなす
+			const float value = position[axis] == 0.0f ? 0.0f : position[axis];
+			std::memcpy(&out[axis], &value, sizeof(float));
+		}
+	};
+	for (uint32_t local = 0; local < count; ++local) {
+		uint32_t bits[3];
+		key(local, bits);
+		// 格子状に並んだ座標でも偏らないように64bitで混ぜる
+		uint64_t hash = (uint64_t(bits[0]) << 32 | bits[1]) * 0xFF51AFD7ED558CCDull;
+		hash = (hash ^ (hash >> 32) ^ bits[2]) * 0xC4CEB9FE1A85EC53ull;
+		size_t slot = static_cast<size_t>(hash ^ (hash >> 29)) & (tableSize - 1);
+		while (true) {
+			if (table[slot] == 0) {
+				table[slot] = local + 1;
+				owners[local] = local;
+				break;
+			}
+			uint32_t other[3];
+			key(table[slot] - 1, other);
+			if (std::memcmp(bits, other, sizeof(bits)) == 0) {
+				owners[local] = table[slot] - 1;
+				break;
+			}
+			slot = (slot + 1) & (tableSize - 1);
+		}
+		++counts[owners[local]];
+	}
+	std::vector<bool> isShared(count);
+	for (uint32_t local = 0; local < count; ++local) {
+		isShared[local] = counts[owners[local]] > 1;
+	}
+	return isShared;
+}
+
+/// <summary>
+/// 三角形の法線(正規化しない)
+/// </summary>
+void ComputeNormal(const double* p0, const double* p1, const double* p2, double out[3]) {
+	const double e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+	const double e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+	out[0] = e1[1] * e2[2] - e1[2] * e2[1];
+	out[1] = e1[2] * e2[0] - e1[0] * e2[2];
+	out[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+double Length(const double v[3]) {
+	return std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+}
+
+}
+
+//=============================================================================================================================
+//	簡略化
+//=============================================================================================================================
+size_t SimplifyMesh(uint32_t* destination, const uint32_t* indices, size_t indexCount, const VertexData* vertices, size_t vertexCount, size_t targetIndexCount, float targetError, float* outError) {
+	assert(indexCount % 3 == 0);
+	if (outError) {
+		*outError = 0.0f;
+	}
+	if (indexCount == 0 || targetIndexCount >= indexCount) {
+		std::copy(indices, indices + indexCount, destination);
+		return indexCount;
+	}
+
+	// 使われている頂点だけに番号を振り直す(LODの段が進むほど頂点バッファの一部しか使わない) ----------
+	std::vector<uint32_t> localIndices(vertexCount, kInvalidIndex);
+	std::vector<uint32_t> usedVertices;
+	std::vector<uint32_t> result(indexCount);
+	for (size_t index = 0; index < indexCount; ++index) {
+		assert(indices[index] < vertexCount);
+		uint32_t& local = localIndices[indices[index]];
+		if (local == kInvalidIndex) {
+			local = static_cast<uint32_t>(usedVertices.size());
+			usedVertices.push_back(indices[index]);
+		}
+		result[index] = local;
+	}
+	const uint32_t localCount = static_cast<uint32_t>(usedVertices.size());
+
+	// 位置を[0, 1]に収める(誤差の計算の桁をそろえる) --------------------------------------
+	std::vector<VertexData> usedData(localCount);
+	for (uint32_t local = 0; local < localCount; ++local) {
+		usedData[local] = vertices[usedVertices[local]];
+	}
+	const MeshBounds bounds = ComputeMeshBounds(usedData.data(), usedData.size());
+	const double extent = (std::max)({ bounds.max.x - bounds.min.x, bounds.max.y - bounds.min.y, bounds.max.z - bounds.min.z, 1e-20f });
+	std::vector<double> positions(size_t(localCount) * 3);
+	for (uint32_t local = 0; local < localCount; ++local) {
+		positions[local * 3 + 0] = (usedData[local].pos.x - bounds.min.x) / extent;
+		positions[local * 3 + 1] = (usedData[local].pos.y - bounds.min.y) / extent;
+		positions[local * 3 + 2] = (usedData[local].pos.z - bounds.min.z) / extent;
+	}
+	usedData = {};
+	auto getPosition = [&](uint32_t local) { return &positions[size_t(local) * 3]; };
+	const double targetErrorSquared = (double(targetError) / extent) * (double(targetError) / extent);
+
+	const std::vector<bool> isShared = FindSharedPositions(vertices, usedVertices);
+
+	// 二次誤差(面 + 端の拘束) ---------------------------------------------------------------
+	std::vector<Quadric> quadrics(localCount);
+	VertexAdjacency adjacency;
+	adjacency.Build(result.data(), result.size(), localCount);
+	// 辺 from→to を持つ三角形があるか
+	auto hasHalfEdge = [&](uint32_t from, uint32_t to) {
+		for (uint32_t at = adjacency.offsets[from]; at < adjacency.offsets[from + 1]; ++at) {
+			const uint32_t* triangle = &result[adjacency.triangles[at] * 3];
+			if ((triangle[0] == from && triangle[1] == to) || (triangle[1] == from && triangle[2] == to) || (triangle[2] == from && triangle[0] == to)) {
+				return true;
+			}
+		}
+		return false;
+	};
+	for (size_t triangle = 0; triangle < result.size() / 3; ++triangle) {
+		const uint32_t* corners = &result[triangle * 3];
+		const double* p0 = getPosition(corners[0]);
+		double normal[3];
+		ComputeNormal(p0, getPosition(corners[1]), getPosition(corners[2]), normal);
+		const double length = Length(normal);
+		if (length == 0.0) {
+			continue;
+		}
+		for (double& value : normal) {
+			value /= length;
+		}
+		// 面積で重み付けする
+		const Quadric plane = Quadric::FromPlane(normal[0], normal[1], normal[2], -(normal[0] * p0[0] + normal[1] * p0[1] + normal[2] * p0[2]), length * 0.5);
+		for (int corner = 0; corner < 3; ++corner) {
+			quadrics[corners[corner]].Add(plane);
+		}
+		// 端の辺には、辺を通り面に垂直な平面を足して、端が内側に縮まないようにする
+		for (int corner = 0; corner < 3; ++corner) {
+			const uint32_t from = corners[corner];
+			const uint32_t to = corners[(corner + 1) % 3];
+			if (hasHalfEdge(to, from)) {
+				continue;
+			}
+			const double* a = getPosition(from);
+			const double* b = getPosition(to);
+			const double edge[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+			double side[3] = { edge[1] * normal[2] - edge[2] * normal[1], edge[2] * normal[0] - edge[0] * normal[2], edge[0] * normal[1] - edge[1] * normal[0] };
+			const double sideLength = Length(side);
+			if (sideLength == 0.0) {
+				continue;
+			}
+			for (double& value : side) {
+				value /= sideLength;
+			}
+			const double edgeLengthSquared = edge[0] * edge[0] + edge[1] * edge[1] + edge[2] * edge[2];
+			const Quadric constraint = Quadric::FromPlane(side[0], side[1], side[2], -(side[0] * a[0] + side[1] * a[1] + side[2] * a[2]), edgeLengthSquared * kBorderWeight);
+			quadrics[from].Add(constraint);
+			quadrics[to].Add(constraint);
+		}
+	}
+
+	// 端 -------------------------------------------------------------------------------------
+	// 端は、逆向きの辺を持つ三角形がない辺。端の辺が出入り1本ずつの頂点だけ端に沿って動かせる
+	// (内側の頂点を縮めても端は変わらないので、最初に求めて端の頂点を縮めた時だけつなぎ直す)
+	std::vector<uint32_t> borderNext(localCount, kInvalidIndex);
+	std::vector<uint32_t> borderPrev(localCount, kInvalidIndex);
+	std::vector<bool> isFixed(isShared);
+	for (size_t triangle = 0; triangle < result.size() / 3; ++triangle) {
+		for (int corner = 0; corner < 3; ++corner) {
+			const uint32_t from = result[triangle * 3 + corner];
+			const uint32_t to = result[triangle * 3 + (corner + 1) % 3];
+			if (hasHalfEdge(to, from)) {
+				continue;
+			}
+			if (borderNext[from] != kInvalidIndex || borderPrev[to] != kInvalidIndex) {
+				isFixed[from] = true;
+				isFixed[to] = true;
+			}
+			borderNext[from] = to;
+			borderPrev[to] = from;
+		}
+	}
+
+	// 縮める(1回ごとに、誤差の小さいものからまとめて) -------------------------------------------
+	std::vector<VertexKind> kinds(localCount);
+	std::vector<uint32_t> remap(localCount);
+	std::vector<bool> isLocked(localCount);
+	std::vector<Collapse> collapses;
+	double maxError = 0.0;
+
+	while (result.size() > targetIndexCount) {
+		adjacency.Build(result.data(), result.size(), localCount);
+
+		for (uint32_t vertex = 0; vertex < localCount; ++vertex) {
+			const bool isBorder = borderNext[vertex] != kInvalidIndex || borderPrev[vertex] != kInvalidIndex;
+			if (isFixed[vertex] || (isBorder && (borderNext[vertex] == kInvalidIndex || borderPrev[vertex] == kInvalidIndex || borderNext[vertex] == borderPrev[vertex]))) {
+				kinds[vertex] = VertexKind::Locked;
+			} else {
+				kinds[vertex] = isBorder ? VertexKind::Border : VertexKind::Manifold;
+			}
+		}
+
+		// 頂点ごとに一番誤差の小さい寄せ先 -------------------------------------------------
+		collapses.clear();
+		for (uint32_t from = 0; from < localCount; ++from) {
+			if (kinds[from] == VertexKind::Locked || adjacency.offsets[from] == adjacency.offsets[from + 1]) {
+				continue;
+			}
+			Collapse best = { from, kInvalidIndex, 0.0f };
+			double bestError = 0.0;
+			auto consider = [&](uint32_t to) {
+				const double* position = getPosition(to);
+				const double weight = quadrics[from].weight + quadrics[to].weight;
+				const double error = weight > 0.0 ? std::fabs(quadrics[from].EvaluateRaw(position) + quadrics[to].EvaluateRaw(position)) / weight : 0.0;
+				if (best.to == kInvalidIndex || error < bestError) {
+					best.to = to;
+					bestError = error;
+				}
+			};
+			if (kinds[from] == VertexKind::Border) {
+				consider(borderNext[from]);
+				consider(borderPrev[from]);
+			} else {
+				for (uint32_t at = adjacency.offsets[from]; at < adjacency.offsets[from + 1]; ++at) {
+					const uint32_t* triangle = &result[adjacency.triangles[at] * 3];
+					// 三角形の並びで次の頂点だけ見れば、周りの辺を1回ずつ見られる(端では前の頂点も)
+					for (int corner = 0; corner < 3; ++corner) {
+						if (triangle[corner] == from) {
+							consider(triangle[(corner + 1) % 3]);
+							consider(triangle[(corner + 2) % 3]);
+							break;
+						}
+					}
+				}
+			}
+			if (best.to != kInvalidIndex && bestError <= targetErrorSquared) {
+				best.error = static_cast<float>(bestError);
+				collapses.push_back(best);
+			}
+		}
+		if (collapses.empty()) {
+			break;
+		}
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs) { return lhs.error < rhs.error; });
+
+		// 誤差の小さい順に縮める ----------------------------------------------------------------
+		// この回で縮めた頂点・寄せ先になった頂点はもう使わない。裏返りの確認は、この回で縮めた分を反映した位置で行う
+		for (uint32_t vertex = 0; vertex < localCount; ++vertex) {
+			remap[vertex] = vertex;
+		}
+		std::fill(isLocked.begin(), isLocked.end(), false);
+		size_t triangleCount = result.size() / 3;
+		const size_t targetTriangleCount = targetIndexCount / 3;
+		size_t collapseCount = 0;
+		for (const Collapse& collapse : collapses) {
+			if (triangleCount <= targetTriangleCount) {
+				break;
+			}
+			if (isLocked[collapse.from] || isLocked[collapse.to]) {
+				continue;
+			}
+			// fromをtoへ動かした時に裏返る・潰れる三角形がないか
+			size_t removedCount = 0;
+			bool isValid = true;
+			for (uint32_t at = adjacency.offsets[collapse.from]; at < adjacency.offsets[collapse.from + 1] && isValid; ++at) {
+				const uint32_t* triangle = &result[adjacency.triangles[at] * 3];
+				const uint32_t corners[3] = { remap[triangle[0]], remap[triangle[1]], remap[triangle[2]] };
+				if (corners[0] == corners[1] || corners[1] == corners[2] || corners[2] == corners[0]) {
+					continue;	// この回で既に潰れた
+				}
+				if (corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to) {
+					++removedCount;
+					continue;
+				}
+				const double* before[3];
+				const double* after[3];
+				for (int corner = 0; corner < 3; ++corner) {
+					before[corner] = getPosition(corners[corner]);
+					after[corner] = corners[corner] == collapse.from ? getPosition(collapse.to) : before[corner];
+				}
+				double normalBefore[3];
+				double normalAfter[3];
+				ComputeNormal(before[0], before[1], before[2], normalBefore);
+				ComputeNormal(after[0], after[1], after[2], normalAfter);
+				const double dot = normalBefore[0] * normalAfter[0] + normalBefore[1] * normalAfter[1] + normalBefore[2] * normalAfter[2];
+				// 向きが大きく変わる(裏返る)、または面積がなくなる
+				isValid = dot > 0.25 * Length(normalBefore) * Length(normalAfter) && Length(normalAfter) > 0.0;
+			}
+			if (!isValid) {
+				continue;
+			}
+
+			remap[collapse.from] = collapse.to;
+			quadrics[collapse.to].Add(quadrics[collapse.from]);
+			if (kinds[collapse.from] == VertexKind::Border) {
+				// 端の並びからfromを抜く
+				const uint32_t prev = borderPrev[collapse.from];
+				const uint32_t next = borderNext[collapse.from];
+				if (next == collapse.to) {
+					borderNext[prev] = collapse.to;
+					borderPrev[collapse.to] = prev;
+				} else {
+					borderPrev[next] = collapse.to;
+					borderNext[collapse.to] = next;
+				}
+				borderNext[collapse.from] = kInvalidIndex;
+				borderPrev[collapse.from] = kInvalidIndex;
+			}
+			isLocked[collapse.from] = true;
+			isLocked[collapse.to] = true;
+			maxError = (std::max)(maxError, double(collapse.error));
+			triangleCount -= removedCount;
+			++collapseCount;
+		}
+		if (collapseCount == 0) {
+			break;
+		}
+
+		// インデックスを付け直し、潰れた三角形を消す ----------------------------------------------
+		size_t writeIndex = 0;
+		for (size_t triangle = 0; triangle < result.size() / 3; ++triangle) {
+			const uint32_t a = remap[result[triangle * 3 + 0]];
+			const uint32_t b = remap[result[triangle * 3 + 1]];
+			const uint32_t c = remap[result[triangle * 3 + 2]];
+			if (a != b && b != c && c != a) {
+				result[writeIndex++] = a;
+				result[writeIndex++] = b;
+				result[writeIndex++] = c;
+			}
+		}
+		result.resize(writeIndex);
+	}
+
+	// 元の頂点の番号に戻す
+	for (size_t index = 0; index < result.size(); ++index) {
+		destination[index] = usedVertices[result[index]];
+	}
+	if (outError) {
+		*outError = static_cast<float>(std::sqrt(maxError) * extent);
+	}
+	return result.size();
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "MeshData.h"
+
+/*================================================================================================
+二次誤差(QEM)でのメッシュの簡略化(焼く時用。D3D12は使わない)
+頂点を隣の頂点へ寄せて(辺を縮めて)三角形を減らす。新しい頂点は作らないので、
+簡略化した結果は元の頂点バッファを指すインデックスだけになり、LODの全段で頂点バッファを共有できる
+
+	・位置が同じでUVが違う頂点(UVの継ぎ目)は動かさないので、継ぎ目は崩れない
+	・穴・メッシュの端は端に沿ってだけ縮める
+	・三角形が裏返る縮め方はしない
+関数は状態を持たないので、メッシュごとに別のスレッドから呼べる
+==================================================================================================*/
+
+/// <summary>
+/// インデックスを減らす
+/// </summary>
+/// <param name="destination">indexCount個分の領域(indicesと同じでも良い)</param>
+/// <param name="indices">元のインデックス(3つで1三角形)</param>
+/// <param name="indexCount"></param>
+/// <param name="vertices"></param>
+/// <param name="vertexCount"></param>
+/// <param name="targetIndexCount">ここまで減らす(誤差が先に上限に届けばそこで止まる)</param>
+/// <param name="targetError">許す誤差(元の形からのずれの目安。モデルの座標の単位)</param>
+/// <param name="outError">実際の誤差(不要ならnullptr)</param>
+/// <returns>destinationに書いたインデックスの数</returns>
+size_t SimplifyMesh(uint32_t* destination, const uint32_t* indices, size_t indexCount, const VertexData* vertices, size_t vertexCount, size_t targetIndexCount, float targetError, float* outError = nullptr);
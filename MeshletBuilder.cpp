@@ -0,0 +1,357 @@
+#include "MeshletBuilder.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+
+namespace {
+
+static const uint32_t kInvalidIndex = UINT32_MAX;
+static const uint8_t kNotInMeshlet = 0xFF;
+
+Vector3 ToVector3(const Vector4& v) {
+	return { v.x, v.y, v.z };
+}
+
+Vector3 Add(const Vector3& a, const Vector3& b) {
+	return { a.x + b.x, a.y + b.y, a.z + b.z };
+}
+
+Vector3 Subtract(const Vector3& a, const Vector3& b) {
+	return { a.x - b.x, a.y - b.y, a.z - b.z };
+}
+
+Vector3 Scale(const Vector3& v, float s) {
+	return { v.x * s, v.y * s, v.z * s };
+}
+
+float Dot(const Vector3& a, const Vector3& b) {
+	return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+float Length(const Vector3& v) {
+	return std::sqrt(Dot(v, v));
+}
+
+/// <summary>
+/// 三角形の表の向き(時計回りが表。面積がなければ0)
+/// </summary>
+Vector3 ComputeNormal(const Vector3& a, const Vector3& b, const Vector3& c) {
+	const Vector3 e1 = Subtract(b, a);
+	const Vector3 e2 = Subtract(c, a);
+	return { e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x };
+}
+
+/// <summary>
+/// 三角形の中心と向き(単位ベクトル)
+/// </summary>
+struct TriangleInfo {
+	Vector3 centroid;
+	Vector3 normal;
+};
+
+}
+
+//=============================================================================================================================
+//	塊に分ける
+//=============================================================================================================================
+size_t BuildMeshlets(MeshletData& data, const uint32_t* indices, size_t indexCount, const VertexData* vertices, size_t vertexCount,
+	float coneWeight, uint32_t maxVertices, uint32_t maxTriangles) {
+	assert(indexCount % 3 == 0);
+	assert(maxVertices >= 3 && maxVertices <= kMeshletMaxVertices);
+	assert(maxTriangles >= 1 && maxTriangles <= kMeshletMaxTriangles);
+	const size_t firstMeshlet = data.meshlets.size();
+	const size_t triangleCount = indexCount / 3;
+
+	// 三角形の中心・向き(使えない三角形は最初から使用済みにする) ------------------------------
+	std::vector<TriangleInfo> infos(triangleCount);
+	std::vector<uint8_t> isUsed(triangleCount, 0);
+	double meshArea = 0.0;
+	size_t validCount = 0;
+	for (size_t triangle = 0; triangle < triangleCount; ++triangle) {
+		const uint32_t a = indices[triangle * 3 + 0];
+		const uint32_t b = indices[triangle * 3 + 1];
+		const uint32_t c = indices[triangle * 3 + 2];
+		assert(a < vertexCount && b < vertexCount && c < vertexCount);
+		const Vector3 pa = ToVector3(vertices[a].pos);
+		const Vector3 pb = ToVector3(vertices[b].pos);
+		const Vector3 pc = ToVector3(vertices[c].pos);
+		const Vector3 normal = ComputeNormal(pa, pb, pc);
+		const float length = Length(normal);
+		if (a == b || b == c || c == a || length == 0.0f) {
+			isUsed[triangle] = 1;
+			continue;
+		}
+		infos[triangle].centroid = Scale(Add(Add(pa, pb), pc), 1.0f / 3.0f);
+		infos[triangle].normal = Scale(normal, 1.0f / length);
+		meshArea += length * 0.5;
+		++validCount;
+	}
+	if (validCount == 0) {
+		return 0;
+	}
+	// 塊1つの大きさの目安(近さの重みに使う)
+	const float expectedRadius = std::sqrt(static_cast<float>(meshArea / validCount) * maxTriangles) * 0.5f;
+
+	// 頂点 → 三角形の隣接(使った三角形は外していく) ------------------------------------------
+	std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+	std::vector<uint32_t> adjacencyCounts(vertexCount, 0);
+	for (size_t triangle = 0; triangle < triangleCount; ++triangle) {
+		if (!isUsed[triangle]) {
+			for (size_t corner = 0; corner < 3; ++corner) {
+				++adjacencyCounts[indices[triangle * 3 + corner]];
+			}
+		}
+	}
+	for (size_t vertex = 0; vertex < vertexCount; ++vertex) {
+		adjacencyOffsets[vertex + 1] = adjacencyOffsets[vertex] + adjacencyCounts[vertex];
+		adjacencyCounts[vertex] = 0;
+	}
+	std::vector<uint32_t> adjacency(adjacencyOffsets[vertexCount]);
+	for (size_t triangle = 0; triangle < triangleCount; ++triangle) {
+		if (!isUsed[triangle]) {
+			for (size_t corner = 0; corner < 3; ++corner) {
+				const uint32_t vertex = indices[triangle * 3 + corner];
+				adjacency[adjacencyOffsets[vertex] + adjacencyCounts[vertex]++] = static_cast<uint32_t>(triangle);
+			}
+		}
+	}
+	auto removeTriangle = [&](uint32_t triangle) {
+		isUsed[triangle] = 1;
+		for (size_t corner = 0; corner < 3; ++corner) {
+			const uint32_t vertex = indices[triangle * 3 + corner];
+			uint32_t* list = adjacency.data() + adjacencyOffsets[vertex];
+			uint32_t& count = adjacencyCounts[vertex];
+			for (uint32_t index = 0; index < count; ++index) {
+				if (list[index] == triangle) {
+					list[index] = list[--count];
+					break;
+				}
+			}
+		}
+	};
+
+	// 今作っている塊 ----------------------------------------------------------------------
+	std::vector<uint8_t> localIndices(vertexCount, kNotInMeshlet);
+	Meshlet meshlet{ static_cast<uint32_t>(data.vertices.size()), static_cast<uint32_t>(data.triangles.size()), 0, 0 };
+	Vector3 centroidSum{ 0.0f, 0.0f, 0.0f };
+	Vector3 normalSum{ 0.0f, 0.0f, 0.0f };
+
+	auto flush = [&]() {
+		if (meshlet.triangleCount == 0) {
+			return;
+		}
+		for (uint32_t index = 0; index < meshlet.vertexCount; ++index) {
+			localIndices[data.vertices[meshlet.vertexOffset + index]] = kNotInMeshlet;
+		}
+		data.meshlets.push_back(meshlet);
+		meshlet = { static_cast<uint32_t>(data.vertices.size()), static_cast<uint32_t>(data.triangles.size()), 0, 0 };
+		centroidSum = { 0.0f, 0.0f, 0.0f };
+		normalSum = { 0.0f, 0.0f, 0.0f };
+	};
+	// 入れると増える頂点の数
+	auto countExtraVertices = [&](uint32_t triangle) {
+		uint32_t extra = 0;
+		for (size_t corner = 0; corner < 3; ++corner) {
+			extra += localIndices[indices[triangle * 3 + corner]] == kNotInMeshlet ? 1 : 0;
+		}
+		return extra;
+	};
+	auto addTriangle = [&](uint32_t triangle) {
+		if (meshlet.vertexCount + countExtraVertices(triangle) > maxVertices || meshlet.triangleCount == maxTriangles) {
+			flush();
+		}
+		for (size_t corner = 0; corner < 3; ++corner) {
+			const uint32_t vertex = indices[triangle * 3 + corner];
+			if (localIndices[vertex] == kNotInMeshlet) {
+				localIndices[vertex] = static_cast<uint8_t>(meshlet.vertexCount++);
+				data.vertices.push_back(vertex);
+			}
+			data.triangles.push_back(localIndices[vertex]);
+		}
+		++meshlet.triangleCount;
+		centroidSum = Add(centroidSum, infos[triangle].centroid);
+		normalSum = Add(normalSum, infos[triangle].normal);
+		removeTriangle(triangle);
+	};
+	// 小さいほど良い。塊の中心に近く、向きが塊の平均にそろっているもの
+	auto score = [&](uint32_t triangle) {
+		const Vector3 center = Scale(centroidSum, 1.0f / float(meshlet.triangleCount));
+		const float distance = Length(Subtract(infos[triangle].centroid, center));
+		const float normalLength = Length(normalSum);
+		const float spread = normalLength > 0.0f ? Dot(infos[triangle].normal, normalSum) / normalLength : 1.0f;
+		const float cone = (std::max)(1.0f - spread * coneWeight, 1e-3f);
+		return (1.0f + distance / expectedRadius * (1.0f - coneWeight)) * cone;
+	};
+
+	// 塊の頂点を使う三角形から選ぶ(頂点を増やさないものを優先して、塊の頂点を少なく保つ)
+	// hasNeighborは入らなかったものも含めて隣が残っていたか
+	auto findBest = [&](bool& hasNeighbor) {
+		uint32_t best = kInvalidIndex;
+		uint32_t bestExtra = 4;
+		float bestScore = FLT_MAX;
+		hasNeighbor = false;
+		for (uint32_t index = 0; index < meshlet.vertexCount; ++index) {
+			const uint32_t vertex = data.vertices[meshlet.vertexOffset + index];
+			const uint32_t* list = adjacency.data() + adjacencyOffsets[vertex];
+			for (uint32_t neighbor = 0; neighbor < adjacencyCounts[vertex]; ++neighbor) {
+				const uint32_t triangle = list[neighbor];
+				hasNeighbor = true;
+				const uint32_t extra = countExtraVertices(triangle);
+				if (meshlet.vertexCount + extra > maxVertices || extra > bestExtra) {
+					continue;
+				}
+				const float triangleScore = score(triangle);
+				if (extra < bestExtra || triangleScore < bestScore) {
+					best = triangle;
+					bestExtra = extra;
+					bestScore = triangleScore;
+				}
+			}
+		}
+		return best;
+	};
+
+	// 次の塊の始まり。直前の塊の隣のうち、周りに残っている三角形が少ない所(端)から始めると
+	// 取り残された小さな島ができにくい。隣がなければインデックスの順に探す
+	size_t seedCursor = 0;
+	auto findSeed = [&]() {
+		uint32_t best = kInvalidIndex;
+		uint32_t bestLiveCount = UINT32_MAX;
+		if (data.meshlets.size() > firstMeshlet) {
+			const Meshlet& previous = data.meshlets.back();
+			for (uint32_t index = 0; index < previous.vertexCount; ++index) {
+				const uint32_t vertex = data.vertices[previous.vertexOffset + index];
+				const uint32_t* list = adjacency.data() + adjacencyOffsets[vertex];
+				for (uint32_t neighbor = 0; neighbor < adjacencyCounts[vertex]; ++neighbor) {
+					const uint32_t triangle = list[neighbor];
+					uint32_t liveCount = 0;
+					for (size_t corner = 0; corner < 3; ++corner) {
+						liveCount += adjacencyCounts[indices[triangle * 3 + corner]];
+					}
+					if (liveCount < bestLiveCount) {
+						best = triangle;
+						bestLiveCount = liveCount;
+					}
+				}
+			}
+		}
+		if (best != kInvalidIndex) {
+			return best;
+		}
+		while (seedCursor < triangleCount && isUsed[seedCursor]) {
+			++seedCursor;
+		}
+		return seedCursor < triangleCount ? static_cast<uint32_t>(seedCursor) : kInvalidIndex;
+	};
+
+	// 組み立て --------------------------------------------------------------------------
+	for (;;) {
+		if (meshlet.triangleCount == maxTriangles) {
+			flush();
+		}
+		uint32_t next = kInvalidIndex;
+		if (meshlet.triangleCount != 0) {
+			bool hasNeighbor = false;
+			next = findBest(hasNeighbor);
+			if (next == kInvalidIndex) {
+				if (hasNeighbor) {
+					// 隣はあるが頂点が入りきらない
+					flush();
+				} else {
+					// 島を使い切った。近くの島なら同じ塊に続けて入れる(小さな島ばかりの塊にならないように)
+					while (seedCursor < triangleCount && isUsed[seedCursor]) {
+						++seedCursor;
+					}
+					if (seedCursor == triangleCount) {
+						break;
+					}
+					const Vector3 center = Scale(centroidSum, 1.0f / float(meshlet.triangleCount));
+					if (Length(Subtract(infos[seedCursor].centroid, center)) <= expectedRadius * 2.0f) {
+						next = static_cast<uint32_t>(seedCursor);
+					} else {
+						flush();
+					}
+				}
+			}
+		}
+		if (next == kInvalidIndex) {
+			next = findSeed();
+			if (next == kInvalidIndex) {
+				break;
+			}
+		}
+		addTriangle(next);
+	}
+	flush();
+
+	// カリング用の情報 -------------------------------------------------------------------
+	for (size_t index = firstMeshlet; index < data.meshlets.size(); ++index) {
+		const Meshlet& result = data.meshlets[index];
+		data.bounds.push_back(ComputeMeshletBounds(data.vertices.data() + result.vertexOffset, result.vertexCount,
+			data.triangles.data() + result.triangleOffset, result.triangleCount, vertices));
+	}
+	return data.meshlets.size() - firstMeshlet;
+}
+
+//=============================================================================================================================
+//	カリング用の情報
+//=============================================================================================================================
+MeshletBounds ComputeMeshletBounds(const uint32_t* meshletVertices, uint32_t vertexCount, const uint8_t* meshletTriangles, uint32_t triangleCount, const VertexData* vertices) {
+	assert(triangleCount <= kMeshletMaxTriangles);
+	MeshletBounds bounds{};
+	bounds.coneAxis = { 0.0f, 0.0f, 1.0f };
+	bounds.coneCutoff = 1.0f;
+	if (vertexCount == 0) {
+		return bounds;
+	}
+
+	// バウンディングスフィア(箱の中心から一番遠い頂点まで) ---------------------------------------
+	Vector3 min = ToVector3(vertices[meshletVertices[0]].pos);
+	Vector3 max = min;
+	for (uint32_t index = 1; index < vertexCount; ++index) {
+		const Vector3 pos = ToVector3(vertices[meshletVertices[index]].pos);
+		min = { (std::min)(min.x, pos.x), (std::min)(min.y, pos.y), (std::min)(min.z, pos.z) };
+		max = { (std::max)(max.x, pos.x), (std::max)(max.y, pos.y), (std::max)(max.z, pos.z) };
+	}
+	bounds.center = Scale(Add(min, max), 0.5f);
+	float radiusSquared = 0.0f;
+	for (uint32_t index = 0; index < vertexCount; ++index) {
+		const Vector3 offset = Subtract(ToVector3(vertices[meshletVertices[index]].pos), bounds.center);
+		radiusSquared = (std::max)(radiusSquared, Dot(offset, offset));
+	}
+	bounds.radius = std::sqrt(radiusSquared);
+
+	// 法線の円錐 ---------------------------------------------------------------------------
+	Vector3 normals[kMeshletMaxTriangles];
+	uint32_t normalCount = 0;
+	Vector3 normalSum{ 0.0f, 0.0f, 0.0f };
+	for (uint32_t triangle = 0; triangle < triangleCount; ++triangle) {
+		const Vector3 a = ToVector3(vertices[meshletVertices[meshletTriangles[triangle * 3 + 0]]].pos);
+		const Vector3 b = ToVector3(vertices[meshletVertices[meshletTriangles[triangle * 3 + 1]]].pos);
+		const Vector3 c = ToVector3(vertices[meshletVertices[meshletTriangles[triangle * 3 + 2]]].pos);
+		const Vector3 normal = ComputeNormal(a, b, c);
+		const float length = Length(normal);
+		if (length == 0.0f) {
+			continue;
+		}
+		normals[normalCount] = Scale(normal, 1.0f / length);
+		normalSum = Add(normalSum, normals[normalCount]);
+		++normalCount;
+	}
+	const float axisLength = Length(normalSum);
+	if (axisLength == 0.0f) {
+		return bounds;
+	}
+	bounds.coneAxis = Scale(normalSum, 1.0f / axisLength);
+	float minDot = 1.0f;
+	for (uint32_t index = 0; index < normalCount; ++index) {
+		minDot = (std::min)(minDot, Dot(normals[index], bounds.coneAxis));
+	}
+	// 半角が90度に近い円錐では裏向きになる所がほとんどないので、判定しない(coneCutoff = 1)
+	if (minDot > 0.1f) {
+		bounds.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+	}
+	return bounds;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "MeshData.h"
+#include "Vector3.h"
+
+/*================================================================================================
+メッシュレット(三角形の小さな塊)の作成(焼く時用。D3D12は使わない)
+隣り合う三角形を、頂点の共有が多く・近く・向きがそろったものから順に1つの塊へ足していく
+塊ごとにバウンディングスフィアと法線の円錐を持たせ、実行時に塊ごとカリングできるようにする(MeshletCulling.h)
+
+	Meshlet          頂点 vertices[vertexOffset, +vertexCount)(メッシュの頂点番号)
+	                 三角形 triangles[triangleOffset, +triangleCount * 3)(塊の中の頂点番号。8bit)
+	MeshletBounds    法線の円錐(coneAxis, coneCutoff)に塊の三角形の向きが全て収まる
+==================================================================================================*/
+
+/// 1つの塊の頂点数・三角形数の上限(メッシュシェーダでも扱える大きさ)
+static const uint32_t kMeshletMaxVertices = 64;
+static const uint32_t kMeshletMaxTriangles = 124;
+
+/// <summary>
+/// 三角形の塊
+/// </summary>
+struct Meshlet {
+	uint32_t vertexOffset;
+	uint32_t triangleOffset;	// MeshletData::trianglesの位置(三角形1つで3つ)
+	uint32_t vertexCount;
+	uint32_t triangleCount;
+};
+static_assert(sizeof(Meshlet) == 16, "Meshlet must be 16 bytes");
+
+/// <summary>
+/// 塊のカリング用の情報(メッシュの座標)
+/// </summary>
+struct MeshletBounds {
+	Vector3 center;
+	float radius;
+	Vector3 coneAxis;			// 三角形の向き(表)の平均
+	float coneCutoff;			// 円錐の半角の正弦(1なら向きがばらばらで裏向きの判定はできない)
+};
+static_assert(sizeof(MeshletBounds) == 32, "MeshletBounds must be 32 bytes");
+
+/// <summary>
+/// 作った塊(BuildMeshletsは後ろに足していくので、サブメッシュ・LODごとに呼んで1つにまとめられる)
+/// </summary>
+struct MeshletData {
+	std::vector<Meshlet> meshlets;
+	std::vector<MeshletBounds> bounds;		// meshletsと同じ数
+	std::vector<uint32_t> vertices;
+	std::vector<uint8_t> triangles;
+};
+
+/// <summary>
+/// インデックスの範囲を塊に分けてdataの後ろに足す(面積のない三角形・同じ頂点を2回使う三角形は捨てる)
+/// </summary>
+/// <param name="data"></param>
+/// <param name="indices">3つで1三角形(OptimizeVertexCache済みだと塊が空間的にまとまりやすい)</param>
+/// <param name="indexCount"></param>
+/// <param name="vertices"></param>
+/// <param name="vertexCount"></param>
+/// <param name="coneWeight">向きをそろえる強さ(0 ~ 1。大きいほど裏向きで捨てやすく、塊の形は粗くなる)</param>
+/// <param name="maxVertices">kMeshletMaxVertices以下</param>
+/// <param name="maxTriangles">kMeshletMaxTriangles以下</param>
+/// <returns>足した塊の数</returns>
+size_t BuildMeshlets(MeshletData& data, const uint32_t* indices, size_t indexCount, const VertexData* vertices, size_t vertexCount,
+	float coneWeight = 0.25f, uint32_t maxVertices = kMeshletMaxVertices, uint32_t maxTriangles = kMeshletMaxTriangles);
+
+/// <summary>
+/// 塊のバウンディングスフィアと法線の円錐を求める
+/// </summary>
+/// <param name="meshletVertices">塊の頂点(メッシュの頂点番号)</param>
+/// <param name="vertexCount"></param>
+/// <param name="meshletTriangles">塊の三角形(塊の中の頂点番号)</param>
+/// <param name="triangleCount"></param>
+/// <param name="vertices"></param>
+/// <returns></returns>
+MeshletBounds ComputeMeshletBounds(const uint32_t* meshletVertices, uint32_t vertexCount, const uint8_t* meshletTriangles, uint32_t triangleCount, const VertexData* vertices);
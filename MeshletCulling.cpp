@@ -0,0 +1,112 @@
+#include "MeshletCulling.h"
+
+#include <cmath>
+
+namespace {
+
+// 拡縮が等しいとみなす差(長さの2乗の比)
+const float kUniformScaleTolerance = 1e-3f;
+
+}
+
+void MeshletCullStats::Add(const MeshletCullStats& other) {
+	meshletCount += other.meshletCount;
+	visibleCount += other.visibleCount;
+	frustumCulledCount += other.frustumCulledCount;
+	backfaceCulledCount += other.backfaceCulledCount;
+	triangleCount += other.triangleCount;
+	visibleTriangleCount += other.visibleTriangleCount;
+}
+
+//=============================================================================================================================
+//	判定
+//=============================================================================================================================
+Frustum MakeFrustum(const Matrix4x4& matrix) {
+	// 行ベクトルに右から掛けるので、クリップ座標の各成分は行列の列との内積
+	auto column = [&](int index) {
+		return Vector4{ matrix.m[0][index], matrix.m[1][index], matrix.m[2][index], matrix.m[3][index] };
+	};
+	auto add = [](const Vector4& a, const Vector4& b) { return Vector4{ a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w }; };
+	auto subtract = [](const Vector4& a, const Vector4& b) { return Vector4{ a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w }; };
+	const Vector4 x = column(0);
+	const Vector4 y = column(1);
+	const Vector4 z = column(2);
+	const Vector4 w = column(3);
+
+	Frustum frustum{};
+	frustum.planes[0] = add(w, x);			// 左   -w <= x
+	frustum.planes[1] = subtract(w, x);		// 右   x <= w
+	frustum.planes[2] = add(w, y);			// 下   -w <= y
+	frustum.planes[3] = subtract(w, y);		// 上   y <= w
+	frustum.planes[4] = z;					// 手前 0 <= z
+	frustum.planes[5] = subtract(w, z);		// 奥   z <= w
+	for (Vector4& plane : frustum.planes) {
+		const float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+		if (length > 0.0f) {
+			plane = { plane.x / length, plane.y / length, plane.z / length, plane.w / length };
+		}
+	}
+	return frustum;
+}
+
+bool IsSphereVisible(const Frustum& frustum, const Vector3& center, float radius) {
+	for (const Vector4& plane : frustum.planes) {
+		if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool IsUniformScale(const Matrix4x4& world) {
+	// 行ベクトルなので、上3行がそれぞれx, y, z軸の拡縮・回転
+	float lengths[3];
+	for (int row = 0; row < 3; ++row) {
+		lengths[row] = world.m[row][0] * world.m[row][0] + world.m[row][1] * world.m[row][1] + world.m[row][2] * world.m[row][2];
+	}
+	const float tolerance = lengths[0] * kUniformScaleTolerance;
+	if (std::fabs(lengths[1] - lengths[0]) > tolerance || std::fabs(lengths[2] - lengths[0]) > tolerance) {
+		return false;
+	}
+	// 反転していると三角形の表裏が入れ替わる
+	const float determinant =
+		world.m[0][0] * (world.m[1][1] * world.m[2][2] - world.m[1][2] * world.m[2][1]) -
+		world.m[0][1] * (world.m[1][0] * world.m[2][2] - world.m[1][2] * world.m[2][0]) +
+		world.m[0][2] * (world.m[1][0] * world.m[2][1] - world.m[1][1] * world.m[2][0]);
+	return determinant > 0.0f;
+}
+
+bool IsMeshletBackfacing(const MeshletBounds& bounds, const Vector3& cameraPosition) {
+	// カメラから中心への向きと円錐の軸の角度が (90度 - 円錐の半角) より小さければ、どの三角形も裏を向けている
+	// 中心以外の点から見た分は半径の分だけ余裕を取る
+	const Vector3 offset = { bounds.center.x - cameraPosition.x, bounds.center.y - cameraPosition.y, bounds.center.z - cameraPosition.z };
+	const float distance = std::sqrt(offset.x * offset.x + offset.y * offset.y + offset.z * offset.z);
+	const float dot = offset.x * bounds.coneAxis.x + offset.y * bounds.coneAxis.y + offset.z * bounds.coneAxis.z;
+	return dot >= bounds.coneCutoff * distance + bounds.radius;
+}
+
+uint32_t CullMeshlets(const Meshlet* meshlets, const MeshletBounds* bounds, uint32_t meshletCount, const Frustum& frustum, const Vector3& cameraPosition,
+	bool cullBackfaces, uint32_t* outVisible, MeshletCullStats* stats) {
+	MeshletCullStats result;
+	result.meshletCount = meshletCount;
+	for (uint32_t index = 0; index < meshletCount; ++index) {
+		result.triangleCount += meshlets[index].triangleCount;
+		if (!IsSphereVisible(frustum, bounds[index].center, bounds[index].radius)) {
+			++result.frustumCulledCount;
+			continue;
+		}
+		if (cullBackfaces && IsMeshletBackfacing(bounds[index], cameraPosition)) {
+			++result.backfaceCulledCount;
+			continue;
+		}
+		if (outVisible) {
+			outVisible[result.visibleCount] = index;
+		}
+		++result.visibleCount;
+		result.visibleTriangleCount += meshlets[index].triangleCount;
+	}
+	if (stats) {
+		stats->Add(result);
+	}
+	return result.visibleCount;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+
+#include "MeshletBuilder.h"
+#include "MyMatrix.h"
+#include "Vector3.h"
+#include "Vector4.h"
+
+/*================================================================================================
+メッシュレットのカリング(CPU。描画・ExecuteIndirectの引数を組み立てる前に塊ごと捨てる)
+	視錐台    バウンディングスフィアが視錐台の外
+	裏向き    法線の円錐がカメラから見て全て裏向き(ラスタライザで裏面を捨てるパイプライン用)
+判定はメッシュの座標で行う。インスタンスごとにWVP行列とメッシュの座標でのカメラの位置を渡す
+視錐台の判定はどの変換でも正しいが、円錐の判定は拡縮が等倍の時だけ正しい(IsUniformScaleで確かめてから使う)
+==================================================================================================*/
+
+/// <summary>
+/// 視錐台の6平面(ax + by + cz + d >= 0 が内側。(a, b, c)は単位ベクトル)
+/// </summary>
+struct Frustum {
+	Vector4 planes[6];
+};
+
+/// <summary>
+/// 数えた結果
+/// </summary>
+struct MeshletCullStats {
+	uint32_t meshletCount = 0;
+	uint32_t visibleCount = 0;
+	uint32_t frustumCulledCount = 0;
+	uint32_t backfaceCulledCount = 0;
+	uint32_t triangleCount = 0;
+	uint32_t visibleTriangleCount = 0;
+
+	/// 捨てた三角形の割合(0 ~ 1)
+	float GetCulledTriangleRatio() const { return triangleCount == 0 ? 0.0f : 1.0f - float(visibleTriangleCount) / float(triangleCount); }
+
+	void Add(const MeshletCullStats& other);
+};
+
+/// <summary>
+/// 行列を掛ける前の座標での視錐台を作る(WVPを渡せばメッシュの座標、VPならワールド座標)
+/// </summary>
+/// <param name="matrix"></param>
+/// <returns></returns>
+Frustum MakeFrustum(const Matrix4x4& matrix);
+
+/// <summary>
+/// 球が視錐台と重なるか
+/// </summary>
+bool IsSphereVisible(const Frustum& frustum, const Vector3& center, float radius);
+
+/// <summary>
+/// ワールド行列の拡縮がxyzで等しく、反転していないか(法線の円錐をそのまま使えるか)
+/// </summary>
+bool IsUniformScale(const Matrix4x4& world);
+
+/// <summary>
+/// 塊の三角形がカメラから見て全て裏向きか
+/// </summary>
+bool IsMeshletBackfacing(const MeshletBounds& bounds, const Vector3& cameraPosition);
+
+/// <summary>
+/// 見える塊の番号を集める
+/// </summary>
+/// <param name="meshlets"></param>
+/// <param name="bounds"></param>
+/// <param name="meshletCount"></param>
+/// <param name="frustum">メッシュの座標での視錐台</param>
+/// <param name="cameraPosition">メッシュの座標でのカメラの位置</param>
+/// <param name="cullBackfaces">裏向きの判定もするか(ワールド行列がIsUniformScaleでない時はfalse)</param>
+/// <param name="outVisible">meshletCount個分の領域(不要ならnullptr)</param>
+/// <param name="stats">足していく(不要ならnullptr)</param>
+/// <returns>見える塊の数</returns>
+uint32_t CullMeshlets(const Meshlet* meshlets, const MeshletBounds* bounds, uint32_t meshletCount, const Frustum& frustum, const Vector3& cameraPosition,
+	bool cullBackfaces, uint32_t* outVisible, MeshletCullStats* stats = nullptr);
@@ -0,0 +1,648 @@
+#include "ObjLoader.h"
+
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+#include <unordered_map>
+
+#include "Function/MappedFile.h"
+#include "Function/ThreadPool.h"
+
+namespace {
+
+// 1つの塊の大きさの下限(小さいファイルは分けない)
+static const size_t kMinChunkSize = 1024 * 1024;
+// ワーカー1つあたりの塊の数(行の長さの偏りをならす)
+static const size_t kChunksPerThread = 4;
+
+// 負の(相対)インデックスは塊の中の番号に直し、このバイアスを引いて正のインデックスと区別する
+static const int32_t kRelativeIndexBias = 1 << 30;
+static const uint32_t kNoTexcoord = UINT32_MAX;
+static const uint32_t kNoVertex = UINT32_MAX;
+// 範囲外の番号を使うので捨てる三角形の印(1つ目の頂点に入れる)
+static const uint64_t kInvalidCorner = UINT64_MAX;
+
+/// <summary>
+/// 面の頂点(ファイルに書かれた番号のまま)
+/// </summary>
+struct ObjCorner {
+	int32_t position;
+	int32_t texcoord;		// 0はUVなし
+};
+
+/// <summary>
+/// usemtl が出てきた位置
+/// </summary>
+struct ObjMaterialSwitch {
+	uint32_t triangle;		// この三角形からマテリアルが変わる
+	std::string name;
+};
+
+/// <summary>
+/// 行の区切りで分けたファイルの一部と、そこから読んだ値
+/// </summary>
+struct ObjChunk {
+	const char* begin = nullptr;
+	const char* end = nullptr;
+
+	std::vector<float> positions;				// x, y, z
+	std::vector<float> texcoords;				// u, v
+	std::vector<ObjCorner> corners;				// 3つで1三角形(多角形は扇形に分ける)
+	std::vector<ObjMaterialSwitch> materialSwitches;
+	std::vector<std::string> materialLibraries;
+	uint32_t skippedLineCount = 0;				// 読めない・知らない行
+	uint32_t skippedTriangleCount = 0;			// 範囲外の番号を使う三角形
+	std::string firstSkippedLine;
+};
+
+//=============================================================================================================================
+//	字句
+//=============================================================================================================================
+
+inline bool IsSpace(char c) {
+	return c == ' ' || c == '\t';
+}
+
+inline bool IsLineEnd(char c) {
+	return c == '\n' || c == '\r';
+}
+
+inline const char* SkipSpaces(const char* p, const char* end) {
+	while (p < end && IsSpace(*p)) {
+		++p;
+	}
+	return p;
+}
+
+inline const char* SkipLine(const char* p, const char* end) {
+	const char* newLine = static_cast<const char*>(std::memchr(p, '\n', end - p));
+	return newLine ? newLine + 1 : end;
+}
+
+/// <summary>
+/// 行頭のキーワードか(後ろが空白であること)
+/// </summary>
+inline bool IsKeyword(const char* p, const char* end, const char* keyword, size_t length) {
+	return static_cast<size_t>(end - p) > length && std::memcmp(p, keyword, length) == 0 && IsSpace(p[length]);
+}
+
+/// <summary>
+/// 行の残り(前後の空白を除く)
+/// </summary>
+std::string ReadRestOfLine(const char* p, const char* end) {
+	p = SkipSpaces(p, end);
+	const char* last = p;
+	while (last < end && !IsLineEnd(*last)) {
+		++last;
+	}
+	while (last > p && IsSpace(last[-1])) {
+		--last;
+	}
+	return std::string(p, last);
+}
+
+/// <summary>
+/// 空白の後の小数を読む。行末なら読まずにfalse
+/// </summary>
+inline bool ParseFloat(const char*& p, const char* end, float& out) {
+	p = SkipSpaces(p, end);
+	// from_charsは先頭の+を受け付けない
+	if (p < end && *p == '+') {
+		++p;
+	}
+	const std::from_chars_result result = std::from_chars(p, end, out);
+	if (result.ec == std::errc::invalid_argument) {
+		return false;
+	}
+	// 表せない大きさ・小ささは0にしておく
+	if (result.ec == std::errc::result_out_of_range) {
+		out = 0.0f;
+	}
+	p = result.ptr;
+	return true;
+}
+
+/// <summary>
+/// 符号付きの整数を読む(空白は飛ばさない)
+/// 絶対値がkRelativeIndexBiasを超える番号は頂点数も超えているので、読めない扱いにする(EncodeIndexであふれない)
+/// </summary>
+inline bool ParseIndex(const char*& p, const char* end, int32_t& out) {
+	const bool isNegative = p < end && *p == '-';
+	if (isNegative) {
+		++p;
+	}
+	if (p >= end || static_cast<unsigned>(*p - '0') > 9) {
+		return false;
+	}
+	int32_t value = 0;
+	while (p < end && static_cast<unsigned>(*p - '0') <= 9) {
+		const int32_t digit = *p - '0';
+		if (value > (kRelativeIndexBias - digit) / 10) {
+			return false;
+		}
+		value = value * 10 + digit;
+		++p;
+	}
+	out = isNegative ? -value : value;
+	return true;
+}
+
+/// <summary>
+/// 負のインデックスを塊の中の番号にする(正はそのまま)
+/// </summary>
+inline int32_t EncodeIndex(int32_t index, size_t localCount) {
+	return index < 0 ? static_cast<int32_t>(localCount) + index - kRelativeIndexBias : index;
+}
+
+/// <summary>
+/// ファイル全体の0始まりの番号にする(範囲外はUINT32_MAX)
+/// </summary>
+inline uint32_t DecodeIndex(int32_t index, size_t chunkBase, size_t totalCount) {
+	const int64_t absolute = index < 0 ? int64_t(chunkBase) + index + kRelativeIndexBias : int64_t(index) - 1;
+	return absolute >= 0 && absolute < int64_t(totalCount) ? static_cast<uint32_t>(absolute) : UINT32_MAX;
+}
+
+//=============================================================================================================================
+//	塊の解析
+//=============================================================================================================================
+
+/// <summary>
+/// 読まないが、書かれていてもよい行か(空行・コメント・法線・グループなど)
+/// </summary>
+bool IsIgnoredLine(const char* p, const char* end) {
+	if (p >= end || IsLineEnd(*p) || *p == '#') {
+		return true;
+	}
+	const char* last = p;
+	while (last < end && !IsSpace(*last) && !IsLineEnd(*last)) {
+		++last;
+	}
+	const std::string_view keyword(p, last - p);
+	return keyword == "vn" || keyword == "vp" || keyword == "o" || keyword == "g" || keyword == "s" || keyword == "l" || keyword == "p";
+}
+
+/// <summary>
+/// 読めない行を数える(最初の1行は警告用に残す)
+/// </summary>
+void SkipBadLine(ObjChunk& chunk, const char* p, const char* end) {
+	if (chunk.skippedLineCount++ == 0) {
+		chunk.firstSkippedLine = ReadRestOfLine(p, end);
+	}
+}
+
+/// <summary>
+/// 面を三角形に分けて足す
+/// </summary>
+/// <returns>番号が読めない・頂点が3つ未満ならfalse(何も足さない)</returns>
+bool ParseFace(const char* p, const char* end, ObjChunk& chunk) {
+	const size_t positionCount = chunk.positions.size() / 3;
+	const size_t texcoordCount = chunk.texcoords.size() / 2;
+	ObjCorner first{};
+	ObjCorner previous{};
+	uint32_t cornerCount = 0;
+	const size_t firstCorner = chunk.corners.size();
+	auto discard = [&]() {
+		chunk.corners.resize(firstCorner);
+		return false;
+	};
+	for (;;) {
+		p = SkipSpaces(p, end);
+		if (p >= end || IsLineEnd(*p) || *p == '#') {
+			break;
+		}
+		// v, v/vt, v//vn, v/vt/vn
+		int32_t position = 0;
+		int32_t texcoord = 0;
+		int32_t normal = 0;
+		if (!ParseIndex(p, end, position) || position == 0) {
+			return discard();
+		}
+		if (p < end && *p == '/') {
+			++p;
+			if (p < end && *p != '/' && !ParseIndex(p, end, texcoord)) {
+				return discard();
+			}
+			if (p < end && *p == '/') {
+				++p;
+				if (p < end && !IsSpace(*p) && !IsLineEnd(*p) && !ParseIndex(p, end, normal)) {
+					return discard();
+				}
+			}
+		}
+		const ObjCorner corner = { EncodeIndex(position, positionCount), texcoord == 0 ? 0 : EncodeIndex(texcoord, texcoordCount) };
+
+		// 扇形に三角形へ分ける
+		if (cornerCount == 0) {
+			first = corner;
+		} else if (cornerCount >= 2) {
+			chunk.corners.push_back(first);
+			chunk.corners.push_back(previous);
+			chunk.corners.push_back(corner);
+		}
+		previous = corner;
+		++cornerCount;
+	}
+	if (cornerCount < 3) {
+		return discard();
+	}
+	return true;
+}
+
+void ParseChunk(ObjChunk& chunk) {
+	const char* p = chunk.begin;
+	const char* end = chunk.end;
+	// 1行あたり20byte程度として先に確保する
+	const size_t estimatedLines = static_cast<size_t>(end - p) / 20;
+	chunk.positions.reserve(estimatedLines * 3 / 2);
+	chunk.corners.reserve(estimatedLines * 3);
+
+	while (p < end) {
+		p = SkipSpaces(p, end);
+		if (p >= end) {
+			break;
+		}
+		const char c = *p;
+		bool isValid = true;
+		if (c == 'v' && IsKeyword(p, end, "v", 1)) {
+			// w や頂点カラーは読まない
+			// 読めなくても後ろの番号がずれないように、読めなかった成分は0にして足す
+			const char* cursor = p + 1;
+			float x = 0.0f, y = 0.0f, z = 0.0f;
+			isValid = ParseFloat(cursor, end, x) && ParseFloat(cursor, end, y) && ParseFloat(cursor, end, z);
+			chunk.positions.push_back(x);
+			chunk.positions.push_back(y);
+			chunk.positions.push_back(z);
+		} else if (c == 'v' && IsKeyword(p, end, "vt", 2)) {
+			// vは省略されることがある
+			const char* cursor = p + 2;
+			float u = 0.0f, v = 0.0f;
+			isValid = ParseFloat(cursor, end, u);
+			if (isValid) {
+				ParseFloat(cursor, end, v);
+			}
+			chunk.texcoords.push_back(u);
+			chunk.texcoords.push_back(v);
+		} else if (c == 'f' && IsKeyword(p, end, "f", 1)) {
+			isValid = ParseFace(p + 1, end, chunk);
+		} else if (c == 'u' && IsKeyword(p, end, "usemtl", 6)) {
+			chunk.materialSwitches.push_back({ static_cast<uint32_t>(chunk.corners.size() / 3), ReadRestOfLine(p + 6, end) });
+		} else if (c == 'm' && IsKeyword(p, end, "mtllib", 6)) {
+			chunk.materialLibraries.push_back(ReadRestOfLine(p + 6, end));
+		} else {
+			// vn, o, g, s, # などは読み飛ばす。それ以外(自由曲面など)は読めない行として数える
+			isValid = IsIgnoredLine(p, end);
+		}
+		if (!isValid) {
+			SkipBadLine(chunk, p, end);
+		}
+		p = SkipLine(p, end);
+	}
+}
+
+/// <summary>
+/// 行の区切りで塊に分ける
+/// </summary>
+std::vector<ObjChunk> SplitChunks(const char* data, size_t size, uint32_t threadCount) {
+	const size_t chunkSize = (std::max)(kMinChunkSize, size / (size_t(threadCount) * kChunksPerThread) + 1);
+	std::vector<ObjChunk> chunks;
+	const char* end = data + size;
+	const char* begin = data;
+	while (begin < end) {
+		const char* split = begin + (std::min)(chunkSize, static_cast<size_t>(end - begin));
+		// 行の途中で切らない
+		split = split < end ? SkipLine(split, end) : end;
+		ObjChunk& chunk = chunks.emplace_back();
+		chunk.begin = begin;
+		chunk.end = split;
+		begin = split;
+	}
+	return chunks;
+}
+
+/// <summary>
+/// 塊ごとの処理を(あれば)ワーカーで回す
+/// </summary>
+template<typename Function>
+void ForEachChunk(std::vector<ObjChunk>& chunks, ThreadPool* threadPool, const Function& function) {
+	if (!threadPool || chunks.size() == 1) {
+		for (size_t index = 0; index < chunks.size(); ++index) {
+			function(index);
+		}
+		return;
+	}
+	for (size_t index = 0; index < chunks.size(); ++index) {
+		threadPool->Submit([&function, index]() { function(index); });
+	}
+	threadPool->WaitIdle();
+}
+
+/// <summary>
+/// ファイル内に書かれたUTF-8のパス
+/// </summary>
+std::filesystem::path Utf8Path(const std::string& path) {
+	return std::filesystem::path(std::u8string(path.begin(), path.end()));
+}
+
+std::string ToUtf8String(const std::filesystem::path& path) {
+	const std::u8string result = path.generic_u8string();
+	return std::string(result.begin(), result.end());
+}
+
+float ElapsedMilliseconds(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// <summary>
+/// マテリアルを名前で探し、なければ名前だけのものを足す
+/// </summary>
+uint32_t FindOrAddMaterial(std::vector<ObjMaterial>& materials, std::unordered_map<std::string, uint32_t>& materialIndices, const std::string& name) {
+	auto found = materialIndices.find(name);
+	if (found != materialIndices.end()) {
+		return found->second;
+	}
+	const uint32_t index = static_cast<uint32_t>(materials.size());
+	materials.emplace_back().name = name;
+	materialIndices.emplace(name, index);
+	return index;
+}
+
+}
+
+//=============================================================================================================================
+//	OBJ
+//=============================================================================================================================
+bool LoadObj(const std::wstring& filePath, ObjModel& outModel, ThreadPool* threadPool, ObjLoadStats* outStats) {
+	const auto start = std::chrono::steady_clock::now();
+	outModel = {};
+
+	MappedFile file;
+	if (!file.Open(filePath)) {
+		return false;
+	}
+	const char* data = reinterpret_cast<const char*>(file.GetData());
+	const uint32_t threadCount = threadPool ? threadPool->GetThreadCount() : 1;
+
+	// 塊ごとに行を解析する ---------------------------------------------------------------
+	std::vector<ObjChunk> chunks = SplitChunks(data, file.GetSize(), threadCount);
+	ForEachChunk(chunks, threadPool, [&chunks](size_t index) {
+		ParseChunk(chunks[index]);
+	});
+	const float parseTime = ElapsedMilliseconds(start);
+
+	// 塊の先頭が全体の何番目にあたるか ---------------------------------------------------
+	const auto buildStart = std::chrono::steady_clock::now();
+	std::vector<size_t> positionBases(chunks.size());
+	std::vector<size_t> texcoordBases(chunks.size());
+	std::vector<size_t> triangleBases(chunks.size());
+	size_t positionCount = 0;
+	size_t texcoordCount = 0;
+	size_t triangleCount = 0;
+	for (size_t index = 0; index < chunks.size(); ++index) {
+		const ObjChunk& chunk = chunks[index];
+		positionBases[index] = positionCount;
+		texcoordBases[index] = texcoordCount;
+		triangleBases[index] = triangleCount;
+		positionCount += chunk.positions.size() / 3;
+		texcoordCount += chunk.texcoords.size() / 2;
+		triangleCount += chunk.corners.size() / 3;
+	}
+	if (triangleCount == 0 || positionCount >= kNoVertex) {
+		return false;
+	}
+
+	std::vector<float> positions(positionCount * 3);
+	std::vector<float> texcoords(texcoordCount * 2);
+	for (size_t index = 0; index < chunks.size(); ++index) {
+		const ObjChunk& chunk = chunks[index];
+		std::copy(chunk.positions.begin(), chunk.positions.end(), positions.begin() + positionBases[index] * 3);
+		std::copy(chunk.texcoords.begin(), chunk.texcoords.end(), texcoords.begin() + texcoordBases[index] * 2);
+	}
+
+	// 面の番号をファイル全体の0始まりにする(並列) ---------------------------------------
+	// 位置 << 32 | UV。UVがなければkNoTexcoord。範囲外の番号を使う三角形は1つ目をkInvalidCornerにする
+	std::vector<uint64_t> corners(triangleCount * 3);
+	ForEachChunk(chunks, threadPool, [&](size_t index) {
+		ObjChunk& chunk = chunks[index];
+		uint64_t* out = corners.data() + triangleBases[index] * 3;
+		for (size_t cornerIndex = 0; cornerIndex < chunk.corners.size(); cornerIndex += 3) {
+			bool isValid = true;
+			for (size_t offset = 0; offset < 3; ++offset) {
+				const ObjCorner& corner = chunk.corners[cornerIndex + offset];
+				const uint32_t position = DecodeIndex(corner.position, positionBases[index], positionCount);
+				const uint32_t texcoord = corner.texcoord == 0 ? kNoTexcoord : DecodeIndex(corner.texcoord, texcoordBases[index], texcoordCount);
+				isValid = isValid && position != UINT32_MAX && (corner.texcoord == 0 || texcoord != UINT32_MAX);
+				out[offset] = (uint64_t(position) << 32) | texcoord;
+			}
+			if (!isValid) {
+				out[0] = kInvalidCorner;
+				++chunk.skippedTriangleCount;
+			}
+			out += 3;
+		}
+		// 読み終わった分は先に捨てる
+		chunk.corners = {};
+		chunk.positions = {};
+		chunk.texcoords = {};
+	});
+	uint32_t skippedLineCount = 0;
+	uint32_t skippedTriangleCount = 0;
+	std::string firstSkippedLine;
+	for (const ObjChunk& chunk : chunks) {
+		if (firstSkippedLine.empty() && chunk.skippedLineCount != 0) {
+			firstSkippedLine = chunk.firstSkippedLine;
+		}
+		skippedLineCount += chunk.skippedLineCount;
+		skippedTriangleCount += chunk.skippedTriangleCount;
+	}
+
+	// (位置, UV)が同じ頂点をまとめる ---------------------------------------------------------
+	// 位置ごとに、その位置を使う頂点をつないでおき、UVを比べる(位置の番号で引くのでハッシュより速い)
+	MeshData& mesh = outModel.mesh;
+	std::vector<uint32_t> firstVertexOfPosition(positionCount, kNoVertex);
+	std::vector<uint32_t> nextVertex;
+	std::vector<uint32_t> vertexTexcoords;
+	mesh.vertices.reserve(positionCount + positionCount / 4);
+	nextVertex.reserve(mesh.vertices.capacity());
+	vertexTexcoords.reserve(mesh.vertices.capacity());
+	mesh.indices.resize(corners.size() - size_t(skippedTriangleCount) * 3);
+
+	auto findOrAddVertex = [&](uint64_t corner) {
+		const uint32_t position = static_cast<uint32_t>(corner >> 32);
+		const uint32_t texcoord = static_cast<uint32_t>(corner);
+		for (uint32_t vertex = firstVertexOfPosition[position]; vertex != kNoVertex; vertex = nextVertex[vertex]) {
+			if (vertexTexcoords[vertex] == texcoord) {
+				return vertex;
+			}
+		}
+		const uint32_t vertex = static_cast<uint32_t>(mesh.vertices.size());
+		// 右手系 → 左手系(xを反転)、UVは上下を反転
+		const float* xyz = &positions[size_t(position) * 3];
+		VertexData& vertexData = mesh.vertices.emplace_back();
+		vertexData.pos = { -xyz[0], xyz[1], xyz[2], 1.0f };
+		if (texcoord == kNoTexcoord) {
+			vertexData.texcord = { 0.0f, 0.0f };
+		} else {
+			vertexData.texcord = { texcoords[size_t(texcoord) * 2], 1.0f - texcoords[size_t(texcoord) * 2 + 1] };
+		}
+		nextVertex.push_back(firstVertexOfPosition[position]);
+		vertexTexcoords.push_back(texcoord);
+		firstVertexOfPosition[position] = vertex;
+		return vertex;
+	};
+	// 三角形を捨てた時は、元の番号 → 詰めた後の番号(usemtl の位置を直す)
+	std::vector<uint32_t> keptTriangles;
+	if (skippedTriangleCount != 0) {
+		keptTriangles.resize(triangleCount + 1);
+	}
+	uint32_t keptCount = 0;
+	for (size_t triangle = 0; triangle < triangleCount; ++triangle) {
+		if (!keptTriangles.empty()) {
+			keptTriangles[triangle] = keptCount;
+		}
+		const uint64_t* corner = &corners[triangle * 3];
+		if (corner[0] == kInvalidCorner) {
+			continue;
+		}
+		// xを反転すると裏返るので回り順を逆にする
+		uint32_t* index = &mesh.indices[size_t(keptCount) * 3];
+		index[0] = findOrAddVertex(corner[0]);
+		index[1] = findOrAddVertex(corner[2]);
+		index[2] = findOrAddVertex(corner[1]);
+		++keptCount;
+	}
+	if (!keptTriangles.empty()) {
+		keptTriangles[triangleCount] = keptCount;
+	}
+	if (keptCount == 0) {
+		return false;
+	}
+	auto remapTriangle = [&keptTriangles](size_t triangle) {
+		return keptTriangles.empty() ? triangle : size_t(keptTriangles[triangle]);
+	};
+
+	// マテリアル ----------------------------------------------------------------------------
+	const std::filesystem::path directory = std::filesystem::path(filePath).parent_path();
+	for (const ObjChunk& chunk : chunks) {
+		for (const std::string& library : chunk.materialLibraries) {
+			LoadMtl((directory / Utf8Path(library)).wstring(), outModel.materials);
+		}
+	}
+	std::unordered_map<std::string, uint32_t> materialIndices;
+	for (uint32_t index = 0; index < outModel.materials.size(); ++index) {
+		materialIndices.emplace(outModel.materials[index].name, index);
+	}
+
+	// usemtl の位置で区切る。最初の usemtl より前の面は既定のマテリアル(名前は空)
+	std::vector<ObjSubmesh>& submeshes = outModel.submeshes;
+	auto beginSubmesh = [&](size_t triangle, uint32_t materialIndex) {
+		const uint32_t firstIndex = static_cast<uint32_t>(triangle * 3);
+		if (!submeshes.empty()) {
+			submeshes.back().indexCount = firstIndex - submeshes.back().firstIndex;
+			if (submeshes.back().indexCount == 0) {
+				submeshes.pop_back();
+			}
+		}
+		// 同じマテリアルが続くなら前の範囲を伸ばす
+		if (!submeshes.empty() && submeshes.back().materialIndex == materialIndex) {
+			return;
+		}
+		submeshes.push_back({ materialIndex, firstIndex, 0 });
+	};
+	for (size_t index = 0; index < chunks.size(); ++index) {
+		for (const ObjMaterialSwitch& materialSwitch : chunks[index].materialSwitches) {
+			const size_t triangle = remapTriangle(triangleBases[index] + materialSwitch.triangle);
+			if (submeshes.empty() && triangle != 0) {
+				beginSubmesh(0, FindOrAddMaterial(outModel.materials, materialIndices, ""));
+			}
+			beginSubmesh(triangle, FindOrAddMaterial(outModel.materials, materialIndices, materialSwitch.name));
+		}
+	}
+	if (submeshes.empty()) {
+		submeshes.push_back({ FindOrAddMaterial(outModel.materials, materialIndices, ""), 0, 0 });
+	}
+	submeshes.back().indexCount = static_cast<uint32_t>(mesh.indices.size()) - submeshes.back().firstIndex;
+	if (submeshes.back().indexCount == 0) {
+		submeshes.pop_back();
+	}
+
+	if (outStats) {
+		outStats->fileSize = file.GetSize();
+		outStats->chunkCount = static_cast<uint32_t>(chunks.size());
+		outStats->triangleCount = keptCount;
+		outStats->skippedLineCount = skippedLineCount;
+		outStats->skippedTriangleCount = skippedTriangleCount;
+		outStats->firstSkippedLine = std::move(firstSkippedLine);
+		outStats->parseTime = parseTime;
+		outStats->buildTime = ElapsedMilliseconds(buildStart);
+		outStats->totalTime = ElapsedMilliseconds(start);
+	}
+	return true;
+}
+
+bool FindObjMaterialLibraries(const std::wstring& filePath, std::vector<std::wstring>& outFiles) {
+	MappedFile file;
+	if (!file.Open(filePath)) {
+		return false;
+	}
+	const std::filesystem::path directory = std::filesystem::path(filePath).parent_path();
+	const char* p = reinterpret_cast<const char*>(file.GetData());
+	const char* end = p + file.GetSize();
+	while (p < end) {
+		p = SkipSpaces(p, end);
+		if (p < end && *p == 'm' && IsKeyword(p, end, "mtllib", 6)) {
+			outFiles.push_back((directory / Utf8Path(ReadRestOfLine(p + 6, end))).wstring());
+		}
+		p = SkipLine(p, end);
+	}
+	return true;
+}
+
+//=============================================================================================================================
+//	MTL
+//=============================================================================================================================
+bool LoadMtl(const std::wstring& filePath, std::vector<ObjMaterial>& outMaterials) {
+	MappedFile file;
+	if (!file.Open(filePath)) {
+		return false;
+	}
+	const std::filesystem::path directory = std::filesystem::path(filePath).parent_path();
+	const char* p = reinterpret_cast<const char*>(file.GetData());
+	const char* end = p + file.GetSize();
+	ObjMaterial* material = nullptr;
+
+	while (p < end) {
+		p = SkipSpaces(p, end);
+		if (IsKeyword(p, end, "newmtl", 6)) {
+			material = &outMaterials.emplace_back();
+			material->name = ReadRestOfLine(p + 6, end);
+		} else if (material && IsKeyword(p, end, "Kd", 2)) {
+			const char* cursor = p + 2;
+			ParseFloat(cursor, end, material->diffuseColor.x);
+			ParseFloat(cursor, end, material->diffuseColor.y);
+			ParseFloat(cursor, end, material->diffuseColor.z);
+		} else if (material && IsKeyword(p, end, "d", 1)) {
+			const char* cursor = p + 1;
+			ParseFloat(cursor, end, material->diffuseColor.w);
+		} else if (material && IsKeyword(p, end, "Tr", 2)) {
+			const char* cursor = p + 2;
+			float transparency = 0.0f;
+			if (ParseFloat(cursor, end, transparency)) {
+				material->diffuseColor.w = 1.0f - transparency;
+			}
+		} else if (material && IsKeyword(p, end, "map_Kd", 6)) {
+			// -s 等のオプションは読まず、最後の項目をファイル名とする
+			std::string texture = ReadRestOfLine(p + 6, end);
+			const size_t lastSpace = texture.find_last_of(" \t");
+			if (lastSpace != std::string::npos) {
+				texture = texture.substr(lastSpace + 1);
+			}
+			material->diffuseTexture = ToUtf8String(directory / Utf8Path(texture));
+		}
+		p = SkipLine(p, end);
+	}
+	return true;
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MeshData.h"
+#include "Vector4.h"
+
+class ThreadPool;
+
+/*================================================================================================
+Wavefront OBJ(+MTL)を読み、インデックス付きのメッシュにする
+ファイルはメモリにマップし、行の区切りで分けた塊ごとに(ThreadPoolがあれば並列に)解析する
+D3D12を使わないのでワーカースレッドやAssetCookerからも呼べる
+
+座標は右手系から左手系に直す(xを反転し、三角形の回り順を逆にする)。UVはvを反転する
+VertexDataに法線はないので vn は読み飛ばし、頂点は(位置, UV)の組でまとめる
+==================================================================================================*/
+
+/// <summary>
+/// MTLのマテリアル(今使う分だけ)
+/// </summary>
+struct ObjMaterial {
+	std::string name;
+	Vector4 diffuseColor = { 1.0f, 1.0f, 1.0f, 1.0f };		// Kd と d
+	std::string diffuseTexture;								// map_Kd (OBJからの相対パスをつないだもの。なければ空)
+};
+
+/// <summary>
+/// 同じマテリアルが続くインデックスの範囲
+/// </summary>
+struct ObjSubmesh {
+	uint32_t materialIndex;
+	uint32_t firstIndex;
+	uint32_t indexCount;
+};
+
+/// <summary>
+/// 読み込んだモデル
+/// </summary>
+struct ObjModel {
+	MeshData mesh;
+	std::vector<ObjSubmesh> submeshes;
+	// usemtl がMTLになければ名前だけのマテリアルを足す。usemtl がなければ既定のマテリアルが1つ入る
+	std::vector<ObjMaterial> materials;
+};
+
+/// <summary>
+/// 読み込みにかかった時間など
+/// </summary>
+struct ObjLoadStats {
+	size_t fileSize = 0;
+	uint32_t chunkCount = 0;
+	uint32_t triangleCount = 0;
+	float parseTime = 0.0f;			// 行の解析(ms)
+	float buildTime = 0.0f;			// 三角形・頂点を組み立てる(ms)
+	float totalTime = 0.0f;			// マップ・MTLを含む全体(ms)
+	uint32_t skippedLineCount = 0;		// 読めない・知らない行(読み飛ばした)
+	uint32_t skippedTriangleCount = 0;	// 範囲外の番号を使うので捨てた三角形
+	std::string firstSkippedLine;		// 警告用に最初の1行
+};
+
+/// <summary>
+/// OBJを読む
+/// </summary>
+/// <param name="filePath"></param>
+/// <param name="outModel"></param>
+/// <param name="threadPool">解析を並列にするワーカー(nullptrなら呼んだスレッドだけで読む)</param>
+/// <param name="outStats">不要ならnullptr(読み飛ばした行・三角形の数もここに返すので、警告を出す時に使う)</param>
+/// <returns>ファイルが開けない・使える面がない場合はfalse。読めない行・範囲外の番号を使う三角形は飛ばして読む</returns>
+bool LoadObj(const std::wstring& filePath, ObjModel& outModel, ThreadPool* threadPool = nullptr, ObjLoadStats* outStats = nullptr);
+
+/// <summary>
+/// OBJが使うMTL(mtllib)のパスだけを集める(面などは解析しない。焼く時の依存ファイルを調べる用)
+/// </summary>
+/// <param name="filePath"></param>
+/// <param name="outFiles">LoadObjが開くのと同じパス(OBJからの相対パスをつないだもの)</param>
+/// <returns>ファイルが開けなければfalse</returns>
+bool FindObjMaterialLibraries(const std::wstring& filePath, std::vector<std::wstring>& outFiles);
+
+/// <summary>
+/// MTLを読んでマテリアルを追加する
+/// </summary>
+/// <param name="filePath"></param>
+/// <param name="outMaterials"></param>
+/// <returns>ファイルが開けなければfalse</returns>
+bool LoadMtl(const std::wstring& filePath, std::vector<ObjMaterial>& outMaterials);
@@ -5,15 +5,21 @@ struct Material{
 };
 
 ConstantBuffer<Material> gMaterial : register(b0);
+#ifdef ENABLE_TEXTURE
 Texture2D<float4> gTexture : register(t0);
 SamplerState gSampler : register(s0);
+#endif
 struct PixelShaderOutput{
 	float4 color : SV_TARGET0; 
 };
 
 PixelShaderOutput main(VertexShaderOutput input){
 	PixelShaderOutput output;
+#ifdef ENABLE_TEXTURE
     float4 textureColor = gTexture.Sample(gSampler, input.texcord);
-    output.color = gMaterial.color * textureColor;
+    output.color = gMaterial.color * textureColor * input.color;
+#else
+    output.color = gMaterial.color * input.color;
+#endif
 	return output;
 }
\ No newline at end of file
@@ -4,16 +4,39 @@ struct TransformationMatrix{
     float4x4 WVP;
 };
 
+#ifdef ENABLE_INSTANCING
+// インスタンスごとの値(C++のInstanceDataと同じ並び)
+struct InstanceData{
+    float4x4 WVP;
+    float4x4 World;
+    float4 color;
+};
+
+StructuredBuffer<InstanceData> gInstances : register(t0, space1);
+#else
 ConstantBuffer<TransformationMatrix> gTransfomationMatrix : register(b0);
+#endif
 struct VertexShaderInput{
 	float4 position : POSITION0;
     float2 texcord : TEXCORD0;
   
 };
 
+#ifdef ENABLE_INSTANCING
+VertexShaderOutput main(VertexShaderInput input, uint instanceId : SV_InstanceID){
+	VertexShaderOutput output;
+    InstanceData instance = gInstances[instanceId];
+    output.position = mul(input.position, instance.WVP);
+    output.texcord = input.texcord;
+    output.color = instance.color;
+	return output;
+}
+#else
 VertexShaderOutput main(VertexShaderInput input){
 	VertexShaderOutput output;
     output.position = mul(input.position, gTransfomationMatrix.WVP);
     output.texcord = input.texcord;
+    output.color = float4(1.0f, 1.0f, 1.0f, 1.0f);
 	return output;
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
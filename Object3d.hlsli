@@ -1,4 +1,5 @@
 struct VertexShaderOutput{
     float4 position : SV_POSITION;
     float2 texcord : TEXCORD0;
+    float4 color : COLOR0;
 };
\ No newline at end of file
@@ -0,0 +1,221 @@
+#include "ShaderCache.h"
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+
+#include "Function/Convert.h"
+#include "Function/DirectXUtils.h"
+#include "Function/Hash.h"
+
+namespace {
+
+/// キャッシュのファイルの識別子("SHDC")
+const uint32_t kShaderCacheMagic = 0x43444853;
+/// 形式やコンパイラの使い方を変えた時に上げる(古いキャッシュを使わないようにする)
+const uint32_t kShaderCacheVersion = 2;
+
+/// <summary>
+/// キャッシュのファイルの先頭
+/// この後に 依存ファイル(パスの長さ u32, UTF-8のパス, ハッシュ u64) × dependencyCount, DXIL, リフレクション と続く
+/// リフレクションがDXILに入っている場合はreflectionSizeを0にしてDXILを使う
+/// </summary>
+struct ShaderCacheHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t key;
+	uint32_t dependencyCount;
+	uint32_t reserved;
+	uint64_t blobSize;
+	uint64_t reflectionSize;
+};
+
+template<typename T>
+bool ReadValue(std::ifstream& file, T& value) {
+	file.read(reinterpret_cast<char*>(&value), sizeof(T));
+	return static_cast<bool>(file);
+}
+
+template<typename T>
+void WriteValue(std::ofstream& file, const T& value) {
+	file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+}
+
+uint64_t MakeShaderKey(const ShaderCompileDesc& desc) {
+	// 区切りを入れないと {"ab","c"} と {"a","bc"} が同じになるので長さも混ぜる
+	uint64_t key = HashCombine(kHashOffsetBasis, kShaderCacheVersion);
+	for (const std::wstring& argument : BuildShaderArguments(desc)) {
+		const std::wstring& value = argument == desc.filePath ? NormalizeShaderPath(argument) : argument;
+		key = HashCombine(key, value.size());
+		key = HashString(value, key);
+	}
+	return key;
+}
+
+void ShaderCache::Init(const std::wstring& cacheDirectory) {
+	cacheDirectory_ = cacheDirectory;
+	hitCount_ = 0;
+	missCount_ = 0;
+}
+
+//=============================================================================================================================
+//	読み込み
+//=============================================================================================================================
+IDxcBlob* ShaderCache::Load(ShaderCompiler& compiler, const ShaderCompileDesc& desc, std::vector<ShaderDependency>* outDependencies, IDxcBlob** outReflection) {
+	const auto start = std::chrono::steady_clock::now();
+	const uint64_t key = MakeShaderKey(desc);
+	const std::wstring cachePath = GetCachePath(desc);
+
+	// キャッシュが使えればコンパイルしない --------------------------------------------------
+	std::vector<ShaderDependency> dependencies;
+	IDxcBlob* reflection = nullptr;
+	IDxcBlob* blob = Read(compiler, cachePath, key, dependencies, reflection);
+	if (blob) {
+		++hitCount_;
+		const float time = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		Log(ConvertString(std::format(L"ShaderCache: hit {} {} ({:.2f}ms)\n", desc.filePath, desc.profile, time)));
+	} else {
+		// コンパイルして保存 ---------------------------------------------------------------
+		++missCount_;
+		dependencies.clear();
+		blob = compiler.Compile(desc, &dependencies, &reflection);
+		if (blob) {
+			Write(cachePath, key, dependencies, blob, reflection);
+			const float time = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+			Log(ConvertString(std::format(L"ShaderCache: compiled {} {} ({:.2f}ms)\n", desc.filePath, desc.profile, time)));
+		}
+	}
+
+	if (outDependencies) {
+		*outDependencies = std::move(dependencies);
+	}
+	if (outReflection) {
+		*outReflection = reflection;
+	} else if (reflection) {
+		reflection->Release();
+	}
+	return blob;
+}
+
+std::wstring ShaderCache::GetCachePath(const ShaderCompileDesc& desc) const {
+	const std::wstring stem = std::filesystem::path(desc.filePath).stem().wstring();
+	const std::filesystem::path cachePath = std::filesystem::path(cacheDirectory_) / (stem + L"_" + HashToHexString(MakeShaderKey(desc)) + L".cso");
+	return cachePath.generic_wstring();
+}
+
+IDxcBlob* ShaderCache::Read(ShaderCompiler& compiler, const std::wstring& cachePath, uint64_t key, std::vector<ShaderDependency>& outDependencies, IDxcBlob*& outReflection) const {
+	std::error_code error;
+	const uint64_t fileSize = std::filesystem::file_size(std::filesystem::path(cachePath), error);
+	if (error) {
+		return nullptr;
+	}
+	std::ifstream file(std::filesystem::path(cachePath), std::ios::binary);
+	if (!file) {
+		return nullptr;
+	}
+
+	ShaderCacheHeader header{};
+	if (!ReadValue(file, header) || header.magic != kShaderCacheMagic || header.version != kShaderCacheVersion || header.key != key) {
+		return nullptr;
+	}
+
+	// 壊れたヘッダーの数で大きな領域を確保しないように、ファイルの大きさと比べる(合わなければキャッシュにないものとする)
+	// 依存ファイルは1つ最低でも長さとハッシュの12byte
+	const uint64_t payloadSize = fileSize - sizeof(ShaderCacheHeader);
+	const uint64_t minDependencySize = sizeof(uint32_t) + sizeof(uint64_t);
+	if (header.dependencyCount > payloadSize / minDependencySize ||
+		header.blobSize == 0 || header.blobSize > payloadSize || header.reflectionSize > payloadSize - header.blobSize ||
+		header.blobSize + header.reflectionSize + header.dependencyCount * minDependencySize > payloadSize) {
+		return nullptr;
+	}
+
+	// 依存ファイルが1つでも変わっていれば使わない
+	outDependencies.resize(header.dependencyCount);
+	for (ShaderDependency& dependency : outDependencies) {
+		uint32_t pathSize = 0;
+		if (!ReadValue(file, pathSize) || pathSize > payloadSize) {
+			return nullptr;
+		}
+		std::u8string path(pathSize, u8'\0');
+		file.read(reinterpret_cast<char*>(path.data()), pathSize);
+		if (!file || !ReadValue(file, dependency.hash)) {
+			return nullptr;
+		}
+		dependency.filePath = std::filesystem::path(path).generic_wstring();
+
+		uint64_t currentHash = 0;
+		if (!HashFile(dependency.filePath, currentHash) || currentHash != dependency.hash) {
+			return nullptr;
+		}
+	}
+
+	// 依存ファイルのパスを読んだ後の残りが、ちょうどDXILとリフレクションの大きさになる
+	const std::streamoff position = file.tellg();
+	if (position < 0 || fileSize - static_cast<uint64_t>(position) != header.blobSize + header.reflectionSize) {
+		return nullptr;
+	}
+	std::vector<char> data(static_cast<size_t>(header.blobSize));
+	file.read(data.data(), data.size());
+	std::vector<char> reflectionData(static_cast<size_t>(header.reflectionSize));
+	file.read(reflectionData.data(), reflectionData.size());
+	if (!file) {
+		return nullptr;
+	}
+
+	IDxcBlob* blob = compiler.CreateBlob(data.data(), data.size());
+	if (reflectionData.empty()) {
+		blob->AddRef();
+		outReflection = blob;
+	} else {
+		outReflection = compiler.CreateBlob(reflectionData.data(), reflectionData.size());
+	}
+	return blob;
+}
+
+void ShaderCache::Write(const std::wstring& cachePath, uint64_t key, const std::vector<ShaderDependency>& dependencies, IDxcBlob* blob, IDxcBlob* reflection) const {
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+
+	// 途中で止まっても壊れたキャッシュが残らないように、一時ファイルに書いてから名前を変える
+	const std::wstring tempPath = cachePath + L".tmp";
+	{
+		std::ofstream file(std::filesystem::path(tempPath), std::ios::binary | std::ios::trunc);
+		if (!file) {
+			return;
+		}
+
+		ShaderCacheHeader header{};
+		header.magic = kShaderCacheMagic;
+		header.version = kShaderCacheVersion;
+		header.key = key;
+		header.dependencyCount = uint32_t(dependencies.size());
+		header.blobSize = blob->GetBufferSize();
+		// DXILに入っているなら同じものを2回書かない
+		const bool hasReflection = reflection && reflection != blob;
+		header.reflectionSize = hasReflection ? reflection->GetBufferSize() : 0;
+		WriteValue(file, header);
+
+		for (const ShaderDependency& dependency : dependencies) {
+			const std::u8string path = std::filesystem::path(dependency.filePath).generic_u8string();
+			WriteValue(file, uint32_t(path.size()));
+			file.write(reinterpret_cast<const char*>(path.data()), path.size());
+			WriteValue(file, dependency.hash);
+		}
+		file.write(static_cast<const char*>(blob->GetBufferPointer()), blob->GetBufferSize());
+		if (hasReflection) {
+			file.write(static_cast<const char*>(reflection->GetBufferPointer()), reflection->GetBufferSize());
+		}
+		if (!file) {
+			file.close();
+			std::filesystem::remove(tempPath, error);
+			return;
+		}
+	}
+
+	std::filesystem::rename(tempPath, cachePath, error);
+	if (error) {
+		std::filesystem::remove(tempPath, error);
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Shader/ShaderCompiler.h"
+
+/*================================================================================================
+コンパイル済みのシェーダー(DXIL)をディスクに保存し、次回の起動ではコンパイルせずに読む
+キャッシュのファイルは、ファイルパス・エントリーポイント・プロファイル・オプションのハッシュで決まり、
+中にコンパイル時に読んだファイル(元のファイルとinclude)とその内容のハッシュ、DXIL、リフレクションを持つ
+どれか1つでも内容が変わっていればコンパイルし直す
+==================================================================================================*/
+
+/// キャッシュの既定の置き場所
+static const wchar_t* const kShaderCacheDirectory = L"Resource/ShaderCache";
+
+/// <summary>
+/// シェーダーのディスクキャッシュ
+/// ファイル単位で読み書きするだけで状態を持たないので、複数のスレッドから同時に使ってよい
+/// </summary>
+class ShaderCache {
+public:
+
+	ShaderCache() = default;
+	~ShaderCache() = default;
+	ShaderCache(const ShaderCache&) = delete;
+	const ShaderCache& operator=(const ShaderCache&) = delete;
+
+	void Init(const std::wstring& cacheDirectory = kShaderCacheDirectory);
+
+	/// <summary>
+	/// キャッシュが使えればそれを、なければコンパイルして保存したものを返す
+	/// </summary>
+	/// <param name="compiler">呼び出したスレッドのコンパイラ</param>
+	/// <param name="desc"></param>
+	/// <param name="outDependencies">依存しているファイルの一覧(不要ならnullptr)。失敗した場合も読めた分は返す</param>
+	/// <param name="outReflection">リフレクション(不要ならnullptr。使い終わったらRelease)</param>
+	/// <returns>DXIL(使い終わったらRelease)。コンパイルエラーならnullptr</returns>
+	IDxcBlob* Load(ShaderCompiler& compiler, const ShaderCompileDesc& desc, std::vector<ShaderDependency>* outDependencies = nullptr, IDxcBlob** outReflection = nullptr);
+
+public: // accessor
+
+	/// キャッシュのファイルのパス
+	std::wstring GetCachePath(const ShaderCompileDesc& desc) const;
+
+	uint32_t GetHitCount() const { return hitCount_; }
+	uint32_t GetMissCount() const { return missCount_; }
+
+private:
+
+	/// <summary>
+	/// キャッシュを読む。依存ファイルが変わっていたら失敗
+	/// </summary>
+	IDxcBlob* Read(ShaderCompiler& compiler, const std::wstring& cachePath, uint64_t key, std::vector<ShaderDependency>& outDependencies, IDxcBlob*& outReflection) const;
+
+	/// <summary>
+	/// キャッシュを書く
+	/// </summary>
+	void Write(const std::wstring& cachePath, uint64_t key, const std::vector<ShaderDependency>& dependencies, IDxcBlob* blob, IDxcBlob* reflection) const;
+
+private:
+	std::wstring cacheDirectory_ = kShaderCacheDirectory;
+
+	std::atomic<uint32_t> hitCount_ = 0;
+	std::atomic<uint32_t> missCount_ = 0;
+};
+
+/// <summary>
+/// キャッシュのキー(ファイルパス・エントリーポイント・プロファイル・オプションのハッシュ)
+/// </summary>
+uint64_t MakeShaderKey(const ShaderCompileDesc& desc);
@@ -0,0 +1,190 @@
+#include "ShaderCompileService.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <format>
+
+#include "Function/DirectXUtils.h"
+
+ShaderCompileService::~ShaderCompileService() {
+	Finalize();
+}
+
+//=============================================================================================================================
+//	初期化・終了
+//=============================================================================================================================
+void ShaderCompileService::Init(ShaderCache* cache, uint32_t workerCount) {
+	cache_ = cache;
+
+	// コンパイラはワーカーのスレッドで作って、そのスレッドで壊す
+	threadPool_.Init(workerCount, nullptr, [this](uint32_t workerIndex) {
+		compilers_[workerIndex]->Finalize();
+	});
+	compilers_.resize(threadPool_.GetThreadCount());
+	for (std::unique_ptr<ShaderCompiler>& compiler : compilers_) {
+		compiler = std::make_unique<ShaderCompiler>();
+	}
+}
+
+void ShaderCompileService::Finalize() {
+	threadPool_.Finalize();
+	compilers_.clear();
+
+	for (Shader& shader : shaders_) {
+		if (shader.blob) {
+			shader.blob->Release();
+		}
+		if (shader.reflection) {
+			shader.reflection->Release();
+		}
+	}
+	shaders_.clear();
+	shaderMap_.clear();
+	dependents_.clear();
+}
+
+//=============================================================================================================================
+//	登録・コンパイル
+//=============================================================================================================================
+ShaderCompileService::ShaderId ShaderCompileService::Register(const ShaderCompileDesc& desc) {
+	const uint64_t key = MakeShaderKey(desc);
+	auto it = shaderMap_.find(key);
+	if (it != shaderMap_.end()) {
+		return it->second;
+	}
+
+	const ShaderId id = ShaderId(shaders_.size());
+	Shader& shader = shaders_.emplace_back();
+	shader.desc = desc;
+	shader.key = key;
+	shaderMap_.emplace(key, id);
+	return id;
+}
+
+bool ShaderCompileService::Compile(const std::vector<ShaderId>& shaders) {
+	assert(!compilers_.empty());
+	const auto start = std::chrono::steady_clock::now();
+
+	// 同じシェーダーを2つのワーカーが同時に書き換えないようにする
+	std::vector<ShaderId> uniqueShaders = shaders;
+	std::sort(uniqueShaders.begin(), uniqueShaders.end());
+	uniqueShaders.erase(std::unique(uniqueShaders.begin(), uniqueShaders.end()), uniqueShaders.end());
+
+	for (ShaderId shader : uniqueShaders) {
+		assert(shader < shaders_.size());
+		threadPool_.Submit([this, shader]() { CompileShader(shader); });
+	}
+	threadPool_.WaitIdle();
+
+	// 依存関係はコンパイルし直すたびに変わりうる
+	RebuildDependents();
+
+	bool isSucceeded = true;
+	for (ShaderId shader : uniqueShaders) {
+		isSucceeded &= !shaders_[shader].hasError;
+	}
+
+	lastCompileTime_ = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	Log(std::format("ShaderCompileService: {} shaders in {:.1f}ms ({} threads)\n", uniqueShaders.size(), lastCompileTime_, threadPool_.GetThreadCount()));
+	return isSucceeded;
+}
+
+bool ShaderCompileService::CompileAll() {
+	std::vector<ShaderId> shaders(shaders_.size());
+	for (ShaderId id = 0; id < ShaderId(shaders.size()); ++id) {
+		shaders[id] = id;
+	}
+	return Compile(shaders);
+}
+
+void ShaderCompileService::CompileShader(ShaderId id) {
+	ShaderCompiler& compiler = *compilers_[ThreadPool::GetWorkerIndex()];
+	if (!compiler.GetUtils()) {
+		compiler.Init();
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	Shader& shader = shaders_[id];
+	std::vector<ShaderDependency> dependencies;
+	IDxcBlob* reflection = nullptr;
+	IDxcBlob* blob = cache_
+		? cache_->Load(compiler, shader.desc, &dependencies, &reflection)
+		: compiler.Compile(shader.desc, &dependencies, &reflection);
+
+	// 失敗しても読んだファイルは覚えておく(直した時にコンパイルし直せるように)
+	shader.dependencies = std::move(dependencies);
+	shader.hasError = blob == nullptr;
+	shader.compileTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	if (blob) {
+		if (shader.blob) {
+			shader.blob->Release();
+		}
+		shader.blob = blob;
+		if (shader.reflection) {
+			shader.reflection->Release();
+		}
+		shader.reflection = reflection;
+		++shader.version;
+	}
+}
+
+//=============================================================================================================================
+//	依存関係
+//=============================================================================================================================
+std::vector<ShaderCompileService::ShaderId> ShaderCompileService::Invalidate(const std::wstring& filePath) const {
+	auto it = dependents_.find(NormalizeShaderPath(filePath));
+	if (it == dependents_.end()) {
+		return {};
+	}
+	return it->second;
+}
+
+void ShaderCompileService::RebuildDependents() {
+	dependents_.clear();
+	for (ShaderId id = 0; id < ShaderId(shaders_.size()); ++id) {
+		for (const ShaderDependency& dependency : shaders_[id].dependencies) {
+			std::vector<ShaderId>& dependents = dependents_[dependency.filePath];
+			if (std::find(dependents.begin(), dependents.end(), id) == dependents.end()) {
+				dependents.push_back(id);
+			}
+		}
+	}
+}
+
+//=============================================================================================================================
+//	accessor
+//=============================================================================================================================
+IDxcBlob* ShaderCompileService::GetBlob(ShaderId shader) const {
+	assert(shader < shaders_.size());
+	return shaders_[shader].blob;
+}
+
+IDxcBlob* ShaderCompileService::GetReflection(ShaderId shader) const {
+	assert(shader < shaders_.size());
+	return shaders_[shader].reflection;
+}
+
+const ShaderCompileDesc& ShaderCompileService::GetDesc(ShaderId shader) const {
+	assert(shader < shaders_.size());
+	return shaders_[shader].desc;
+}
+
+const std::vector<ShaderDependency>& ShaderCompileService::GetDependencies(ShaderId shader) const {
+	assert(shader < shaders_.size());
+	return shaders_[shader].dependencies;
+}
+
+bool ShaderCompileService::HasError(ShaderId shader) const {
+	assert(shader < shaders_.size());
+	return shaders_[shader].hasError;
+}
+
+uint32_t ShaderCompileService::GetVersion(ShaderId shader) const {
+	assert(shader < shaders_.size());
+	return shaders_[shader].version;
+}
+
+float ShaderCompileService::GetCompileTime(ShaderId shader) const {
+	assert(shader < shaders_.size());
+	return shaders_[shader].compileTime;
+}
@@ -0,0 +1,129 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Function/ThreadPool.h"
+#include "Shader/ShaderCompiler.h"
+#include "Shader/ShaderCache.h"
+
+/// <summary>
+/// シェーダーをまとめてワーカースレッドでコンパイルする
+/// コンパイラはワーカーごとに持つ。includeの依存関係を覚えておき、
+/// ファイルが変わった時にそれに依存するシェーダーだけをコンパイルし直せるようにする
+/// </summary>
+class ShaderCompileService {
+public:
+
+	using ShaderId = uint32_t;
+
+	static const ShaderId kInvalidShader = UINT32_MAX;
+
+public:
+
+	ShaderCompileService() = default;
+	~ShaderCompileService();
+	ShaderCompileService(const ShaderCompileService&) = delete;
+	const ShaderCompileService& operator=(const ShaderCompileService&) = delete;
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="cache">コンパイル結果のキャッシュ(使わないならnullptr)</param>
+	/// <param name="workerCount">0ならCPUに合わせる</param>
+	void Init(ShaderCache* cache, uint32_t workerCount = 0);
+
+	void Finalize();
+
+	/// <summary>
+	/// シェーダーを登録する(まだコンパイルしない)。同じ指定なら同じIDを返す
+	/// </summary>
+	ShaderId Register(const ShaderCompileDesc& desc);
+
+	/// <summary>
+	/// 指定したシェーダーをワーカーでコンパイルし、全て終わるまで待つ
+	/// 失敗したものは前の結果を残す
+	/// </summary>
+	/// <param name="shaders"></param>
+	/// <returns>全て成功したか</returns>
+	bool Compile(const std::vector<ShaderId>& shaders);
+
+	/// <summary>
+	/// 登録した全てのシェーダーをコンパイルする
+	/// </summary>
+	bool CompileAll();
+
+	/// <summary>
+	/// ファイルが変わったことを伝え、それに依存する(includeしている)シェーダーを返す
+	/// </summary>
+	/// <param name="filePath"></param>
+	/// <returns>コンパイルし直すべきシェーダー</returns>
+	std::vector<ShaderId> Invalidate(const std::wstring& filePath) const;
+
+public: // accessor
+
+	/// コンパイル結果(サービスが持っているのでReleaseしない。コンパイルし直すと無効になる)
+	IDxcBlob* GetBlob(ShaderId shader) const;
+
+	/// リフレクション(ルートシグネチャを作るのに使う。GetBlobと同じく所有しない)
+	IDxcBlob* GetReflection(ShaderId shader) const;
+
+	const ShaderCompileDesc& GetDesc(ShaderId shader) const;
+
+	/// 元のファイルとincludeしたファイル
+	const std::vector<ShaderDependency>& GetDependencies(ShaderId shader) const;
+
+	/// 直近のコンパイルが失敗したか
+	bool HasError(ShaderId shader) const;
+
+	/// コンパイルに成功した回数(変わったかどうかの判定用)
+	uint32_t GetVersion(ShaderId shader) const;
+
+	/// 直近のコンパイル(キャッシュから読んだ場合は読み込み)にかかった時間(ミリ秒)
+	float GetCompileTime(ShaderId shader) const;
+
+	uint32_t GetShaderCount() const { return uint32_t(shaders_.size()); }
+
+	uint32_t GetWorkerCount() const { return threadPool_.GetThreadCount(); }
+
+	/// 直近のCompileにかかった時間(ミリ秒)
+	float GetLastCompileTime() const { return lastCompileTime_; }
+
+private:
+
+	struct Shader {
+		ShaderCompileDesc desc;
+		uint64_t key = 0;
+		IDxcBlob* blob = nullptr;
+		IDxcBlob* reflection = nullptr;
+		std::vector<ShaderDependency> dependencies;
+		bool hasError = false;
+		uint32_t version = 0;
+		float compileTime = 0.0f;
+	};
+
+	/// <summary>
+	/// ワーカーで1つコンパイルする
+	/// </summary>
+	void CompileShader(ShaderId shader);
+
+	/// <summary>
+	/// ファイル → 依存しているシェーダー の表を作り直す
+	/// </summary>
+	void RebuildDependents();
+
+private:
+	ShaderCache* cache_ = nullptr;
+	ThreadPool threadPool_;
+	// ワーカー番号ごとのコンパイラ(最初に使う時に初期化する)
+	std::vector<std::unique_ptr<ShaderCompiler>> compilers_;
+
+	// コンパイル中はワーカーが自分の担当の要素だけを書き換える(配列の大きさは変えない)
+	std::vector<Shader> shaders_;
+	std::unordered_map<uint64_t, ShaderId> shaderMap_;
+	std::unordered_map<std::wstring, std::vector<ShaderId>> dependents_;
+
+	float lastCompileTime_ = 0.0f;
+};
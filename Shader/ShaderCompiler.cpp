@@ -0,0 +1,261 @@
+#include "ShaderCompiler.h"
+#include <cassert>
+#include <filesystem>
+#include <format>
+#include <fstream>
+
+#include "Function/Convert.h"
+#include "Function/DirectXUtils.h"
+#include "Function/Hash.h"
+
+#pragma comment(lib, "dxcompiler.lib")
+
+namespace {
+
+/// <summary>
+/// 既定のincludeの処理に、読んだファイルを記録する処理を足したもの
+/// コンパイル中だけスタックに置いて使うので、参照カウントは持たない
+/// </summary>
+class RecordingIncludeHandler : public IDxcIncludeHandler {
+public:
+
+	RecordingIncludeHandler(IDxcIncludeHandler* includeHandler, std::vector<ShaderDependency>* dependencies)
+		: includeHandler_(includeHandler), dependencies_(dependencies) {
+	}
+
+	HRESULT STDMETHODCALLTYPE LoadSource(LPCWSTR pFilename, IDxcBlob** ppIncludeSource) override {
+		HRESULT hr = includeHandler_->LoadSource(pFilename, ppIncludeSource);
+		if (FAILED(hr) || !dependencies_) {
+			return hr;
+		}
+
+		// 同じファイルを何度includeしても1つとして記録する
+		const std::wstring filePath = NormalizeShaderPath(pFilename);
+		for (const ShaderDependency& dependency : *dependencies_) {
+			if (dependency.filePath == filePath) {
+				return hr;
+			}
+		}
+		// 後でファイルを読み直すと食い違う可能性があるので、コンパイラが実際に読んだ中身をハッシュする
+		ShaderDependency& dependency = dependencies_->emplace_back();
+		dependency.filePath = filePath;
+		dependency.hash = HashBytes((*ppIncludeSource)->GetBufferPointer(), (*ppIncludeSource)->GetBufferSize());
+		return hr;
+	}
+
+	HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override {
+		if (riid == __uuidof(IDxcIncludeHandler) || riid == __uuidof(IUnknown)) {
+			*ppvObject = this;
+			return S_OK;
+		}
+		*ppvObject = nullptr;
+		return E_NOINTERFACE;
+	}
+
+	ULONG STDMETHODCALLTYPE AddRef() override { return 1; }
+	ULONG STDMETHODCALLTYPE Release() override { return 1; }
+
+private:
+	IDxcIncludeHandler* includeHandler_;
+	std::vector<ShaderDependency>* dependencies_;
+};
+
+}
+
+ShaderCompiler::~ShaderCompiler() {
+	Finalize();
+}
+
+void ShaderCompiler::Init() {
+	assert(!dxcUtils_);
+	HRESULT hr = DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&dxcUtils_));
+	assert(SUCCEEDED(hr));
+	hr = DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&dxcCompiler_));
+	assert(SUCCEEDED(hr));
+
+	// includeに対応するための設定
+	hr = dxcUtils_->CreateDefaultIncludeHandler(&includeHandler_);
+	assert(SUCCEEDED(hr));
+}
+
+void ShaderCompiler::Finalize() {
+	if (includeHandler_) {
+		includeHandler_->Release();
+		includeHandler_ = nullptr;
+	}
+	if (dxcCompiler_) {
+		dxcCompiler_->Release();
+		dxcCompiler_ = nullptr;
+	}
+	if (dxcUtils_) {
+		dxcUtils_->Release();
+		dxcUtils_ = nullptr;
+	}
+}
+
+//=============================================================================================================================
+//	コンパイル
+//=============================================================================================================================
+IDxcBlob* ShaderCompiler::Compile(const ShaderCompileDesc& desc, std::vector<ShaderDependency>* outDependencies, IDxcBlob** outReflection) {
+	assert(dxcCompiler_);
+
+	// 1.-----------------------------------------------------------------------------------------
+	// これからシェーダーをコンパイルする旨えおログに出す
+	Log(ConvertString(std::format(L"Begin compileShader, path:{}, profile:{}\n", desc.filePath, desc.profile)));
+	// hlslファイルを読む
+	IDxcBlobEncoding* shaderSource = nullptr;
+	HRESULT hr = dxcUtils_->LoadFile(desc.filePath.c_str(), nullptr, &shaderSource);
+	if (FAILED(hr)) {
+		Log(ConvertString(std::format(L"Failed to open shader, path:{}\n", desc.filePath)));
+		// 開けなくても自分自身は依存に入れておく(ファイルを直した・置いた時にコンパイルし直せるように)
+		if (outDependencies) {
+			outDependencies->clear();
+			outDependencies->push_back({ NormalizeShaderPath(desc.filePath), 0 });
+		}
+		return nullptr;
+	}
+	DxcBuffer shaderSourceBuffer{};
+	shaderSourceBuffer.Ptr = shaderSource->GetBufferPointer();
+	shaderSourceBuffer.Size = shaderSource->GetBufferSize();
+	shaderSourceBuffer.Encoding = DXC_CP_UTF8;
+
+	if (outDependencies) {
+		outDependencies->clear();
+		outDependencies->push_back({ NormalizeShaderPath(desc.filePath), HashBytes(shaderSourceBuffer.Ptr, shaderSourceBuffer.Size) });
+	}
+
+	// 2.-----------------------------------------------------------------------------------------
+	const std::vector<std::wstring> arguments = BuildShaderArguments(desc);
+	std::vector<LPCWSTR> argumentPointers;
+	argumentPointers.reserve(arguments.size());
+	for (const std::wstring& argument : arguments) {
+		argumentPointers.push_back(argument.c_str());
+	}
+
+	// 実際にshaderをコンパイルする
+	RecordingIncludeHandler includeHandler(includeHandler_, outDependencies);
+	IDxcResult* shaderResult = nullptr;
+	hr = dxcCompiler_->Compile(
+		&shaderSourceBuffer,				// 読み込んだファイル
+		argumentPointers.data(),			// コンパイルオプション
+		UINT32(argumentPointers.size()),	// コンパイルオプションの数
+		&includeHandler,					// includeが含まれた諸々
+		IID_PPV_ARGS(&shaderResult)			// コンパイル結果
+	);
+	// コンパイルエラーではなくdxcが起動できないなど致命的な状況
+	assert(SUCCEEDED(hr));
+	shaderSource->Release();
+
+	// 3.-----------------------------------------------------------------------------------------
+	// 警告,エラーが出たらログに出す
+	IDxcBlobUtf8* shaderError = nullptr;
+	shaderResult->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&shaderError), nullptr);
+	if (shaderError != nullptr) {
+		if (shaderError->GetStringLength() != 0) {
+			Log(shaderError->GetStringPointer());
+		}
+		shaderError->Release();
+	}
+	HRESULT status = S_OK;
+	shaderResult->GetStatus(&status);
+	if (FAILED(status)) {
+		Log(ConvertString(std::format(L"Compile Failed, path:{}\n", desc.filePath)));
+		shaderResult->Release();
+		return nullptr;
+	}
+
+	// 4.-----------------------------------------------------------------------------------------
+	// コンパイル結果から実行用のバイナリ部分を取得
+	IDxcBlob* shaderBlob = nullptr;
+	hr = shaderResult->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&shaderBlob), nullptr);
+	assert(SUCCEEDED(hr));
+
+	// リフレクションは別の出力で取る。出ていない場合はDXILにそのまま入っている
+	if (outReflection) {
+		*outReflection = nullptr;
+		if (shaderResult->HasOutput(DXC_OUT_REFLECTION)) {
+			shaderResult->GetOutput(DXC_OUT_REFLECTION, IID_PPV_ARGS(outReflection), nullptr);
+		}
+		if (!*outReflection) {
+			shaderBlob->AddRef();
+			*outReflection = shaderBlob;
+		}
+	}
+
+	// デバッグ情報を外した場合はPDBが別に出てくるので保存する(ファイル名はDXILのハッシュ)
+	if (shaderResult->HasOutput(DXC_OUT_PDB)) {
+		WritePdb(shaderResult);
+	}
+	// 成功したらログを出す
+	Log(ConvertString(std::format(L"Compile Succeeded, path:{}, profile:{}\n", desc.filePath, desc.profile)));
+	// もう使わないリソースを解放
+	shaderResult->Release();
+
+	return shaderBlob;
+}
+
+IDxcBlob* ShaderCompiler::CreateBlob(const void* data, size_t size) {
+	assert(dxcUtils_);
+	IDxcBlobEncoding* blob = nullptr;
+	HRESULT hr = dxcUtils_->CreateBlob(data, UINT32(size), DXC_CP_ACP, &blob);
+	assert(SUCCEEDED(hr));
+	return blob;
+}
+
+void ShaderCompiler::WritePdb(IDxcResult* shaderResult) {
+	IDxcBlob* pdb = nullptr;
+	IDxcBlobUtf16* pdbName = nullptr;
+	HRESULT hr = shaderResult->GetOutput(DXC_OUT_PDB, IID_PPV_ARGS(&pdb), &pdbName);
+	if (SUCCEEDED(hr) && pdb && pdbName) {
+		std::error_code error;
+		std::filesystem::create_directories(kShaderPdbDirectory, error);
+		const std::filesystem::path pdbPath = std::filesystem::path(kShaderPdbDirectory) / std::filesystem::path(pdbName->GetStringPointer()).filename();
+		std::ofstream file(pdbPath, std::ios::binary | std::ios::trunc);
+		file.write(static_cast<const char*>(pdb->GetBufferPointer()), pdb->GetBufferSize());
+	}
+	if (pdb) {
+		pdb->Release();
+	}
+	if (pdbName) {
+		pdbName->Release();
+	}
+}
+
+//=============================================================================================================================
+//	補助
+//=============================================================================================================================
+std::vector<std::wstring> MakeShaderBuildArguments(ShaderBuildConfig config) {
+	switch (config) {
+	case ShaderBuildConfig::Release:
+		return {
+			L"-O3",							// 最適化
+			L"-Zi", L"-Qstrip_debug",		// デバッグ情報は作るがDXILには入れずPDBに分ける
+			L"-Qstrip_reflect",				// リフレクションもDXILからは外す(別の出力で取れる)
+			L"-Zpr",						// メモリレイアウトは行優先
+		};
+	default:
+		return {
+			L"-Zi", L"-Qembed_debug",		// デバック用に情報を埋め込む
+			L"-Od",							// 最適化を外して置く
+			L"-Zpr",						// メモリレイアウトは行優先
+		};
+	}
+}
+
+std::wstring NormalizeShaderPath(const std::wstring& filePath) {
+	return std::filesystem::path(filePath).lexically_normal().generic_wstring();
+}
+
+std::vector<std::wstring> BuildShaderArguments(const ShaderCompileDesc& desc) {
+	std::vector<std::wstring> arguments = {
+		desc.filePath,				// コンパイル対象のhlslファイル
+		L"-E", desc.entryPoint,		// エントリーポイントの指定
+		L"-T", desc.profile,		// shaderProfileの設定
+	};
+	for (const std::wstring& define : desc.defines) {
+		arguments.push_back(L"-D");
+		arguments.push_back(define);
+	}
+	arguments.insert(arguments.end(), desc.arguments.begin(), desc.arguments.end());
+	return arguments;
+}
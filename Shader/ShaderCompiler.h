@@ -0,0 +1,108 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// dxc
+#include <dxcapi.h>
+
+/// <summary>
+/// コンパイルの設定
+/// </summary>
+enum class ShaderBuildConfig : uint32_t {
+	Debug,		// 最適化なし・デバッグ情報を埋め込む
+	Release,	// -O3・デバッグ情報はPDBに分けてDXILからは外す
+};
+
+#ifdef _DEBUG
+static const ShaderBuildConfig kDefaultShaderBuildConfig = ShaderBuildConfig::Debug;
+#else
+static const ShaderBuildConfig kDefaultShaderBuildConfig = ShaderBuildConfig::Release;
+#endif
+
+/// Release設定で分けたPDBの置き場所(PIX等にはここを教える)
+static const wchar_t* const kShaderPdbDirectory = L"Resource/ShaderCache/Pdb";
+
+/// <summary>
+/// 設定ごとのコンパイルオプション
+/// </summary>
+std::vector<std::wstring> MakeShaderBuildArguments(ShaderBuildConfig config);
+
+/// <summary>
+/// コンパイルするシェーダーの指定(キャッシュのキーにもなる)
+/// </summary>
+struct ShaderCompileDesc {
+	std::wstring filePath;
+	std::wstring profile;					// vs_6_0, ps_6_0 など
+	std::wstring entryPoint = L"main";
+	// -D で渡すマクロ(NAME か NAME=VALUE)
+	std::vector<std::wstring> defines;
+	// ファイル名・-E・-T・-D 以外のオプション
+	std::vector<std::wstring> arguments = MakeShaderBuildArguments(kDefaultShaderBuildConfig);
+};
+
+/// <summary>
+/// コンパイル結果が依存しているファイル(元のファイルとinclude)と、その時の内容のハッシュ
+/// </summary>
+struct ShaderDependency {
+	std::wstring filePath;
+	uint64_t hash = 0;
+};
+
+/// <summary>
+/// DXCでHLSLをDXILにする
+/// IDxcCompiler3はスレッドセーフではないので、並列に使う場合はスレッドごとに作る
+/// </summary>
+class ShaderCompiler {
+public:
+
+	ShaderCompiler() = default;
+	~ShaderCompiler();
+	ShaderCompiler(const ShaderCompiler&) = delete;
+	const ShaderCompiler& operator=(const ShaderCompiler&) = delete;
+
+	void Init();
+
+	void Finalize();
+
+	/// <summary>
+	/// コンパイルする。エラーはログに出してnullptrを返す
+	/// デバッグ情報を分けた場合(-Qstrip_debug)はPDBをkShaderPdbDirectoryに書き出す
+	/// </summary>
+	/// <param name="desc"></param>
+	/// <param name="outDependencies">読んだファイルの一覧(不要ならnullptr)</param>
+	/// <param name="outReflection">リフレクション(-Qstrip_reflectでDXILから外しても取れる。不要ならnullptr。使い終わったらRelease)</param>
+	/// <returns>DXIL(使い終わったらRelease)</returns>
+	IDxcBlob* Compile(const ShaderCompileDesc& desc, std::vector<ShaderDependency>* outDependencies = nullptr, IDxcBlob** outReflection = nullptr);
+
+	/// <summary>
+	/// DXIL等をIDxcBlobにする(中身はコピーされる)
+	/// </summary>
+	IDxcBlob* CreateBlob(const void* data, size_t size);
+
+public: // accessor
+
+	IDxcUtils* GetUtils() const { return dxcUtils_; }
+
+private:
+
+	/// <summary>
+	/// 分けたPDBを保存する
+	/// </summary>
+	void WritePdb(IDxcResult* shaderResult);
+
+private:
+	IDxcUtils* dxcUtils_ = nullptr;
+	IDxcCompiler3* dxcCompiler_ = nullptr;
+	IDxcIncludeHandler* includeHandler_ = nullptr;
+};
+
+/// <summary>
+/// 依存ファイルの比較に使う形にパスを揃える("./a//b.hlsli" → "a/b.hlsli")
+/// </summary>
+std::wstring NormalizeShaderPath(const std::wstring& filePath);
+
+/// <summary>
+/// コンパイルに渡すオプションの一覧(ファイル名・エントリーポイント・プロファイル・マクロを含む)
+/// </summary>
+std::vector<std::wstring> BuildShaderArguments(const ShaderCompileDesc& desc);
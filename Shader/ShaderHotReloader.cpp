@@ -0,0 +1,202 @@
+#include "ShaderHotReloader.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <format>
+
+#include "Function/Convert.h"
+#include "Function/DirectXUtils.h"
+
+ShaderHotReloader::~ShaderHotReloader() {
+	Finalize();
+}
+
+//=============================================================================================================================
+//	初期化・終了
+//=============================================================================================================================
+void ShaderHotReloader::Init(ShaderCompileService* service, uint32_t pollIntervalMs) {
+	assert(service);
+	service_ = service;
+	pollIntervalMs_ = pollIntervalMs;
+}
+
+void ShaderHotReloader::Finalize() {
+	if (thread_.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stop_ = true;
+		}
+		stopCondition_.notify_all();
+		thread_.join();
+	}
+
+	for (Pipeline& pipeline : pipelines_) {
+		ReleaseBuildResult(pipeline.pending);
+	}
+	pipelines_.clear();
+
+	for (PendingRelease& pending : pendingReleases_) {
+		pending.object->Release();
+	}
+	pendingReleases_.clear();
+}
+
+void ShaderHotReloader::AddPipeline(ID3D12PipelineState** target, ID3D12RootSignature** rootSignatureTarget, const std::vector<ShaderCompileService::ShaderId>& shaders, PipelineBuilder builder, LayoutSetter setLayout) {
+	assert(target && rootSignatureTarget && builder && setLayout);
+	assert(!thread_.joinable());
+	Pipeline& pipeline = pipelines_.emplace_back();
+	pipeline.target = target;
+	pipeline.rootSignatureTarget = rootSignatureTarget;
+	pipeline.shaders = shaders;
+	pipeline.builder = std::move(builder);
+	pipeline.setLayout = std::move(setLayout);
+}
+
+void ShaderHotReloader::Start() {
+	assert(service_);
+	assert(!thread_.joinable());
+	// 今の状態を基準にする(ここで監視を始めたファイルは変更扱いにしない)
+	UpdateWatchFiles();
+	stop_ = false;
+	thread_ = std::thread(&ShaderHotReloader::ThreadMain, this);
+	Log(std::format("ShaderHotReloader: watching {} files\n", watcher_.GetFileCount()));
+}
+
+//=============================================================================================================================
+//	差し替え(メインスレッド)
+//=============================================================================================================================
+void ShaderHotReloader::Update(uint64_t fenceValue, uint64_t completedFenceValue) {
+	// GPUが使い終わった古いPSO・ルートシグネチャを解放する ----------------
+	for (size_t index = 0; index < pendingReleases_.size();) {
+		if (pendingReleases_[index].fenceValue <= completedFenceValue) {
+			pendingReleases_[index].object->Release();
+			pendingReleases_[index] = pendingReleases_.back();
+			pendingReleases_.pop_back();
+		} else {
+			++index;
+		}
+	}
+
+	// 出来上がったルートシグネチャとPSOを差し替える ----------------------
+	// 裏のスレッドが書き込み中なら次のフレームに回す(描画を待たせない)
+	std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+	if (!lock.owns_lock()) {
+		return;
+	}
+	for (Pipeline& pipeline : pipelines_) {
+		BuildResult& pending = pipeline.pending;
+		if (!pending.pipelineState) {
+			continue;
+		}
+		// 元のものは今のフレームのコマンドが終わるまで使われている
+		if (*pipeline.target) {
+			pendingReleases_.push_back({ *pipeline.target, fenceValue });
+		}
+		*pipeline.target = pending.pipelineState;
+		pending.pipelineState = nullptr;
+		++reloadCount_;
+
+		if (*pipeline.rootSignatureTarget != pending.rootSignature) {
+			++rootSignatureReloadCount_;
+		}
+		if (*pipeline.rootSignatureTarget) {
+			pendingReleases_.push_back({ *pipeline.rootSignatureTarget, fenceValue });
+		}
+		*pipeline.rootSignatureTarget = pending.rootSignature;
+		pending.rootSignature = nullptr;
+		// 形のハッシュには名前を含めないので、同じルートシグネチャでも名前 → 番号は変わっているかもしれない
+		pipeline.setLayout(pending.layout);
+	}
+}
+
+//=============================================================================================================================
+//	監視・コンパイル(裏のスレッド)
+//=============================================================================================================================
+void ShaderHotReloader::ThreadMain() {
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			if (stopCondition_.wait_for(lock, std::chrono::milliseconds(pollIntervalMs_), [this] { return stop_; })) {
+				return;
+			}
+		}
+
+		const std::vector<std::wstring> changedFiles = watcher_.Poll();
+		if (!changedFiles.empty()) {
+			Reload(changedFiles);
+		}
+	}
+}
+
+void ShaderHotReloader::Reload(const std::vector<std::wstring>& changedFiles) {
+	std::vector<ShaderCompileService::ShaderId> shaders;
+	for (const std::wstring& filePath : changedFiles) {
+		Log(ConvertString(std::format(L"ShaderHotReloader: changed {}\n", filePath)));
+		const std::vector<ShaderCompileService::ShaderId> dependents = service_->Invalidate(filePath);
+		shaders.insert(shaders.end(), dependents.begin(), dependents.end());
+	}
+	if (shaders.empty()) {
+		return;
+	}
+
+	// コンパイルできたかはバージョンが上がったかで見る
+	std::vector<uint32_t> versions(service_->GetShaderCount());
+	for (ShaderCompileService::ShaderId id = 0; id < versions.size(); ++id) {
+		versions[id] = service_->GetVersion(id);
+	}
+	if (!service_->Compile(shaders)) {
+		// エラーはコンパイラがログに出している。失敗したシェーダーを使うPSOはそのまま
+		Log("ShaderHotReloader: compile failed, keeping previous pipeline\n");
+	}
+
+	// includeが増減しているかもしれない
+	UpdateWatchFiles();
+
+	for (Pipeline& pipeline : pipelines_) {
+		bool isChanged = false;
+		bool hasError = false;
+		for (ShaderCompileService::ShaderId id : pipeline.shaders) {
+			isChanged |= service_->GetVersion(id) != versions[id];
+			hasError |= service_->HasError(id);
+		}
+		if (!isChanged || hasError) {
+			continue;
+		}
+
+		// リソースが増減・移動していればルートシグネチャも新しいリフレクションから作り直す
+		BuildResult result = pipeline.builder();
+		if (!result.pipelineState) {
+			ReleaseBuildResult(result);
+			Log("ShaderHotReloader: failed to create pipeline, keeping previous pipeline\n");
+			continue;
+		}
+		assert(result.rootSignature);
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		ReleaseBuildResult(pipeline.pending);
+		pipeline.pending = std::move(result);
+	}
+}
+
+void ShaderHotReloader::ReleaseBuildResult(BuildResult& result) {
+	if (result.pipelineState) {
+		result.pipelineState->Release();
+		result.pipelineState = nullptr;
+	}
+	if (result.rootSignature) {
+		result.rootSignature->Release();
+		result.rootSignature = nullptr;
+	}
+}
+
+void ShaderHotReloader::UpdateWatchFiles() {
+	std::vector<std::wstring> files;
+	for (ShaderCompileService::ShaderId id = 0; id < service_->GetShaderCount(); ++id) {
+		for (const ShaderDependency& dependency : service_->GetDependencies(id)) {
+			if (std::find(files.begin(), files.end(), dependency.filePath) == files.end()) {
+				files.push_back(dependency.filePath);
+			}
+		}
+	}
+	watcher_.SetFiles(files);
+}
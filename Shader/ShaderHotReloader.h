@@ -0,0 +1,148 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <d3d12.h>
+
+#include "DirectXCommon/RootSignatureCache.h"
+#include "Function/FileWatcher.h"
+#include "Shader/ShaderCompileService.h"
+
+/// <summary>
+/// シェーダーのファイル(includeを含む)が変わったら裏のスレッドでコンパイルし直し、ルートシグネチャとPSOを作り直す
+/// 作ったものはUpdate(フレームの区切り)で差し替えるので、描画は止まらない
+/// Start後はShaderCompileServiceをこのクラスのスレッドだけが使う
+/// </summary>
+class ShaderHotReloader {
+public:
+
+	/// <summary>
+	/// 作り直したルートシグネチャとPSO(どちらも参照を1つ持つ)
+	/// </summary>
+	struct BuildResult {
+		ID3D12PipelineState* pipelineState = nullptr;
+		// 新しいリフレクションから作ったもの(リソースが変わっていなければ今と同じもの)
+		ID3D12RootSignature* rootSignature = nullptr;
+		RootSignatureLayout layout;
+	};
+
+	/// ルートシグネチャとPSOを作る(裏のスレッドで呼ばれる)。失敗したらpipelineStateをnullptrにして返す
+	using PipelineBuilder = std::function<BuildResult()>;
+
+	/// 差し替えた後で呼ぶ(メインスレッド。ルートパラメータの番号を引き直す)
+	using LayoutSetter = std::function<void(const RootSignatureLayout&)>;
+
+public:
+
+	ShaderHotReloader() = default;
+	~ShaderHotReloader();
+	ShaderHotReloader(const ShaderHotReloader&) = delete;
+	const ShaderHotReloader& operator=(const ShaderHotReloader&) = delete;
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="service"></param>
+	/// <param name="pollIntervalMs">ファイルを見に行く間隔(ミリ秒)</param>
+	void Init(ShaderCompileService* service, uint32_t pollIntervalMs = 500);
+
+	/// <summary>
+	/// スレッドを止め、まだ差し替えていないPSOを解放する(GPUの完了を待ってから呼ぶ)
+	/// </summary>
+	void Finalize();
+
+	/// <summary>
+	/// 作り直すPSOを登録する(Startより前に呼ぶ)
+	/// </summary>
+	/// <param name="target">差し替える先(元のPSOはGPUが使い終わったら解放する)</param>
+	/// <param name="rootSignatureTarget">PSOと一緒に差し替えるルートシグネチャ(元のものはGPUが使い終わったら解放する)</param>
+	/// <param name="shaders">PSOが使っているシェーダー</param>
+	/// <param name="builder"></param>
+	/// <param name="setLayout"></param>
+	void AddPipeline(ID3D12PipelineState** target, ID3D12RootSignature** rootSignatureTarget, const std::vector<ShaderCompileService::ShaderId>& shaders, PipelineBuilder builder, LayoutSetter setLayout);
+
+	/// <summary>
+	/// 監視を始める
+	/// </summary>
+	void Start();
+
+	/// <summary>
+	/// 出来上がったPSOを差し替え、GPUが使い終わった古いPSOを解放する(フレームの区切りで呼ぶ)
+	/// </summary>
+	/// <param name="fenceValue">今のフレームで使ったPSOが使い終わるフェンス値</param>
+	/// <param name="completedFenceValue">GPUが終わらせたフェンス値</param>
+	void Update(uint64_t fenceValue, uint64_t completedFenceValue);
+
+public: // accessor
+
+	/// 差し替えたPSOの数
+	uint32_t GetReloadCount() const { return reloadCount_.load(); }
+
+	/// 別のルートシグネチャに差し替えた数(リソースが変わった回数)
+	uint32_t GetRootSignatureReloadCount() const { return rootSignatureReloadCount_.load(); }
+
+	bool IsRunning() const { return thread_.joinable(); }
+
+private:
+
+	struct Pipeline {
+		ID3D12PipelineState** target = nullptr;
+		ID3D12RootSignature** rootSignatureTarget = nullptr;
+		std::vector<ShaderCompileService::ShaderId> shaders;
+		PipelineBuilder builder;
+		LayoutSetter setLayout;
+		// 作ったがまだ差し替えていないもの(mutex_で守る。pipelineStateがnullptrならなし)
+		BuildResult pending;
+	};
+
+	/// <summary>
+	/// GPUが使い終わったら解放するPSO・ルートシグネチャ
+	/// </summary>
+	struct PendingRelease {
+		ID3D12DeviceChild* object;
+		uint64_t fenceValue;
+	};
+
+private:
+
+	void ThreadMain();
+
+	/// <summary>
+	/// 変わったファイルに依存するシェーダーをコンパイルし、影響するPSOを作り直す
+	/// </summary>
+	void Reload(const std::vector<std::wstring>& changedFiles);
+
+	/// <summary>
+	/// 全てのシェーダーが読んだファイルを監視対象にする
+	/// </summary>
+	void UpdateWatchFiles();
+
+	/// <summary>
+	/// 差し替えずに捨てる(一度も使われていないのですぐ解放できる)
+	/// </summary>
+	static void ReleaseBuildResult(BuildResult& result);
+
+private:
+	ShaderCompileService* service_ = nullptr;
+	uint32_t pollIntervalMs_ = 500;
+	FileWatcher watcher_;
+
+	// Start後は増減しない(pendingだけをmutex_で守って書き換える)
+	std::vector<Pipeline> pipelines_;
+	// メインスレッドだけが触る
+	std::vector<PendingRelease> pendingReleases_;
+
+	std::thread thread_;
+	std::mutex mutex_;
+	std::condition_variable stopCondition_;
+	bool stop_ = false;
+
+	std::atomic<uint32_t> reloadCount_ = 0;
+	std::atomic<uint32_t> rootSignatureReloadCount_ = 0;
+};
@@ -0,0 +1,77 @@
+#include "ShaderPermutation.h"
+#include <cassert>
+#include <format>
+
+#include "Function/Convert.h"
+#include "Function/DirectXUtils.h"
+
+void ShaderPermutation::Init(ShaderCompileService* service, const ShaderPermutationDesc& desc) {
+	assert(service);
+	assert(desc.features.size() <= kMaxFeatures);
+	service_ = service;
+	desc_ = desc;
+
+	const uint32_t variantCount = 1u << desc.features.size();
+	variants_.resize(variantCount);
+	for (uint32_t mask = 0; mask < variantCount; ++mask) {
+		ShaderCompileDesc compileDesc;
+		compileDesc.filePath = desc.filePath;
+		compileDesc.profile = desc.profile;
+		compileDesc.entryPoint = desc.entryPoint;
+		compileDesc.arguments = MakeShaderBuildArguments(desc.config);
+		for (uint32_t bit = 0; bit < desc.features.size(); ++bit) {
+			if (mask & (1u << bit)) {
+				compileDesc.defines.push_back(desc.features[bit] + L"=1");
+			}
+		}
+		variants_[mask] = service->Register(compileDesc);
+	}
+}
+
+uint32_t ShaderPermutation::GetFeatureBit(const std::wstring& feature) const {
+	for (uint32_t bit = 0; bit < desc_.features.size(); ++bit) {
+		if (desc_.features[bit] == feature) {
+			return 1u << bit;
+		}
+	}
+	return 0;
+}
+
+ShaderCompileService::ShaderId ShaderPermutation::GetShader(uint32_t featureMask) const {
+	assert(!variants_.empty());	// Init前
+	assert((featureMask & ~GetFeatureMask()) == 0);	// 宣言していない機能のビット
+	if (variants_.empty()) {
+		return ShaderCompileService::kInvalidShader;
+	}
+	return variants_[featureMask & GetFeatureMask()];
+}
+
+IDxcBlob* ShaderPermutation::GetBlob(uint32_t featureMask) const {
+	const ShaderCompileService::ShaderId shader = GetShader(featureMask);
+	if (shader == ShaderCompileService::kInvalidShader) {
+		return nullptr;
+	}
+	return service_->GetBlob(shader);
+}
+
+void ShaderPermutation::LogStatistics() const {
+	const wchar_t* configName = desc_.config == ShaderBuildConfig::Release ? L"Release" : L"Debug";
+	size_t totalSize = 0;
+	float totalTime = 0.0f;
+	for (uint32_t mask = 0; mask < variants_.size(); ++mask) {
+		// 有効な機能の名前を並べる
+		std::wstring features;
+		for (uint32_t bit = 0; bit < desc_.features.size(); ++bit) {
+			if (mask & (1u << bit)) {
+				features += (features.empty() ? L"" : L"|") + desc_.features[bit];
+			}
+		}
+		IDxcBlob* blob = service_->GetBlob(variants_[mask]);
+		const size_t size = blob ? blob->GetBufferSize() : 0;
+		const float time = service_->GetCompileTime(variants_[mask]);
+		totalSize += size;
+		totalTime += time;
+		Log(ConvertString(std::format(L"  {} [{}] {}: {} bytes, {:.1f}ms\n", desc_.filePath, features.empty() ? L"-" : features, configName, size, time)));
+	}
+	Log(ConvertString(std::format(L"{} {}: {} variants, {} bytes, {:.1f}ms\n", desc_.filePath, configName, variants_.size(), totalSize, totalTime)));
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Shader/ShaderCompileService.h"
+
+/// <summary>
+/// シェーダーが持つ機能(define)の一覧
+/// features[i] がビットi に対応し、ビットが立っていれば "-D 名前=1" でコンパイルする
+/// </summary>
+struct ShaderPermutationDesc {
+	std::wstring filePath;
+	std::wstring profile;
+	std::wstring entryPoint = L"main";
+	std::vector<std::wstring> features;
+	ShaderBuildConfig config = kDefaultShaderBuildConfig;
+};
+
+/// <summary>
+/// 機能の組み合わせ(ビットマスク)ごとのシェーダー
+/// 全ての組み合わせをShaderCompileServiceに登録し、描画時はマスクを添字にして引く
+/// </summary>
+class ShaderPermutation {
+public:
+
+	/// 組み合わせは 2^機能数 あるので増やしすぎない
+	static const uint32_t kMaxFeatures = 8;
+
+public:
+
+	/// <summary>
+	/// 全ての組み合わせを登録する(コンパイルはShaderCompileServiceで行う)
+	/// </summary>
+	/// <param name="service"></param>
+	/// <param name="desc"></param>
+	void Init(ShaderCompileService* service, const ShaderPermutationDesc& desc);
+
+	/// <summary>
+	/// 機能名からビットを求める(ない場合は0)
+	/// </summary>
+	uint32_t GetFeatureBit(const std::wstring& feature) const;
+
+	/// <summary>
+	/// 機能の組み合わせのシェーダー
+	/// 宣言していない機能のビットは別の組み合わせに化けないように落とす(デバッグではassert)
+	/// </summary>
+	/// <returns>Init前はkInvalidShader</returns>
+	ShaderCompileService::ShaderId GetShader(uint32_t featureMask) const;
+
+	/// <summary>
+	/// 機能の組み合わせのDXIL(Init前・コンパイル前はnullptr)
+	/// </summary>
+	IDxcBlob* GetBlob(uint32_t featureMask) const;
+
+	/// <summary>
+	/// 組み合わせごとのDXILの大きさとコンパイル時間をログに出す
+	/// </summary>
+	void LogStatistics() const;
+
+public: // accessor
+
+	/// 宣言した機能のビットを全て立てたマスク
+	uint32_t GetFeatureMask() const { return (1u << desc_.features.size()) - 1; }
+
+	/// 全ての組み合わせ(Compileにそのまま渡せる)
+	const std::vector<ShaderCompileService::ShaderId>& GetShaders() const { return variants_; }
+
+	uint32_t GetVariantCount() const { return uint32_t(variants_.size()); }
+
+private:
+	ShaderCompileService* service_ = nullptr;
+	ShaderPermutationDesc desc_;
+	// 添字が機能のビットマスク
+	std::vector<ShaderCompileService::ShaderId> variants_;
+};
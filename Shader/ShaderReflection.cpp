@@ -0,0 +1,71 @@
+#include "ShaderReflection.h"
+#include <format>
+
+#include <d3d12shader.h>
+
+#include "Function/DirectXUtils.h"
+
+bool ReflectShaderBindings(IDxcUtils* utils, IDxcBlob* reflection, D3D12_SHADER_VISIBILITY visibility, std::vector<ShaderBinding>& outBindings) {
+	if (!utils || !reflection) {
+		return false;
+	}
+
+	DxcBuffer reflectionBuffer{};
+	reflectionBuffer.Ptr = reflection->GetBufferPointer();
+	reflectionBuffer.Size = reflection->GetBufferSize();
+	reflectionBuffer.Encoding = DXC_CP_ACP;
+	ID3D12ShaderReflection* shaderReflection = nullptr;
+	HRESULT hr = utils->CreateReflection(&reflectionBuffer, IID_PPV_ARGS(&shaderReflection));
+	if (FAILED(hr)) {
+		Log(std::format("ReflectShaderBindings: failed to create reflection (hr = {:#x})\n", uint32_t(hr)));
+		return false;
+	}
+
+	D3D12_SHADER_DESC shaderDesc{};
+	shaderReflection->GetDesc(&shaderDesc);
+	for (UINT index = 0; index < shaderDesc.BoundResources; ++index) {
+		D3D12_SHADER_INPUT_BIND_DESC bindDesc{};
+		shaderReflection->GetResourceBindingDesc(index, &bindDesc);
+
+		ShaderBinding binding;
+		switch (bindDesc.Type) {
+		case D3D_SIT_CBUFFER:
+			binding.type = ShaderBindingType::ConstantBuffer;
+			break;
+		case D3D_SIT_STRUCTURED:
+		case D3D_SIT_BYTEADDRESS:
+		case D3D_SIT_RTACCELERATIONSTRUCTURE:
+			binding.type = ShaderBindingType::Buffer;
+			break;
+		case D3D_SIT_UAV_RWSTRUCTURED:
+		case D3D_SIT_UAV_RWBYTEADDRESS:
+		case D3D_SIT_UAV_APPEND_STRUCTURED:
+		case D3D_SIT_UAV_CONSUME_STRUCTURED:
+		case D3D_SIT_UAV_RWSTRUCTURED_WITH_COUNTER:
+			binding.type = ShaderBindingType::RWBuffer;
+			break;
+		case D3D_SIT_TBUFFER:
+		case D3D_SIT_TEXTURE:
+			binding.type = ShaderBindingType::Texture;
+			break;
+		case D3D_SIT_UAV_RWTYPED:
+			binding.type = ShaderBindingType::RWTexture;
+			break;
+		case D3D_SIT_SAMPLER:
+			binding.type = ShaderBindingType::Sampler;
+			break;
+		default:
+			Log(std::format("ReflectShaderBindings: unsupported resource type {} ({})\n", uint32_t(bindDesc.Type), bindDesc.Name));
+			continue;
+		}
+		binding.name = bindDesc.Name;
+		binding.shaderRegister = bindDesc.BindPoint;
+		binding.registerSpace = bindDesc.Space;
+		binding.count = bindDesc.BindCount;
+		binding.visibility = visibility;
+		outBindings.push_back(std::move(binding));
+	}
+
+	shaderReflection->Release();
+	return true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <d3d12.h>
+// dxc
+#include <dxcapi.h>
+
+/// <summary>
+/// シェーダーが使うリソースの種類(ルートパラメータの作り方が変わる単位)
+/// </summary>
+enum class ShaderBindingType : uint32_t {
+	ConstantBuffer,		// cbuffer / ConstantBuffer<T>        → ルートCBV
+	Buffer,				// StructuredBuffer / ByteAddressBuffer → ルートSRV
+	RWBuffer,			// RWStructuredBuffer 等               → ルートUAV
+	Texture,			// Texture2D 等                        → DescriptorTable(SRV)
+	RWTexture,			// RWTexture2D 等                      → DescriptorTable(UAV)
+	Sampler,			// SamplerState                        → StaticSampler
+};
+
+/// <summary>
+/// シェーダーのリソース1つ分の情報
+/// </summary>
+struct ShaderBinding {
+	std::string name;
+	ShaderBindingType type = ShaderBindingType::ConstantBuffer;
+	uint32_t shaderRegister = 0;
+	uint32_t registerSpace = 0;
+	// 配列の要素数(0は大きさ指定なし)
+	uint32_t count = 1;
+	D3D12_SHADER_VISIBILITY visibility = D3D12_SHADER_VISIBILITY_ALL;
+};
+
+/// <summary>
+/// DXCのリフレクションからリソースの一覧を取り出す
+/// </summary>
+/// <param name="utils"></param>
+/// <param name="reflection">ShaderCompileService::GetReflectionの結果</param>
+/// <param name="visibility">どのステージのシェーダーか</param>
+/// <param name="outBindings">末尾に追加する</param>
+/// <returns>リフレクションが読めたか</returns>
+bool ReflectShaderBindings(IDxcUtils* utils, IDxcBlob* reflection, D3D12_SHADER_VISIBILITY visibility, std::vector<ShaderBinding>& outBindings);
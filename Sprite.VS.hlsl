@@ -0,0 +1,21 @@
+#include "Sprite.hlsli"
+
+struct SpriteProjection{
+    float4x4 projection;
+};
+
+// スクリーン座標(ピクセル)をクリップ空間にする
+ConstantBuffer<SpriteProjection> gSpriteProjection : register(b0);
+struct SpriteVertexInput{
+    float2 position : POSITION0;
+    float2 texcoord : TEXCOORD0;
+    float4 color : COLOR0;
+};
+
+SpriteVertexOutput main(SpriteVertexInput input){
+    SpriteVertexOutput output;
+    output.position = mul(float4(input.position, 0.0f, 1.0f), gSpriteProjection.projection);
+    output.texcoord = input.texcoord;
+    output.color = input.color;
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,5 @@
+struct SpriteVertexOutput{
+    float4 position : SV_POSITION;
+    float2 texcoord : TEXCOORD0;
+    float4 color : COLOR0;
+};
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+/*================================================================================================
+ベンチマークの最小限の仕組み(D3D12もデバイスも使わないものだけを測る)
+	BENCHMARK(名前) { ... }    関数を登録する。main.cppがまとめて実行する
+	中で測って結果をprintfする。最適化で消えないように、結果はBenchmarkSinkに足しておく
+Releaseで実行すること
+==================================================================================================*/
+
+/// <summary>
+/// 登録されたベンチマーク
+/// </summary>
+struct BenchmarkCase {
+	const char* name;
+	void (*function)();
+};
+
+inline std::vector<BenchmarkCase>& GetBenchmarkCases() {
+	static std::vector<BenchmarkCase> benchmarkCases;
+	return benchmarkCases;
+}
+
+struct BenchmarkRegistrar {
+	BenchmarkRegistrar(const char* name, void (*function)()) { GetBenchmarkCases().push_back({ name, function }); }
+};
+
+/// 計算結果の捨て場所(最適化で計算ごと消されないようにする)
+inline volatile uint64_t BenchmarkSink = 0;
+
+/// <summary>
+/// functionをrepeatCount回呼んだ時間(ミリ秒)
+/// </summary>
+template<typename Function>
+double MeasureMilliseconds(uint32_t repeatCount, Function&& function) {
+	const auto start = std::chrono::steady_clock::now();
+	for (uint32_t repeat = 0; repeat < repeatCount; ++repeat) {
+		function();
+	}
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// <summary>
+/// プロセスのメモリ使用量(バイト)
+/// </summary>
+struct MemoryUsage {
+	uint64_t workingSet;		// 物理メモリに載っている分(マップしたファイルの読んだページを含む)
+	uint64_t privateBytes;		// このプロセスだけのもの(ヒープ等。マップしたファイルは含まない)
+};
+
+/// <summary>
+/// 今のメモリ使用量(OSごとの取り方はmain.cpp)
+/// </summary>
+MemoryUsage GetMemoryUsage();
+
+#define BENCHMARK(name) \
+	static void name(); \
+	static BenchmarkRegistrar name##Registrar(#name, name); \
+	static void name()
@@ -0,0 +1,118 @@
+#include <random>
+#include <vector>
+
+#include "BenchmarkFramework.h"
+#include "DirectXCommon/DescriptorAllocator.h"
+
+namespace {
+
+const uint32_t kPersistentCount = 4096;
+const uint32_t kTransientCount = 65536;
+const uint32_t kFramesInFlight = 3;
+
+} // namespace
+
+/// <summary>
+/// 常駐の確保・解放をランダムな順で繰り返す(テクスチャの読み込み・破棄が続く状態)
+/// </summary>
+BENCHMARK(DescriptorAllocator_PersistentChurn) {
+	DescriptorAllocator allocator;
+	allocator.Init(kPersistentCount, kTransientCount);
+
+	std::mt19937 random(1);
+	std::vector<uint32_t> live;
+	live.reserve(kPersistentCount);
+	const uint32_t operationCount = 1000000;
+	uint64_t failedCount = 0;
+
+	const double time = MeasureMilliseconds(10, [&]() {
+		for (uint32_t operation = 0; operation < operationCount; ++operation) {
+			// 半分くらい埋まった状態を保つ
+			if (live.empty() || (live.size() < kPersistentCount / 2 + (random() & 1023))) {
+				const uint32_t index = allocator.AllocatePersistent();
+				if (index == DescriptorAllocator::kInvalidIndex) {
+					++failedCount;
+					continue;
+				}
+				live.push_back(index);
+			} else {
+				const size_t slot = random() % live.size();
+				allocator.FreePersistent(live[slot]);
+				live[slot] = live.back();
+				live.pop_back();
+			}
+		}
+	});
+	BenchmarkSink = BenchmarkSink + live.size() + failedCount;
+
+	std::printf("  %u operations x 10: %.2f ms (%.1f ns/op), %llu failed, %u live\n",
+		operationCount, time, time * 1e6 / (operationCount * 10.0), static_cast<unsigned long long>(failedCount), allocator.GetPersistentUsedCount());
+}
+
+/// <summary>
+/// 一時の確保を1フレームに大量に行い、フェンスが遅れて進む状態を続ける(DescriptorTableを毎ドロー作る場合)
+/// </summary>
+BENCHMARK(DescriptorAllocator_TransientFrames) {
+	DescriptorAllocator allocator;
+	allocator.Init(kPersistentCount, kTransientCount);
+
+	std::mt19937 random(2);
+	const uint32_t frameCount = 10000;
+	// 1フレームに使える量の範囲でばらつかせる(テーブルの大きさは1～8)
+	const uint32_t tablesPerFrame = 2000;
+	uint64_t fenceValue = 1;
+	uint64_t allocationCount = 0;
+	uint64_t failedCount = 0;
+
+	const double time = MeasureMilliseconds(1, [&]() {
+		for (uint32_t frame = 0; frame < frameCount; ++frame) {
+			for (uint32_t table = 0; table < tablesPerFrame; ++table) {
+				const uint32_t index = allocator.AllocateTransient(1 + (random() & 7));
+				++allocationCount;
+				if (index == DescriptorAllocator::kInvalidIndex) {
+					++failedCount;
+				}
+			}
+			// GPUはkFramesInFlight前のフレームまで終わっている
+			allocator.EndFrame(fenceValue, fenceValue >= kFramesInFlight ? fenceValue - kFramesInFlight : 0);
+			++fenceValue;
+		}
+	});
+	BenchmarkSink = BenchmarkSink + allocationCount;
+
+	std::printf("  %llu allocations: %.2f ms (%.1f ns/op), %llu failed\n",
+		static_cast<unsigned long long>(allocationCount), time, time * 1e6 / double(allocationCount), static_cast<unsigned long long>(failedCount));
+}
+
+/// <summary>
+/// 一時の領域を使い切る状態が続いても、無効な番号を返すだけで壊れないことを確かめる
+/// </summary>
+BENCHMARK(DescriptorAllocator_TransientExhaustion) {
+	DescriptorAllocator allocator;
+	allocator.Init(0, 1024);
+
+	uint64_t fenceValue = 1;
+	uint64_t allocationCount = 0;
+	uint64_t failedCount = 0;
+	uint64_t outOfRangeCount = 0;
+
+	const double time = MeasureMilliseconds(1, [&]() {
+		for (uint32_t frame = 0; frame < 100000; ++frame) {
+			// 1フレームで容量より多く要求する
+			for (uint32_t table = 0; table < 200; ++table) {
+				const uint32_t index = allocator.AllocateTransient(8);
+				++allocationCount;
+				if (index == DescriptorAllocator::kInvalidIndex) {
+					++failedCount;
+				} else if (index + 8 > allocator.GetTotalCount()) {
+					++outOfRangeCount;
+				}
+			}
+			allocator.EndFrame(fenceValue, fenceValue >= kFramesInFlight ? fenceValue - kFramesInFlight : 0);
+			++fenceValue;
+		}
+	});
+
+	std::printf("  %llu allocations: %.2f ms, %llu failed, %llu out of range\n",
+		static_cast<unsigned long long>(allocationCount), time, static_cast<unsigned long long>(failedCount), static_cast<unsigned long long>(outOfRangeCount));
+}
@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "BenchmarkFramework.h"
+#include "DirectXCommon/InstanceData.h"
+#include "MyMatrix.h"
+
+/*================================================================================================
+インスタンス描画の値を詰める時間
+100万インスタンスについて、DrawInstancesと同じく PackInstances でまとめて書く場合と、
+1つずつ MakeAffineMatrix → Multiply して InstanceData に書く場合の1フレーム分を比べる
+書き込み先はアップロードヒープの代わりに先に触っておいた配列。結果の差(相対)も出す
+==================================================================================================*/
+
+namespace {
+
+const size_t kInstanceCount = 1000000;
+const uint32_t kFrameCount = 10;
+
+/// <summary>
+/// 要素ごとの差を、値の大きさ(1未満は1)で割った最大値(全てのインスタンスの行列で)
+/// </summary>
+float GetMaxRelativeDifference(const std::vector<InstanceData>& a, const std::vector<InstanceData>& b) {
+	float difference = 0.0f;
+	for (size_t index = 0; index < a.size(); ++index) {
+		for (int row = 0; row < 4; ++row) {
+			for (int col = 0; col < 4; ++col) {
+				const float wvpScale = (std::max)(1.0f, std::abs(b[index].WVP.m[row][col]));
+				const float worldScale = (std::max)(1.0f, std::abs(b[index].World.m[row][col]));
+				difference = (std::max)({ difference,
+					std::abs(a[index].WVP.m[row][col] - b[index].WVP.m[row][col]) / wvpScale,
+					std::abs(a[index].World.m[row][col] - b[index].World.m[row][col]) / worldScale });
+			}
+		}
+	}
+	return difference;
+}
+
+} // namespace
+
+BENCHMARK(InstanceData_PackInstances) {
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+	std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+	std::uniform_real_distribution<float> translate(-50.0f, 50.0f);
+	std::uniform_real_distribution<float> channel(0.0f, 1.0f);
+	TransformBatch batch;
+	batch.Reserve(kInstanceCount);
+	std::vector<Vector4> colors(kInstanceCount);
+	for (size_t index = 0; index < kInstanceCount; ++index) {
+		batch.Add({ { scale(random), scale(random), scale(random) }, { angle(random), angle(random), angle(random) },
+			{ translate(random), translate(random), translate(random) } });
+		colors[index] = { channel(random), channel(random), channel(random), 1.0f };
+	}
+	const Matrix4x4 view = InverseAffine(MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.2f, 0.0f, 0.0f }, { 0.0f, 10.0f, -80.0f }));
+	const Matrix4x4 vp = Multiply(view, MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 200.0f));
+
+	// 1つずつ(Object3dと同じ作り方)
+	std::vector<InstanceData> objectInstances(kInstanceCount);
+	const double objectTime = MeasureMilliseconds(kFrameCount, [&]() {
+		for (uint32_t index = 0; index < kInstanceCount; ++index) {
+			InstanceData& instance = objectInstances[index];
+			instance.World = MakeAffineMatrix(batch.Get(index));
+			instance.WVP = Multiply(instance.World, vp);
+			instance.color = colors[index];
+		}
+	}) / kFrameCount;
+	BenchmarkSink = BenchmarkSink + static_cast<uint64_t>(objectInstances.back().WVP.m[3][3] != 0.0f);
+
+	// PackInstances
+	std::vector<InstanceData> packedInstances(kInstanceCount);
+	const double packTime = MeasureMilliseconds(kFrameCount, [&]() {
+		PackInstances(batch, kInstanceCount, vp, colors.data(), packedInstances.data());
+	}) / kFrameCount;
+	BenchmarkSink = BenchmarkSink + static_cast<uint64_t>(packedInstances.back().WVP.m[3][3] != 0.0f);
+
+	std::printf("  %zu instances: per object %.1f ms, PackInstances %.1f ms (%.1f ns/instance), x%.1f\n",
+		kInstanceCount, objectTime, packTime, packTime * 1e6 / kInstanceCount, objectTime / packTime);
+	std::printf("  max relative difference: %.2g\n", GetMaxRelativeDifference(packedInstances, objectInstances));
+}
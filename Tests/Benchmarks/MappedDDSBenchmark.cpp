@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "BenchmarkFramework.h"
+#include "MappedDDS.h"
+
+/*================================================================================================
+DDSの読み込み時間とメモリ
+16MBのDDS(2048x2048 RGBA8、DX10ヘッダ)を24枚一時ディレクトリに書き出し、
+TextureManagerと同じく「読んでアップロード用のバッファにコピーする」までを
+LoadFromDDSFile(ヒープ → ScratchImage → コピー) と MappedDDS(マップ → コピー) で比べる
+メモリは1枚を持っている間の増分の最大値(マップしたページは共有なのでprivateには入らない)
+ファイルはOSのキャッシュに載った状態で測る
+==================================================================================================*/
+
+namespace {
+
+const uint32_t kTextureCount = 24;
+const uint32_t kTextureSize = 2048;
+
+/// <summary>
+/// 1枚ずつ模様を変えたDDSを書き出す
+/// 古いヘッダのRGBA8はMappedDDSが受け付けないので、DX10ヘッダにする
+/// </summary>
+std::vector<std::wstring> WriteTestTextures(const std::filesystem::path& directory) {
+	std::filesystem::create_directories(directory);
+	std::vector<std::wstring> files;
+	DirectX::ScratchImage image{};
+	if (FAILED(image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, kTextureSize, kTextureSize, 1, 1))) {
+		return files;
+	}
+	const DirectX::Image* pixels = image.GetImage(0, 0, 0);
+	for (uint32_t textureIndex = 0; textureIndex < kTextureCount; ++textureIndex) {
+		for (uint32_t y = 0; y < kTextureSize; ++y) {
+			uint8_t* row = pixels->pixels + size_t(y) * pixels->rowPitch;
+			for (uint32_t x = 0; x < kTextureSize; ++x) {
+				row[x * 4 + 0] = static_cast<uint8_t>(x + textureIndex);
+				row[x * 4 + 1] = static_cast<uint8_t>(y * 3 + textureIndex);
+				row[x * 4 + 2] = static_cast<uint8_t>((x ^ y) + textureIndex * 7);
+				row[x * 4 + 3] = 255;
+			}
+		}
+		const std::wstring file = (directory / (L"texture" + std::to_wstring(textureIndex) + L".dds")).wstring();
+		if (FAILED(DirectX::SaveToDDSFile(*pixels, DirectX::DDS_FLAGS_FORCE_DX10_EXT, file.c_str()))) {
+			break;
+		}
+		files.push_back(file);
+	}
+	return files;
+}
+
+/// <summary>
+/// サブリソースを順にアップロード用のバッファへ詰める(CreateUploadJobのコピーの代わり)
+/// </summary>
+size_t CopyImages(const DirectX::Image* images, size_t imageCount, std::vector<uint8_t>& uploadBuffer) {
+	size_t offset = 0;
+	for (size_t index = 0; index < imageCount; ++index) {
+		if (offset + images[index].slicePitch > uploadBuffer.size()) {
+			break;
+		}
+		std::memcpy(uploadBuffer.data() + offset, images[index].pixels, images[index].slicePitch);
+		offset += images[index].slicePitch;
+	}
+	return offset;
+}
+
+double ToMegabytes(uint64_t bytes) {
+	return double(bytes) / (1024.0 * 1024.0);
+}
+
+/// <summary>
+/// beforeからの増分でpeakを更新する(減った場合は0)
+/// </summary>
+void UpdatePeakGrowth(const MemoryUsage& before, MemoryUsage& peak) {
+	const MemoryUsage after = GetMemoryUsage();
+	if (after.workingSet > before.workingSet) {
+		peak.workingSet = (std::max)(peak.workingSet, after.workingSet - before.workingSet);
+	}
+	if (after.privateBytes > before.privateBytes) {
+		peak.privateBytes = (std::max)(peak.privateBytes, after.privateBytes - before.privateBytes);
+	}
+}
+
+} // namespace
+
+BENCHMARK(MappedDDS_MappedVsRead) {
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "DirectXGameMappedDDSBenchmark";
+	const std::vector<std::wstring> files = WriteTestTextures(directory);
+	if (files.size() != kTextureCount) {
+		std::printf("  failed to write test textures\n");
+		return;
+	}
+	// アップロード用のバッファの代わり(先に触っておき、増分に入れない)
+	std::vector<uint8_t> uploadBuffer(size_t(kTextureSize) * kTextureSize * 4, 1);
+	// 1回読んでキャッシュに載せる
+	for (const std::wstring& file : files) {
+		MappedDDS texture;
+		if (SUCCEEDED(texture.Open(file))) {
+			BenchmarkSink = BenchmarkSink + CopyImages(texture.GetImages(), texture.GetImageCount(), uploadBuffer);
+		}
+	}
+
+	// LoadFromDDSFile: ヒープに読み、ScratchImageにコピーしてからアップロード用のバッファへ
+	uint32_t readFailedCount = 0;
+	MemoryUsage readGrowth{};
+	const double readTime = MeasureMilliseconds(1, [&]() {
+		for (const std::wstring& file : files) {
+			const MemoryUsage before = GetMemoryUsage();
+			DirectX::ScratchImage image{};
+			if (FAILED(DirectX::LoadFromDDSFile(file.c_str(), DirectX::DDS_FLAGS_NONE, nullptr, image))) {
+				++readFailedCount;
+				continue;
+			}
+			BenchmarkSink = BenchmarkSink + CopyImages(image.GetImages(), image.GetImageCount(), uploadBuffer);
+			UpdatePeakGrowth(before, readGrowth);
+		}
+	}) / kTextureCount;
+	std::printf("  LoadFromDDSFile: %u files of %.0f MB, %.1f ms/file, +%.1f MB working set, +%.1f MB private (%u failed)\n",
+		kTextureCount, ToMegabytes(uploadBuffer.size()), readTime, ToMegabytes(readGrowth.workingSet), ToMegabytes(readGrowth.privateBytes), readFailedCount);
+
+	// MappedDDS: マップしたまま直接アップロード用のバッファへ
+	uint32_t mappedFailedCount = 0;
+	MemoryUsage mappedGrowth{};
+	const double mappedTime = MeasureMilliseconds(1, [&]() {
+		for (const std::wstring& file : files) {
+			const MemoryUsage before = GetMemoryUsage();
+			MappedDDS texture;
+			if (FAILED(texture.Open(file))) {
+				++mappedFailedCount;
+				continue;
+			}
+			BenchmarkSink = BenchmarkSink + CopyImages(texture.GetImages(), texture.GetImageCount(), uploadBuffer);
+			UpdatePeakGrowth(before, mappedGrowth);
+		}
+	}) / kTextureCount;
+	std::printf("  MappedDDS      : %.1f ms/file, +%.1f MB working set, +%.1f MB private, x%.1f (%u failed)\n",
+		mappedTime, ToMegabytes(mappedGrowth.workingSet), ToMegabytes(mappedGrowth.privateBytes), readTime / mappedTime, mappedFailedCount);
+
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+}
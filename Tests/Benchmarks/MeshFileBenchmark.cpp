@@ -0,0 +1,124 @@
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+#include "BenchmarkFramework.h"
+#include "MeshFile.h"
+#include "ObjLoader.h"
+
+/*================================================================================================
+メッシュの読み込み時間とメモリ
+格子のOBJ(三角形 約100万)と、それを焼いた.meshを一時ディレクトリに書き出し、
+main.cppと同じく「読んでアップロード用のバッファにコピーする」までを LoadObj と MappedMesh で比べる
+メモリは読み終わって結果を持っている間の増分(マップしたページは共有なのでprivateには入らない)
+ファイルはOSのキャッシュに載った状態で測る
+==================================================================================================*/
+
+namespace {
+
+const uint32_t kGridSize = 708;		// 708 * 708 * 2 = 約100万三角形
+const uint32_t kRepeatCount = 3;
+
+/// <summary>
+/// 高さを少しずつ変えた格子を書き出す(v/vt の面)
+/// </summary>
+bool WriteGridObj(const std::filesystem::path& path) {
+	FILE* file = std::fopen(path.string().c_str(), "wb");
+	if (!file) {
+		return false;
+	}
+	for (uint32_t y = 0; y <= kGridSize; ++y) {
+		for (uint32_t x = 0; x <= kGridSize; ++x) {
+			std::fprintf(file, "v %.6f %.6f %.6f\n", x * 0.01f - 3.5f, y * 0.01f - 3.5f, 0.001f * ((x * 7 + y * 13) % 100));
+			std::fprintf(file, "vt %.6f %.6f\n", float(x) / kGridSize, float(y) / kGridSize);
+		}
+	}
+	for (uint32_t y = 0; y < kGridSize; ++y) {
+		for (uint32_t x = 0; x < kGridSize; ++x) {
+			const uint32_t a = y * (kGridSize + 1) + x + 1;
+			const uint32_t b = a + 1;
+			const uint32_t c = a + kGridSize + 1;
+			const uint32_t d = c + 1;
+			std::fprintf(file, "f %u/%u %u/%u %u/%u %u/%u\n", a, a, b, b, d, d, c, c);
+		}
+	}
+	return std::fclose(file) == 0;
+}
+
+double ToMegabytes(uint64_t bytes) {
+	return double(bytes) / (1024.0 * 1024.0);
+}
+
+/// <summary>
+/// 前後のメモリの増分(減った場合は0)
+/// </summary>
+MemoryUsage GetGrowth(const MemoryUsage& before, const MemoryUsage& after) {
+	return {
+		after.workingSet > before.workingSet ? after.workingSet - before.workingSet : 0,
+		after.privateBytes > before.privateBytes ? after.privateBytes - before.privateBytes : 0,
+	};
+}
+
+} // namespace
+
+BENCHMARK(MeshFile_MappedVsObj) {
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "DirectXGameMeshFileBenchmark";
+	std::filesystem::create_directories(directory);
+	const std::filesystem::path objPath = directory / "grid.obj";
+	const std::filesystem::path meshPath = directory / "grid.mesh";
+	ObjModel cooked;
+	if (!WriteGridObj(objPath) || !LoadObj(objPath.wstring(), cooked) || !WriteMeshFile(meshPath.wstring(), cooked)) {
+		std::printf("  failed to write test files\n");
+		return;
+	}
+	std::error_code error;
+	const double objMegabytes = ToMegabytes(std::filesystem::file_size(objPath, error));
+	const double meshMegabytes = ToMegabytes(std::filesystem::file_size(meshPath, error));
+	// アップロード用のバッファの代わり(先に触っておき、増分に入れない)
+	std::vector<uint8_t> uploadBuffer(GetMeshByteSize(cooked.mesh), 1);
+	cooked = {};
+
+	// LoadObj: 解析して、頂点・インデックスを詰めてコピーする
+	MemoryUsage objGrowth{};
+	const double objTime = MeasureMilliseconds(kRepeatCount, [&]() {
+		const MemoryUsage before = GetMemoryUsage();
+		ObjModel model;
+		LoadObj(objPath.wstring(), model);
+		const size_t vertexBytes = model.mesh.vertices.size() * sizeof(VertexData);
+		std::memcpy(uploadBuffer.data(), model.mesh.vertices.data(), vertexBytes);
+		uint8_t* indices = uploadBuffer.data() + vertexBytes;
+		if (GetIndexStride(model.mesh.vertices.size()) == sizeof(uint16_t)) {
+			for (size_t index = 0; index < model.mesh.indices.size(); ++index) {
+				reinterpret_cast<uint16_t*>(indices)[index] = static_cast<uint16_t>(model.mesh.indices[index]);
+			}
+		} else {
+			std::memcpy(indices, model.mesh.indices.data(), model.mesh.indices.size() * sizeof(uint32_t));
+		}
+		objGrowth = GetGrowth(before, GetMemoryUsage());
+		BenchmarkSink = BenchmarkSink + model.mesh.indices.size();
+	}) / kRepeatCount;
+	std::printf("  LoadObj    : %.1f MB obj, %.1f ms, +%.1f MB working set, +%.1f MB private\n",
+		objMegabytes, objTime, ToMegabytes(objGrowth.workingSet), ToMegabytes(objGrowth.privateBytes));
+
+	// MappedMesh: マップしてGPUと同じ並びのまま2回memcpyする
+	MemoryUsage meshGrowth{};
+	double openTime = 0.0;
+	const double meshTime = MeasureMilliseconds(kRepeatCount, [&]() {
+		const MemoryUsage before = GetMemoryUsage();
+		MappedMesh mesh;
+		openTime += MeasureMilliseconds(1, [&]() { mesh.Open(meshPath.wstring()); });
+		if (!mesh.IsOpen()) {
+			return;
+		}
+		const size_t vertexBytes = size_t(mesh.GetVertexCount()) * sizeof(VertexData);
+		std::memcpy(uploadBuffer.data(), mesh.GetVertices(), vertexBytes);
+		std::memcpy(uploadBuffer.data() + vertexBytes, mesh.GetIndices(), size_t(mesh.GetIndexCount()) * mesh.GetIndexStride());
+		meshGrowth = GetGrowth(before, GetMemoryUsage());
+		BenchmarkSink = BenchmarkSink + mesh.GetIndexCount();
+	}) / kRepeatCount;
+	std::printf("  MappedMesh : %.1f MB mesh, %.1f ms (open %.3f ms), +%.1f MB working set, +%.1f MB private, x%.1f\n",
+		meshMegabytes, meshTime, openTime / kRepeatCount, ToMegabytes(meshGrowth.workingSet), ToMegabytes(meshGrowth.privateBytes), objTime / meshTime);
+
+	std::filesystem::remove_all(directory, error);
+}
@@ -0,0 +1,116 @@
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "BenchmarkFramework.h"
+#include "MeshSimplifier.h"
+#include "Function/ThreadPool.h"
+
+/*================================================================================================
+LODを作る簡略化の速さ(1秒あたりに処理できる元の三角形の数)
+球を少し波打たせたサブメッシュ8つ(三角形 約52万)を半分まで減らす
+MeshCookerと同じく、1スレッドで順に減らす場合とサブメッシュごとにThreadPoolへ積む場合を比べる
+==================================================================================================*/
+
+namespace {
+
+const uint32_t kSubmeshCount = 8;
+const uint32_t kRings = 128;
+const uint32_t kSegments = 256;
+const uint32_t kRepeatCount = 3;
+
+/// <summary>
+/// 同じ頂点配列を使うサブメッシュ
+/// </summary>
+struct TestSubmesh {
+	uint32_t firstIndex;
+	uint32_t indexCount;
+};
+
+/// <summary>
+/// 球を1つずつ足す(継ぎ目はUVの違う頂点にして、UVの継ぎ目を残す処理も通す)
+/// </summary>
+MeshData MakeSpheres(std::vector<TestSubmesh>& outSubmeshes) {
+	const float kPi = 3.14159265f;
+	MeshData mesh;
+	for (uint32_t sphere = 0; sphere < kSubmeshCount; ++sphere) {
+		const float centerX = float(sphere % 4) * 2.5f;
+		const float centerY = float(sphere / 4) * 2.5f;
+		const uint32_t baseVertex = static_cast<uint32_t>(mesh.vertices.size());
+		for (uint32_t ring = 0; ring <= kRings; ++ring) {
+			for (uint32_t segment = 0; segment <= kSegments; ++segment) {
+				const float theta = kPi * ring / kRings;
+				const float phi = 2.0f * kPi * (segment % kSegments) / kSegments;
+				const float radius = 1.0f + 0.05f * std::sin(5.0f * theta + float(sphere)) * std::cos(7.0f * phi);
+				VertexData& vertex = mesh.vertices.emplace_back();
+				vertex.pos = { centerX + radius * std::sin(theta) * std::cos(phi), centerY + radius * std::cos(theta), radius * std::sin(theta) * std::sin(phi), 1.0f };
+				vertex.texcord = { float(segment) / kSegments, float(ring) / kRings };
+			}
+		}
+		const uint32_t firstIndex = static_cast<uint32_t>(mesh.indices.size());
+		for (uint32_t ring = 0; ring < kRings; ++ring) {
+			for (uint32_t segment = 0; segment < kSegments; ++segment) {
+				const uint32_t a = baseVertex + ring * (kSegments + 1) + segment;
+				const uint32_t b = a + 1;
+				const uint32_t c = a + kSegments + 1;
+				const uint32_t d = c + 1;
+				mesh.indices.insert(mesh.indices.end(), { a, c, b, b, c, d });
+			}
+		}
+		outSubmeshes.push_back({ firstIndex, static_cast<uint32_t>(mesh.indices.size()) - firstIndex });
+	}
+	return mesh;
+}
+
+/// <summary>
+/// サブメッシュ1つを半分にする
+/// </summary>
+size_t SimplifySubmesh(const MeshData& mesh, const TestSubmesh& submesh, std::vector<uint32_t>& destination) {
+	destination.resize(submesh.indexCount);
+	const size_t targetIndexCount = size_t(submesh.indexCount / 2) / 3 * 3;
+	return SimplifyMesh(destination.data(), mesh.indices.data() + submesh.firstIndex, submesh.indexCount,
+		mesh.vertices.data(), mesh.vertices.size(), targetIndexCount, 0.05f);
+}
+
+} // namespace
+
+BENCHMARK(MeshSimplifier_TrianglesPerSecond) {
+	std::vector<TestSubmesh> submeshes;
+	const MeshData mesh = MakeSpheres(submeshes);
+	const double triangleCount = double(mesh.indices.size() / 3) * kRepeatCount;
+	std::vector<std::vector<uint32_t>> simplified(submeshes.size());
+	std::vector<size_t> simplifiedCounts(submeshes.size());
+
+	const double serialTime = MeasureMilliseconds(kRepeatCount, [&]() {
+		for (size_t index = 0; index < submeshes.size(); ++index) {
+			simplifiedCounts[index] = SimplifySubmesh(mesh, submeshes[index], simplified[index]);
+		}
+	});
+	size_t serialIndexCount = 0;
+	for (size_t count : simplifiedCounts) {
+		serialIndexCount += count;
+	}
+	std::printf("  serial     : %zu -> %zu triangles, %.1f ms, %.2f M triangles/s\n",
+		mesh.indices.size() / 3, serialIndexCount / 3, serialTime / kRepeatCount, triangleCount / (serialTime * 1000.0));
+
+	// MeshCookerと同じく、サブメッシュ1つを1ジョブにする
+	ThreadPool threadPool;
+	threadPool.Init(0);
+	const double parallelTime = MeasureMilliseconds(kRepeatCount, [&]() {
+		for (size_t index = 0; index < submeshes.size(); ++index) {
+			threadPool.Submit([&, index]() {
+				simplifiedCounts[index] = SimplifySubmesh(mesh, submeshes[index], simplified[index]);
+			});
+		}
+		threadPool.WaitIdle();
+	});
+	size_t parallelIndexCount = 0;
+	for (size_t count : simplifiedCounts) {
+		parallelIndexCount += count;
+	}
+	std::printf("  thread pool: %zu -> %zu triangles, %.1f ms, %.2f M triangles/s (%u threads, x%.2f)\n",
+		mesh.indices.size() / 3, parallelIndexCount / 3, parallelTime / kRepeatCount, triangleCount / (parallelTime * 1000.0),
+		threadPool.GetThreadCount(), serialTime / parallelTime);
+	threadPool.Finalize();
+	BenchmarkSink = BenchmarkSink + serialIndexCount + parallelIndexCount;
+}
@@ -0,0 +1,114 @@
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "BenchmarkFramework.h"
+#include "MeshletBuilder.h"
+#include "MeshletCulling.h"
+
+/*================================================================================================
+メッシュレットのカリングの時間
+main.cppと同じく16x9のインスタンスを並べ、1フレーム分(インスタンスごとに視錐台・カメラの位置を
+メッシュの座標に持ってきて全ての塊を判定する)を測る。視錐台だけの場合と裏向きの判定もする場合を比べる
+==================================================================================================*/
+
+namespace {
+
+const uint32_t kFrameCount = 200;
+const int kInstanceColumns = 16;
+const int kInstanceRows = 9;
+const float kInstanceScale = 0.3f;
+const uint32_t kRings = 96;
+const uint32_t kSegments = 192;
+
+/// <summary>
+/// 半径0.5の波打った球(三角形 約3.7万)
+/// </summary>
+MeshData MakeSphere() {
+	const float kPi = 3.14159265f;
+	MeshData mesh;
+	for (uint32_t ring = 0; ring <= kRings; ++ring) {
+		for (uint32_t segment = 0; segment <= kSegments; ++segment) {
+			const float theta = kPi * ring / kRings;
+			const float phi = 2.0f * kPi * (segment % kSegments) / kSegments;
+			const float radius = 0.5f * (1.0f + 0.05f * std::sin(5.0f * theta) * std::cos(7.0f * phi));
+			VertexData& vertex = mesh.vertices.emplace_back();
+			vertex.pos = { radius * std::sin(theta) * std::cos(phi), radius * std::cos(theta), radius * std::sin(theta) * std::sin(phi), 1.0f };
+			vertex.texcord = { float(segment) / kSegments, float(ring) / kRings };
+		}
+	}
+	for (uint32_t ring = 0; ring < kRings; ++ring) {
+		for (uint32_t segment = 0; segment < kSegments; ++segment) {
+			const uint32_t a = ring * (kSegments + 1) + segment;
+			const uint32_t b = a + 1;
+			const uint32_t c = a + kSegments + 1;
+			const uint32_t d = c + 1;
+			// 左手系で外側が表(時計回り)
+			mesh.indices.insert(mesh.indices.end(), { a, b, c, b, d, c });
+		}
+	}
+	return mesh;
+}
+
+/// <summary>
+/// 1フレーム分のカリング(main.cppと同じ手順)
+/// </summary>
+MeshletCullStats CullFrame(const MeshletData& meshlets, const std::vector<Matrix4x4>& worlds, const Matrix4x4& viewProjection,
+	const Vector3& cameraPosition, bool cullBackfaces, std::vector<uint32_t>& visible) {
+	MeshletCullStats stats;
+	const uint32_t meshletCount = static_cast<uint32_t>(meshlets.meshlets.size());
+	for (const Matrix4x4& world : worlds) {
+		const Frustum frustum = MakeFrustum(Multiply(world, viewProjection));
+		const Vector3 localCamera = Transform(cameraPosition, InverseAffine(world));
+		CullMeshlets(meshlets.meshlets.data(), meshlets.bounds.data(), meshletCount, frustum, localCamera,
+			cullBackfaces && IsUniformScale(world), visible.data(), &stats);
+	}
+	return stats;
+}
+
+} // namespace
+
+BENCHMARK(MeshletCulling_144Instances) {
+	const MeshData mesh = MakeSphere();
+	MeshletData meshlets;
+	BuildMeshlets(meshlets, mesh.indices.data(), mesh.indices.size(), mesh.vertices.data(), mesh.vertices.size());
+	std::vector<uint32_t> visible(meshlets.meshlets.size());
+
+	// main.cppと同じ並び。カメラは手前から見る
+	const Vector3 cameraPosition = { 0.0f, 0.0f, -5.0f };
+	const Matrix4x4 view = InverseAffine(MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.0f, 0.0f, 0.0f }, cameraPosition));
+	const Matrix4x4 viewProjection = Multiply(view, MakePerspectiveFovMatrix(0.45f, 1280.0f / 720.0f, 0.1f, 100.0f));
+	std::vector<Matrix4x4> worlds;
+	for (int row = 0; row < kInstanceRows; ++row) {
+		for (int column = 0; column < kInstanceColumns; ++column) {
+			const float x = (float(column) - float(kInstanceColumns - 1) * 0.5f) * 0.35f;
+			const float y = (float(row) - float(kInstanceRows - 1) * 0.5f) * 0.35f;
+			worlds.push_back(MakeAffineMatrix({ kInstanceScale, kInstanceScale, kInstanceScale }, { 0.0f, float(column) * 0.3f, 0.0f }, { x, y, 2.0f }));
+		}
+	}
+	const double meshletsPerFrame = double(meshlets.meshlets.size()) * worlds.size();
+	std::printf("  %zu instances x %zu meshlets (%zu triangles)\n", worlds.size(), meshlets.meshlets.size(), mesh.indices.size() / 3);
+
+	for (bool cullBackfaces : { false, true }) {
+		MeshletCullStats stats;
+		const double time = MeasureMilliseconds(kFrameCount, [&]() {
+			stats = CullFrame(meshlets, worlds, viewProjection, cameraPosition, cullBackfaces, visible);
+		});
+		BenchmarkSink = BenchmarkSink + stats.visibleCount;
+		std::printf("  %-17s: %.3f ms/frame, %.1f ns/meshlet, %u / %u visible (frustum %u, backface %u), %.1f%% triangles culled\n",
+			cullBackfaces ? "frustum+backface" : "frustum", time / kFrameCount, time * 1e6 / (kFrameCount * meshletsPerFrame),
+			stats.visibleCount, stats.meshletCount, stats.frustumCulledCount, stats.backfaceCulledCount, stats.GetCulledTriangleRatio() * 100.0f);
+	}
+
+	// 拡縮が等倍でないインスタンスは裏向きの判定を飛ばす
+	for (Matrix4x4& world : worlds) {
+		world = Multiply(MakeAffineMatrix({ 1.0f, 2.0f, 1.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }), world);
+	}
+	MeshletCullStats stats;
+	const double time = MeasureMilliseconds(kFrameCount, [&]() {
+		stats = CullFrame(meshlets, worlds, viewProjection, cameraPosition, true, visible);
+	});
+	BenchmarkSink = BenchmarkSink + stats.visibleCount;
+	std::printf("  non-uniform scale: %.3f ms/frame, %u / %u visible (frustum %u, backface %u)\n",
+		time / kFrameCount, stats.visibleCount, stats.meshletCount, stats.frustumCulledCount, stats.backfaceCulledCount);
+}
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "BenchmarkFramework.h"
+#include "MathSimd.h"
+#include "MyMatrix.h"
+
+/*================================================================================================
+行列演算の時間
+4096個の乱数の行列で、MyMatrixの積・逆行列(ビルドで選ばれたSIMDのバックエンド)と、
+同じ式をSIMDを使わずに書いたものを比べる。1回あたりのナノ秒
+逆行列の種類ごとの比較は乱数のTRS行列で行い、誤差(|M * M^-1 - I|の最大値)も出す
+==================================================================================================*/
+
+namespace {
+
+const size_t kMatrixCount = 4096;
+const uint32_t kRepeatCount = 200;
+
+#if defined(MYMATH_USE_AVX2)
+const char* kBackendName = "AVX2";
+#elif defined(MYMATH_USE_SSE)
+const char* kBackendName = "SSE";
+#else
+const char* kBackendName = "scalar";
+#endif
+
+/// <summary>
+/// SIMDを使わない積(スカラー版と同じ式)
+/// </summary>
+Matrix4x4 ScalarMultiply(const Matrix4x4& m1, const Matrix4x4& m2) {
+	Matrix4x4 result{};
+	for (int row = 0; row < 4; row++) {
+		for (int col = 0; col < 4; col++) {
+			for (int oi = 0; oi < 4; oi++) {
+				result.m[row][col] += m1.m[row][oi] * m2.m[oi][col];
+			}
+		}
+	}
+	return result;
+}
+
+/// <summary>
+/// SIMDを使わない逆行列(スカラー版と同じGauss-Jordan)
+/// </summary>
+Matrix4x4 ScalarInverse(Matrix4x4 matrix) {
+	Matrix4x4 result = MakeIdentity4x4();
+	for (int i = 0; i < 4; ++i) {
+		if (matrix.m[i][i] == 0.0f) {
+			for (int j = i + 1; j < 4; ++j) {
+				if (matrix.m[j][i] != 0.0f) {
+					swapRows(matrix, i, j);
+					swapRows(result, i, j);
+					break;
+				}
+			}
+		}
+		const float pivot = matrix.m[i][i];
+		scaleRow(matrix, i, 1.0f / pivot);
+		scaleRow(result, i, 1.0f / pivot);
+		for (int j = i + 1; j < 4; ++j) {
+			const float factor = matrix.m[j][i];
+			addScaledRow(matrix, j, i, -factor);
+			addScaledRow(result, j, i, -factor);
+		}
+	}
+	for (int i = 3; i > 0; --i) {
+		for (int j = i - 1; j >= 0; --j) {
+			const float factor = matrix.m[j][i];
+			addScaledRow(matrix, j, i, -factor);
+			addScaledRow(result, j, i, -factor);
+		}
+	}
+	return result;
+}
+
+std::vector<Matrix4x4> MakeRandomMatrices(uint32_t seed) {
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> value(-4.0f, 4.0f);
+	std::vector<Matrix4x4> matrices(kMatrixCount);
+	for (Matrix4x4& matrix : matrices) {
+		for (int row = 0; row < 4; ++row) {
+			for (int col = 0; col < 4; ++col) {
+				matrix.m[row][col] = value(random);
+			}
+		}
+	}
+	return matrices;
+}
+
+/// <summary>
+/// 乱数のTRS行列(rigidなら拡縮は1)
+/// </summary>
+std::vector<Matrix4x4> MakeRandomTransforms(uint32_t seed, bool rigid) {
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> scale(0.2f, 5.0f);
+	std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+	std::uniform_real_distribution<float> translate(-100.0f, 100.0f);
+	std::vector<Matrix4x4> matrices(kMatrixCount);
+	for (Matrix4x4& matrix : matrices) {
+		const Vector3 scales = rigid ? Vector3{ 1.0f, 1.0f, 1.0f } : Vector3{ scale(random), scale(random), scale(random) };
+		matrix = MakeAffineMatrix(scales, { angle(random), angle(random), angle(random) }, { translate(random), translate(random), translate(random) });
+	}
+	return matrices;
+}
+
+/// <summary>
+/// M * M^-1 と単位行列の差の最大値(全ての行列で)
+/// </summary>
+float GetInverseError(const std::vector<Matrix4x4>& matrices, const std::vector<Matrix4x4>& inverses) {
+	float error = 0.0f;
+	for (size_t index = 0; index < matrices.size(); ++index) {
+		const Matrix4x4 product = Multiply(matrices[index], inverses[index]);
+		for (int row = 0; row < 4; ++row) {
+			for (int col = 0; col < 4; ++col) {
+				error = (std::max)(error, std::abs(product.m[row][col] - (row == col ? 1.0f : 0.0f)));
+			}
+		}
+	}
+	return error;
+}
+
+/// <summary>
+/// 結果の一部を足して捨てる(計算を消されないようにする)
+/// </summary>
+void Consume(const std::vector<Matrix4x4>& matrices) {
+	float sum = 0.0f;
+	for (const Matrix4x4& matrix : matrices) {
+		sum += matrix.m[0][0] + matrix.m[3][3];
+	}
+	BenchmarkSink = BenchmarkSink + static_cast<uint64_t>(sum != 0.0f);
+}
+
+/// <summary>
+/// 全ての行列にfunctionをかけた1回あたりの時間(ナノ秒)
+/// </summary>
+template<typename Function>
+double MeasurePerMatrix(std::vector<Matrix4x4>& results, Function&& function) {
+	const double time = MeasureMilliseconds(kRepeatCount, [&]() {
+		for (size_t index = 0; index < kMatrixCount; ++index) {
+			results[index] = function(index);
+		}
+	});
+	Consume(results);
+	return time * 1e6 / (double(kRepeatCount) * kMatrixCount);
+}
+
+} // namespace
+
+BENCHMARK(MyMatrix_MultiplyAndInverse) {
+	const std::vector<Matrix4x4> lhs = MakeRandomMatrices(1);
+	const std::vector<Matrix4x4> rhs = MakeRandomMatrices(2);
+	std::vector<Matrix4x4> results(kMatrixCount);
+
+	const double multiplyTime = MeasurePerMatrix(results, [&](size_t index) { return Multiply(lhs[index], rhs[index]); });
+	const double scalarMultiplyTime = MeasurePerMatrix(results, [&](size_t index) { return ScalarMultiply(lhs[index], rhs[index]); });
+	std::printf("  Multiply: %s %.1f ns, scalar %.1f ns, x%.2f\n", kBackendName, multiplyTime, scalarMultiplyTime, scalarMultiplyTime / multiplyTime);
+
+	const double inverseTime = MeasurePerMatrix(results, [&](size_t index) { return Inverse(lhs[index]); });
+	const double scalarInverseTime = MeasurePerMatrix(results, [&](size_t index) { return ScalarInverse(lhs[index]); });
+	std::printf("  Inverse : %s %.1f ns, scalar %.1f ns, x%.2f\n", kBackendName, inverseTime, scalarInverseTime, scalarInverseTime / inverseTime);
+}
+
+BENCHMARK(MyMatrix_InverseVariants) {
+	const std::vector<Matrix4x4> affines = MakeRandomTransforms(3, false);
+	const std::vector<Matrix4x4> rigids = MakeRandomTransforms(4, true);
+	std::vector<Matrix4x4> results(kMatrixCount);
+
+	auto report = [&](const char* name, double time, const std::vector<Matrix4x4>& matrices) {
+		std::printf("  %-15s: %6.1f ns, max error %.2g\n", name, time, GetInverseError(matrices, results));
+	};
+	report("Inverse", MeasurePerMatrix(results, [&](size_t index) { return Inverse(affines[index]); }), affines);
+	report("InverseCofactor", MeasurePerMatrix(results, [&](size_t index) { return InverseCofactor(affines[index]); }), affines);
+	const double batchTime = MeasureMilliseconds(kRepeatCount, [&]() { InverseN(affines.data(), results.data(), kMatrixCount); });
+	Consume(results);
+	report("InverseN", batchTime * 1e6 / (double(kRepeatCount) * kMatrixCount), affines);
+	report("InverseAffine", MeasurePerMatrix(results, [&](size_t index) { return InverseAffine(affines[index]); }), affines);
+
+	// 拡縮が1の行列
+	report("Inverse (rigid)", MeasurePerMatrix(results, [&](size_t index) { return Inverse(rigids[index]); }), rigids);
+	report("InverseRigid", MeasurePerMatrix(results, [&](size_t index) { return InverseRigid(rigids[index]); }), rigids);
+}
@@ -0,0 +1,101 @@
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "BenchmarkFramework.h"
+#include "MyMatrix.h"
+#include "MyQuaternion.h"
+
+/*================================================================================================
+Quaternionの補間・行列の組み立ての時間
+	・アニメーションのブレンドと同じく、4096組のQuaternionを同じtで補間する(Slerp / Nlerp / SlerpN)
+	・4096個のTRSの行列を作る(オイラー角 → MakeAffineMatrix / Quaternion → MakeAffineMatrixQuat)
+1回あたりのナノ秒
+==================================================================================================*/
+
+namespace {
+
+const size_t kElementCount = 4096;
+const uint32_t kRepeatCount = 500;
+
+Quaternion MakeRandomQuaternion(std::mt19937& random) {
+	std::normal_distribution<float> value;
+	return Normalize({ value(random), value(random), value(random), value(random) });
+}
+
+double ToNanosecondsPerElement(double milliseconds) {
+	return milliseconds * 1e6 / (double(kRepeatCount) * kElementCount);
+}
+
+void Consume(const std::vector<Quaternion>& quaternions) {
+	float sum = 0.0f;
+	for (const Quaternion& q : quaternions) {
+		sum += q.w;
+	}
+	BenchmarkSink = BenchmarkSink + static_cast<uint64_t>(sum != 0.0f);
+}
+
+} // namespace
+
+BENCHMARK(MyQuaternion_Interpolation) {
+	std::mt19937 random(1);
+	std::vector<Quaternion> from(kElementCount);
+	std::vector<Quaternion> to(kElementCount);
+	for (size_t index = 0; index < kElementCount; ++index) {
+		from[index] = MakeRandomQuaternion(random);
+		to[index] = MakeRandomQuaternion(random);
+	}
+	std::vector<Quaternion> result(kElementCount);
+	float t = 0.0f;
+
+	const double slerpTime = MeasureMilliseconds(kRepeatCount, [&]() {
+		t = t < 1.0f ? t + 0.001f : 0.0f;
+		for (size_t index = 0; index < kElementCount; ++index) {
+			result[index] = Slerp(from[index], to[index], t);
+		}
+	});
+	Consume(result);
+	const double nlerpTime = MeasureMilliseconds(kRepeatCount, [&]() {
+		t = t < 1.0f ? t + 0.001f : 0.0f;
+		for (size_t index = 0; index < kElementCount; ++index) {
+			result[index] = Nlerp(from[index], to[index], t);
+		}
+	});
+	Consume(result);
+	const double slerpNTime = MeasureMilliseconds(kRepeatCount, [&]() {
+		t = t < 1.0f ? t + 0.001f : 0.0f;
+		SlerpN(from.data(), to.data(), t, result.data(), kElementCount);
+	});
+	Consume(result);
+	std::printf("  Slerp %.1f ns, Nlerp %.1f ns, SlerpN %.1f ns (x%.1f vs Slerp)\n",
+		ToNanosecondsPerElement(slerpTime), ToNanosecondsPerElement(nlerpTime), ToNanosecondsPerElement(slerpNTime), slerpTime / slerpNTime);
+}
+
+BENCHMARK(MyQuaternion_AffineMatrix) {
+	std::mt19937 random(2);
+	std::uniform_real_distribution<float> value(-3.0f, 3.0f);
+	std::vector<Vector3> rotates(kElementCount);
+	std::vector<Quaternion> quaternions(kElementCount);
+	for (size_t index = 0; index < kElementCount; ++index) {
+		rotates[index] = { value(random), value(random), value(random) };
+		quaternions[index] = MakeRotateQuaternion(rotates[index]);
+	}
+	const Vector3 scale = { 1.0f, 2.0f, 0.5f };
+	const Vector3 translate = { 3.0f, -1.0f, 10.0f };
+	std::vector<Matrix4x4> results(kElementCount);
+
+	const double eulerTime = MeasureMilliseconds(kRepeatCount, [&]() {
+		for (size_t index = 0; index < kElementCount; ++index) {
+			results[index] = MakeAffineMatrix(scale, rotates[index], translate);
+		}
+	});
+	BenchmarkSink = BenchmarkSink + static_cast<uint64_t>(results.back().m[0][0] != 0.0f);
+	const double quaternionTime = MeasureMilliseconds(kRepeatCount, [&]() {
+		for (size_t index = 0; index < kElementCount; ++index) {
+			results[index] = MakeAffineMatrixQuat(scale, quaternions[index], translate);
+		}
+	});
+	BenchmarkSink = BenchmarkSink + static_cast<uint64_t>(results.back().m[0][0] != 0.0f);
+	std::printf("  MakeAffineMatrix (euler) %.1f ns, MakeAffineMatrixQuat %.1f ns, x%.1f\n",
+		ToNanosecondsPerElement(eulerTime), ToNanosecondsPerElement(quaternionTime), eulerTime / quaternionTime);
+}
@@ -0,0 +1,145 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "BenchmarkFramework.h"
+#include "ObjLoader.h"
+#include "Function/ThreadPool.h"
+
+/*================================================================================================
+OBJの読み込み時間
+格子のOBJ(三角形 約100万)を一時ディレクトリに書き出し、getline + sscanf で1行ずつ読む素朴な実装と、
+LoadObj(マップして塊ごとに解析する)を1スレッド・ThreadPoolで比べる
+==================================================================================================*/
+
+namespace {
+
+const uint32_t kGridSize = 708;		// 708 * 708 * 2 = 約100万三角形
+const uint32_t kRepeatCount = 3;
+
+/// <summary>
+/// 高さを少しずつ変えた格子を書き出す(v/vt/vn の面)
+/// </summary>
+bool WriteGridObj(const std::filesystem::path& path) {
+	FILE* file = std::fopen(path.string().c_str(), "wb");
+	if (!file) {
+		return false;
+	}
+	std::fprintf(file, "# grid\no grid\n");
+	for (uint32_t y = 0; y <= kGridSize; ++y) {
+		for (uint32_t x = 0; x <= kGridSize; ++x) {
+			std::fprintf(file, "v %.6f %.6f %.6f\n", x * 0.01f - 3.5f, y * 0.01f - 3.5f, 0.001f * ((x * 7 + y * 13) % 100));
+		}
+	}
+	for (uint32_t y = 0; y <= kGridSize; ++y) {
+		for (uint32_t x = 0; x <= kGridSize; ++x) {
+			std::fprintf(file, "vt %.6f %.6f\n", float(x) / kGridSize, float(y) / kGridSize);
+		}
+	}
+	std::fprintf(file, "vn 0.000000 0.000000 1.000000\ns off\n");
+	for (uint32_t y = 0; y < kGridSize; ++y) {
+		for (uint32_t x = 0; x < kGridSize; ++x) {
+			const uint32_t a = y * (kGridSize + 1) + x + 1;
+			const uint32_t b = a + 1;
+			const uint32_t c = a + kGridSize + 1;
+			const uint32_t d = c + 1;
+			std::fprintf(file, "f %u/%u/1 %u/%u/1 %u/%u/1\n", a, a, b, b, d, d);
+			std::fprintf(file, "f %u/%u/1 %u/%u/1 %u/%u/1\n", a, a, d, d, c, c);
+		}
+	}
+	return std::fclose(file) == 0;
+}
+
+/// <summary>
+/// getline + sscanf で読み、(位置, UV)が同じ頂点をハッシュでまとめる(三角形の面だけ読める)
+/// LoadObjと同じ座標の変換・回り順にする
+/// </summary>
+bool LoadObjGetline(const std::filesystem::path& path, MeshData& outMesh) {
+	std::ifstream stream(path);
+	if (!stream) {
+		return false;
+	}
+	std::vector<float> positions;
+	std::vector<float> texcoords;
+	std::unordered_map<uint64_t, uint32_t> vertexIndices;
+	std::string line;
+	while (std::getline(stream, line)) {
+		if (line.rfind("v ", 0) == 0) {
+			float x = 0.0f, y = 0.0f, z = 0.0f;
+			std::sscanf(line.c_str() + 2, "%f %f %f", &x, &y, &z);
+			positions.insert(positions.end(), { x, y, z });
+		} else if (line.rfind("vt ", 0) == 0) {
+			float u = 0.0f, v = 0.0f;
+			std::sscanf(line.c_str() + 3, "%f %f", &u, &v);
+			texcoords.insert(texcoords.end(), { u, v });
+		} else if (line.rfind("f ", 0) == 0) {
+			uint32_t position[3], texcoord[3], normal[3];
+			if (std::sscanf(line.c_str() + 2, "%u/%u/%u %u/%u/%u %u/%u/%u", &position[0], &texcoord[0], &normal[0],
+				&position[1], &texcoord[1], &normal[1], &position[2], &texcoord[2], &normal[2]) != 9) {
+				return false;
+			}
+			for (uint32_t corner : { 0, 2, 1 }) {
+				const uint64_t key = (uint64_t(position[corner] - 1) << 32) | (texcoord[corner] - 1);
+				auto found = vertexIndices.find(key);
+				if (found == vertexIndices.end()) {
+					const float* xyz = &positions[size_t(position[corner] - 1) * 3];
+					const float* uv = &texcoords[size_t(texcoord[corner] - 1) * 2];
+					VertexData& vertex = outMesh.vertices.emplace_back();
+					vertex.pos = { -xyz[0], xyz[1], xyz[2], 1.0f };
+					vertex.texcord = { uv[0], 1.0f - uv[1] };
+					found = vertexIndices.emplace(key, static_cast<uint32_t>(outMesh.vertices.size() - 1)).first;
+				}
+				outMesh.indices.push_back(found->second);
+			}
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+BENCHMARK(ObjLoader_GetlineVsMapped) {
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "DirectXGameObjLoaderBenchmark";
+	std::filesystem::create_directories(directory);
+	const std::filesystem::path path = directory / "grid.obj";
+	if (!WriteGridObj(path)) {
+		std::printf("  failed to write test obj\n");
+		return;
+	}
+	std::error_code error;
+	const double fileMegabytes = double(std::filesystem::file_size(path, error)) / (1024.0 * 1024.0);
+
+	MeshData getlineMesh;
+	const double getlineTime = MeasureMilliseconds(kRepeatCount, [&]() {
+		getlineMesh = {};
+		LoadObjGetline(path, getlineMesh);
+	}) / kRepeatCount;
+	std::printf("  getline+sscanf : %.1f MB, %zu triangles in %.1f ms (%.0f MB/s)\n",
+		fileMegabytes, getlineMesh.indices.size() / 3, getlineTime, fileMegabytes * 1000.0 / getlineTime);
+
+	ObjModel model;
+	const double serialTime = MeasureMilliseconds(kRepeatCount, [&]() {
+		LoadObj(path.wstring(), model);
+	}) / kRepeatCount;
+	// 同じ頂点・インデックスになっていること
+	const bool isSame = model.mesh.indices == getlineMesh.indices && model.mesh.vertices.size() == getlineMesh.vertices.size();
+	std::printf("  LoadObj        : %zu triangles in %.1f ms (%.0f MB/s, x%.2f, %s)\n",
+		model.mesh.indices.size() / 3, serialTime, fileMegabytes * 1000.0 / serialTime, getlineTime / serialTime, isSame ? "same mesh" : "MESH DIFFERS");
+
+	ThreadPool threadPool;
+	threadPool.Init(0);
+	ObjLoadStats stats;
+	const double parallelTime = MeasureMilliseconds(kRepeatCount, [&]() {
+		LoadObj(path.wstring(), model, &threadPool, &stats);
+	}) / kRepeatCount;
+	std::printf("  LoadObj (pool) : %zu triangles in %.1f ms (%.0f MB/s, x%.2f, %u threads, %u chunks, parse %.1f ms, build %.1f ms)\n",
+		model.mesh.indices.size() / 3, parallelTime, fileMegabytes * 1000.0 / parallelTime, getlineTime / parallelTime,
+		threadPool.GetThreadCount(), stats.chunkCount, stats.parseTime, stats.buildTime);
+	threadPool.Finalize();
+	BenchmarkSink = BenchmarkSink + getlineMesh.vertices.size() + model.mesh.vertices.size();
+
+	std::filesystem::remove_all(directory, error);
+}
@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BenchmarkFramework.h"
+#include "Shader/ShaderCompileService.h"
+#include "Shader/ShaderPermutation.h"
+
+/*================================================================================================
+シェーダーのコンパイル時間(ワーカーの数ごと)
+機能7つのピクセルシェーダー(128通り)と頂点シェーダー1つを一時ディレクトリに書き出し、
+ShaderCompileServiceのワーカーを 1, 2, 4, CPUの数 と変えてまとめてコンパイルする
+キャッシュは使わない。ワーカーのコンパイラを作る時間を外すため、1回目は捨てて2回目を測る
+USE_SHADOWの時だけincludeするhlsliを変えた時に、コンパイルし直す数(128通りの半分)と時間も出す
+==================================================================================================*/
+
+namespace {
+
+const wchar_t* const kFeatures[] = {
+	L"USE_TEXTURE", L"USE_NORMAL_MAP", L"USE_SPECULAR", L"USE_FOG", L"USE_RIM", L"USE_SHADOW", L"USE_SKIN",
+};
+
+/// 全てのシェーダーがincludeする
+const char* const kCommonSource = R"(
+struct VertexShaderOutput {
+	float4 position : SV_POSITION;
+	float2 texcoord : TEXCOORD0;
+	float3 normal : NORMAL0;
+	float3 worldPosition : POSITION0;
+};
+
+float3 ApplyLight(float3 color, float3 normal, float3 direction) {
+	float NdotL = dot(normalize(normal), -direction);
+	return color * pow(NdotL * 0.5f + 0.5f, 2.0f);
+}
+)";
+
+/// USE_SHADOWのシェーダーだけがincludeする
+const char* const kShadowSource = R"(
+Texture2D<float> gShadowMap : register(t2);
+
+float SampleShadow(SamplerState s, float2 texcoord) {
+	float shadow = 0.0f;
+	[unroll] for (int y = -2; y <= 2; ++y) {
+		[unroll] for (int x = -2; x <= 2; ++x) {
+			shadow += gShadowMap.Sample(s, texcoord + float2(x, y) / 1024.0f);
+		}
+	}
+	return shadow / 25.0f;
+}
+)";
+
+const char* const kPixelSource = R"(
+#include "Common.hlsli"
+#if USE_SHADOW
+#include "Shadow.hlsli"
+#endif
+
+Texture2D<float4> gTexture : register(t0);
+Texture2D<float4> gNormalMap : register(t1);
+SamplerState gSampler : register(s0);
+
+cbuffer Material : register(b0) {
+	float4 gColor;
+	float3 gLightDirection;
+	float gShininess;
+	float3 gCameraPosition;
+	float gFogDensity;
+};
+
+float4 main(VertexShaderOutput input) : SV_TARGET {
+	float4 color = gColor;
+	float3 normal = input.normal;
+#if USE_TEXTURE
+	color *= gTexture.Sample(gSampler, input.texcoord);
+#endif
+#if USE_NORMAL_MAP
+	normal = normalize(normal + gNormalMap.Sample(gSampler, input.texcoord).xyz * 2.0f - 1.0f);
+#endif
+	color.rgb = ApplyLight(color.rgb, normal, gLightDirection);
+	float3 toEye = normalize(gCameraPosition - input.worldPosition);
+#if USE_SPECULAR
+	color.rgb += pow(saturate(dot(reflect(gLightDirection, normal), toEye)), gShininess);
+#endif
+#if USE_RIM
+	color.rgb += pow(1.0f - saturate(dot(normal, toEye)), 3.0f) * 0.5f;
+#endif
+#if USE_SHADOW
+	color.rgb *= SampleShadow(gSampler, input.texcoord);
+#endif
+#if USE_SKIN
+	color.rgb = lerp(color.rgb, float3(1.0f, 0.8f, 0.7f), saturate(normal.y));
+#endif
+#if USE_FOG
+	color.rgb = lerp(color.rgb, float3(0.5f, 0.6f, 0.7f), 1.0f - exp(-gFogDensity * length(gCameraPosition - input.worldPosition)));
+#endif
+	return color;
+}
+)";
+
+const char* const kVertexSource = R"(
+#include "Common.hlsli"
+
+cbuffer Transform : register(b0) {
+	float4x4 gWVP;
+	float4x4 gWorld;
+};
+
+VertexShaderOutput main(float4 position : POSITION0, float2 texcoord : TEXCOORD0, float3 normal : NORMAL0) {
+	VertexShaderOutput output;
+	output.position = mul(position, gWVP);
+	output.texcoord = texcoord;
+	output.normal = normalize(mul(normal, (float3x3)gWorld));
+	output.worldPosition = mul(position, gWorld).xyz;
+	return output;
+}
+)";
+
+bool WriteText(const std::filesystem::path& path, const char* text) {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file << text;
+	return bool(file);
+}
+
+} // namespace
+
+BENCHMARK(ShaderCompile_WorkerScaling) {
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "DirectXGameShaderCompileBenchmark";
+	std::filesystem::create_directories(directory);
+	if (!WriteText(directory / "Common.hlsli", kCommonSource) || !WriteText(directory / "Shadow.hlsli", kShadowSource)
+		|| !WriteText(directory / "Material.PS.hlsl", kPixelSource) || !WriteText(directory / "Material.VS.hlsl", kVertexSource)) {
+		std::printf("  failed to write test shaders\n");
+		return;
+	}
+
+	std::vector<uint32_t> workerCounts = { 1, 2, 4 };
+	const uint32_t hardwareCount = (std::max)(1u, std::thread::hardware_concurrency());
+	if (hardwareCount > workerCounts.back()) {
+		workerCounts.push_back(hardwareCount);
+	}
+
+	double singleTime = 0.0;
+	for (uint32_t workerCount : workerCounts) {
+		ShaderCompileService service;
+		service.Init(nullptr, workerCount);
+		// Release設定だとPDBを書き出すので、Debug設定で比べる
+		ShaderPermutation permutation;
+		ShaderPermutationDesc desc;
+		desc.filePath = (directory / "Material.PS.hlsl").wstring();
+		desc.profile = L"ps_6_0";
+		desc.features.assign(std::begin(kFeatures), std::end(kFeatures));
+		desc.config = ShaderBuildConfig::Debug;
+		permutation.Init(&service, desc);
+		ShaderCompileDesc vertexDesc;
+		vertexDesc.filePath = (directory / "Material.VS.hlsl").wstring();
+		vertexDesc.profile = L"vs_6_0";
+		vertexDesc.arguments = MakeShaderBuildArguments(ShaderBuildConfig::Debug);
+		service.Register(vertexDesc);
+
+		bool isSucceeded = service.CompileAll();
+		const double time = MeasureMilliseconds(1, [&]() { isSucceeded = service.CompileAll() && isSucceeded; });
+		if (workerCount == 1) {
+			singleTime = time;
+		}
+		std::printf("  %2u workers: %u shaders in %.1f ms, x%.2f%s\n",
+			service.GetWorkerCount(), service.GetShaderCount(), time, singleTime / time, isSucceeded ? "" : " (failed)");
+
+		// Shadow.hlsliが変わった時は、それをincludeしているものだけをコンパイルし直す
+		if (workerCount == workerCounts.back()) {
+			const std::vector<ShaderCompileService::ShaderId> dependents = service.Invalidate((directory / "Shadow.hlsli").wstring());
+			const double recompileTime = MeasureMilliseconds(1, [&]() { service.Compile(dependents); });
+			std::printf("  Shadow.hlsli changed: %zu of %u shaders recompiled in %.1f ms\n", dependents.size(), service.GetShaderCount(), recompileTime);
+		}
+		BenchmarkSink = BenchmarkSink + service.GetShaderCount();
+		service.Finalize();
+	}
+
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+}
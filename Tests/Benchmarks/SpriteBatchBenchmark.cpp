@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <d3d12.h>
+#include <dxgi1_6.h>
+
+#include "BenchmarkFramework.h"
+#include "MathSimd.h"
+#include "DirectXCommon/SpriteBatch.h"
+
+/*================================================================================================
+スプライトの頂点を作る時間
+10万枚を追加し、SpriteBatch::Build(テクスチャの順に並べ替えて頂点を書く)1回の時間を
+テクスチャが16枚の場合と1枚の場合で測る。並べ替えを std::sort で行った場合の時間も出す
+頂点を作る部分はビルドで選ばれたバックエンドで動くので、スカラー版の時間は
+MYMATH_FORCE_SCALAR を定義してビルドし直して測る(出力の先頭にバックエンドの名前を出す)
+SpriteBatchの初期化にデバイスが要るので、GPUがない環境ではWARPを使う
+==================================================================================================*/
+
+namespace {
+
+const uint32_t kSpriteCount = 100000;
+const uint32_t kRepeatCount = 20;
+
+#if defined(MYMATH_USE_AVX2)
+const char* kBackendName = "AVX2";
+#elif defined(MYMATH_USE_SSE)
+const char* kBackendName = "SSE";
+#else
+const char* kBackendName = "scalar";
+#endif
+
+/// <summary>
+/// デバイスを作る(作れなければWARP)
+/// </summary>
+ID3D12Device* CreateDevice() {
+	ID3D12Device* device = nullptr;
+	if (SUCCEEDED(D3D12CreateDevice(nullptr, D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(&device)))) {
+		return device;
+	}
+	IDXGIFactory4* factory = nullptr;
+	if (FAILED(CreateDXGIFactory1(IID_PPV_ARGS(&factory)))) {
+		return nullptr;
+	}
+	IDXGIAdapter* warpAdapter = nullptr;
+	if (SUCCEEDED(factory->EnumWarpAdapter(IID_PPV_ARGS(&warpAdapter)))) {
+		if (FAILED(D3D12CreateDevice(warpAdapter, D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(&device)))) {
+			device = nullptr;
+		}
+		warpAdapter->Release();
+	}
+	factory->Release();
+	return device;
+}
+
+/// <summary>
+/// 乱数のスプライトをtextureCount枚のテクスチャに振り分けて追加する
+/// </summary>
+void AddRandomSprites(SpriteBatch& batch, uint32_t textureCount, std::vector<uint64_t>& sortKeys) {
+	std::mt19937 random(textureCount);
+	std::uniform_real_distribution<float> position(0.0f, 1280.0f);
+	std::uniform_real_distribution<float> size(4.0f, 64.0f);
+	std::uniform_real_distribution<float> rotation(-3.14159265f, 3.14159265f);
+	std::uniform_real_distribution<float> channel(0.0f, 1.0f);
+	std::uniform_int_distribution<uint32_t> texture(0, textureCount - 1);
+	sortKeys.clear();
+	for (uint32_t index = 0; index < kSpriteCount; ++index) {
+		Sprite sprite;
+		sprite.position = { position(random), position(random) };
+		sprite.size = { size(random), size(random) };
+		sprite.color = { channel(random), channel(random), channel(random), 1.0f };
+		sprite.rotation = rotation(random);
+		sprite.textureHandle = texture(random);
+		batch.Add(sprite);
+		sortKeys.push_back((uint64_t(sprite.textureHandle) << 32) | index);
+	}
+}
+
+} // namespace
+
+BENCHMARK(SpriteBatch_Build) {
+	ID3D12Device* device = CreateDevice();
+	if (!device) {
+		std::printf("  failed to create a device\n");
+		return;
+	}
+	SpriteBatch batch;
+	batch.Init(device, kSpriteCount, 2, [](uint32_t) { return D3D12_GPU_DESCRIPTOR_HANDLE{}; });
+	// アップロードヒープの代わり(先に触っておく)
+	std::vector<SpriteVertex> vertices(size_t(kSpriteCount) * SpriteBatch::kVerticesPerSprite, SpriteVertex{});
+	std::vector<uint64_t> sortKeys;
+
+	std::printf("  backend: %s\n", kBackendName);
+	for (uint32_t textureCount : { 16u, 1u }) {
+		AddRandomSprites(batch, textureCount, sortKeys);
+		const double buildTime = MeasureMilliseconds(kRepeatCount, [&]() { batch.Build(vertices.data()); }) / kRepeatCount;
+		BenchmarkSink = BenchmarkSink + batch.GetDrawRanges().size() + vertices.back().color;
+
+		// Buildの並べ替えを std::sort にした場合の、並べ替えだけの時間
+		std::vector<uint64_t> keys;
+		const double sortTime = MeasureMilliseconds(kRepeatCount, [&]() {
+			keys = sortKeys;
+			std::sort(keys.begin(), keys.end());
+		}) / kRepeatCount;
+		BenchmarkSink = BenchmarkSink + keys.front();
+
+		std::printf("  %2u textures: %u sprites, Build %.2f ms (%zu ranges), std::sort alone %.2f ms\n",
+			textureCount, kSpriteCount, buildTime, batch.GetDrawRanges().size(), sortTime);
+		batch.Clear();
+	}
+
+	batch.Finalize();
+	device->Release();
+}
@@ -0,0 +1,72 @@
+#include <cstdio>
+
+#include "BenchmarkFramework.h"
+#include "DirectXCommon/CommandRecorder.h"
+
+namespace {
+
+const uint32_t kFrameCount = 1000;
+const uint32_t kMaterialCount = 8;
+const uint32_t kTextureCount = 16;
+
+/// ルートシグネチャ・PSOはポインタを比べるだけなので、アドレスだけあればよい
+int rootSignatureStorage = 0;
+int pipelineStateStorage = 0;
+
+/// <summary>
+/// DirectXCommon::DrawCallと同じ並びで、1フレームにdrawCount回描く
+/// 行列は毎回、マテリアル・テクスチャはたまに変わる(似たものをまとめて描いた状態)
+/// </summary>
+void RecordFrame(ICommandRecorder& recorder, uint32_t drawCount) {
+	ID3D12RootSignature* rootSignature = reinterpret_cast<ID3D12RootSignature*>(&rootSignatureStorage);
+	ID3D12PipelineState* pipelineState = reinterpret_cast<ID3D12PipelineState*>(&pipelineStateStorage);
+	const CommandViewport viewport{ 0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f };
+	const CommandRect scissorRect{ 0, 0, 1280, 720 };
+	const VertexBufferView vertexView{ 0x10000, 65536, 32 };
+	const IndexBufferView indexView{ 0x20000, 16384, 42 };		// DXGI_FORMAT_R32_UINT
+
+	for (uint32_t draw = 0; draw < drawCount; ++draw) {
+		recorder.RSSetViewports(1, &viewport);
+		recorder.RSSetScissorRects(1, &scissorRect);
+		recorder.SetGraphicsRootSignature(rootSignature);
+		recorder.SetPipelineState(pipelineState);
+		recorder.IASetVertexBuffers(0, 1, &vertexView);
+		recorder.IASetIndexBuffer(&indexView);
+		recorder.IASetPrimitiveTopology(PrimitiveTopology::TriangleList);
+		recorder.SetGraphicsRootConstantBufferView(0, 0x30000 + (draw * kMaterialCount / drawCount) * 256);
+		recorder.SetGraphicsRootConstantBufferView(1, 0x40000 + draw * 256);
+		const GpuDescriptorHandle texture{ 0x50000 + (draw * kTextureCount / drawCount) * 32 };
+		recorder.SetGraphicsRootDescriptorTable(2, texture);
+		recorder.DrawIndexedInstanced(36, 1, 0, 0, 0);
+	}
+}
+
+} // namespace
+
+/// <summary>
+/// そのまま積んだ場合とStateFilterを通した場合の、コマンドリストに届く状態設定の数と積む時間
+/// </summary>
+BENCHMARK(StateFilter_RedundantStateCalls) {
+	const uint32_t drawCounts[] = { 16, 256, 4096 };
+	for (uint32_t drawCount : drawCounts) {
+		CommandCounter direct;
+		const double directTime = MeasureMilliseconds(kFrameCount, [&]() {
+			RecordFrame(direct, drawCount);
+		});
+
+		CommandCounter filtered;
+		StateFilter filter;
+		filter.Init(&filtered);
+		const double filterTime = MeasureMilliseconds(kFrameCount, [&]() {
+			filter.BeginFrame();
+			RecordFrame(filter, drawCount);
+		});
+		BenchmarkSink = BenchmarkSink + direct.GetStateCount() + filtered.GetStateCount();
+
+		const double directPerFrame = double(direct.GetStateCount()) / kFrameCount;
+		const double filteredPerFrame = double(filtered.GetStateCount()) / kFrameCount;
+		std::printf("  %5u draws: state calls %8.0f -> %6.0f per frame (%.1f%% removed), record %.1f -> %.1f ns/draw\n",
+			drawCount, directPerFrame, filteredPerFrame, 100.0 * (1.0 - filteredPerFrame / directPerFrame),
+			directTime * 1e6 / (double(kFrameCount) * drawCount), filterTime * 1e6 / (double(kFrameCount) * drawCount));
+	}
+}
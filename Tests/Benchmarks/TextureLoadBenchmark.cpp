@@ -0,0 +1,115 @@
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <objbase.h>
+#endif
+
+#include "BenchmarkFramework.h"
+#include "TextureDecoder.h"
+#include "Function/ThreadPool.h"
+
+/*================================================================================================
+テクスチャ500枚の読み込み時間(ワーカーで行う部分: ファイルの読み込み・デコード・ミップ作成)
+TGAを一時ディレクトリに書き出し、1スレッドで順に読む場合とThreadPoolで並べて読む場合を比べる
+GPUへのコピーはゲームの中でTextureManagerがバッチの時間としてログに出す
+==================================================================================================*/
+
+namespace {
+
+const uint32_t kTextureCount = 500;
+const uint32_t kTextureSize = 256;
+
+/// <summary>
+/// 1枚ずつ模様を変えたTGAを書き出す
+/// </summary>
+std::vector<std::wstring> WriteTestTextures(const std::filesystem::path& directory) {
+	std::filesystem::create_directories(directory);
+	std::vector<std::wstring> files;
+	for (uint32_t textureIndex = 0; textureIndex < kTextureCount; ++textureIndex) {
+		DirectX::ScratchImage image{};
+		if (FAILED(image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, kTextureSize, kTextureSize, 1, 1))) {
+			break;
+		}
+		const DirectX::Image* pixels = image.GetImage(0, 0, 0);
+		for (uint32_t y = 0; y < kTextureSize; ++y) {
+			uint8_t* row = pixels->pixels + size_t(y) * pixels->rowPitch;
+			for (uint32_t x = 0; x < kTextureSize; ++x) {
+				row[x * 4 + 0] = static_cast<uint8_t>(x + textureIndex);
+				row[x * 4 + 1] = static_cast<uint8_t>(y * 3 + textureIndex);
+				row[x * 4 + 2] = static_cast<uint8_t>((x ^ y) + textureIndex * 7);
+				row[x * 4 + 3] = 255;
+			}
+		}
+		const std::wstring file = (directory / (L"texture" + std::to_wstring(textureIndex) + L".tga")).wstring();
+		if (FAILED(DirectX::SaveToTGAFile(*pixels, file.c_str()))) {
+			break;
+		}
+		files.push_back(file);
+	}
+	return files;
+}
+
+} // namespace
+
+BENCHMARK(TextureLoad_500Textures) {
+#ifdef _WIN32
+	// ミップ作成のフィルタがWICを使う
+	(void)CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+#endif
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "DirectXGameTextureLoadBenchmark";
+	const std::vector<std::wstring> files = WriteTestTextures(directory);
+	if (files.size() != kTextureCount) {
+		std::printf("  failed to write test textures\n");
+		return;
+	}
+
+	// 1スレッドで順に読む(非同期にする前のInitializeと同じ)
+	uint32_t failedCount = 0;
+	const double serialTime = MeasureMilliseconds(1, [&]() {
+		for (const std::wstring& file : files) {
+			DirectX::ScratchImage image{};
+			if (FAILED(DecodeTexture(file, image))) {
+				++failedCount;
+			}
+			BenchmarkSink = BenchmarkSink + image.GetPixelsSize();
+		}
+	});
+	std::printf("  serial     : %u textures %ux%u in %.1f ms (%.2f ms/texture, %u failed)\n",
+		kTextureCount, kTextureSize, kTextureSize, serialTime, serialTime / kTextureCount, failedCount);
+
+	// TextureManagerと同じくワーカーに1枚ずつ積む
+	ThreadPool threadPool;
+#ifdef _WIN32
+	threadPool.Init(0, [](uint32_t) { (void)CoInitializeEx(nullptr, COINIT_MULTITHREADED); }, [](uint32_t) { CoUninitialize(); });
+#else
+	threadPool.Init(0);
+#endif
+	std::atomic<uint32_t> parallelFailedCount = 0;
+	// BenchmarkSinkはワーカーから触らず、全て終わってから足す
+	std::atomic<uint64_t> parallelPixelsSize = 0;
+	const double parallelTime = MeasureMilliseconds(1, [&]() {
+		for (const std::wstring& file : files) {
+			threadPool.Submit([&, file]() {
+				DirectX::ScratchImage image{};
+				if (FAILED(DecodeTexture(file, image))) {
+					++parallelFailedCount;
+				}
+				parallelPixelsSize += image.GetPixelsSize();
+			});
+		}
+		threadPool.WaitIdle();
+	});
+	BenchmarkSink = BenchmarkSink + parallelPixelsSize.load();
+	std::printf("  thread pool: %u textures in %.1f ms (%u threads, x%.2f, %u failed)\n",
+		kTextureCount, parallelTime, threadPool.GetThreadCount(), serialTime / parallelTime, parallelFailedCount.load());
+	threadPool.Finalize();
+
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+#ifdef _WIN32
+	CoUninitialize();
+#endif
+}
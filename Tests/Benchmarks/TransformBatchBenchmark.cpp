@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "BenchmarkFramework.h"
+#include "MyMatrix.h"
+#include "TransformBatch.h"
+
+/*================================================================================================
+World・WVP行列を作る時間
+10万個のTransformについて、1つずつ MakeAffineMatrix → Multiply する場合と、
+TransformBatch::ComputeWorldMatrices でまとめて作る場合の1フレーム分を比べ、結果の差も出す
+==================================================================================================*/
+
+namespace {
+
+const size_t kEntityCount = 100000;
+const uint32_t kFrameCount = 50;
+
+float GetMaxDifference(const std::vector<Matrix4x4>& a, const std::vector<Matrix4x4>& b) {
+	float difference = 0.0f;
+	for (size_t index = 0; index < a.size(); ++index) {
+		for (int row = 0; row < 4; ++row) {
+			for (int col = 0; col < 4; ++col) {
+				difference = (std::max)(difference, std::abs(a[index].m[row][col] - b[index].m[row][col]));
+			}
+		}
+	}
+	return difference;
+}
+
+} // namespace
+
+BENCHMARK(TransformBatch_ComputeWorldMatrices) {
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+	std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+	std::uniform_real_distribution<float> translate(-50.0f, 50.0f);
+	TransformBatch batch;
+	batch.Reserve(kEntityCount);
+	for (size_t index = 0; index < kEntityCount; ++index) {
+		batch.Add({ { scale(random), scale(random), scale(random) }, { angle(random), angle(random), angle(random) },
+			{ translate(random), translate(random), translate(random) } });
+	}
+	const Matrix4x4 view = InverseAffine(MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.2f, 0.0f, 0.0f }, { 0.0f, 10.0f, -80.0f }));
+	const Matrix4x4 vp = Multiply(view, MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 200.0f));
+
+	// 1つずつ(Object3dと同じ作り方)
+	std::vector<Matrix4x4> objectWvps(kEntityCount);
+	std::vector<Matrix4x4> objectWorlds(kEntityCount);
+	const double objectTime = MeasureMilliseconds(kFrameCount, [&]() {
+		for (uint32_t index = 0; index < kEntityCount; ++index) {
+			objectWorlds[index] = MakeAffineMatrix(batch.Get(index));
+			objectWvps[index] = Multiply(objectWorlds[index], vp);
+		}
+	}) / kFrameCount;
+	BenchmarkSink = BenchmarkSink + static_cast<uint64_t>(objectWvps.back().m[3][3] != 0.0f);
+
+	// まとめて
+	std::vector<Matrix4x4> batchWvps(kEntityCount);
+	std::vector<Matrix4x4> batchWorlds(kEntityCount);
+	const double batchTime = MeasureMilliseconds(kFrameCount, [&]() {
+		batch.ComputeWorldMatrices(vp, batchWvps.data(), batchWorlds.data());
+	}) / kFrameCount;
+	BenchmarkSink = BenchmarkSink + static_cast<uint64_t>(batchWvps.back().m[3][3] != 0.0f);
+
+	std::printf("  %zu entities: per object %.2f ms, TransformBatch %.2f ms, x%.1f\n", kEntityCount, objectTime, batchTime, objectTime / batchTime);
+	std::printf("  max difference: wvp %.2g, world %.2g\n", GetMaxDifference(batchWvps, objectWvps), GetMaxDifference(batchWorlds, objectWorlds));
+}
@@ -0,0 +1,53 @@
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "BenchmarkFramework.h"
+
+/*================================================================================================
+ベンチマーク
+	Benchmarks [名前の一部]
+引数があれば名前にそれを含むものだけ実行する
+==================================================================================================*/
+
+MemoryUsage GetMemoryUsage() {
+	MemoryUsage usage{};
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters{};
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		usage.workingSet = counters.WorkingSetSize;
+		usage.privateBytes = counters.PagefileUsage;
+	}
+#else
+	// /proc/self/statm: 全体 常駐 共有 ...(ページ数)
+	unsigned long long size = 0, resident = 0, shared = 0;
+	if (FILE* file = std::fopen("/proc/self/statm", "r")) {
+		if (std::fscanf(file, "%llu %llu %llu", &size, &resident, &shared) == 3) {
+			const uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+			usage.workingSet = resident * pageSize;
+			usage.privateBytes = (resident - shared) * pageSize;
+		}
+		std::fclose(file);
+	}
+#endif
+	return usage;
+}
+
+int main(int argc, char* argv[]) {
+	const char* filter = argc > 1 ? argv[1] : nullptr;
+
+	for (const BenchmarkCase& benchmarkCase : GetBenchmarkCases()) {
+		if (filter && !std::strstr(benchmarkCase.name, filter)) {
+			continue;
+		}
+		std::printf("== %s\n", benchmarkCase.name);
+		benchmarkCase.function();
+	}
+	return 0;
+}
@@ -0,0 +1,125 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "TestFramework.h"
+#include "TestFiles.h"
+#include "CookManifest.h"
+
+namespace {
+
+/// 内容を変えずに更新日時だけ進める
+void Touch(const std::wstring& filePath) {
+	std::error_code error;
+	const auto writeTime = std::filesystem::last_write_time(filePath, error);
+	std::filesystem::last_write_time(filePath, writeTime + std::chrono::seconds(10), error);
+}
+
+CookManifestEntry MakeEntry(const std::wstring& source, const std::wstring& cooked) {
+	CookManifestEntry entry;
+	MakeCookSourceFile(source, entry.source);
+	entry.cookedPath = cooked;
+	return entry;
+}
+
+} // namespace
+
+TEST(CookManifest_NormalizesPaths) {
+	CHECK(NormalizeCookPath(L"./Resource/a.png") == L"Resource/a.png");
+	CHECK(NormalizeCookPath(L"Resource/x/../a.png") == L"Resource/a.png");
+	CHECK(NormalizeCookPath((std::filesystem::current_path() / L"Resource" / L"a.png").wstring()) == L"Resource/a.png");
+}
+
+TEST(CookManifest_SaveLoadRoundTrip) {
+	TempDirectory directory(L"RoundTrip");
+	const std::wstring source = directory.File(L"a.png");
+	const std::wstring material = directory.File(L"a.mtl");
+	WriteText(source, "source");
+	WriteText(material, "material");
+
+	CookManifest manifest;
+	CookManifestEntry entry = MakeEntry(source, directory.File(L"a_0123.dds"));
+	CookSourceFile dependency;
+	CHECK(MakeCookSourceFile(material, dependency));
+	entry.dependencies.push_back(dependency);
+	manifest.Set(entry);
+	manifest.Set(MakeEntry(material, directory.File(L"b.dds")));
+	CHECK(manifest.Save(GetCookManifestPath(directory.GetPath())));
+
+	CookManifest loaded;
+	CHECK(loaded.Load(GetCookManifestPath(directory.GetPath())));
+	CHECK_EQUAL(loaded.GetEntryCount(), 2);
+	const CookManifestEntry* found = loaded.Find(L"./" + source);
+	CHECK(found != nullptr);
+	if (found) {
+		CHECK(found->cookedPath == entry.cookedPath);
+		CHECK_EQUAL(found->source.size, 6);
+		CHECK_EQUAL(found->source.hash, entry.source.hash);
+		CHECK_EQUAL(found->source.writeTime, entry.source.writeTime);
+		CHECK_EQUAL(found->dependencies.size(), 1);
+		CHECK(found->dependencies.size() == 1 && found->dependencies[0].filePath == NormalizeCookPath(material));
+	}
+}
+
+TEST(CookManifest_LoadRejectsMissingAndBrokenFiles) {
+	TempDirectory directory(L"Broken");
+	CookManifest manifest;
+	CHECK(!manifest.Load(directory.File(L"missing.bin")));
+
+	// 先頭は正しいが、パスの長さが壊れている
+	const std::wstring manifestPath = directory.File(L"manifest.bin");
+	{
+		std::ofstream file(std::filesystem::path(manifestPath), std::ios::binary);
+		const uint32_t header[4] = { 0x4E414D43, 1, 1, 0 };
+		file.write(reinterpret_cast<const char*>(header), sizeof(header));
+		const uint32_t pathSize = 0x7FFFFFFF;
+		file.write(reinterpret_cast<const char*>(&pathSize), sizeof(pathSize));
+	}
+	CHECK(!manifest.Load(manifestPath));
+	CHECK_EQUAL(manifest.GetEntryCount(), 0);
+}
+
+TEST(CookManifest_ResolveChecksSourceAndDependencies) {
+	TempDirectory directory(L"Resolve");
+	const std::wstring source = directory.File(L"model.obj");
+	const std::wstring material = directory.File(L"model.mtl");
+	const std::wstring cooked = directory.File(L"model_0123.mesh");
+	WriteText(source, "v 0 0 0");
+	WriteText(material, "newmtl a");
+	WriteText(cooked, "cooked");
+
+	CookManifest manifest;
+	CookManifestEntry entry = MakeEntry(source, cooked);
+	CookSourceFile dependency;
+	MakeCookSourceFile(material, dependency);
+	entry.dependencies.push_back(dependency);
+	manifest.Set(entry);
+
+	CHECK(manifest.Resolve(source) == NormalizeCookPath(cooked));
+	CHECK(manifest.Resolve(directory.File(L"other.obj")).empty());
+
+	// 日時だけ変わった(チェックアウト等)なら内容を比べて使う
+	Touch(source);
+	CHECK(manifest.Resolve(source) == NormalizeCookPath(cooked));
+
+	// 大きさが同じでも内容が変わっていれば使わない
+	WriteText(source, "v 1 0 0");
+	Touch(source);
+	CHECK(manifest.Resolve(source).empty());
+	manifest.Set(MakeEntry(source, cooked));
+	CHECK(manifest.Resolve(source) == NormalizeCookPath(cooked));
+
+	// 依存ファイルが変わっても使わない
+	entry = MakeEntry(source, cooked);
+	entry.dependencies.push_back(dependency);
+	manifest.Set(entry);
+	WriteText(material, "newmtl b");
+	Touch(material);
+	CHECK(manifest.Resolve(source).empty());
+
+	// 焼いたファイルが消えていれば使わない
+	manifest.Set(MakeEntry(source, cooked));
+	std::filesystem::remove(cooked);
+	CHECK(manifest.Resolve(source).empty());
+}
@@ -0,0 +1,65 @@
+#include "TestFramework.h"
+#include "DirectXCommon/DescriptorAllocator.h"
+
+TEST(DescriptorAllocator_PersistentUsesLowIndicesFirst) {
+	DescriptorAllocator allocator;
+	allocator.Init(4, 8);
+
+	CHECK_EQUAL(allocator.GetTotalCount(), 12);
+	CHECK_EQUAL(allocator.AllocatePersistent(), 0);
+	CHECK_EQUAL(allocator.AllocatePersistent(), 1);
+	CHECK_EQUAL(allocator.GetPersistentUsedCount(), 2);
+	CHECK(allocator.IsPersistentAllocated(1));
+	CHECK(!allocator.IsPersistentAllocated(2));
+}
+
+TEST(DescriptorAllocator_PersistentReturnsInvalidWhenFull) {
+	DescriptorAllocator allocator;
+	allocator.Init(3, 1);
+
+	for (uint32_t i = 0; i < 3; ++i) {
+		CHECK(allocator.AllocatePersistent() != DescriptorAllocator::kInvalidIndex);
+	}
+	CHECK_EQUAL(allocator.AllocatePersistent(), DescriptorAllocator::kInvalidIndex);
+	CHECK_EQUAL(allocator.GetPersistentUsedCount(), 3);
+
+	// 解放した番号がまた使われる
+	allocator.FreePersistent(1);
+	CHECK(!allocator.IsPersistentAllocated(1));
+	CHECK_EQUAL(allocator.AllocatePersistent(), 1);
+	CHECK_EQUAL(allocator.AllocatePersistent(), DescriptorAllocator::kInvalidIndex);
+}
+
+TEST(DescriptorAllocator_NoPersistentRange) {
+	DescriptorAllocator allocator;
+	allocator.Init(0, 4);
+
+	CHECK_EQUAL(allocator.AllocatePersistent(), DescriptorAllocator::kInvalidIndex);
+	CHECK_EQUAL(allocator.AllocateTransient(2), 0);
+}
+
+TEST(DescriptorAllocator_TransientFollowsPersistentRange) {
+	DescriptorAllocator allocator;
+	allocator.Init(4, 8);
+
+	CHECK_EQUAL(allocator.AllocateTransient(3), 4);
+	CHECK_EQUAL(allocator.AllocateTransient(2), 7);
+	CHECK_EQUAL(allocator.GetTransientUsedCount(), 5);
+	// 一時の確保は常駐の範囲に影響しない
+	CHECK_EQUAL(allocator.AllocatePersistent(), 0);
+}
+
+TEST(DescriptorAllocator_TransientReturnsInvalidUntilRetired) {
+	DescriptorAllocator allocator;
+	allocator.Init(2, 8);
+
+	CHECK_EQUAL(allocator.AllocateTransient(6), 2);
+	allocator.EndFrame(1, 0);
+	// 残り2では足りない(連続している必要がある)
+	CHECK_EQUAL(allocator.AllocateTransient(3), DescriptorAllocator::kInvalidIndex);
+	CHECK_EQUAL(allocator.AllocateTransient(9), DescriptorAllocator::kInvalidIndex);
+
+	// フレーム1が終われば先頭から使える
+	allocator.EndFrame(2, 1);
+	CHECK_EQUAL(allocator.AllocateTransient(3), 2);
+}
@@ -0,0 +1,127 @@
+#include <vector>
+
+#include "TestFramework.h"
+#include "DirectXCommon/FrameScheduler.h"
+
+namespace {
+
+/// <summary>
+/// GPUの代わりのフェンス。completedValueはテストが進め、Waitは待った値を記録してその値まで終わらせる
+/// </summary>
+class MockFence : public IFrameFence {
+public:
+	void Signal(uint64_t value) override { signaledValues.push_back(value); }
+	uint64_t GetCompletedValue() const override { return completedValue; }
+	void Wait(uint64_t value) override {
+		waitedValues.push_back(value);
+		if (completedValue < value) {
+			completedValue = value;
+		}
+	}
+
+	uint64_t completedValue = 0;
+	std::vector<uint64_t> signaledValues;
+	std::vector<uint64_t> waitedValues;
+};
+
+} // namespace
+
+TEST(FrameScheduler_SignalsIncreasingValuesAndRotatesSlots) {
+	MockFence fence;
+	FrameScheduler scheduler;
+	scheduler.Init(&fence, 3);
+
+	CHECK_EQUAL(scheduler.GetFrameIndex(), 0);
+	CHECK_EQUAL(scheduler.GetCurrentFenceValue(), 1);
+	CHECK_EQUAL(scheduler.Advance(), 1);
+	CHECK_EQUAL(scheduler.GetFrameIndex(), 1);
+	CHECK_EQUAL(scheduler.Advance(), 2);
+	CHECK_EQUAL(scheduler.GetFrameIndex(), 2);
+	CHECK_EQUAL(scheduler.Advance(), 3);
+	CHECK_EQUAL(scheduler.GetFrameIndex(), 0);
+	CHECK_EQUAL(scheduler.GetLastSignaledValue(), 3);
+
+	CHECK_EQUAL(fence.signaledValues.size(), 3);
+	CHECK_EQUAL(fence.signaledValues[0], 1);
+	CHECK_EQUAL(fence.signaledValues[2], 3);
+}
+
+TEST(FrameScheduler_WaitsOnlyWhenReusedSlotIsBusy) {
+	MockFence fence;
+	FrameScheduler scheduler;
+	scheduler.Init(&fence, 2);
+
+	// 1フレーム目: 次のスロットはまだ使われていないので待たない
+	scheduler.Advance();
+	CHECK(fence.waitedValues.empty());
+
+	// 2フレーム目: スロット0を再利用する。GPUは何も終わらせていないのでフレーム1を待つ
+	scheduler.Advance();
+	CHECK_EQUAL(fence.waitedValues.size(), 1);
+	CHECK_EQUAL(fence.waitedValues[0], 1);
+
+	// GPUが先に終わらせていれば待たない
+	fence.completedValue = 2;
+	scheduler.Advance();
+	CHECK_EQUAL(fence.waitedValues.size(), 1);
+
+	// スロット0(フレーム3)はまだ終わっていない
+	scheduler.Advance();
+	CHECK_EQUAL(fence.waitedValues.size(), 2);
+	CHECK_EQUAL(fence.waitedValues[1], 3);
+}
+
+TEST(FrameScheduler_SingleFrameInFlightWaitsEveryFrame) {
+	MockFence fence;
+	FrameScheduler scheduler;
+	scheduler.Init(&fence, 1);
+
+	for (uint64_t frame = 1; frame <= 4; ++frame) {
+		CHECK_EQUAL(scheduler.Advance(), frame);
+		CHECK_EQUAL(scheduler.GetFrameIndex(), 0);
+		CHECK_EQUAL(fence.waitedValues.back(), frame);
+	}
+	CHECK_EQUAL(fence.waitedValues.size(), 4);
+}
+
+TEST(FrameScheduler_InitContinuesFromCompletedValue) {
+	// 作り直し(リサイズ等)の後も、フェンスの値を戻さずに続ける
+	MockFence fence;
+	fence.completedValue = 10;
+	FrameScheduler scheduler;
+	scheduler.Init(&fence, 2);
+
+	CHECK_EQUAL(scheduler.Advance(), 11);
+	CHECK(fence.waitedValues.empty());
+	CHECK_EQUAL(scheduler.GetCompletedValue(), 10);
+}
+
+TEST(FrameScheduler_WaitForIdleSignalsAndWaitsForLatest) {
+	MockFence fence;
+	FrameScheduler scheduler;
+	scheduler.Init(&fence, 3);
+	scheduler.Advance();
+	scheduler.Advance();
+
+	scheduler.WaitForIdle();
+	CHECK_EQUAL(fence.signaledValues.back(), 3);
+	CHECK_EQUAL(fence.waitedValues.back(), 3);
+	CHECK_EQUAL(fence.completedValue, 3);
+
+	// 待った後は次のAdvanceでどのスロットも空いている
+	const size_t waitCount = fence.waitedValues.size();
+	CHECK_EQUAL(scheduler.Advance(), 4);
+	CHECK_EQUAL(fence.waitedValues.size(), waitCount);
+}
+
+TEST(FrameScheduler_RecordsWaitHistory) {
+	MockFence fence;
+	FrameScheduler scheduler;
+	scheduler.Init(&fence, 1);
+
+	for (uint32_t i = 0; i < FrameScheduler::kWaitHistoryCount + 5; ++i) {
+		scheduler.Advance();
+	}
+	CHECK_EQUAL(scheduler.GetWaitHistoryOffset(), 5);
+	CHECK(scheduler.GetLastWaitTime() >= 0.0f);
+}
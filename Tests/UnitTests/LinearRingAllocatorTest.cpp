@@ -0,0 +1,63 @@
+#include "TestFramework.h"
+#include "DirectXCommon/LinearRingAllocator.h"
+
+TEST(LinearRingAllocator_AlignsAndAdvances) {
+	LinearRingAllocator allocator;
+	allocator.Init(1024);
+
+	CHECK_EQUAL(allocator.Allocate(10, 1), 0);
+	CHECK_EQUAL(allocator.Allocate(16, 256), 256);
+	CHECK_EQUAL(allocator.GetFrameUsedSize(), 256 + 16);
+}
+
+TEST(LinearRingAllocator_ReturnsInvalidWhenFull) {
+	LinearRingAllocator allocator;
+	allocator.Init(1024);
+
+	CHECK_EQUAL(allocator.Allocate(0, 1), LinearRingAllocator::kInvalidOffset);
+	CHECK_EQUAL(allocator.Allocate(2048, 1), LinearRingAllocator::kInvalidOffset);
+
+	CHECK_EQUAL(allocator.Allocate(768, 256), 0);
+	// 残り256に収まらない
+	CHECK_EQUAL(allocator.Allocate(512, 256), LinearRingAllocator::kInvalidOffset);
+	CHECK_EQUAL(allocator.Allocate(256, 256), 768);
+	CHECK_EQUAL(allocator.Allocate(1, 1), LinearRingAllocator::kInvalidOffset);
+	// 失敗しても位置は進まない
+	CHECK_EQUAL(allocator.GetUsedSize(), 1024);
+}
+
+TEST(LinearRingAllocator_ReusesRetiredFrames) {
+	LinearRingAllocator allocator;
+	allocator.Init(1024);
+
+	CHECK_EQUAL(allocator.Allocate(512, 256), 0);
+	allocator.FinishFrame(1);
+	CHECK_EQUAL(allocator.Allocate(512, 256), 512);
+	allocator.FinishFrame(2);
+
+	// フレーム1が終わるまでは先頭に戻れない
+	allocator.Retire(0);
+	CHECK_EQUAL(allocator.Allocate(256, 256), LinearRingAllocator::kInvalidOffset);
+
+	allocator.Retire(1);
+	CHECK_EQUAL(allocator.Allocate(256, 256), 0);
+	CHECK_EQUAL(allocator.Allocate(256, 256), 256);
+	CHECK_EQUAL(allocator.Allocate(256, 256), LinearRingAllocator::kInvalidOffset);
+	allocator.FinishFrame(3);
+	CHECK_EQUAL(allocator.GetPeakFrameUsedSize(), 512);
+
+	allocator.Retire(3);
+	CHECK_EQUAL(allocator.GetUsedSize(), 0);
+}
+
+TEST(LinearRingAllocator_WrapSkipsTail) {
+	LinearRingAllocator allocator;
+	allocator.Init(1024);
+
+	CHECK_EQUAL(allocator.Allocate(768, 1), 0);
+	allocator.FinishFrame(1);
+	allocator.Retire(1);
+	// 末尾の256には収まらないので先頭から。捨てた末尾も使っている量に数える
+	CHECK_EQUAL(allocator.Allocate(512, 1), 0);
+	CHECK_EQUAL(allocator.GetUsedSize(), 256 + 512);
+}
@@ -0,0 +1,94 @@
+#include "TestFramework.h"
+#include <cmath>
+
+#include "MeshData.h"
+
+namespace {
+
+VertexData MakeVertex(float x, float y, float z, float u = 0.0f, float v = 0.0f) {
+	return { { x, y, z, 1.0f }, { u, v } };
+}
+
+}
+
+TEST(MeshData_WeldsUnindexedTriangles) {
+	// 2枚の三角形で四角形。共有する2頂点が重複している
+	MeshData mesh;
+	mesh.vertices = {
+		MakeVertex(0, 0, 0), MakeVertex(0, 1, 0), MakeVertex(1, 0, 0),
+		MakeVertex(1, 0, 0), MakeVertex(0, 1, 0), MakeVertex(1, 1, 0),
+	};
+	WeldVertices(mesh);
+	CHECK_EQUAL(mesh.vertices.size(), 4);
+	CHECK_EQUAL(mesh.indices.size(), 6);
+	// 頂点は最初に出てきた順に残る
+	const uint32_t expected[] = { 0, 1, 2, 2, 1, 3 };
+	for (size_t index = 0; index < 6; ++index) {
+		CHECK_EQUAL(mesh.indices[index], expected[index]);
+	}
+	CHECK(mesh.vertices[3].pos.x == 1.0f && mesh.vertices[3].pos.y == 1.0f);
+}
+
+TEST(MeshData_WeldTreatsNegativeZeroAsZero) {
+	MeshData mesh;
+	mesh.vertices = {
+		MakeVertex(-0.0f, 0, 0), MakeVertex(0, 1, 0), MakeVertex(1, 0, -0.0f),
+		MakeVertex(0.0f, 0, 0), MakeVertex(1, 0, 0.0f), MakeVertex(0, 1, 0, -0.0f),
+	};
+	WeldVertices(mesh);
+	CHECK_EQUAL(mesh.vertices.size(), 3);
+	CHECK_EQUAL(mesh.indices[3], 0);
+	CHECK_EQUAL(mesh.indices[4], 2);
+	CHECK_EQUAL(mesh.indices[5], 1);
+	// 残る頂点は+0にそろう
+	CHECK(!std::signbit(mesh.vertices[0].pos.x));
+
+	// UVが違えば位置が同じでも別の頂点
+	MeshData seam;
+	seam.vertices = { MakeVertex(0, 0, 0, 0.0f), MakeVertex(0, 0, 0, 1.0f), MakeVertex(0, 0, 0, 0.0f) };
+	WeldVertices(seam);
+	CHECK_EQUAL(seam.vertices.size(), 2);
+}
+
+TEST(MeshData_WeldRemapsExistingIndices) {
+	// 1番は使われず、3番は0番と同じ
+	MeshData mesh;
+	mesh.vertices = { MakeVertex(0, 0, 0), MakeVertex(5, 5, 5), MakeVertex(1, 0, 0), MakeVertex(0, 0, 0), MakeVertex(0, 1, 0) };
+	mesh.indices = { 4, 2, 3, 0, 4, 2 };
+	WeldVertices(mesh);
+	CHECK_EQUAL(mesh.vertices.size(), 3);
+	const uint32_t expected[] = { 0, 1, 2, 2, 0, 1 };
+	for (size_t index = 0; index < 6; ++index) {
+		CHECK_EQUAL(mesh.indices[index], expected[index]);
+	}
+	CHECK(mesh.vertices[0].pos.y == 1.0f);
+	CHECK(mesh.vertices[2].pos.x == 0.0f && mesh.vertices[2].pos.y == 0.0f);
+}
+
+TEST(MeshData_IndexStrideFollowsWeldedVertexCount) {
+	CHECK_EQUAL(GetIndexStride(0), 2);
+	CHECK_EQUAL(GetIndexStride(kMaxIndex16VertexCount), 2);
+	CHECK_EQUAL(GetIndexStride(kMaxIndex16VertexCount + 1), 4);
+
+	// 7万頂点でも、まとめて16bitに収まれば2byteのインデックス
+	MeshData mesh;
+	for (uint32_t index = 0; index < 70000; ++index) {
+		mesh.vertices.push_back(MakeVertex(float(index % 30000), 0, 0));
+	}
+	CHECK_EQUAL(GetIndexStride(mesh.vertices.size()), 4);
+	WeldVertices(mesh);
+	CHECK_EQUAL(mesh.vertices.size(), 30000);
+	CHECK_EQUAL(mesh.indices.size(), 70000);
+	CHECK_EQUAL(mesh.indices[69999], 69999 % 30000);
+	CHECK_EQUAL(GetIndexStride(mesh.vertices.size()), 2);
+	CHECK_EQUAL(GetMeshByteSize(mesh), 30000 * sizeof(VertexData) + 70000 * 2);
+
+	// 全て違う頂点なら4byteのまま
+	MeshData unique;
+	for (uint32_t index = 0; index < 70000; ++index) {
+		unique.vertices.push_back(MakeVertex(float(index), 0, 0));
+	}
+	WeldVertices(unique);
+	CHECK_EQUAL(unique.vertices.size(), 70000);
+	CHECK_EQUAL(GetIndexStride(unique.vertices.size()), 4);
+}
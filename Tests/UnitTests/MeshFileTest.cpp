@@ -0,0 +1,179 @@
+#include "TestFramework.h"
+#include "TestFiles.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "MeshFile.h"
+
+namespace {
+
+/// <summary>
+/// size x size の四角形の格子。上半分と下半分でマテリアルを分ける
+/// </summary>
+ObjModel MakeGridModel(uint32_t size) {
+	ObjModel model;
+	for (uint32_t y = 0; y <= size; ++y) {
+		for (uint32_t x = 0; x <= size; ++x) {
+			model.mesh.vertices.push_back({ { float(x), float(y), 0.0f, 1.0f }, { float(x) / size, float(y) / size } });
+		}
+	}
+	for (uint32_t y = 0; y < size; ++y) {
+		for (uint32_t x = 0; x < size; ++x) {
+			const uint32_t a = y * (size + 1) + x;
+			const uint32_t b = a + 1;
+			const uint32_t c = a + size + 1;
+			const uint32_t d = c + 1;
+			model.mesh.indices.insert(model.mesh.indices.end(), { a, c, b, b, c, d });
+		}
+	}
+	const uint32_t half = static_cast<uint32_t>(model.mesh.indices.size() / 2);
+	model.materials.push_back({ "red", { 1.0f, 0.0f, 0.0f, 1.0f }, "textures/red.png" });
+	model.materials.push_back({ "blue", { 0.0f, 0.0f, 1.0f, 0.5f }, "" });
+	model.submeshes.push_back({ 0, 0, half });
+	model.submeshes.push_back({ 1, half, half });
+	return model;
+}
+
+std::vector<char> ReadBytes(const std::wstring& filePath) {
+	std::ifstream file(std::filesystem::path(filePath), std::ios::binary);
+	return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void WriteBytes(const std::wstring& filePath, const char* data, size_t size) {
+	WriteText(filePath, std::string_view(data, size));
+}
+
+}
+
+TEST(MeshFile_RoundTrip) {
+	TempDirectory directory(L"MeshFileRoundTrip");
+	ObjModel model = MakeGridModel(8);
+	const uint32_t lod0IndexCount = static_cast<uint32_t>(model.mesh.indices.size());
+
+	// 1段目は元のインデックスの後ろに、半分の三角形を1つのサブメッシュとして置く
+	std::vector<MeshFileLodSource> lods(2);
+	lods[0].submeshes = model.submeshes;
+	lods[1].error = 0.5f;
+	lods[1].submeshes.push_back({ 0, lod0IndexCount, lod0IndexCount / 2 });
+	model.mesh.indices.insert(model.mesh.indices.end(), model.mesh.indices.begin(), model.mesh.indices.begin() + lod0IndexCount / 2);
+
+	MeshletData meshlets;
+	for (MeshFileLodSource& lod : lods) {
+		for (const ObjSubmesh& submesh : lod.submeshes) {
+			const size_t count = BuildMeshlets(meshlets, model.mesh.indices.data() + submesh.firstIndex, submesh.indexCount,
+				model.mesh.vertices.data(), model.mesh.vertices.size());
+			lod.meshletCounts.push_back(static_cast<uint32_t>(count));
+		}
+	}
+
+	const std::wstring filePath = directory.File(L"grid.mesh");
+	CHECK(WriteMeshFile(filePath, model, lods, &meshlets));
+
+	MappedMesh mesh;
+	CHECK(mesh.Open(filePath));
+	if (!mesh.IsOpen()) {
+		return;
+	}
+	// 頂点はそのまま、インデックスは81頂点なので16bit
+	CHECK_EQUAL(mesh.GetVertexCount(), model.mesh.vertices.size());
+	CHECK(std::memcmp(mesh.GetVertices(), model.mesh.vertices.data(), model.mesh.vertices.size() * sizeof(VertexData)) == 0);
+	CHECK_EQUAL(mesh.GetIndexStride(), 2);
+	CHECK_EQUAL(mesh.GetIndexCount(), model.mesh.indices.size());
+	const uint16_t* indices = static_cast<const uint16_t*>(mesh.GetIndices());
+	bool isSameIndices = true;
+	for (size_t index = 0; index < model.mesh.indices.size(); ++index) {
+		isSameIndices = isSameIndices && indices[index] == model.mesh.indices[index];
+	}
+	CHECK(isSameIndices);
+
+	// LOD・サブメッシュ
+	CHECK_EQUAL(mesh.GetLodCount(), 2);
+	CHECK_EQUAL(mesh.GetLods()[0].indexCount, lod0IndexCount);
+	CHECK_EQUAL(mesh.GetLods()[0].submeshCount, 2);
+	CHECK_EQUAL(mesh.GetLods()[1].firstIndex, lod0IndexCount);
+	CHECK_EQUAL(mesh.GetLods()[1].firstSubmesh, 2);
+	CHECK(mesh.GetLods()[1].error == 0.5f);
+	CHECK_EQUAL(mesh.GetSubmeshCount(), 3);
+	CHECK_EQUAL(mesh.GetSubmeshes()[1].materialIndex, 1);
+	CHECK_EQUAL(mesh.GetSubmeshes()[1].firstIndex, lod0IndexCount / 2);
+
+	// メッシュレット
+	CHECK_EQUAL(mesh.GetMeshletCount(), meshlets.meshlets.size());
+	CHECK_EQUAL(mesh.GetLods()[1].firstMeshlet, mesh.GetLods()[0].meshletCount);
+	CHECK(std::memcmp(mesh.GetMeshlets(), meshlets.meshlets.data(), meshlets.meshlets.size() * sizeof(Meshlet)) == 0);
+	CHECK(std::memcmp(mesh.GetMeshletVertices(), meshlets.vertices.data(), meshlets.vertices.size() * sizeof(uint32_t)) == 0);
+	CHECK(std::memcmp(mesh.GetMeshletTriangles(), meshlets.triangles.data(), meshlets.triangles.size()) == 0);
+
+	// マテリアル・範囲
+	CHECK_EQUAL(mesh.GetMaterialCount(), 2);
+	CHECK(std::strcmp(mesh.GetString(mesh.GetMaterial(0).nameOffset), "red") == 0);
+	CHECK(std::strcmp(mesh.GetString(mesh.GetMaterial(0).diffuseTextureOffset), "textures/red.png") == 0);
+	CHECK(std::strcmp(mesh.GetString(mesh.GetMaterial(1).diffuseTextureOffset), "") == 0);
+	CHECK(mesh.GetMaterial(1).diffuseColor.w == 0.5f);
+	CHECK(mesh.GetBounds().max.x == 8.0f && mesh.GetBounds().max.y == 8.0f);
+}
+
+TEST(MeshFile_Uses32BitIndicesForLargeMeshes) {
+	TempDirectory directory(L"MeshFileIndex32");
+	const ObjModel model = MakeGridModel(300);
+	CHECK(model.mesh.vertices.size() > kMaxIndex16VertexCount);
+	const std::wstring filePath = directory.File(L"large.mesh");
+	CHECK(WriteMeshFile(filePath, model));
+
+	MappedMesh mesh;
+	CHECK(mesh.Open(filePath));
+	if (!mesh.IsOpen()) {
+		return;
+	}
+	CHECK_EQUAL(mesh.GetIndexStride(), 4);
+	CHECK(std::memcmp(mesh.GetIndices(), model.mesh.indices.data(), model.mesh.indices.size() * sizeof(uint32_t)) == 0);
+	// LODを渡さなければ元の形の1段だけ
+	CHECK_EQUAL(mesh.GetLodCount(), 1);
+	CHECK_EQUAL(mesh.GetSubmeshCount(), 2);
+	CHECK_EQUAL(mesh.GetMeshletCount(), 0);
+}
+
+TEST(MeshFile_RejectsBrokenFiles) {
+	TempDirectory directory(L"MeshFileBroken");
+	const std::wstring goodPath = directory.File(L"good.mesh");
+	CHECK(WriteMeshFile(goodPath, MakeGridModel(4)));
+	const std::vector<char> bytes = ReadBytes(goodPath);
+	CHECK(bytes.size() > sizeof(MeshFileHeader));
+
+	MappedMesh mesh;
+	CHECK(mesh.Open(goodPath));
+	mesh.Close();
+	CHECK(!mesh.Open(directory.File(L"missing.mesh")));
+
+	// 途中で切れている(ヘッダの中・最後の1byte)
+	const std::wstring headerOnlyPath = directory.File(L"header.mesh");
+	WriteBytes(headerOnlyPath, bytes.data(), sizeof(MeshFileHeader) / 2);
+	CHECK(!mesh.Open(headerOnlyPath));
+	const std::wstring truncatedPath = directory.File(L"truncated.mesh");
+	WriteBytes(truncatedPath, bytes.data(), bytes.size() - 1);
+	CHECK(!mesh.Open(truncatedPath));
+	CHECK(!mesh.IsOpen());
+
+	// 違うバージョン・形式
+	std::vector<char> versioned = bytes;
+	reinterpret_cast<MeshFileHeader*>(versioned.data())->version = kMeshFileVersion + 1;
+	const std::wstring versionPath = directory.File(L"version.mesh");
+	WriteBytes(versionPath, versioned.data(), versioned.size());
+	CHECK(!mesh.Open(versionPath));
+
+	std::vector<char> magic = bytes;
+	reinterpret_cast<MeshFileHeader*>(magic.data())->magic = 0;
+	const std::wstring magicPath = directory.File(L"magic.mesh");
+	WriteBytes(magicPath, magic.data(), magic.size());
+	CHECK(!mesh.Open(magicPath));
+
+	// 区画の外を指すサブメッシュ
+	std::vector<char> outOfRange = bytes;
+	const MeshFileHeader* header = reinterpret_cast<const MeshFileHeader*>(outOfRange.data());
+	reinterpret_cast<MeshFileSubmesh*>(outOfRange.data() + header->submeshOffset)->indexCount = header->indexCount + 3;
+	const std::wstring rangePath = directory.File(L"range.mesh");
+	WriteBytes(rangePath, outOfRange.data(), outOfRange.size());
+	CHECK(!mesh.Open(rangePath));
+}
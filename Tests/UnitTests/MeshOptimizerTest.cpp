@@ -0,0 +1,192 @@
+#include "TestFramework.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "MeshOptimizer.h"
+
+namespace {
+
+using Triangle = std::array<uint32_t, 3>;
+
+/// <summary>
+/// 一番小さい番号が先頭に来るように回した三角形の一覧(回り順は保つ)
+/// </summary>
+std::vector<Triangle> GetTriangles(const std::vector<uint32_t>& indices) {
+	std::vector<Triangle> triangles;
+	for (size_t index = 0; index + 2 < indices.size(); index += 3) {
+		Triangle triangle = { indices[index], indices[index + 1], indices[index + 2] };
+		std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+		triangles.push_back(triangle);
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+/// <summary>
+/// 緯度経度の球(三角形 約rings * segments * 2)。時計回りが外向き
+/// </summary>
+MeshData MakeSphere(uint32_t rings, uint32_t segments) {
+	MeshData mesh;
+	const float pi = 3.14159265f;
+	for (uint32_t ring = 0; ring <= rings; ++ring) {
+		const float lat = pi * ring / rings - pi * 0.5f;
+		for (uint32_t segment = 0; segment <= segments; ++segment) {
+			const float lon = 2.0f * pi * segment / segments;
+			mesh.vertices.push_back({ { std::cos(lat) * std::cos(lon), std::sin(lat), std::cos(lat) * std::sin(lon), 1.0f },
+				{ float(segment) / segments, float(ring) / rings } });
+		}
+	}
+	for (uint32_t ring = 0; ring < rings; ++ring) {
+		for (uint32_t segment = 0; segment < segments; ++segment) {
+			const uint32_t a = ring * (segments + 1) + segment;
+			const uint32_t b = a + 1;
+			const uint32_t c = a + segments + 1;
+			const uint32_t d = c + 1;
+			mesh.indices.insert(mesh.indices.end(), { a, c, b, b, c, d });
+		}
+	}
+	return mesh;
+}
+
+/// <summary>
+/// 三角形の順番をばらばらにする(三角形の中の並びはそのまま)
+/// </summary>
+void ShuffleTriangles(std::vector<uint32_t>& indices) {
+	std::vector<Triangle> triangles;
+	for (size_t index = 0; index < indices.size(); index += 3) {
+		triangles.push_back({ indices[index], indices[index + 1], indices[index + 2] });
+	}
+	std::shuffle(triangles.begin(), triangles.end(), std::mt19937(12345));
+	for (size_t triangle = 0; triangle < triangles.size(); ++triangle) {
+		std::copy(triangles[triangle].begin(), triangles[triangle].end(), indices.begin() + triangle * 3);
+	}
+}
+
+/// <summary>
+/// 頂点の並びをばらばらにし、インデックスを付け直す
+/// </summary>
+void ShuffleVertices(MeshData& mesh) {
+	std::vector<uint32_t> order(mesh.vertices.size());
+	for (uint32_t vertex = 0; vertex < order.size(); ++vertex) {
+		order[vertex] = vertex;
+	}
+	std::shuffle(order.begin(), order.end(), std::mt19937(6789));
+	std::vector<VertexData> vertices(mesh.vertices.size());
+	for (uint32_t vertex = 0; vertex < order.size(); ++vertex) {
+		vertices[order[vertex]] = mesh.vertices[vertex];
+	}
+	for (uint32_t& index : mesh.indices) {
+		index = order[index];
+	}
+	mesh.vertices.swap(vertices);
+}
+
+float GetAcmr(const MeshData& mesh) {
+	return AnalyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size()).acmr;
+}
+
+}
+
+TEST(MeshOptimizer_VertexCacheKeepsTrianglesAndLowersAcmr) {
+	MeshData mesh = MakeSphere(32, 64);
+	ShuffleTriangles(mesh.indices);
+	const std::vector<Triangle> triangles = GetTriangles(mesh.indices);
+	const float shuffledAcmr = GetAcmr(mesh);
+
+	OptimizeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+	// 同じ三角形が同じ回り順で残る
+	CHECK(GetTriangles(mesh.indices) == triangles);
+	// ばらばらならほぼ3、格子は0.5に近いほど良い
+	const float optimizedAcmr = GetAcmr(mesh);
+	CHECK(shuffledAcmr > 2.5f);
+	CHECK(optimizedAcmr < 0.8f);
+
+	// 元から良い並び(行ごとの格子)よりも悪くならない
+	MeshData ordered = MakeSphere(32, 64);
+	const float orderedAcmr = GetAcmr(ordered);
+	OptimizeVertexCache(ordered.indices.data(), ordered.indices.size(), ordered.vertices.size());
+	CHECK(GetAcmr(ordered) <= orderedAcmr);
+
+	// 空なら何もしない
+	OptimizeVertexCache(nullptr, 0, 0);
+}
+
+TEST(MeshOptimizer_OverdrawKeepsTrianglesWithinThreshold) {
+	MeshData mesh = MakeSphere(32, 64);
+	ShuffleTriangles(mesh.indices);
+	const std::vector<Triangle> triangles = GetTriangles(mesh.indices);
+	const float shuffledAcmr = GetAcmr(mesh);
+	OptimizeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+	const float tipsifyAcmr = GetAcmr(mesh);
+
+	const float threshold = 1.05f;
+	OptimizeOverdraw(mesh.indices.data(), mesh.indices.size(), mesh.vertices.data(), mesh.vertices.size(), threshold);
+	CHECK(GetTriangles(mesh.indices) == triangles);
+	// 塊の区切りでキャッシュが落ちる分だけ悪くなるが、並べ替える前よりはずっと良い
+	const float overdrawAcmr = GetAcmr(mesh);
+	CHECK(overdrawAcmr < shuffledAcmr);
+	CHECK(overdrawAcmr <= tipsifyAcmr * threshold * 1.1f);
+
+	// 悪化を許さない(1.0)場合も、三角形は変えずにACMRをほぼ保つ
+	MeshData hard = MakeSphere(32, 64);
+	OptimizeVertexCache(hard.indices.data(), hard.indices.size(), hard.vertices.size());
+	const float hardAcmr = GetAcmr(hard);
+	OptimizeOverdraw(hard.indices.data(), hard.indices.size(), hard.vertices.data(), hard.vertices.size(), 1.0f);
+	CHECK(GetTriangles(hard.indices) == GetTriangles(MakeSphere(32, 64).indices));
+	CHECK(GetAcmr(hard) <= hardAcmr * 1.1f);
+}
+
+TEST(MeshOptimizer_VertexFetchFollowsFirstUse) {
+	// 三角形はキャッシュ向きに並べ、頂点はばらばら
+	MeshData mesh = MakeSphere(16, 32);
+	ShuffleVertices(mesh);
+	OptimizeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+	// 使われない頂点を足しておく
+	mesh.vertices.push_back({ { 9.0f, 9.0f, 9.0f, 1.0f }, { 0.0f, 0.0f } });
+	const MeshData original = mesh;
+	const VertexFetchStats before = AnalyzeVertexFetch(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size(), sizeof(VertexData));
+
+	OptimizeVertexFetch(mesh);
+	CHECK_EQUAL(mesh.vertices.size(), original.vertices.size() - 1);
+	CHECK_EQUAL(mesh.indices.size(), original.indices.size());
+
+	// 同じ場所の頂点を同じ順に指す(三角形と回り順はそのまま)
+	bool isSameCorners = true;
+	for (size_t index = 0; index < mesh.indices.size(); ++index) {
+		const VertexData& vertex = mesh.vertices[mesh.indices[index]];
+		const VertexData& expected = original.vertices[original.indices[index]];
+		isSameCorners = isSameCorners && vertex.pos.x == expected.pos.x && vertex.pos.y == expected.pos.y && vertex.pos.z == expected.pos.z
+			&& vertex.texcord.x == expected.texcord.x && vertex.texcord.y == expected.texcord.y;
+	}
+	CHECK(isSameCorners);
+
+	// 新しい番号は最初に使われた順
+	uint32_t nextVertex = 0;
+	bool isFirstUseOrder = true;
+	for (uint32_t index : mesh.indices) {
+		isFirstUseOrder = isFirstUseOrder && index <= nextVertex;
+		nextVertex = std::max(nextVertex, index + 1);
+	}
+	CHECK(isFirstUseOrder);
+
+	const VertexFetchStats after = AnalyzeVertexFetch(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size(), sizeof(VertexData));
+	CHECK(after.bytesFetched < before.bytesFetched);
+	CHECK(after.overfetch < 2.0f);
+}
+
+TEST(MeshOptimizer_AnalyzeVertexCache) {
+	// 2枚で4頂点: 1枚目は3回、2枚目は1回だけシェーダが走る
+	const std::vector<uint32_t> quad = { 0, 1, 2, 2, 1, 3 };
+	const VertexCacheStats stats = AnalyzeVertexCache(quad.data(), quad.size(), 4);
+	CHECK_EQUAL(stats.transformedCount, 4);
+	CHECK(stats.acmr == 2.0f);
+	CHECK(stats.atvr == 1.0f);
+
+	// キャッシュが3つなら、3つ前の頂点は追い出されている
+	const std::vector<uint32_t> strip = { 0, 1, 2, 3, 4, 5, 0, 1, 2 };
+	CHECK_EQUAL(AnalyzeVertexCache(strip.data(), strip.size(), 6, 3).transformedCount, 9);
+	CHECK_EQUAL(AnalyzeVertexCache(strip.data(), strip.size(), 6, 6).transformedCount, 6);
+}
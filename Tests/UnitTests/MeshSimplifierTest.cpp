@@ -0,0 +1,197 @@
+#include "TestFramework.h"
+#include <cmath>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "MeshSimplifier.h"
+
+namespace {
+
+/// <summary>
+/// 緯度経度の球。経度0の継ぎ目と両極は、位置が同じでUVが違う頂点になる
+/// </summary>
+MeshData MakeSphere(uint32_t rings, uint32_t segments) {
+	MeshData mesh;
+	const float pi = 3.14159265f;
+	for (uint32_t ring = 0; ring <= rings; ++ring) {
+		const float lat = pi * ring / rings - pi * 0.5f;
+		for (uint32_t segment = 0; segment <= segments; ++segment) {
+			// 端の位置はぴったり同じにする
+			const float lon = segment == segments ? 0.0f : 2.0f * pi * segment / segments;
+			const float radius = ring == 0 || ring == rings ? 0.0f : std::cos(lat);
+			mesh.vertices.push_back({ { radius * std::cos(lon), ring == 0 ? -1.0f : ring == rings ? 1.0f : std::sin(lat), radius * std::sin(lon), 1.0f },
+				{ float(segment) / segments, float(ring) / rings } });
+		}
+	}
+	for (uint32_t ring = 0; ring < rings; ++ring) {
+		for (uint32_t segment = 0; segment < segments; ++segment) {
+			const uint32_t a = ring * (segments + 1) + segment;
+			const uint32_t b = a + 1;
+			const uint32_t c = a + segments + 1;
+			const uint32_t d = c + 1;
+			mesh.indices.insert(mesh.indices.end(), { a, c, b, b, c, d });
+		}
+	}
+	return mesh;
+}
+
+/// <summary>
+/// z = 0 の平らな size x size の格子(穴のない1枚なので、周りが全て端)
+/// </summary>
+MeshData MakeGrid(uint32_t size) {
+	MeshData mesh;
+	for (uint32_t y = 0; y <= size; ++y) {
+		for (uint32_t x = 0; x <= size; ++x) {
+			mesh.vertices.push_back({ { float(x), float(y), 0.0f, 1.0f }, { float(x) / size, float(y) / size } });
+		}
+	}
+	for (uint32_t y = 0; y < size; ++y) {
+		for (uint32_t x = 0; x < size; ++x) {
+			const uint32_t a = y * (size + 1) + x;
+			const uint32_t b = a + 1;
+			const uint32_t c = a + size + 1;
+			const uint32_t d = c + 1;
+			mesh.indices.insert(mesh.indices.end(), { a, c, b, b, c, d });
+		}
+	}
+	return mesh;
+}
+
+/// <summary>
+/// 番号が頂点の中に収まり、潰れた三角形がないか
+/// </summary>
+bool IsValidTriangles(const std::vector<uint32_t>& indices, size_t vertexCount) {
+	if (indices.size() % 3 != 0) {
+		return false;
+	}
+	for (size_t index = 0; index < indices.size(); index += 3) {
+		const uint32_t a = indices[index];
+		const uint32_t b = indices[index + 1];
+		const uint32_t c = indices[index + 2];
+		if (a >= vertexCount || b >= vertexCount || c >= vertexCount || a == b || b == c || c == a) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/// <summary>
+/// xy平面での符号付きの面積の合計(時計回りが正)
+/// </summary>
+float GetSignedArea(const std::vector<uint32_t>& indices, const MeshData& mesh) {
+	float area = 0.0f;
+	for (size_t index = 0; index < indices.size(); index += 3) {
+		const Vector4& a = mesh.vertices[indices[index]].pos;
+		const Vector4& b = mesh.vertices[indices[index + 1]].pos;
+		const Vector4& c = mesh.vertices[indices[index + 2]].pos;
+		area -= ((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x)) * 0.5f;
+	}
+	return area;
+}
+
+std::vector<uint32_t> Simplify(const MeshData& mesh, size_t targetIndexCount, float targetError, float* outError = nullptr) {
+	std::vector<uint32_t> result(mesh.indices.size());
+	result.resize(SimplifyMesh(result.data(), mesh.indices.data(), mesh.indices.size(), mesh.vertices.data(), mesh.vertices.size(),
+		targetIndexCount, targetError, outError));
+	return result;
+}
+
+}
+
+TEST(MeshSimplifier_RespectsTargetCount) {
+	// 継ぎ目と極は動かさないので、減らせるのは1/4あたりまで
+	const MeshData mesh = MakeSphere(24, 48);
+	for (size_t divisor : { 2, 3, 4 }) {
+		const size_t target = mesh.indices.size() / divisor / 3 * 3;
+		float error = 0.0f;
+		const std::vector<uint32_t> result = Simplify(mesh, target, 1.0f, &error);
+		CHECK(IsValidTriangles(result, mesh.vertices.size()));
+		// 誤差が十分に許されていれば目標まで減らし、それより減らしすぎない
+		CHECK(result.size() <= target);
+		CHECK(result.size() * 10 >= target * 9);
+		CHECK(error > 0.0f && error <= 1.0f);
+	}
+
+	// 目標が元の数以上なら何もしない
+	CHECK(Simplify(mesh, mesh.indices.size(), 1.0f) == mesh.indices);
+}
+
+TEST(MeshSimplifier_StopsAtTargetError) {
+	const MeshData mesh = MakeSphere(24, 48);
+	const float targetError = 0.01f;
+	float error = 0.0f;
+	const std::vector<uint32_t> result = Simplify(mesh, 0, targetError, &error);
+	CHECK(IsValidTriangles(result, mesh.vertices.size()));
+	// 球は曲がっているので、誤差を小さくすると目標(0)までは減らない
+	CHECK(result.size() > 0);
+	CHECK(result.size() < mesh.indices.size());
+	CHECK(error <= targetError);
+
+	// 許す誤差を大きくすれば更に減る
+	CHECK(Simplify(mesh, 0, 0.1f).size() < result.size());
+}
+
+TEST(MeshSimplifier_KeepsUvSeams) {
+	const MeshData mesh = MakeSphere(24, 48);
+	const std::vector<uint32_t> result = Simplify(mesh, mesh.indices.size() / 4, 1.0f);
+	CHECK(IsValidTriangles(result, mesh.vertices.size()));
+
+	// 位置が同じでUVが違う頂点(経度0の継ぎ目・極)は、元の場所のまま全て残る
+	std::map<std::pair<float, std::pair<float, float>>, uint32_t> positionCounts;
+	for (const VertexData& vertex : mesh.vertices) {
+		++positionCounts[{ vertex.pos.x, { vertex.pos.y, vertex.pos.z } }];
+	}
+	const std::set<uint32_t> used(result.begin(), result.end());
+	size_t seamCount = 0;
+	bool isSeamKept = true;
+	for (uint32_t vertex = 0; vertex < mesh.vertices.size(); ++vertex) {
+		const Vector4& pos = mesh.vertices[vertex].pos;
+		if (positionCounts[{ pos.x, { pos.y, pos.z } }] > 1) {
+			++seamCount;
+			isSeamKept = isSeamKept && used.count(vertex) != 0;
+		}
+	}
+	CHECK_EQUAL(seamCount, (24 - 1) * 2 + 2 * (48 + 1));
+	CHECK(isSeamKept);
+}
+
+TEST(MeshSimplifier_KeepsBordersAndWinding) {
+	const MeshData mesh = MakeGrid(16);
+	const float area = GetSignedArea(mesh.indices, mesh);
+	CHECK(area == 256.0f);
+
+	// 平らなので誤差0でも減らせる
+	float error = 1.0f;
+	const std::vector<uint32_t> result = Simplify(mesh, 0, 0.0f, &error);
+	CHECK(IsValidTriangles(result, mesh.vertices.size()));
+	CHECK(result.size() * 8 < mesh.indices.size());
+	CHECK(error < 1e-3f);
+
+	// 端は内側に縮まず、裏返った三角形もないので、面積がそのまま
+	CHECK(std::abs(GetSignedArea(result, mesh) - area) < 1e-2f);
+	bool isFrontFacing = true;
+	for (size_t index = 0; index < result.size(); index += 3) {
+		isFrontFacing = isFrontFacing && GetSignedArea({ result[index], result[index + 1], result[index + 2] }, mesh) > 0.0f;
+	}
+	CHECK(isFrontFacing);
+
+	// 端の辺(逆向きの辺がない辺)は、元の外周の同じ辺の上にある
+	std::set<std::pair<uint32_t, uint32_t>> edges;
+	for (size_t index = 0; index < result.size(); index += 3) {
+		for (size_t corner = 0; corner < 3; ++corner) {
+			edges.insert({ result[index + corner], result[index + (corner + 1) % 3] });
+		}
+	}
+	bool isOnOutline = true;
+	for (const std::pair<uint32_t, uint32_t>& edge : edges) {
+		if (edges.count({ edge.second, edge.first })) {
+			continue;
+		}
+		const Vector4& a = mesh.vertices[edge.first].pos;
+		const Vector4& b = mesh.vertices[edge.second].pos;
+		isOnOutline = isOnOutline && ((a.x == 0.0f && b.x == 0.0f) || (a.x == 16.0f && b.x == 16.0f) || (a.y == 0.0f && b.y == 0.0f) || (a.y == 16.0f && b.y == 16.0f));
+	}
+	CHECK(isOnOutline);
+}
@@ -0,0 +1,55 @@
+#include "TestFramework.h"
+
+#include "MeshletCulling.h"
+
+namespace {
+
+/// <summary>
+/// 原点にあり、+zを向いた(裏を-zに向けた)塊1つ
+/// </summary>
+void MakeFacingMeshlet(Meshlet& outMeshlet, MeshletBounds& outBounds) {
+	outMeshlet = { 0, 0, 3, 1 };
+	outBounds = { { 0.0f, 0.0f, 0.0f }, 0.1f, { 0.0f, 0.0f, 1.0f }, 0.0f };
+}
+
+/// 何も捨てない視錐台(全ての平面で d が大きい)
+Frustum MakeOpenFrustum() {
+	Frustum frustum{};
+	for (Vector4& plane : frustum.planes) {
+		plane = { 1.0f, 0.0f, 0.0f, 1000.0f };
+	}
+	return frustum;
+}
+
+}
+
+TEST(MeshletCulling_IsUniformScale) {
+	CHECK(IsUniformScale(MakeAffineMatrix({ 0.3f, 0.3f, 0.3f }, { 0.5f, 1.0f, 0.2f }, { 1.0f, 2.0f, 3.0f })));
+	CHECK(!IsUniformScale(MakeAffineMatrix({ 1.0f, 2.0f, 1.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f })));
+	// 回転しても軸ごとの長さは変わらないので、非等倍のまま
+	CHECK(!IsUniformScale(MakeAffineMatrix({ 1.0f, 1.0f, 1.5f }, { 0.7f, 0.3f, 0.0f }, { 0.0f, 0.0f, 0.0f })));
+	// 反転は表裏が入れ替わる
+	CHECK(!IsUniformScale(MakeAffineMatrix({ -1.0f, 1.0f, 1.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f })));
+}
+
+TEST(MeshletCulling_BackfaceTestCanBeSkipped) {
+	Meshlet meshlet{};
+	MeshletBounds bounds{};
+	MakeFacingMeshlet(meshlet, bounds);
+	const Frustum frustum = MakeOpenFrustum();
+	// -z側から見ると裏(円錐の軸がカメラから離れる向き)
+	const Vector3 behind = { 0.0f, 0.0f, -5.0f };
+	const Vector3 front = { 0.0f, 0.0f, 5.0f };
+
+	MeshletCullStats stats;
+	CHECK_EQUAL(CullMeshlets(&meshlet, &bounds, 1, frustum, behind, true, nullptr, &stats), 0);
+	CHECK_EQUAL(stats.backfaceCulledCount, 1);
+	CHECK_EQUAL(CullMeshlets(&meshlet, &bounds, 1, frustum, front, true, nullptr, nullptr), 1);
+
+	// 非等倍の拡縮では円錐を使わないので、裏からでも残す
+	stats = {};
+	uint32_t visible = UINT32_MAX;
+	CHECK_EQUAL(CullMeshlets(&meshlet, &bounds, 1, frustum, behind, false, &visible, &stats), 1);
+	CHECK_EQUAL(stats.backfaceCulledCount, 0);
+	CHECK_EQUAL(visible, 0);
+}
@@ -0,0 +1,240 @@
+#include "TestFramework.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "MyMatrix.h"
+
+namespace {
+
+/// <summary>
+/// SIMDを使わない積(MathSimd.hのスカラー版と同じ式)
+/// </summary>
+Matrix4x4 ScalarMultiply(const Matrix4x4& m1, const Matrix4x4& m2) {
+	Matrix4x4 result{};
+	for (int row = 0; row < 4; row++) {
+		for (int col = 0; col < 4; col++) {
+			for (int oi = 0; oi < 4; oi++) {
+				result.m[row][col] += m1.m[row][oi] * m2.m[oi][col];
+			}
+		}
+	}
+	return result;
+}
+
+/// <summary>
+/// SIMDを使わない逆行列(ピボットが0の時だけ行を入れ替えるGauss-Jordan。スカラー版と同じ手順)
+/// </summary>
+Matrix4x4 ScalarInverse(Matrix4x4 matrix) {
+	Matrix4x4 result = MakeIdentity4x4();
+	for (int i = 0; i < 4; ++i) {
+		if (matrix.m[i][i] == 0.0f) {
+			for (int j = i + 1; j < 4; ++j) {
+				if (matrix.m[j][i] != 0.0f) {
+					swapRows(matrix, i, j);
+					swapRows(result, i, j);
+					break;
+				}
+			}
+		}
+		const float pivot = matrix.m[i][i];
+		scaleRow(matrix, i, 1.0f / pivot);
+		scaleRow(result, i, 1.0f / pivot);
+		for (int j = i + 1; j < 4; ++j) {
+			const float factor = matrix.m[j][i];
+			addScaledRow(matrix, j, i, -factor);
+			addScaledRow(result, j, i, -factor);
+		}
+	}
+	for (int i = 3; i > 0; --i) {
+		for (int j = i - 1; j >= 0; --j) {
+			const float factor = matrix.m[j][i];
+			addScaledRow(matrix, j, i, -factor);
+			addScaledRow(result, j, i, -factor);
+		}
+	}
+	return result;
+}
+
+/// <summary>
+/// 乱数の行列。一部の要素は0・-0にして、ピボットの入れ替えと符号の扱いも通す
+/// </summary>
+std::vector<Matrix4x4> MakeRandomMatrices(size_t count, uint32_t seed) {
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> value(-4.0f, 4.0f);
+	std::vector<Matrix4x4> matrices(count);
+	for (size_t index = 0; index < count; ++index) {
+		for (int row = 0; row < 4; ++row) {
+			for (int col = 0; col < 4; ++col) {
+				const uint32_t kind = random() % 16;
+				matrices[index].m[row][col] = kind == 0 ? 0.0f : kind == 1 ? -0.0f : value(random);
+			}
+		}
+	}
+	return matrices;
+}
+
+/// <summary>
+/// ビット単位で同じか(正則でない行列から出るnanは、符号を問わず同じとみなす)
+/// </summary>
+bool IsSameBits(const Matrix4x4& a, const Matrix4x4& b) {
+	for (int row = 0; row < 4; ++row) {
+		for (int col = 0; col < 4; ++col) {
+			const bool isBothNan = std::isnan(a.m[row][col]) && std::isnan(b.m[row][col]);
+			if (!isBothNan && std::memcmp(&a.m[row][col], &b.m[row][col], sizeof(float)) != 0) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/// <summary>
+/// M * M^-1 と単位行列の差の最大値
+/// </summary>
+float GetInverseError(const Matrix4x4& matrix, const Matrix4x4& inverse) {
+	const Matrix4x4 product = Multiply(matrix, inverse);
+	float error = 0.0f;
+	for (int row = 0; row < 4; ++row) {
+		for (int col = 0; col < 4; ++col) {
+			error = (std::max)(error, std::abs(product.m[row][col] - (row == col ? 1.0f : 0.0f)));
+		}
+	}
+	return error;
+}
+
+/// <summary>
+/// 乱数のTRS行列(uniformScaleなら拡縮は1)
+/// </summary>
+std::vector<Matrix4x4> MakeRandomTransforms(size_t count, uint32_t seed, bool uniformScale) {
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> scale(0.2f, 5.0f);
+	std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+	std::uniform_real_distribution<float> translate(-100.0f, 100.0f);
+	std::vector<Matrix4x4> matrices(count);
+	for (Matrix4x4& matrix : matrices) {
+		const Vector3 scales = uniformScale ? Vector3{ 1.0f, 1.0f, 1.0f } : Vector3{ scale(random), scale(random), scale(random) };
+		matrix = MakeAffineMatrix(scales, { angle(random), angle(random), angle(random) }, { translate(random), translate(random), translate(random) });
+	}
+	return matrices;
+}
+
+}
+
+TEST(MyMatrix_MultiplyMatchesScalar) {
+	const std::vector<Matrix4x4> lhs = MakeRandomMatrices(2000, 1);
+	const std::vector<Matrix4x4> rhs = MakeRandomMatrices(2000, 2);
+	// SSE/AVX2でも足す順番が同じなので、-0の符号までビット単位で一致する
+	size_t mismatchCount = 0;
+	for (size_t index = 0; index < lhs.size(); ++index) {
+		mismatchCount += !IsSameBits(Multiply(lhs[index], rhs[index]), ScalarMultiply(lhs[index], rhs[index]));
+	}
+	CHECK_EQUAL(mismatchCount, 0);
+}
+
+TEST(MyMatrix_InverseMatchesScalar) {
+	std::vector<Matrix4x4> matrices = MakeRandomMatrices(2000, 3);
+	// 対角が0の行列(行の入れ替えが必要)を混ぜる
+	for (size_t index = 0; index < matrices.size(); index += 4) {
+		matrices[index].m[index % 3][index % 3] = 0.0f;
+	}
+	size_t mismatchCount = 0;
+	for (const Matrix4x4& matrix : matrices) {
+		mismatchCount += !IsSameBits(Inverse(matrix), ScalarInverse(matrix));
+	}
+	CHECK_EQUAL(mismatchCount, 0);
+}
+
+TEST(MyMatrix_TransposeAndTransformMatchScalar) {
+	const std::vector<Matrix4x4> matrices = MakeRandomMatrices(200, 4);
+	bool isSameTranspose = true;
+	for (const Matrix4x4& matrix : matrices) {
+		const Matrix4x4 transposed = Transpose(matrix);
+		for (int row = 0; row < 4; ++row) {
+			for (int col = 0; col < 4; ++col) {
+				isSameTranspose = isSameTranspose && std::memcmp(&transposed.m[row][col], &matrix.m[col][row], sizeof(float)) == 0;
+			}
+		}
+	}
+	CHECK(isSameTranspose);
+
+	const Matrix4x4 matrix = MakeAffineMatrix({ 2.0f, 0.5f, 1.0f }, { 0.3f, -1.2f, 2.0f }, { 1.0f, -2.0f, 3.0f });
+	const Vector3 vector = { 0.25f, -3.0f, 7.5f };
+	const Vector3 transformed = Transform(vector, matrix);
+	const float x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + 1.0f * matrix.m[3][0];
+	const float y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + 1.0f * matrix.m[3][1];
+	const float z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + 1.0f * matrix.m[3][2];
+	const float w = vector.x * matrix.m[0][3] + vector.y * matrix.m[1][3] + vector.z * matrix.m[2][3] + 1.0f * matrix.m[3][3];
+	CHECK(transformed.x == x / w && transformed.y == y / w && transformed.z == z / w);
+}
+
+TEST(MyMatrix_AffineInversesAreAccurate) {
+	// 拡縮・回転・平行移動を含む行列では、閉じた式の方がGauss-Jordanより誤差が小さい
+	float affineError = 0.0f;
+	float generalError = 0.0f;
+	for (const Matrix4x4& matrix : MakeRandomTransforms(1000, 5, false)) {
+		const Matrix4x4 inverse = InverseAffine(matrix);
+		affineError = (std::max)(affineError, GetInverseError(matrix, inverse));
+		generalError = (std::max)(generalError, GetInverseError(matrix, Inverse(matrix)));
+		// 4列目は(0,0,0,1)のまま
+		CHECK(inverse.m[0][3] == 0.0f && inverse.m[1][3] == 0.0f && inverse.m[2][3] == 0.0f && inverse.m[3][3] == 1.0f);
+	}
+	CHECK(affineError < 1e-4f);
+	CHECK(affineError <= generalError);
+
+	// 拡縮が1なら回転の転置で済む
+	float rigidError = 0.0f;
+	for (const Matrix4x4& matrix : MakeRandomTransforms(1000, 6, true)) {
+		rigidError = (std::max)(rigidError, GetInverseError(matrix, InverseRigid(matrix)));
+	}
+	CHECK(rigidError < 1e-4f);
+}
+
+TEST(MyMatrix_CofactorInverseMatchesGeneral) {
+	// 条件の良い(対角が大きい)乱数の行列
+	std::vector<Matrix4x4> matrices = MakeRandomMatrices(1001, 7);
+	for (Matrix4x4& matrix : matrices) {
+		for (int axis = 0; axis < 4; ++axis) {
+			matrix.m[axis][axis] = 20.0f;
+		}
+	}
+	float cofactorError = 0.0f;
+	float difference = 0.0f;
+	for (const Matrix4x4& matrix : matrices) {
+		const Matrix4x4 cofactor = InverseCofactor(matrix);
+		const Matrix4x4 general = Inverse(matrix);
+		cofactorError = (std::max)(cofactorError, GetInverseError(matrix, cofactor));
+		for (int row = 0; row < 4; ++row) {
+			for (int col = 0; col < 4; ++col) {
+				difference = (std::max)(difference, std::abs(cofactor.m[row][col] - general.m[row][col]));
+			}
+		}
+	}
+	CHECK(cofactorError < 1e-5f);
+	CHECK(difference < 1e-5f);
+
+	// まとめて求めても1つずつと同じ(4の倍数でない数・書き込み先が同じ場合も)
+	std::vector<Matrix4x4> batched(matrices.size());
+	InverseN(matrices.data(), batched.data(), matrices.size());
+	std::vector<Matrix4x4> inPlace = matrices;
+	InverseN(inPlace.data(), inPlace.data(), inPlace.size());
+	// (SIMDの符号反転は 0 - x なので、0の符号だけは違うことがある)
+	auto isSameValues = [](const Matrix4x4& a, const Matrix4x4& b) {
+		for (int row = 0; row < 4; ++row) {
+			for (int col = 0; col < 4; ++col) {
+				if (a.m[row][col] != b.m[row][col]) {
+					return false;
+				}
+			}
+		}
+		return true;
+	};
+	size_t mismatchCount = 0;
+	for (size_t index = 0; index < matrices.size(); ++index) {
+		const Matrix4x4 expected = InverseCofactor(matrices[index]);
+		mismatchCount += !isSameValues(batched[index], expected) + !isSameValues(inPlace[index], expected);
+	}
+	CHECK_EQUAL(mismatchCount, 0);
+}
@@ -0,0 +1,166 @@
+#include "TestFramework.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "MyMatrix.h"
+#include "MyQuaternion.h"
+
+namespace {
+
+/// <summary>
+/// 倍精度のSlerp(比べる基準)
+/// </summary>
+void ReferenceSlerp(const Quaternion& q0, const Quaternion& q1, double t, double (&out)[4]) {
+	const double a[4] = { q0.x, q0.y, q0.z, q0.w };
+	double b[4] = { q1.x, q1.y, q1.z, q1.w };
+	double dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+	if (dot < 0.0) {
+		for (double& value : b) {
+			value = -value;
+		}
+		dot = -dot;
+	}
+	const double theta = std::acos((std::min)(dot, 1.0));
+	for (int axis = 0; axis < 4; ++axis) {
+		out[axis] = theta < 1e-12 ? a[axis] : (std::sin((1.0 - t) * theta) * a[axis] + std::sin(t * theta) * b[axis]) / std::sin(theta);
+	}
+}
+
+/// <summary>
+/// 2つの回転の差(回転角。ラジアン)
+/// 1に近い内積のacosはfloatの丸めで大きくずれるので、弦の長さから求める
+/// </summary>
+double GetAngleError(const Quaternion& actual, const double (&expected)[4]) {
+	const double length = std::sqrt(double(actual.x) * actual.x + double(actual.y) * actual.y + double(actual.z) * actual.z + double(actual.w) * actual.w);
+	const double a[4] = { actual.x / length, actual.y / length, actual.z / length, actual.w / length };
+	// qと-qは同じ回転
+	const double sign = a[0] * expected[0] + a[1] * expected[1] + a[2] * expected[2] + a[3] * expected[3] < 0.0 ? -1.0 : 1.0;
+	double chordSq = 0.0;
+	for (int axis = 0; axis < 4; ++axis) {
+		chordSq += (a[axis] - sign * expected[axis]) * (a[axis] - sign * expected[axis]);
+	}
+	return 4.0 * std::asin(std::sqrt(chordSq) * 0.5);
+}
+
+Quaternion MakeRandomQuaternion(std::mt19937& random) {
+	std::normal_distribution<float> value;
+	return Normalize({ value(random), value(random), value(random), value(random) });
+}
+
+/// <summary>
+/// q0と内積がdotになる単位Quaternion
+/// </summary>
+Quaternion MakeQuaternionWithDot(const Quaternion& q0, float dot, std::mt19937& random) {
+	// q0に直交する単位ベクトルを作り、dotとsqrt(1 - dot^2)で混ぜる
+	Quaternion other = MakeRandomQuaternion(random);
+	const float projection = Dot(other, q0);
+	other = Normalize({ other.x - q0.x * projection, other.y - q0.y * projection, other.z - q0.z * projection, other.w - q0.w * projection });
+	const float side = std::sqrt((std::max)(0.0f, 1.0f - dot * dot));
+	return Normalize({ q0.x * dot + other.x * side, q0.y * dot + other.y * side, q0.z * dot + other.z * side, q0.w * dot + other.w * side });
+}
+
+float GetRelativeError(const Matrix4x4& actual, const Matrix4x4& expected) {
+	float error = 0.0f;
+	for (int row = 0; row < 4; ++row) {
+		for (int col = 0; col < 4; ++col) {
+			const float scale = (std::max)(1.0f, std::abs(expected.m[row][col]));
+			error = (std::max)(error, std::abs(actual.m[row][col] - expected.m[row][col]) / scale);
+		}
+	}
+	return error;
+}
+
+}
+
+TEST(MyQuaternion_SlerpNStaysWithinStatedBound) {
+	// |dot|を0~1、tを0~1で振る(dotが負の場合も)。SIMDの4つずつと余りの両方を通るように数をずらす
+	// (dotが0ちょうどは最短経路が2つあり、どちらを選ぶかが決まらないので除く)
+	std::mt19937 random(1);
+	std::vector<Quaternion> from;
+	std::vector<Quaternion> to;
+	for (int step = 1; step <= 64; ++step) {
+		const float dot = float(step) / 64.0f;
+		for (float sign : { 1.0f, -1.0f }) {
+			const Quaternion q0 = MakeRandomQuaternion(random);
+			from.push_back(q0);
+			to.push_back(MakeQuaternionWithDot(q0, dot * sign, random));
+		}
+	}
+	from.push_back(IdentityQuaternion());
+	to.push_back(IdentityQuaternion());
+
+	double maxError = 0.0;
+	std::vector<Quaternion> result(from.size());
+	for (int step = 0; step <= 64; ++step) {
+		const float t = float(step) / 64.0f;
+		SlerpN(from.data(), to.data(), t, result.data(), from.size());
+		for (size_t index = 0; index < from.size(); ++index) {
+			double expected[4];
+			ReferenceSlerp(from[index], to[index], t, expected);
+			maxError = (std::max)(maxError, GetAngleError(result[index], expected));
+		}
+	}
+	// MyQuaternion.hに書いた上限(5.1e-4ラジアン)
+	CHECK(maxError <= 5.1e-4);
+	CHECK(maxError > 0.0);
+
+	// 書き込み先が補間元と同じでも良い
+	std::vector<Quaternion> inPlace = from;
+	SlerpN(inPlace.data(), to.data(), 0.3f, inPlace.data(), inPlace.size());
+	SlerpN(from.data(), to.data(), 0.3f, result.data(), from.size());
+	bool isSame = true;
+	for (size_t index = 0; index < from.size(); ++index) {
+		isSame = isSame && inPlace[index].x == result[index].x && inPlace[index].w == result[index].w;
+	}
+	CHECK(isSame);
+}
+
+TEST(MyQuaternion_SlerpNEndpoints) {
+	std::mt19937 random(2);
+	std::vector<Quaternion> from;
+	std::vector<Quaternion> to;
+	for (int index = 0; index < 7; ++index) {
+		from.push_back(MakeRandomQuaternion(random));
+		to.push_back(MakeRandomQuaternion(random));
+	}
+	std::vector<Quaternion> result(from.size());
+	SlerpN(from.data(), to.data(), 0.0f, result.data(), from.size());
+	float startError = 0.0f;
+	for (size_t index = 0; index < from.size(); ++index) {
+		startError = (std::max)(startError, 1.0f - std::abs(Dot(result[index], from[index])));
+	}
+	SlerpN(from.data(), to.data(), 1.0f, result.data(), from.size());
+	float endError = 0.0f;
+	for (size_t index = 0; index < from.size(); ++index) {
+		endError = (std::max)(endError, 1.0f - std::abs(Dot(result[index], to[index])));
+	}
+	CHECK(startError < 1e-6f);
+	CHECK(endError < 1e-6f);
+}
+
+TEST(MyQuaternion_AffineMatrixQuatMatchesEuler) {
+	std::mt19937 random(3);
+	std::uniform_real_distribution<float> scale(0.1f, 4.0f);
+	std::uniform_real_distribution<float> angle(-6.3f, 6.3f);
+	std::uniform_real_distribution<float> translate(-50.0f, 50.0f);
+	float error = 0.0f;
+	float rotateError = 0.0f;
+	for (int index = 0; index < 1000; ++index) {
+		const Vector3 scales = { scale(random), scale(random), scale(random) };
+		const Vector3 rotate = { angle(random), angle(random), angle(random) };
+		const Vector3 translation = { translate(random), translate(random), translate(random) };
+		const Quaternion q = MakeRotateQuaternion(rotate);
+		// オイラー角 → 行列の積 と Quaternion → 直接組み立て が同じ行列になる
+		error = (std::max)(error, GetRelativeError(MakeAffineMatrixQuat(scales, q, translation), MakeAffineMatrix(scales, rotate, translation)));
+
+		// ベクトルの回転も行列と同じ
+		const Vector3 vector = { translate(random), translate(random), translate(random) };
+		const Vector3 rotated = RotateVector(vector, q);
+		const Vector3 transformed = Transform(vector, MakeRotateXYZMatrix(rotate));
+		rotateError = (std::max)({ rotateError, std::abs(rotated.x - transformed.x), std::abs(rotated.y - transformed.y), std::abs(rotated.z - transformed.z) });
+	}
+	CHECK(error < 1e-5f);
+	CHECK(rotateError < 1e-4f);
+}
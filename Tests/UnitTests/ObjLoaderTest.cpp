@@ -0,0 +1,199 @@
+#include "TestFramework.h"
+#include "TestFiles.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "ObjLoader.h"
+#include "Function/ThreadPool.h"
+
+namespace {
+
+bool LoadText(const TempDirectory& directory, const wchar_t* name, std::string_view text, ObjModel& outModel, ObjLoadStats* outStats = nullptr) {
+	const std::wstring filePath = directory.File(name);
+	WriteText(filePath, text);
+	return LoadObj(filePath, outModel, nullptr, outStats);
+}
+
+bool IsSameModel(const ObjModel& a, const ObjModel& b) {
+	if (a.mesh.indices != b.mesh.indices || a.mesh.vertices.size() != b.mesh.vertices.size()
+		|| a.submeshes.size() != b.submeshes.size() || a.materials.size() != b.materials.size()) {
+		return false;
+	}
+	if (std::memcmp(a.mesh.vertices.data(), b.mesh.vertices.data(), a.mesh.vertices.size() * sizeof(VertexData)) != 0) {
+		return false;
+	}
+	for (size_t index = 0; index < a.submeshes.size(); ++index) {
+		const ObjSubmesh& submeshA = a.submeshes[index];
+		const ObjSubmesh& submeshB = b.submeshes[index];
+		if (submeshA.firstIndex != submeshB.firstIndex || submeshA.indexCount != submeshB.indexCount
+			|| a.materials[submeshA.materialIndex].name != b.materials[submeshB.materialIndex].name) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/// <summary>
+/// 塊が複数に分かれる大きさ(数MB)の格子。面は行ごとに絶対・相対の番号を混ぜ、途中でマテリアルを変える
+/// </summary>
+std::string MakeGridObj(uint32_t gridSize) {
+	std::string text;
+	char line[128];
+	for (uint32_t y = 0; y <= gridSize; ++y) {
+		for (uint32_t x = 0; x <= gridSize; ++x) {
+			std::snprintf(line, sizeof(line), "v %.4f %.4f %.4f\nvt %.4f %.4f\n", x * 0.01f, y * 0.01f, 0.001f * ((x * 7 + y * 13) % 100),
+				float(x) / gridSize, float(y) / gridSize);
+			text += line;
+		}
+	}
+	const uint32_t vertexCount = (gridSize + 1) * (gridSize + 1);
+	for (uint32_t y = 0; y < gridSize; ++y) {
+		if (y % 64 == 0) {
+			text += y % 128 == 0 ? "usemtl red\n" : "usemtl blue\n";
+		}
+		for (uint32_t x = 0; x < gridSize; ++x) {
+			const uint32_t a = y * (gridSize + 1) + x + 1;
+			const uint32_t b = a + 1;
+			const uint32_t c = a + gridSize + 1;
+			const uint32_t d = c + 1;
+			if (y % 2 == 0) {
+				std::snprintf(line, sizeof(line), "f %u/%u %u/%u %u/%u %u/%u\n", a, a, b, b, d, d, c, c);
+			} else {
+				// 全ての頂点の後ろにあるので、末尾からの番号
+				const int32_t base = int32_t(vertexCount) + 1;
+				std::snprintf(line, sizeof(line), "f %d/%d %d/%d %d/%d\n", int32_t(a) - base, int32_t(a) - base, int32_t(b) - base, int32_t(b) - base,
+					int32_t(d) - base, int32_t(d) - base);
+				text += line;
+				std::snprintf(line, sizeof(line), "f %d/%d %d/%d %d/%d\n", int32_t(a) - base, int32_t(a) - base, int32_t(d) - base, int32_t(d) - base,
+					int32_t(c) - base, int32_t(c) - base);
+			}
+			text += line;
+		}
+	}
+	return text;
+}
+
+}
+
+TEST(ObjLoader_NegativeIndices) {
+	TempDirectory directory(L"ObjNegative");
+	ObjModel absolute;
+	ObjModel relative;
+	CHECK(LoadText(directory, L"absolute.obj", "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\nv 1 1 0\nf 2 3 4\n", absolute));
+	// 相対の番号はその行までに出てきた頂点から数える
+	CHECK(LoadText(directory, L"relative.obj", "v 0 0 0\nv 1 0 0\nv 0 1 0\nf -3 -2 -1\nv 1 1 0\nf -3 -2 -1\n", relative));
+	CHECK_EQUAL(absolute.mesh.indices.size(), 6);
+	CHECK(IsSameModel(absolute, relative));
+}
+
+TEST(ObjLoader_CrlfLineEnds) {
+	TempDirectory directory(L"ObjCrlf");
+	const char* lf = "v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nvt 1 0\nvt 0 1\nusemtl red\nf 1/1 2/2 3/3\n";
+	const char* crlf = "v 0 0 0\r\nv 1 0 0\r\nv 0 1 0\r\nvt 0 0\r\nvt 1 0\r\nvt 0 1\r\nusemtl red\r\nf 1/1 2/2 3/3\r\n";
+	ObjModel lfModel;
+	ObjModel crlfModel;
+	ObjLoadStats stats;
+	CHECK(LoadText(directory, L"lf.obj", lf, lfModel));
+	CHECK(LoadText(directory, L"crlf.obj", crlf, crlfModel, &stats));
+	CHECK(IsSameModel(lfModel, crlfModel));
+	CHECK_EQUAL(stats.skippedLineCount, 0);
+	CHECK_EQUAL(crlfModel.submeshes.size(), 1);
+	CHECK(crlfModel.materials[crlfModel.submeshes[0].materialIndex].name == "red");
+}
+
+TEST(ObjLoader_TriangulatesQuadsAndPolygons) {
+	TempDirectory directory(L"ObjPolygon");
+	const char* vertices = "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nv 0.5 1.5 0\n";
+	ObjModel polygons;
+	ObjModel triangles;
+	CHECK(LoadText(directory, L"polygons.obj", std::string(vertices) + "f 1 2 3 4\nf 1 2 3 5 4\n", polygons));
+	// 最初の頂点を中心にした扇形
+	CHECK(LoadText(directory, L"triangles.obj", std::string(vertices) + "f 1 2 3\nf 1 3 4\nf 1 2 3\nf 1 3 5\nf 1 5 4\n", triangles));
+	CHECK_EQUAL(polygons.mesh.indices.size(), 15);
+	CHECK(IsSameModel(polygons, triangles));
+
+	// xを反転して回り順を逆にする: (1, 2, 3) → (1, 3, 2)
+	const VertexData& second = polygons.mesh.vertices[polygons.mesh.indices[1]];
+	const VertexData& third = polygons.mesh.vertices[polygons.mesh.indices[2]];
+	CHECK(second.pos.x == -1.0f && second.pos.y == 1.0f);
+	CHECK(third.pos.x == -1.0f && third.pos.y == 0.0f);
+}
+
+TEST(ObjLoader_SkipsBadLines) {
+	TempDirectory directory(L"ObjBadLines");
+	ObjModel model;
+	ObjLoadStats stats;
+	const char* text =
+		"# comment\n"
+		"o object\n"
+		"v 0 0 0\nv 1 0 0\nv 0 1 0\n"
+		"vn 0 0 1\n"
+		"s off\n"
+		"foo bar\n"
+		"f 1 2\n"
+		"f 1 x 3\n"
+		"f 99999999999 1 2\n"
+		"f 1 2 3\n";
+	CHECK(LoadText(directory, L"bad.obj", text, model, &stats));
+	// 知らない行・頂点が足りない面・読めない番号・桁あふれの4行を飛ばす(vn, o, s, コメントは数えない)
+	CHECK_EQUAL(stats.skippedLineCount, 4);
+	CHECK(stats.firstSkippedLine == "foo bar");
+	CHECK_EQUAL(stats.triangleCount, 1);
+	CHECK_EQUAL(model.mesh.indices.size(), 3);
+}
+
+TEST(ObjLoader_DropsOutOfRangeFaces) {
+	TempDirectory directory(L"ObjOutOfRange");
+	ObjModel model;
+	ObjLoadStats stats;
+	const char* text =
+		"v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\n"
+		"f 1 2 3\n"
+		"f 1 2 9\n"
+		"f 1/1 2/2 3/1\n"
+		"f -1 -2 -4\n"
+		"usemtl red\n"
+		"f 3 2 1\n";
+	CHECK(LoadText(directory, L"range.obj", text, model, &stats));
+	CHECK_EQUAL(stats.skippedTriangleCount, 3);
+	CHECK_EQUAL(stats.triangleCount, 2);
+	CHECK_EQUAL(model.mesh.indices.size(), 6);
+	// 捨てた三角形の分だけ usemtl の位置を詰める
+	CHECK_EQUAL(model.submeshes.size(), 2);
+	CHECK_EQUAL(model.submeshes[1].firstIndex, 3);
+	CHECK_EQUAL(model.submeshes[1].indexCount, 3);
+	for (uint32_t index : model.mesh.indices) {
+		CHECK(index < model.mesh.vertices.size());
+	}
+
+	// 使える面がなければ失敗
+	ObjModel empty;
+	CHECK(!LoadText(directory, L"empty.obj", "v 0 0 0\nf 1 2 3\n", empty));
+}
+
+TEST(ObjLoader_ThreadPoolMatchesSerial) {
+	TempDirectory directory(L"ObjThreadPool");
+	const std::wstring filePath = directory.File(L"grid.obj");
+	WriteText(filePath, MakeGridObj(300));
+
+	ObjModel serial;
+	ObjLoadStats serialStats;
+	CHECK(LoadObj(filePath, serial, nullptr, &serialStats));
+
+	ThreadPool threadPool;
+	threadPool.Init(4);
+	ObjModel pooled;
+	ObjLoadStats pooledStats;
+	CHECK(LoadObj(filePath, pooled, &threadPool, &pooledStats));
+	threadPool.Finalize();
+
+	// 相対の番号・usemtl が塊の境目をまたいでも同じ結果になる
+	CHECK(pooledStats.chunkCount > 1);
+	CHECK_EQUAL(serialStats.skippedLineCount, 0);
+	CHECK_EQUAL(serialStats.skippedTriangleCount, 0);
+	CHECK_EQUAL(serial.mesh.indices.size(), 300 * 300 * 6);
+	CHECK_EQUAL(serial.mesh.vertices.size(), 301 * 301);
+	CHECK_EQUAL(serial.submeshes.size(), 5);
+	CHECK(IsSameModel(serial, pooled));
+}
@@ -0,0 +1,305 @@
+#include "TestFramework.h"
+#include <cstring>
+#include <vector>
+
+#include "DirectXCommon/PipelineStateCache.h"
+
+namespace {
+
+/// <summary>
+/// 参照カウントだけを持つPSOの偽物(デバイスなしで作れる)
+/// </summary>
+class FakePipelineState final : public ID3D12PipelineState {
+public:
+	HRESULT STDMETHODCALLTYPE QueryInterface(REFIID, void** object) override { *object = nullptr; return E_NOINTERFACE; }
+	ULONG STDMETHODCALLTYPE AddRef() override { return ++refCount_; }
+	ULONG STDMETHODCALLTYPE Release() override {
+		const ULONG refCount = --refCount_;
+		if (refCount == 0) {
+			delete this;
+		}
+		return refCount;
+	}
+	HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID, UINT*, void*) override { return E_NOTIMPL; }
+	HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID, UINT, const void*) override { return E_NOTIMPL; }
+	HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID, const IUnknown*) override { return E_NOTIMPL; }
+	HRESULT STDMETHODCALLTYPE SetName(LPCWSTR) override { return E_NOTIMPL; }
+	HRESULT STDMETHODCALLTYPE GetDevice(REFIID, void** device) override { *device = nullptr; return E_NOTIMPL; }
+	HRESULT STDMETHODCALLTYPE GetCachedBlob(ID3DBlob** blob) override { *blob = nullptr; return E_NOTIMPL; }
+
+	ULONG GetRefCount() const { return refCount_; }
+
+private:
+	ULONG refCount_ = 1;
+};
+
+/// <summary>
+/// 頼まれた回数とキーを覚えておく
+/// </summary>
+class FakePipelineSource : public IPipelineStateSource {
+public:
+	ID3D12PipelineState* CreateGraphicsPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC&, uint64_t key) override {
+		keys.push_back(key);
+		if (isFailing) {
+			return nullptr;
+		}
+		return new FakePipelineState();
+	}
+
+	std::vector<uint64_t> keys;
+	bool isFailing = false;
+};
+
+/// ルートシグネチャはキャッシュのキーを引くのにしか使わないので、アドレスだけあればよい
+ID3D12RootSignature* MakeFakeRootSignature(int& storage) {
+	return reinterpret_cast<ID3D12RootSignature*>(&storage);
+}
+
+/// <summary>
+/// PSOの設定とそれが指す先(シェーダー・セマンティクス名)をまとめて持つ
+/// 中身を同じにしても、コピーごとにポインタは別になる
+/// </summary>
+struct PipelineDescFixture {
+	std::vector<char> vertexShader;
+	std::vector<char> pixelShader;
+	std::vector<char> positionName;
+	std::vector<char> texcoordName;
+	D3D12_INPUT_ELEMENT_DESC elements[2];
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC desc;
+
+	/// <param name="fill">使わない設定・パディングに入れておく値</param>
+	explicit PipelineDescFixture(unsigned char fill) {
+		const char vertexBytes[] = "DXBC vertex shader";
+		const char pixelBytes[] = "DXBC pixel shader";
+		vertexShader.assign(vertexBytes, vertexBytes + sizeof(vertexBytes));
+		pixelShader.assign(pixelBytes, pixelBytes + sizeof(pixelBytes));
+		const char position[] = "POSITION";
+		const char texcoord[] = "TEXCOORD";
+		positionName.assign(position, position + sizeof(position));
+		texcoordName.assign(texcoord, texcoord + sizeof(texcoord));
+
+		std::memset(elements, fill, sizeof(elements));
+		elements[0].SemanticName = positionName.data();
+		elements[0].SemanticIndex = 0;
+		elements[0].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+		elements[0].InputSlot = 0;
+		elements[0].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+		elements[0].InputSlotClass = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA;
+		elements[0].InstanceDataStepRate = 0;
+		elements[1] = elements[0];
+		elements[1].SemanticName = texcoordName.data();
+		elements[1].Format = DXGI_FORMAT_R32G32_FLOAT;
+
+		// 使う設定だけを書く(それ以外はfillのまま)
+		std::memset(&desc, fill, sizeof(desc));
+		desc.VS = { vertexShader.data(), vertexShader.size() };
+		desc.PS = { pixelShader.data(), pixelShader.size() };
+		desc.DS = {};
+		desc.HS = {};
+		desc.GS = {};
+		desc.StreamOutput.NumEntries = 0;
+		desc.StreamOutput.NumStrides = 0;
+		desc.StreamOutput.RasterizedStream = 0;
+		desc.BlendState.AlphaToCoverageEnable = false;
+		// RenderTarget[0]だけが使われ、ブレンドしないのでブレンド係数も使われない
+		desc.BlendState.IndependentBlendEnable = false;
+		desc.BlendState.RenderTarget[0].BlendEnable = false;
+		desc.BlendState.RenderTarget[0].LogicOpEnable = false;
+		desc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+		desc.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;
+		desc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+		desc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+		desc.RasterizerState.FrontCounterClockwise = false;
+		desc.RasterizerState.DepthBias = 0;
+		desc.RasterizerState.DepthBiasClamp = 0.0f;
+		desc.RasterizerState.SlopeScaledDepthBias = 0.0f;
+		desc.RasterizerState.DepthClipEnable = true;
+		desc.RasterizerState.MultisampleEnable = false;
+		desc.RasterizerState.AntialiasedLineEnable = false;
+		desc.RasterizerState.ForcedSampleCount = 0;
+		desc.RasterizerState.ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF;
+		desc.DepthStencilState.DepthEnable = true;
+		desc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
+		desc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
+		// ステンシルを使わないのでステンシルの設定は使われない
+		desc.DepthStencilState.StencilEnable = false;
+		desc.InputLayout = { elements, 2 };
+		desc.IBStripCutValue = D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_DISABLED;
+		desc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+		// RTVFormats[1]以降は使われない
+		desc.NumRenderTargets = 1;
+		desc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+		desc.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
+		desc.SampleDesc.Count = 1;
+		desc.SampleDesc.Quality = 0;
+		desc.NodeMask = 0;
+		desc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
+	}
+
+	PipelineDescFixture(const PipelineDescFixture&) = delete;
+	const PipelineDescFixture& operator=(const PipelineDescFixture&) = delete;
+};
+
+}
+
+//=============================================================================================================================
+//	HashGraphicsPipelineDesc
+//=============================================================================================================================
+TEST(PipelineStateCache_EqualDescsHashEqual) {
+	// パディング・使わない設定・ポインタが違っても、中身が同じなら同じキー
+	PipelineDescFixture a(0x00);
+	PipelineDescFixture b(0xCD);
+	CHECK(a.desc.VS.pShaderBytecode != b.desc.VS.pShaderBytecode);
+	CHECK_EQUAL(HashGraphicsPipelineDesc(a.desc, 1), HashGraphicsPipelineDesc(b.desc, 1));
+}
+
+TEST(PipelineStateCache_UnusedFieldsDoNotChangeHash) {
+	PipelineDescFixture fixture(0x00);
+	const uint64_t hash = HashGraphicsPipelineDesc(fixture.desc, 1);
+
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = fixture.desc;
+	desc.BlendState.RenderTarget[0].SrcBlend = D3D12_BLEND_SRC_ALPHA;
+	desc.BlendState.RenderTarget[1].BlendEnable = true;
+	desc.DepthStencilState.StencilReadMask = 0x0F;
+	desc.DepthStencilState.FrontFace.StencilFunc = D3D12_COMPARISON_FUNC_ALWAYS;
+	desc.RTVFormats[1] = DXGI_FORMAT_R32G32_FLOAT;
+	desc.CachedPSO.CachedBlobSizeInBytes = 16;
+	desc.pRootSignature = nullptr;
+	CHECK_EQUAL(HashGraphicsPipelineDesc(desc, 1), hash);
+
+	// 深度を使わなければ深度の書き込み・比較も使われない
+	desc.DepthStencilState.DepthEnable = false;
+	const uint64_t depthDisabledHash = HashGraphicsPipelineDesc(desc, 1);
+	desc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_ALWAYS;
+	CHECK_EQUAL(HashGraphicsPipelineDesc(desc, 1), depthDisabledHash);
+}
+
+TEST(PipelineStateCache_UsedFieldsChangeHash) {
+	PipelineDescFixture fixture(0x00);
+	const uint64_t hash = HashGraphicsPipelineDesc(fixture.desc, 1);
+
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = fixture.desc;
+	desc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+	CHECK(HashGraphicsPipelineDesc(desc, 1) != hash);
+
+	desc = fixture.desc;
+	desc.BlendState.RenderTarget[0].BlendEnable = true;
+	CHECK(HashGraphicsPipelineDesc(desc, 1) != hash);
+
+	// シェーダーのバイトコードが1バイトでも違えば別のPSO
+	fixture.pixelShader[0] = 'X';
+	CHECK(HashGraphicsPipelineDesc(fixture.desc, 1) != hash);
+	fixture.pixelShader[0] = 'D';
+	CHECK_EQUAL(HashGraphicsPipelineDesc(fixture.desc, 1), hash);
+
+	// ルートシグネチャが違えば別のPSO
+	CHECK(HashGraphicsPipelineDesc(fixture.desc, 2) != hash);
+}
+
+//=============================================================================================================================
+//	PipelineStateCache
+//=============================================================================================================================
+TEST(PipelineStateCache_SameDescHitsCache) {
+	FakePipelineSource source;
+	PipelineStateCache cache;
+	cache.Init(&source);
+	int rootSignatureStorage = 0;
+	ID3D12RootSignature* rootSignature = MakeFakeRootSignature(rootSignatureStorage);
+	cache.RegisterRootSignature(rootSignature, uint64_t(100));
+
+	PipelineDescFixture a(0x00);
+	PipelineDescFixture b(0xCD);
+	a.desc.pRootSignature = rootSignature;
+	b.desc.pRootSignature = rootSignature;
+
+	ID3D12PipelineState* first = cache.GetOrCreate(a.desc);
+	ID3D12PipelineState* second = cache.GetOrCreate(b.desc);
+	CHECK(first != nullptr);
+	CHECK(first == second);
+	CHECK_EQUAL(source.keys.size(), 1);
+	CHECK_EQUAL(source.keys[0], HashGraphicsPipelineDesc(a.desc, 100));
+	CHECK_EQUAL(cache.GetMissCount(), 1);
+	CHECK_EQUAL(cache.GetHitCount(), 1);
+	CHECK_EQUAL(cache.GetPipelineCount(), 1);
+	// キャッシュが1つ、返した2回分で3つ
+	CHECK_EQUAL(static_cast<FakePipelineState*>(first)->GetRefCount(), 3);
+
+	first->Release();
+	second->Release();
+	cache.Finalize();
+}
+
+TEST(PipelineStateCache_DifferentDescMissesCache) {
+	FakePipelineSource source;
+	PipelineStateCache cache;
+	cache.Init(&source);
+	int rootSignatureStorage = 0;
+	ID3D12RootSignature* rootSignature = MakeFakeRootSignature(rootSignatureStorage);
+	cache.RegisterRootSignature(rootSignature, uint64_t(100));
+
+	PipelineDescFixture fixture(0x00);
+	fixture.desc.pRootSignature = rootSignature;
+	ID3D12PipelineState* solid = cache.GetOrCreate(fixture.desc);
+	fixture.desc.RasterizerState.FillMode = D3D12_FILL_MODE_WIREFRAME;
+	ID3D12PipelineState* wireframe = cache.GetOrCreate(fixture.desc);
+	CHECK(solid != wireframe);
+	CHECK_EQUAL(source.keys.size(), 2);
+	CHECK_EQUAL(cache.GetMissCount(), 2);
+	CHECK_EQUAL(cache.GetHitCount(), 0);
+	CHECK_EQUAL(cache.GetPipelineCount(), 2);
+
+	solid->Release();
+	wireframe->Release();
+	cache.Finalize();
+}
+
+TEST(PipelineStateCache_RootSignaturesWithSameHashShareEntry) {
+	// ポインタではなく登録したハッシュで引くので、作り直した同じ形のルートシグネチャでも当たる
+	FakePipelineSource source;
+	PipelineStateCache cache;
+	cache.Init(&source);
+	int storageA = 0;
+	int storageB = 0;
+	ID3D12RootSignature* rootSignatureA = MakeFakeRootSignature(storageA);
+	ID3D12RootSignature* rootSignatureB = MakeFakeRootSignature(storageB);
+	cache.RegisterRootSignature(rootSignatureA, uint64_t(100));
+	cache.RegisterRootSignature(rootSignatureB, uint64_t(100));
+
+	PipelineDescFixture fixture(0x00);
+	fixture.desc.pRootSignature = rootSignatureA;
+	ID3D12PipelineState* first = cache.GetOrCreate(fixture.desc);
+	fixture.desc.pRootSignature = rootSignatureB;
+	ID3D12PipelineState* second = cache.GetOrCreate(fixture.desc);
+	CHECK(first == second);
+	CHECK_EQUAL(source.keys.size(), 1);
+
+	first->Release();
+	second->Release();
+	cache.Finalize();
+}
+
+TEST(PipelineStateCache_FailedCreateIsNotCached) {
+	FakePipelineSource source;
+	source.isFailing = true;
+	PipelineStateCache cache;
+	cache.Init(&source);
+	int rootSignatureStorage = 0;
+	ID3D12RootSignature* rootSignature = MakeFakeRootSignature(rootSignatureStorage);
+	cache.RegisterRootSignature(rootSignature, uint64_t(100));
+
+	PipelineDescFixture fixture(0x00);
+	fixture.desc.pRootSignature = rootSignature;
+	CHECK(cache.GetOrCreate(fixture.desc) == nullptr);
+	CHECK_EQUAL(cache.GetPipelineCount(), 0);
+	CHECK_EQUAL(cache.GetMissCount(), 0);
+
+	// 次に頼まれた時はもう一度作りに行く
+	source.isFailing = false;
+	ID3D12PipelineState* pipelineState = cache.GetOrCreate(fixture.desc);
+	CHECK(pipelineState != nullptr);
+	CHECK_EQUAL(source.keys.size(), 2);
+	CHECK_EQUAL(cache.GetPipelineCount(), 1);
+
+	pipelineState->Release();
+	cache.Finalize();
+}
@@ -0,0 +1,128 @@
+#include "TestFramework.h"
+#include <algorithm>
+#include <vector>
+
+#include "DirectXCommon/RootSignatureCache.h"
+
+namespace {
+
+ShaderBinding MakeBinding(const char* name, ShaderBindingType type, uint32_t shaderRegister, D3D12_SHADER_VISIBILITY visibility, uint32_t count = 1) {
+	ShaderBinding binding;
+	binding.name = name;
+	binding.type = type;
+	binding.shaderRegister = shaderRegister;
+	binding.count = count;
+	binding.visibility = visibility;
+	return binding;
+}
+
+/// <summary>
+/// object3d(VS: 行列, PS: マテリアル・テクスチャ・サンプラー)と同じ形
+/// </summary>
+std::vector<ShaderBinding> MakeObjectBindings() {
+	return {
+		MakeBinding("gTransformationMatrix", ShaderBindingType::ConstantBuffer, 0, D3D12_SHADER_VISIBILITY_VERTEX),
+		MakeBinding("gTexture", ShaderBindingType::Texture, 0, D3D12_SHADER_VISIBILITY_PIXEL),
+		MakeBinding("gSampler", ShaderBindingType::Sampler, 0, D3D12_SHADER_VISIBILITY_PIXEL),
+		MakeBinding("gMaterial", ShaderBindingType::ConstantBuffer, 1, D3D12_SHADER_VISIBILITY_PIXEL),
+		MakeBinding("gInstances", ShaderBindingType::Buffer, 1, D3D12_SHADER_VISIBILITY_VERTEX),
+	};
+}
+
+}
+
+TEST(RootSignatureLayout_OrdersRootDescriptorsBeforeTables) {
+	const RootSignatureLayout layout = BuildRootSignatureLayout(MakeObjectBindings());
+
+	// ルートCBV(レジスタ順) → ルートSRV → DescriptorTable、サンプラーは別
+	CHECK_EQUAL(layout.parameters.size(), 4);
+	CHECK_EQUAL(layout.staticSamplers.size(), 1);
+	CHECK_EQUAL(layout.FindParameter("gTransformationMatrix"), 0);
+	CHECK_EQUAL(layout.FindParameter("gMaterial"), 1);
+	CHECK_EQUAL(layout.FindParameter("gInstances"), 2);
+	CHECK_EQUAL(layout.FindParameter("gTexture"), 3);
+	CHECK_EQUAL(layout.FindParameter("gSampler"), RootSignatureLayout::kInvalidParameter);
+	CHECK_EQUAL(layout.FindParameter("gMissing"), RootSignatureLayout::kInvalidParameter);
+	CHECK(layout.parameters[0].type == ShaderBindingType::ConstantBuffer && layout.parameters[0].shaderRegister == 0);
+	CHECK(layout.parameters[1].type == ShaderBindingType::ConstantBuffer && layout.parameters[1].shaderRegister == 1);
+	CHECK(layout.parameters[2].type == ShaderBindingType::Buffer);
+	CHECK(layout.parameters[3].type == ShaderBindingType::Texture);
+}
+
+TEST(RootSignatureLayout_MergesStagesIntoVisibilityAll) {
+	std::vector<ShaderBinding> bindings = {
+		MakeBinding("gMaterial", ShaderBindingType::ConstantBuffer, 0, D3D12_SHADER_VISIBILITY_VERTEX),
+		MakeBinding("gMaterial", ShaderBindingType::ConstantBuffer, 0, D3D12_SHADER_VISIBILITY_PIXEL),
+		MakeBinding("gSampler", ShaderBindingType::Sampler, 0, D3D12_SHADER_VISIBILITY_PIXEL),
+		MakeBinding("gSampler", ShaderBindingType::Sampler, 0, D3D12_SHADER_VISIBILITY_PIXEL),
+	};
+	const RootSignatureLayout layout = BuildRootSignatureLayout(bindings);
+	CHECK_EQUAL(layout.parameters.size(), 1);
+	CHECK_EQUAL(layout.parameters[0].visibility, D3D12_SHADER_VISIBILITY_ALL);
+	// 同じステージからしか使われないものはそのステージのまま
+	CHECK_EQUAL(layout.staticSamplers.size(), 1);
+	CHECK_EQUAL(layout.staticSamplers[0].visibility, D3D12_SHADER_VISIBILITY_PIXEL);
+
+	// 名前が違えば同じレジスタでも別のリソース
+	bindings.push_back(MakeBinding("gOther", ShaderBindingType::ConstantBuffer, 0, D3D12_SHADER_VISIBILITY_PIXEL));
+	CHECK_EQUAL(BuildRootSignatureLayout(bindings).parameters.size(), 2);
+}
+
+TEST(RootSignatureLayout_SameReflectionSameHash) {
+	const std::vector<ShaderBinding> bindings = MakeObjectBindings();
+	const RootSignatureLayout layout = BuildRootSignatureLayout(bindings);
+	CHECK(BuildRootSignatureLayout(bindings).hash == layout.hash);
+
+	// 宣言順が違っても同じ形・同じ番号
+	std::vector<ShaderBinding> reversed = bindings;
+	std::reverse(reversed.begin(), reversed.end());
+	const RootSignatureLayout reversedLayout = BuildRootSignatureLayout(reversed);
+	CHECK(reversedLayout.hash == layout.hash);
+	CHECK_EQUAL(reversedLayout.FindParameter("gTexture"), layout.FindParameter("gTexture"));
+
+	// 名前はハッシュに含めない
+	std::vector<ShaderBinding> renamed = bindings;
+	renamed[0].name = "gWorldViewProjection";
+	CHECK(BuildRootSignatureLayout(renamed).hash == layout.hash);
+
+	// レジスタ・Visibilityが変われば別の形
+	std::vector<ShaderBinding> moved = bindings;
+	moved[0].shaderRegister = 2;
+	CHECK(BuildRootSignatureLayout(moved).hash != layout.hash);
+	std::vector<ShaderBinding> shared = bindings;
+	shared[0].visibility = D3D12_SHADER_VISIBILITY_ALL;
+	CHECK(BuildRootSignatureLayout(shared).hash != layout.hash);
+}
+
+TEST(RootSignatureLayout_DescriptorTableOrRootDescriptor) {
+	const std::vector<ShaderBinding> bindings = {
+		MakeBinding("gConstant", ShaderBindingType::ConstantBuffer, 0, D3D12_SHADER_VISIBILITY_ALL),
+		MakeBinding("gConstants", ShaderBindingType::ConstantBuffer, 1, D3D12_SHADER_VISIBILITY_ALL, 4),
+		MakeBinding("gBuffer", ShaderBindingType::Buffer, 0, D3D12_SHADER_VISIBILITY_ALL),
+		MakeBinding("gBuffers", ShaderBindingType::Buffer, 1, D3D12_SHADER_VISIBILITY_ALL, 0),
+		MakeBinding("gOutput", ShaderBindingType::RWBuffer, 0, D3D12_SHADER_VISIBILITY_ALL),
+		MakeBinding("gTexture", ShaderBindingType::Texture, 2, D3D12_SHADER_VISIBILITY_ALL),
+		MakeBinding("gOutputTexture", ShaderBindingType::RWTexture, 1, D3D12_SHADER_VISIBILITY_ALL),
+	};
+	const RootSignatureLayout layout = BuildRootSignatureLayout(bindings);
+	CHECK_EQUAL(layout.parameters.size(), bindings.size());
+
+	auto isTable = [&](const char* name) {
+		const uint32_t index = layout.FindParameter(name);
+		return index != RootSignatureLayout::kInvalidParameter && layout.parameters[index].IsDescriptorTable();
+	};
+	// 1つだけのバッファはルートCBV/SRV/UAV
+	CHECK(!isTable("gConstant"));
+	CHECK(!isTable("gBuffer"));
+	CHECK(!isTable("gOutput"));
+	// テクスチャと配列(大きさ指定なしを含む)はDescriptorTable
+	CHECK(isTable("gConstants"));
+	CHECK(isTable("gBuffers"));
+	CHECK(isTable("gTexture"));
+	CHECK(isTable("gOutputTexture"));
+
+	// DescriptorTableは全てルートディスクリプタの後ろ
+	for (size_t index = 1; index < layout.parameters.size(); ++index) {
+		CHECK(layout.parameters[index - 1].IsDescriptorTable() <= layout.parameters[index].IsDescriptorTable());
+	}
+}
@@ -0,0 +1,153 @@
+#include "TestFramework.h"
+
+#include "DirectXCommon/CommandRecorder.h"
+
+namespace {
+
+/// ルートシグネチャ・PSO・ヒープはポインタを比べるだけなので、アドレスだけあればよい
+template<typename T>
+T* MakeFakeObject(int& storage) {
+	return reinterpret_cast<T*>(&storage);
+}
+
+GpuDescriptorHandle MakeHandle(uint64_t ptr) {
+	return { ptr };
+}
+
+}
+
+TEST(StateFilter_DropsRedundantState) {
+	CommandCounter counter;
+	StateFilter filter;
+	filter.Init(&counter);
+	int rootSignatureStorage = 0;
+	int pipelineStateStorage = 0;
+	ID3D12RootSignature* rootSignature = MakeFakeObject<ID3D12RootSignature>(rootSignatureStorage);
+	ID3D12PipelineState* pipelineState = MakeFakeObject<ID3D12PipelineState>(pipelineStateStorage);
+	CommandViewport viewport{ 0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f };
+
+	for (int draw = 0; draw < 3; ++draw) {
+		filter.RSSetViewports(1, &viewport);
+		filter.SetGraphicsRootSignature(rootSignature);
+		filter.SetPipelineState(pipelineState);
+		filter.IASetPrimitiveTopology(PrimitiveTopology::TriangleList);
+		filter.SetGraphicsRootConstantBufferView(0, 0x1000);
+		filter.DrawInstanced(3, 1, 0, 0);
+	}
+
+	// 最初のドローの5つだけが通り、描画は全て通る
+	CHECK_EQUAL(counter.GetStateCount(), 5);
+	CHECK_EQUAL(counter.GetDrawCount(), 3);
+	CHECK_EQUAL(filter.GetFrameStats().filteredCount, 10);
+	CHECK_EQUAL(filter.GetFrameStats().issuedCount, 8);
+	CHECK_EQUAL(filter.GetFrameStats().drawCount, 3);
+}
+
+TEST(StateFilter_PassesChangedState) {
+	CommandCounter counter;
+	StateFilter filter;
+	filter.Init(&counter);
+
+	filter.SetGraphicsRootConstantBufferView(0, 0x1000);
+	filter.SetGraphicsRootConstantBufferView(0, 0x2000);
+	// 同じ値でも種類が違えば別の引数
+	filter.SetGraphicsRootShaderResourceView(0, 0x2000);
+	filter.SetGraphicsRootConstantBufferView(1, 0x2000);
+	CHECK_EQUAL(counter.GetStateCount(), 4);
+
+	CommandViewport viewport{ 0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f };
+	filter.RSSetViewports(1, &viewport);
+	viewport.width = 640.0f;
+	filter.RSSetViewports(1, &viewport);
+	CHECK_EQUAL(counter.GetStateCount(), 6);
+}
+
+TEST(StateFilter_RootSignatureChangeResetsRootArguments) {
+	CommandCounter counter;
+	StateFilter filter;
+	filter.Init(&counter);
+	int storageA = 0;
+	int storageB = 0;
+	ID3D12RootSignature* rootSignatureA = MakeFakeObject<ID3D12RootSignature>(storageA);
+	ID3D12RootSignature* rootSignatureB = MakeFakeObject<ID3D12RootSignature>(storageB);
+
+	filter.SetGraphicsRootSignature(rootSignatureA);
+	filter.SetGraphicsRootConstantBufferView(0, 0x1000);
+	filter.SetGraphicsRootSignature(rootSignatureB);
+	// ルートシグネチャを変えた後は同じ値でも設定し直す
+	filter.SetGraphicsRootConstantBufferView(0, 0x1000);
+	CHECK_EQUAL(counter.GetStateCount(), 4);
+	CHECK_EQUAL(filter.GetFrameStats().filteredCount, 0);
+}
+
+TEST(StateFilter_DescriptorHeapChangeResetsTablesOnly) {
+	CommandCounter counter;
+	StateFilter filter;
+	filter.Init(&counter);
+	int storageA = 0;
+	int storageB = 0;
+	ID3D12DescriptorHeap* heapA = MakeFakeObject<ID3D12DescriptorHeap>(storageA);
+	ID3D12DescriptorHeap* heapB = MakeFakeObject<ID3D12DescriptorHeap>(storageB);
+
+	filter.SetDescriptorHeaps(1, &heapA);
+	filter.SetGraphicsRootDescriptorTable(0, MakeHandle(0x100));
+	filter.SetGraphicsRootConstantBufferView(1, 0x1000);
+	filter.SetDescriptorHeaps(1, &heapA);
+	CHECK_EQUAL(counter.GetStateCount(), 3);
+
+	filter.SetDescriptorHeaps(1, &heapB);
+	filter.SetGraphicsRootDescriptorTable(0, MakeHandle(0x100));
+	filter.SetGraphicsRootConstantBufferView(1, 0x1000);
+	// ヒープとDescriptorTableは通り、ルートCBVは捨てる
+	CHECK_EQUAL(counter.GetStateCount(), 5);
+}
+
+TEST(StateFilter_VertexBuffersPerSlot) {
+	CommandCounter counter;
+	StateFilter filter;
+	filter.Init(&counter);
+	VertexBufferView views[2] = {
+		{ 0x1000, 256, 32 },
+		{ 0x2000, 128, 16 },
+	};
+
+	filter.IASetVertexBuffers(0, 2, views);
+	filter.IASetVertexBuffers(1, 1, &views[1]);
+	CHECK_EQUAL(counter.GetStateCount(), 1);
+
+	// 外す(nullptr)は常に通し、外したスロットは次の設定を通す
+	filter.IASetVertexBuffers(1, 1, nullptr);
+	filter.IASetVertexBuffers(1, 1, &views[1]);
+	CHECK_EQUAL(counter.GetStateCount(), 3);
+
+	IndexBufferView indexView{ 0x3000, 64, 42 };		// DXGI_FORMAT_R32_UINT
+	filter.IASetIndexBuffer(&indexView);
+	filter.IASetIndexBuffer(&indexView);
+	CHECK_EQUAL(counter.GetStateCount(), 4);
+}
+
+TEST(StateFilter_BeginFrameForgetsStateAndKeepsStats) {
+	CommandCounter counter;
+	StateFilter filter;
+	filter.Init(&counter);
+	int pipelineStateStorage = 0;
+	ID3D12PipelineState* pipelineState = MakeFakeObject<ID3D12PipelineState>(pipelineStateStorage);
+
+	filter.SetPipelineState(pipelineState);
+	filter.SetPipelineState(pipelineState);
+	filter.DrawInstanced(3, 1, 0, 0);
+
+	// コマンドリストをResetすると状態は消えているので、同じPSOでも通す
+	filter.BeginFrame();
+	filter.SetPipelineState(pipelineState);
+	CHECK_EQUAL(counter.GetStateCount(), 2);
+	CHECK_EQUAL(filter.GetLastFrameStats().issuedCount, 2);
+	CHECK_EQUAL(filter.GetLastFrameStats().filteredCount, 1);
+	CHECK_EQUAL(filter.GetLastFrameStats().drawCount, 1);
+	CHECK_EQUAL(filter.GetFrameStats().issuedCount, 1);
+
+	// 外でコマンドリストを触った後も同じ
+	filter.Invalidate();
+	filter.SetPipelineState(pipelineState);
+	CHECK_EQUAL(counter.GetStateCount(), 3);
+}
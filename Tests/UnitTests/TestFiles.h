@@ -0,0 +1,38 @@
+#pragma once
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+/*================================================================================================
+ファイルを読み書きするテスト用(作業ディレクトリの UnitTestsTemp の下に作り、終わったら消す)
+==================================================================================================*/
+
+/// <summary>
+/// テストごとの一時ディレクトリ(作業ディレクトリからの相対で作り、終わったら消す)
+/// </summary>
+class TempDirectory {
+public:
+	explicit TempDirectory(const wchar_t* name) : path_(std::filesystem::path(L"UnitTestsTemp") / name) {
+		std::error_code error;
+		std::filesystem::remove_all(path_, error);
+		std::filesystem::create_directories(path_, error);
+	}
+	~TempDirectory() {
+		std::error_code error;
+		std::filesystem::remove_all(path_.parent_path(), error);
+	}
+	std::wstring File(const wchar_t* name) const { return (path_ / name).generic_wstring(); }
+	std::wstring GetPath() const { return path_.generic_wstring(); }
+
+private:
+	std::filesystem::path path_;
+};
+
+/// <summary>
+/// そのまま(改行を変えずに)書き出す
+/// </summary>
+inline void WriteText(const std::wstring& filePath, std::string_view text) {
+	std::ofstream file(std::filesystem::path(filePath), std::ios::binary | std::ios::trunc);
+	file.write(text.data(), text.size());
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdio>
+#include <vector>
+
+/*================================================================================================
+単体テストの最小限の仕組み(外のライブラリは使わない。D3D12もデバイスも使わない)
+	TEST(名前) { ... }    関数を登録する。main.cppがまとめて実行する
+	CHECK(式)             偽なら場所を出力して失敗を数え、そのまま続ける
+	CHECK_EQUAL(a, b)     a == b をCHECKする(整数のみ。値も出力する)
+==================================================================================================*/
+
+/// <summary>
+/// 登録されたテスト
+/// </summary>
+struct TestCase {
+	const char* name;
+	void (*function)();
+};
+
+inline std::vector<TestCase>& GetTestCases() {
+	static std::vector<TestCase> testCases;
+	return testCases;
+}
+
+/// 失敗したCHECKの数(全テストの合計)
+inline int& GetTestFailureCount() {
+	static int failureCount = 0;
+	return failureCount;
+}
+
+struct TestRegistrar {
+	TestRegistrar(const char* name, void (*function)()) { GetTestCases().push_back({ name, function }); }
+};
+
+inline void ReportCheck(bool passed, const char* expression, const char* file, int line) {
+	if (!passed) {
+		std::printf("  %s(%d): CHECK(%s) failed\n", file, line, expression);
+		++GetTestFailureCount();
+	}
+}
+
+inline void ReportCheckEqual(long long actual, long long expected, const char* expression, const char* file, int line) {
+	if (actual != expected) {
+		std::printf("  %s(%d): CHECK_EQUAL(%s) failed: %lld != %lld\n", file, line, expression, actual, expected);
+		++GetTestFailureCount();
+	}
+}
+
+#define TEST(name) \
+	static void name(); \
+	static TestRegistrar name##Registrar(#name, name); \
+	static void name()
+
+#define CHECK(expression) ReportCheck(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
+#define CHECK_EQUAL(actual, expected) \
+	ReportCheckEqual(static_cast<long long>(actual), static_cast<long long>(expected), #actual ", " #expected, __FILE__, __LINE__)
@@ -0,0 +1,82 @@
+#include <filesystem>
+#include <string>
+
+#ifdef _WIN32
+#include <objbase.h>
+#endif
+
+#include "TestFramework.h"
+#include "TextureDecoder.h"
+
+namespace {
+
+const size_t kWidth = 8;
+const size_t kHeight = 4;
+
+/// <summary>
+/// 8x4のTGAを書き出す(画素ごとに値を変える)
+/// </summary>
+bool WriteTestTga(const std::wstring& filePath) {
+	DirectX::ScratchImage image{};
+	if (FAILED(image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, kWidth, kHeight, 1, 1))) {
+		return false;
+	}
+	const DirectX::Image* pixels = image.GetImage(0, 0, 0);
+	for (size_t y = 0; y < kHeight; ++y) {
+		uint8_t* row = pixels->pixels + y * pixels->rowPitch;
+		for (size_t x = 0; x < kWidth; ++x) {
+			row[x * 4 + 0] = static_cast<uint8_t>(x * 30);
+			row[x * 4 + 1] = static_cast<uint8_t>(y * 60);
+			row[x * 4 + 2] = 128;
+			row[x * 4 + 3] = 255;
+		}
+	}
+	return SUCCEEDED(DirectX::SaveToTGAFile(*pixels, filePath.c_str()));
+}
+
+}
+
+TEST(TextureDecoder_DecodesTgaWithMips) {
+#ifdef _WIN32
+	// ミップ作成のフィルタがWICを使う
+	(void)CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+#endif
+	const std::filesystem::path directory = std::filesystem::path(L"UnitTestsTemp") / L"TextureDecoder";
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+	const std::wstring filePath = (directory / L"test.tga").wstring();
+	CHECK(WriteTestTga(filePath));
+
+	DirectX::ScratchImage image{};
+	CHECK(SUCCEEDED(DecodeTexture(filePath, image)));
+	const DirectX::TexMetadata& metadata = image.GetMetadata();
+	CHECK_EQUAL(metadata.width, kWidth);
+	CHECK_EQUAL(metadata.height, kHeight);
+	CHECK_EQUAL(metadata.format, DXGI_FORMAT_R8G8B8A8_UNORM);
+	// 8x4 → 4x2 → 2x1 → 1x1
+	CHECK_EQUAL(metadata.mipLevels, 4);
+	const DirectX::Image* lastMip = image.GetImage(3, 0, 0);
+	CHECK(lastMip != nullptr);
+	if (lastMip) {
+		CHECK_EQUAL(lastMip->width, 1);
+		CHECK_EQUAL(lastMip->height, 1);
+	}
+	// 元の画素が読めていること
+	const DirectX::Image* topMip = image.GetImage(0, 0, 0);
+	CHECK_EQUAL(topMip->pixels[topMip->rowPitch * 2 + 3 * 4 + 0], 90);
+	CHECK_EQUAL(topMip->pixels[topMip->rowPitch * 2 + 3 * 4 + 1], 120);
+
+	// ミップを作らない指定
+	DirectX::ScratchImage noMips{};
+	CHECK(SUCCEEDED(DecodeTexture(filePath, noMips, false)));
+	CHECK_EQUAL(noMips.GetMetadata().mipLevels, 1);
+
+	// 無いファイル
+	DirectX::ScratchImage missing{};
+	CHECK(FAILED(DecodeTexture((directory / L"missing.tga").wstring(), missing)));
+
+	std::filesystem::remove_all(directory.parent_path(), error);
+#ifdef _WIN32
+	CoUninitialize();
+#endif
+}
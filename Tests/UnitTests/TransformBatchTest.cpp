@@ -0,0 +1,117 @@
+#include "TestFramework.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "MyMatrix.h"
+#include "TransformBatch.h"
+
+namespace {
+
+/// <summary>
+/// 乱数のTransformを持つバッチ(回転は1周を超える値も入れる)
+/// </summary>
+TransformBatch MakeRandomBatch(size_t count, uint32_t seed) {
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> scale(0.1f, 4.0f);
+	std::uniform_real_distribution<float> angle(-20.0f, 20.0f);
+	std::uniform_real_distribution<float> translate(-50.0f, 50.0f);
+	TransformBatch batch;
+	for (size_t index = 0; index < count; ++index) {
+		batch.Add({ { scale(random), scale(random), scale(random) }, { angle(random), angle(random), angle(random) },
+			{ translate(random), translate(random), translate(random) } });
+	}
+	return batch;
+}
+
+Matrix4x4 MakeViewProjection() {
+	const Matrix4x4 view = InverseAffine(MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.2f, 0.4f, 0.0f }, { 0.0f, 5.0f, -60.0f }));
+	return Multiply(view, MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 200.0f));
+}
+
+/// <summary>
+/// 要素ごとの差を、値の大きさ(1未満は1)で割った最大値
+/// </summary>
+float GetRelativeError(const Matrix4x4& actual, const Matrix4x4& expected) {
+	float error = 0.0f;
+	for (int row = 0; row < 4; ++row) {
+		for (int col = 0; col < 4; ++col) {
+			const float scale = (std::max)(1.0f, std::abs(expected.m[row][col]));
+			error = (std::max)(error, std::abs(actual.m[row][col] - expected.m[row][col]) / scale);
+		}
+	}
+	return error;
+}
+
+}
+
+TEST(TransformBatch_MatchesPerObjectMatrices) {
+	// SIMDの4つずつの後ろに余りが出る数
+	const TransformBatch batch = MakeRandomBatch(103, 1);
+	const Matrix4x4 vp = MakeViewProjection();
+	std::vector<Matrix4x4> wvps(batch.GetSize());
+	std::vector<Matrix4x4> worlds(batch.GetSize());
+	batch.ComputeWorldMatrices(vp, wvps.data(), worlds.data());
+
+	float worldError = 0.0f;
+	float wvpError = 0.0f;
+	bool isLastColumnExact = true;
+	for (uint32_t index = 0; index < batch.GetSize(); ++index) {
+		const Matrix4x4 world = MakeAffineMatrix(batch.Get(index));
+		worldError = (std::max)(worldError, GetRelativeError(worlds[index], world));
+		wvpError = (std::max)(wvpError, GetRelativeError(wvps[index], Multiply(world, vp)));
+		isLastColumnExact = isLastColumnExact && worlds[index].m[0][3] == 0.0f && worlds[index].m[1][3] == 0.0f
+			&& worlds[index].m[2][3] == 0.0f && worlds[index].m[3][3] == 1.0f;
+	}
+	// sin,cosの近似と式の展開の分だけずれる
+	CHECK(worldError < 1e-5f);
+	CHECK(wvpError < 1e-5f);
+	CHECK(isLastColumnExact);
+}
+
+TEST(TransformBatch_StrideAndCount) {
+	// インスタンスごとの構造体に直接書き込む場合
+	struct Instance {
+		Matrix4x4 wvp;
+		Matrix4x4 world;
+		float color[4];
+	};
+	const TransformBatch batch = MakeRandomBatch(10, 2);
+	const Matrix4x4 vp = MakeViewProjection();
+	std::vector<Matrix4x4> wvps(batch.GetSize());
+	batch.ComputeWorldMatrices(vp, wvps.data());
+
+	std::vector<Instance> instances(batch.GetSize());
+	for (Instance& instance : instances) {
+		instance.color[0] = 0.5f;
+	}
+	// 先頭の7個だけ。残りと、行列以外のメンバーは書き換えない
+	const size_t count = 7;
+	batch.ComputeWorldMatrices(count, vp, &instances[0].wvp, &instances[0].world, sizeof(Instance));
+	bool isWritten = true;
+	for (size_t index = 0; index < instances.size(); ++index) {
+		const Matrix4x4 world = MakeAffineMatrix(batch.Get(static_cast<uint32_t>(index)));
+		if (index < count) {
+			isWritten = isWritten && GetRelativeError(instances[index].wvp, wvps[index]) < 1e-5f && GetRelativeError(instances[index].world, world) < 1e-5f;
+		} else {
+			isWritten = isWritten && instances[index].wvp.m[0][0] == 0.0f && instances[index].world.m[3][3] == 0.0f;
+		}
+		isWritten = isWritten && instances[index].color[0] == 0.5f;
+	}
+	CHECK(isWritten);
+}
+
+TEST(TransformBatch_SetGetAndClear) {
+	TransformBatch batch;
+	const kTransform transform = { { 1.0f, 2.0f, 3.0f }, { 0.1f, 0.2f, 0.3f }, { 4.0f, 5.0f, 6.0f } };
+	CHECK_EQUAL(batch.Add(transform), 0);
+	CHECK_EQUAL(batch.Add(transform), 1);
+	batch.Set(1, { { 7.0f, 8.0f, 9.0f }, { 0.0f, 0.0f, 0.0f }, { -1.0f, -2.0f, -3.0f } });
+	const kTransform second = batch.Get(1);
+	CHECK(second.scalel.x == 7.0f && second.rotate.y == 0.0f && second.translate.z == -3.0f);
+	CHECK(batch.Get(0).rotate.z == 0.3f);
+	CHECK(batch.GetScale().y[1] == 8.0f);
+	batch.Clear();
+	CHECK_EQUAL(batch.GetSize(), 0);
+}
@@ -0,0 +1,33 @@
+#include <cstdio>
+#include <cstring>
+
+#include "TestFramework.h"
+
+/*================================================================================================
+単体テスト
+	UnitTests [名前の一部]
+引数があれば名前にそれを含むテストだけ実行する。1つでも失敗すれば1を返す
+==================================================================================================*/
+
+int main(int argc, char* argv[]) {
+	const char* filter = argc > 1 ? argv[1] : nullptr;
+
+	int runCount = 0;
+	int failedCount = 0;
+	for (const TestCase& testCase : GetTestCases()) {
+		if (filter && !std::strstr(testCase.name, filter)) {
+			continue;
+		}
+		const int failuresBefore = GetTestFailureCount();
+		testCase.function();
+		const bool passed = GetTestFailureCount() == failuresBefore;
+		std::printf("%s %s\n", passed ? "[ OK ]" : "[FAIL]", testCase.name);
+		++runCount;
+		if (!passed) {
+			++failedCount;
+		}
+	}
+
+	std::printf("%d tests, %d failed\n", runCount, failedCount);
+	return failedCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,121 @@
+#include "TextureCooker.h"
+#include "TextureDecoder.h"
+#include "Function/Hash.h"
+
+#include <chrono>
+#include <filesystem>
+
+namespace {
+
+/// 焼き方を変えた時に上げる(古いキャッシュを使わないようにする)
+const uint32_t kTextureCookerVersion = 1;
+
+using Clock = std::chrono::steady_clock;
+
+float ElapsedMs(Clock::time_point start) {
+	return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+}
+
+/// <summary>
+/// 圧縮後の形式(sRGBかどうかは元に合わせる)
+/// </summary>
+DXGI_FORMAT GetCompressedFormat(TextureCompression compression, DXGI_FORMAT sourceFormat) {
+	const bool isSRGB = DirectX::IsSRGB(sourceFormat);
+	switch (compression) {
+	case TextureCompression::BC1:
+		return isSRGB ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM;
+	case TextureCompression::BC3:
+		return isSRGB ? DXGI_FORMAT_BC3_UNORM_SRGB : DXGI_FORMAT_BC3_UNORM;
+	case TextureCompression::BC7:
+		return isSRGB ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM;
+	default:
+		return sourceFormat;
+	}
+}
+
+uint64_t MakeCookKey(uint64_t sourceHash, const TextureCookSettings& settings) {
+	uint64_t key = HashCombine(sourceHash, kTextureCookerVersion);
+	key = HashCombine(key, settings.compression);
+	key = HashCombine(key, settings.generateMips);
+	return key;
+}
+
+}
+
+//=============================================================================================================================
+//	キャッシュ
+//=============================================================================================================================
+std::wstring GetCookedTexturePath(const std::wstring& sourcePath, uint64_t sourceHash, const TextureCookSettings& settings, const std::wstring& cacheDirectory) {
+	const std::wstring stem = std::filesystem::path(sourcePath).stem().wstring();
+	const std::filesystem::path cookedPath = std::filesystem::path(cacheDirectory) / (stem + L"_" + HashToHexString(MakeCookKey(sourceHash, settings)) + L".dds");
+	return cookedPath.generic_wstring();
+}
+
+//=============================================================================================================================
+//	焼く
+//=============================================================================================================================
+HRESULT CookTexture(const std::wstring& sourcePath, const TextureCookSettings& settings, TextureCookResult& outResult, const std::wstring& cacheDirectory, bool force) {
+	outResult = TextureCookResult{};
+
+	// キャッシュの確認 ------------------------------------------------------------
+	Clock::time_point start = Clock::now();
+	CookManifestEntry& manifestEntry = outResult.manifestEntry;
+	if (!MakeCookSourceFile(sourcePath, manifestEntry.source)) {
+		return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+	}
+	outResult.sourceSize = manifestEntry.source.size;
+	outResult.cookedPath = GetCookedTexturePath(sourcePath, manifestEntry.source.hash, settings, cacheDirectory);
+	manifestEntry.cookedPath = NormalizeCookPath(outResult.cookedPath);
+	outResult.hashTime = ElapsedMs(start);
+
+	std::error_code error;
+	if (!force && std::filesystem::exists(outResult.cookedPath, error)) {
+		outResult.isCached = true;
+		outResult.cookedSize = std::filesystem::file_size(outResult.cookedPath, error);
+		return S_OK;
+	}
+
+	// 読み込み + ミップ ----------------------------------------------------------
+	start = Clock::now();
+	DirectX::ScratchImage image{};
+	HRESULT hr = DecodeTexture(sourcePath, image, settings.generateMips != 0);
+	if (FAILED(hr)) {
+		return hr;
+	}
+	outResult.decodeTime = ElapsedMs(start);
+
+	// 圧縮 ------------------------------------------------------------------------
+	start = Clock::now();
+	const DirectX::TexMetadata& metadata = image.GetMetadata();
+	const DXGI_FORMAT format = GetCompressedFormat(settings.compression, metadata.format);
+	DirectX::ScratchImage compressed{};
+	const DirectX::ScratchImage* output = &image;
+	if (format != metadata.format && !DirectX::IsCompressed(metadata.format)) {
+		// 元がsRGBならsRGBのまま、そうでなければリニアのまま圧縮する
+		hr = DirectX::Compress(image.GetImages(), image.GetImageCount(), metadata, format, DirectX::TEX_COMPRESS_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, compressed);
+		if (FAILED(hr)) {
+			return hr;
+		}
+		output = &compressed;
+	}
+	outResult.compressTime = ElapsedMs(start);
+
+	// 保存 ------------------------------------------------------------------------
+	start = Clock::now();
+	std::filesystem::create_directories(std::filesystem::path(outResult.cookedPath).parent_path(), error);
+	// 途中で止まっても壊れたキャッシュが残らないように、一時ファイルに書いてから名前を変える
+	const std::wstring tempPath = outResult.cookedPath + L".tmp";
+	hr = DirectX::SaveToDDSFile(output->GetImages(), output->GetImageCount(), output->GetMetadata(), DirectX::DDS_FLAGS_NONE, tempPath.c_str());
+	if (FAILED(hr)) {
+		return hr;
+	}
+	std::filesystem::rename(tempPath, outResult.cookedPath, error);
+	if (error) {
+		std::filesystem::remove(tempPath, error);
+		return E_FAIL;
+	}
+	outResult.saveTime = ElapsedMs(start);
+	outResult.cookedSize = std::filesystem::file_size(outResult.cookedPath, error);
+
+	return S_OK;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <DirectXTex.h>
+
+#include "CookManifest.h"
+
+/*================================================================================================
+テクスチャをミップ付き・ブロック圧縮済みのDDSにしてキャッシュに保存する(オフライン用)
+キャッシュのファイル名は元ファイルの内容と設定のハッシュで決まるので、
+元ファイルか設定が変われば自動的に作り直しになる
+実行時は焼いた時の対応表(CookManifest)から引くので、どの設定で焼いたものでも使える
+==================================================================================================*/
+
+/// <summary>
+/// 圧縮形式
+/// </summary>
+enum class TextureCompression : uint32_t {
+	None,	// 圧縮しない(元の形式のまま)
+	BC1,	// RGB + 1bitアルファ 4bpp
+	BC3,	// RGBA 8bpp
+	BC7,	// RGBA 8bpp 高品質(圧縮は遅い)
+};
+
+/// <summary>
+/// 焼く時の設定(ハッシュに含まれるので、変えたらキャッシュのバージョンも変わる)
+/// </summary>
+struct TextureCookSettings {
+	TextureCompression compression = TextureCompression::BC7;
+	uint32_t generateMips = 1;	// ミップを作るか
+};
+
+/// <summary>
+/// 焼いた結果と、各工程にかかった時間(ミリ秒)
+/// </summary>
+struct TextureCookResult {
+	std::wstring cookedPath;
+	bool isCached = false;			// 既にキャッシュがあったので何もしなかった
+	float hashTime = 0.0f;
+	float decodeTime = 0.0f;		// 読み込み + ミップ作成
+	float compressTime = 0.0f;
+	float saveTime = 0.0f;
+	uint64_t sourceSize = 0;
+	uint64_t cookedSize = 0;
+	CookManifestEntry manifestEntry;	// 成功したら(キャッシュがあった場合も)対応表に載せる内容
+};
+
+/// キャッシュの既定の置き場所
+static const wchar_t* const kTextureCacheDirectory = L"Resource/Cooked";
+
+/// <summary>
+/// 焼いたファイルのパス(<cacheDirectory>/<元のファイル名>_<ハッシュ>.dds)
+/// </summary>
+std::wstring GetCookedTexturePath(const std::wstring& sourcePath, uint64_t sourceHash, const TextureCookSettings& settings, const std::wstring& cacheDirectory = kTextureCacheDirectory);
+
+/// <summary>
+/// 焼く。キャッシュがあれば何もしない
+/// </summary>
+/// <param name="sourcePath"></param>
+/// <param name="settings"></param>
+/// <param name="outResult"></param>
+/// <param name="cacheDirectory"></param>
+/// <param name="force">キャッシュがあっても焼き直す</param>
+/// <returns></returns>
+HRESULT CookTexture(const std::wstring& sourcePath, const TextureCookSettings& settings, TextureCookResult& outResult, const std::wstring& cacheDirectory = kTextureCacheDirectory, bool force = false);
@@ -0,0 +1,64 @@
+#include "TextureDecoder.h"
+#include <cwctype>
+
+namespace {
+
+/// <summary>
+/// 拡張子を小文字で返す(ドットを含む)
+/// </summary>
+std::wstring GetLowerExtension(const std::wstring& filePath) {
+	const size_t dot = filePath.find_last_of(L'.');
+	if (dot == std::wstring::npos) {
+		return std::wstring();
+	}
+	std::wstring extension = filePath.substr(dot);
+	for (wchar_t& c : extension) {
+		c = static_cast<wchar_t>(std::towlower(c));
+	}
+	return extension;
+}
+
+}
+
+//=============================================================================================================================
+//	読み込み
+//=============================================================================================================================
+HRESULT DecodeTexture(const std::wstring& filePath, DirectX::ScratchImage& outImage, bool generateMips) {
+	const std::wstring extension = GetLowerExtension(filePath);
+
+	DirectX::ScratchImage image{};
+	HRESULT hr = E_FAIL;
+	if (extension == L".dds") {
+		hr = DirectX::LoadFromDDSFile(filePath.c_str(), DirectX::DDS_FLAGS_NONE, nullptr, image);
+	} else if (extension == L".tga") {
+		hr = DirectX::LoadFromTGAFile(filePath.c_str(), DirectX::TGA_FLAGS_NONE, nullptr, image);
+	} else if (extension == L".hdr") {
+		hr = DirectX::LoadFromHDRFile(filePath.c_str(), nullptr, image);
+	} else {
+#ifdef _WIN32
+		hr = DirectX::LoadFromWICFile(filePath.c_str(), DirectX::WIC_FLAGS_FORCE_SRGB, nullptr, image);
+#else
+		hr = HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+#endif
+	}
+	if (FAILED(hr)) {
+		return hr;
+	}
+
+	// ミップを作る --------------------------------------------------------------------
+	const DirectX::TexMetadata& metadata = image.GetMetadata();
+	const bool hasMips = metadata.mipLevels > 1;
+	const bool isSinglePixel = metadata.width == 1 && metadata.height == 1;
+	if (!generateMips || hasMips || isSinglePixel || DirectX::IsCompressed(metadata.format)) {
+		outImage = std::move(image);
+		return S_OK;
+	}
+
+	const DirectX::TEX_FILTER_FLAGS filter = DirectX::IsSRGB(metadata.format) ? DirectX::TEX_FILTER_SRGB : DirectX::TEX_FILTER_DEFAULT;
+	if (metadata.dimension == DirectX::TEX_DIMENSION_TEXTURE3D) {
+		hr = DirectX::GenerateMipMaps3D(image.GetImages(), image.GetImageCount(), metadata, filter, 0, outImage);
+	} else {
+		hr = DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(), metadata, filter, 0, outImage);
+	}
+	return hr;
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <string>
+#include <DirectXTex.h>
+
+/*================================================================================================
+テクスチャファイルをCPU上の画像(ミップ付き)にする
+D3D12を使わないのでワーカースレッドからでも呼べる
+(WICを使う形式はスレッドごとにCoInitializeExが必要)
+==================================================================================================*/
+
+/// <summary>
+/// 拡張子から形式を判定して読み込み、ミップがなければ作る
+/// .dds .tga .hdr はDirectXTexで、それ以外(png,jpg,bmp等)はWICで読む
+/// </summary>
+/// <param name="filePath"></param>
+/// <param name="outImage"></param>
+/// <param name="generateMips">ミップを作るか(ファイルにミップがある場合・圧縮形式の場合は作らない)</param>
+/// <returns></returns>
+HRESULT DecodeTexture(const std::wstring& filePath, DirectX::ScratchImage& outImage, bool generateMips = true);
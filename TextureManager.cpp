@@ -1,4 +1,68 @@
 #include "TextureManager.h"
+#include "TextureDecoder.h"
+#include "TextureCooker.h"
+#include "MappedDDS.h"
+
+#include <cstdlib>
+
+namespace {
+
+/// <summary>
+/// metadataを元にコピー先のテクスチャを作る(ワーカーから呼ぶので失敗はassertせずに返す)
+/// </summary>
+HRESULT CreateTextureResource(ID3D12Device* device, const DirectX::TexMetadata& metadata, ID3D12Resource** outResource) {
+	// metadataを元にResourceの設定
+	D3D12_RESOURCE_DESC desc{};
+	desc.Width = UINT(metadata.width);								// Textureの幅
+	desc.Height = UINT(metadata.height);							// Textureの高さ
+	desc.MipLevels = UINT16(metadata.mipLevels);					// mipmapの数
+	desc.DepthOrArraySize = metadata.dimension == DirectX::TEX_DIMENSION_TEXTURE3D
+		? UINT16(metadata.depth) : UINT16(metadata.arraySize);		// 奥行き　or 配列Textureの配数
+	desc.Format = metadata.format;									// TextureのFormat
+	desc.SampleDesc.Count = 1;										// サンプリングカウント
+	desc.Dimension = D3D12_RESOURCE_DIMENSION(metadata.dimension);	// Textureの次元数
+
+	// GPUだけが読むのでDefaultHeapに置き、アップロード用バッファからコピーする
+	D3D12_HEAP_PROPERTIES heapProperties{};
+	heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+	// resourceを生成する
+	*outResource = nullptr;
+	return device->CreateCommittedResource(
+		&heapProperties,					// Heapの設定
+		D3D12_HEAP_FLAG_NONE,				// Heapの特殊の設定
+		&desc,								// Resourceの設定
+		D3D12_RESOURCE_STATE_COPY_DEST,		// 最初はコピー先
+		nullptr,							// clear最適地。使わない
+		IID_PPV_ARGS(outResource)			// 作成するResourceポインタへのポインタ
+	);
+}
+
+/// <summary>
+/// metadataを元にSRVの設定を作る
+/// </summary>
+D3D12_SHADER_RESOURCE_VIEW_DESC MakeSrvDesc(const DirectX::TexMetadata& metadata) {
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+	srvDesc.Format = metadata.format;
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	if (metadata.dimension == DirectX::TEX_DIMENSION_TEXTURE3D) {
+		srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE3D;
+		srvDesc.Texture3D.MipLevels = UINT(metadata.mipLevels);
+	} else if (metadata.IsCubemap()) {
+		srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURECUBE;
+		srvDesc.TextureCube.MipLevels = UINT(metadata.mipLevels);
+	} else if (metadata.arraySize > 1) {
+		srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
+		srvDesc.Texture2DArray.MipLevels = UINT(metadata.mipLevels);
+		srvDesc.Texture2DArray.ArraySize = UINT(metadata.arraySize);
+	} else {
+		srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+		srvDesc.Texture2D.MipLevels = UINT(metadata.mipLevels);
+	}
+	return srvDesc;
+}
+
+}
 
 TextureManager* TextureManager::GetInstacne(){
 	static TextureManager instance;
@@ -6,98 +70,332 @@ TextureManager* TextureManager::GetInstacne(){
 }
 
 //=============================================================================================================================
-//	内容
+//	初期化・終了
 //=============================================================================================================================
-void TextureManager::Initialize(DirectXCommon* dxCommon){
+void TextureManager::Initialize(DirectXCommon* dxCommon, uint32_t workerCount){
 	assert(dxCommon);
+	dxCommon_ = dxCommon;
+	isCanceled_ = false;
 
-	mipImage_ = LoadTextrue("Resource/uvChecker.png");
-	const DirectX::TexMetadata& metadata = mipImage_.GetMetadata();
-	textureResource_ = CreateTextureResource(dxCommon->GetDevice(), metadata);
-	UploadTextureData(textureResource_, mipImage_);
+	// WICはスレッドごとにCOMの初期化が必要
+	threadPool_.Init(workerCount,
+		[](uint32_t) { CoInitializeEx(nullptr, COINIT_MULTITHREADED); },
+		[](uint32_t) { CoUninitialize(); }
+	);
 
-	// ------------------------------------------------------------
-	// metadataを元にSRVの設定
-	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
-	srvDesc.Format = metadata.format;
-	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-	srvDesc.Texture2D.MipLevels = UINT(metadata.mipLevels);
+	// 焼いたテクスチャの対応表(なければ元ファイルから読む)
+	cookManifest_.Load(GetCookManifestPath(kTextureCacheDirectory));
 
-	// ------------------------------------------------------------
-	dxCommon->SetDescTable();
-	// 生成
-	dxCommon->GetDevice()->CreateShaderResourceView(textureResource_, &srvDesc, dxCommon->GetSrvHandleCPU());
+	// ハンドル0は代わりのテクスチャ
+	CreateFallbackTexture();
 }
 
 void TextureManager::Finalize(){
-	textureResource_->Release();
+	// 読み込み中のものは打ち切る
+	isCanceled_ = true;
+	threadPool_.Finalize();
+
+	// GPUが使い終わるまで待つ
+	dxCommon_->WaitForGpu();
+
+	for (UploadJob& job : completedJobs_) {
+		uploadQueue_.push_back(std::move(job));
+	}
+	completedJobs_.clear();
+	for (UploadJob& job : uploadQueue_) {
+		if (job.resource) { job.resource->Release(); }
+		if (job.intermediateResource) { job.intermediateResource->Release(); }
+	}
+	uploadQueue_.clear();
+
+	for (PendingRelease& pending : pendingReleases_) {
+		pending.resource->Release();
+	}
+	pendingReleases_.clear();
+
+	DescriptorHeap* srvHeap = dxCommon_->GetSRVDescriptorHeap();
+	for (Texture& texture : textures_) {
+		srvHeap->Free(texture.srvHandle);
+		if (texture.resource) {
+			texture.resource->Release();
+		}
+	}
+	textures_.clear();
+	handleMap_.clear();
+	pendingCount_ = 0;
 }
 
 //=============================================================================================================================
-//	関数
+//	読み込み
 //=============================================================================================================================
-DirectX::ScratchImage TextureManager::LoadTextrue(const std::string& filePath){
-	DirectX::ScratchImage image{};
-	std::wstring filePathW = ConvertWString(filePath);
-	HRESULT hr = DirectX::LoadFromWICFile(filePathW.c_str(), DirectX::WIC_FLAGS_FORCE_SRGB, nullptr, image);
-	assert(SUCCEEDED(hr));
+uint32_t TextureManager::Load(const std::string& filePath){
+	// 既に読んでいればそのハンドルを返す
+	auto it = handleMap_.find(filePath);
+	if (it != handleMap_.end()) {
+		return it->second;
+	}
 
-	// ミニマップの作成
-	DirectX::ScratchImage mipImages{};
-	hr = DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(), image.GetMetadata(), DirectX::TEX_FILTER_SRGB, 0, mipImages);
-	assert(SUCCEEDED(hr));
+	const uint32_t handle = static_cast<uint32_t>(textures_.size());
+	Texture& texture = textures_.emplace_back();
+	texture.filePath = filePath;
+	handleMap_.emplace(filePath, handle);
+
+	if (pendingCount_ == 0) {
+		batchStartTime_ = std::chrono::steady_clock::now();
+		batchLoadCount_ = 0;
+		cookedLoadCount_ = 0;
+	}
+	++pendingCount_;
+	++batchLoadCount_;
+
+	// 読み込み・ミップ作成・アップロード用バッファへの書き込みまでワーカーで行う
+	threadPool_.Submit([this, handle, filePathW = ConvertWString(filePath)]() {
+		if (isCanceled_) {
+			return;
+		}
+
+		UploadJob job{ handle, E_FAIL };
+		// AssetCookerで焼いたDDSがあれば、読むだけで済む(ミップも圧縮も済んでいる)
+		// 元ファイルは大きさと日時だけ比べる(違う時だけ内容のハッシュを取り直す)
+		const std::wstring cookedPath = cookManifest_.Resolve(filePathW);
+		if (!cookedPath.empty()) {
+			// マップしたファイルからアップロード用バッファへ直接コピーする(ヒープには読み込まない)
+			MappedDDS dds;
+			if (SUCCEEDED(dds.Open(cookedPath))) {
+				job = CreateUploadJob(handle, dds.GetMetadata(), dds.GetImages(), dds.GetImageCount());
+			} else {
+				// 読み込み時に展開が必要な形式はScratchImageを通す
+				DirectX::ScratchImage image{};
+				if (SUCCEEDED(DecodeTexture(cookedPath, image, false))) {
+					job = CreateUploadJob(handle, image.GetMetadata(), image.GetImages(), image.GetImageCount());
+				}
+			}
+			if (SUCCEEDED(job.hr)) {
+				++cookedLoadCount_;
+			}
+		}
+		if (FAILED(job.hr)) {
+			DirectX::ScratchImage image{};
+			const HRESULT hr = DecodeTexture(filePathW, image);
+			job = SUCCEEDED(hr)
+				? CreateUploadJob(handle, image.GetMetadata(), image.GetImages(), image.GetImageCount())
+				: UploadJob{ handle, hr };
+		}
+
+		std::lock_guard<std::mutex> lock(completedMutex_);
+		completedJobs_.push_back(std::move(job));
+	});
 
-	return mipImages;
+	return handle;
 }
 
-ID3D12Resource* TextureManager::CreateTextureResource(ID3D12Device* device, const DirectX::TexMetadata& metadata){
-	// metadataを元にResourceの設定
-	D3D12_RESOURCE_DESC desc{};
-	desc.Width = UINT(metadata.width);								// Textureの幅
-	desc.Height = UINT(metadata.height);							// Textureの高さ
-	desc.MipLevels = UINT16(metadata.mipLevels);					// mipmapの数
-	desc.DepthOrArraySize = UINT16(metadata.arraySize);				// 奥行き　or 配列Textureの配数
-	desc.Format = metadata.format;									// TextureのFormat
-	desc.SampleDesc.Count = 1;										// サンプリングカウント
-	desc.Dimension = D3D12_RESOURCE_DIMENSION(metadata.dimension);	// Textureの次元数
+void TextureManager::Update(){
+	// GPUが使い終わったアップロード用バッファを解放する ----------------------------------
+	const uint64_t completedFenceValue = dxCommon_->GetFrameScheduler().GetCompletedValue();
+	for (size_t index = 0; index < pendingReleases_.size();) {
+		if (pendingReleases_[index].fenceValue <= completedFenceValue) {
+			pendingReleases_[index].resource->Release();
+			pendingReleases_[index] = pendingReleases_.back();
+			pendingReleases_.pop_back();
+		} else {
+			++index;
+		}
+	}
 
-	// 利用するheapの設定。非常に特殊な運用。exで一般的
-	D3D12_HEAP_PROPERTIES heapProperties{};
-	heapProperties.Type = D3D12_HEAP_TYPE_CUSTOM;
-	heapProperties.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_WRITE_BACK;
-	heapProperties.MemoryPoolPreference = D3D12_MEMORY_POOL_L0;
+	// ワーカーが終わらせた分を受け取る --------------------------------------------------
+	{
+		std::lock_guard<std::mutex> lock(completedMutex_);
+		for (UploadJob& job : completedJobs_) {
+			uploadQueue_.push_back(std::move(job));
+		}
+		completedJobs_.clear();
+	}
 
-	// resourceを生成する
-	ID3D12Resource* resource = nullptr;
-	HRESULT hr = device->CreateCommittedResource(
-		&heapProperties,					// Heapの設定
-		D3D12_HEAP_FLAG_NONE,				// Heapの特殊の設定
-		&desc,								// Resourceの設定
-		D3D12_RESOURCE_STATE_GENERIC_READ,	// 初回のResourceState Textureは木基本読むだけ
-		nullptr,							// clear最適地。使わない
-		IID_PPV_ARGS(&resource)				// 作成するResourceポインタへのポインタ
-	);
+	// 予算の分だけコピーコマンドを積む(最低1つは進める) ----------------------------------
+	uint64_t uploadedSize = 0;
+	while (!uploadQueue_.empty() && (uploadedSize == 0 || uploadedSize + uploadQueue_.front().uploadSize <= kUploadBudgetPerFrame)) {
+		UploadJob& job = uploadQueue_.front();
+		uploadedSize += job.uploadSize;
+		RecordUpload(job);
+		uploadQueue_.pop_front();
+
+		--pendingCount_;
+		if (pendingCount_ == 0) {
+			lastBatchLoadTime_ = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - batchStartTime_).count();
+			Log(std::format("TextureManager: loaded {} textures ({} cooked) in {:.1f}ms ({} threads)\n", batchLoadCount_, cookedLoadCount_.load(), lastBatchLoadTime_, threadPool_.GetThreadCount()));
+		}
+	}
+}
+
+void TextureManager::WaitForAll(){
+	threadPool_.WaitIdle();
+
+	std::lock_guard<std::mutex> lock(completedMutex_);
+	for (UploadJob& job : completedJobs_) {
+		uploadQueue_.push_back(std::move(job));
+	}
+	completedJobs_.clear();
+	while (!uploadQueue_.empty()) {
+		RecordUpload(uploadQueue_.front());
+		uploadQueue_.pop_front();
+		--pendingCount_;
+	}
+	lastBatchLoadTime_ = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - batchStartTime_).count();
+}
+
+//=============================================================================================================================
+//	アップロード
+//=============================================================================================================================
+TextureManager::UploadJob TextureManager::CreateUploadJob(uint32_t handle, const DirectX::TexMetadata& metadata, const DirectX::Image* images, size_t imageCount) const{
+	ID3D12Device* device = dxCommon_->GetDevice();
+
+	UploadJob job;
+	job.handle = handle;
+	job.metadata = metadata;
+
+	// サブリソースごとの元データ(imagesのピクセルを指すだけでコピーはしない)
+	std::vector<D3D12_SUBRESOURCE_DATA> subresources;
+	job.hr = DirectX::PrepareUpload(device, images, imageCount, job.metadata, subresources);
+	if (FAILED(job.hr)) {
+		return job;
+	}
+	// 作れなければ(メモリ不足・対応していない形式等)失敗として返し、代わりのテクスチャのまま使う
+	job.hr = CreateTextureResource(device, job.metadata, &job.resource);
+	if (FAILED(job.hr)) {
+		return job;
+	}
+
+	// アップロード用バッファ内の配置を求める
+	const UINT subresourceCount = UINT(subresources.size());
+	job.footprints.resize(subresourceCount);
+	std::vector<UINT> numRows(subresourceCount);
+	std::vector<UINT64> rowSizes(subresourceCount);
+	const D3D12_RESOURCE_DESC desc = job.resource->GetDesc();
+	device->GetCopyableFootprints(&desc, 0, subresourceCount, 0, job.footprints.data(), numRows.data(), rowSizes.data(), &job.uploadSize);
+
+	// アップロード用バッファに書き込んでおく(UpdateSubresourcesのうちCPUで行う部分)
+	job.hr = CreateBufferResource(device, static_cast<size_t>(job.uploadSize), &job.intermediateResource);
+	if (FAILED(job.hr)) {
+		job.resource->Release();
+		job.resource = nullptr;
+		return job;
+	}
+	uint8_t* mappedData = nullptr;
+	job.hr = job.intermediateResource->Map(0, nullptr, reinterpret_cast<void**>(&mappedData));
+	if (FAILED(job.hr)) {
+		// 失敗したジョブはリソースを持たない(呼び出し側で作り直せるように)
+		job.resource->Release();
+		job.resource = nullptr;
+		job.intermediateResource->Release();
+		job.intermediateResource = nullptr;
+		return job;
+	}
+	for (UINT index = 0; index < subresourceCount; ++index) {
+		const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& footprint = job.footprints[index];
+		D3D12_MEMCPY_DEST dest{ mappedData + footprint.Offset, footprint.Footprint.RowPitch, SIZE_T(footprint.Footprint.RowPitch) * numRows[index] };
+		MemcpySubresource(&dest, &subresources[index], static_cast<SIZE_T>(rowSizes[index]), numRows[index], footprint.Footprint.Depth);
+	}
+	job.intermediateResource->Unmap(0, nullptr);
+
+	return job;
+}
+
+void TextureManager::RecordUpload(UploadJob& job){
+	Texture& texture = textures_[job.handle];
+	if (FAILED(job.hr)) {
+		// 失敗したものは代わりのテクスチャのまま使う
+		Log(std::format("TextureManager: failed to load {} (hr = 0x{:08X})\n", texture.filePath, static_cast<uint32_t>(job.hr)));
+		texture.state = State::Failed;
+		if (job.resource) { job.resource->Release(); }
+		if (job.intermediateResource) { job.intermediateResource->Release(); }
+		return;
+	}
+
+	// SRVの場所が取れなければコピーも積まずに、代わりのテクスチャのまま使う
+	texture.srvHandle = dxCommon_->GetSRVDescriptorHeap()->AllocatePersistent();
+	if (!texture.srvHandle.IsValid()) {
+		Log(std::format("TextureManager: no free SRV descriptor for {}\n", texture.filePath));
+		texture.state = State::Failed;
+		job.resource->Release();
+		job.intermediateResource->Release();
+		job.resource = nullptr;
+		job.intermediateResource = nullptr;
+		return;
+	}
+
+	ID3D12GraphicsCommandList* commandList = dxCommon_->GetCommandList();
+
+	// サブリソースごとにコピー
+	for (UINT index = 0; index < UINT(job.footprints.size()); ++index) {
+		CD3DX12_TEXTURE_COPY_LOCATION dst(job.resource, index);
+		CD3DX12_TEXTURE_COPY_LOCATION src(job.intermediateResource, job.footprints[index]);
+		commandList->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+	}
+
+	D3D12_RESOURCE_BARRIER barrier{};
+	barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+	barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+	barrier.Transition.pResource = job.resource;
+	barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+	barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+	barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+	commandList->ResourceBarrier(1, &barrier);
+
+	// SRVの生成
+	const D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = MakeSrvDesc(job.metadata);
+	dxCommon_->GetDevice()->CreateShaderResourceView(job.resource, &srvDesc, texture.srvHandle.cpu);
+
+	texture.resource = job.resource;
+	texture.metadata = job.metadata;
+	texture.state = State::Ready;
+
+	// アップロード用バッファはこのフレームのコマンドが終わったら解放する
+	pendingReleases_.push_back({ job.intermediateResource, dxCommon_->GetFrameScheduler().GetCurrentFenceValue() });
+	job.resource = nullptr;
+	job.intermediateResource = nullptr;
+}
+
+void TextureManager::CreateFallbackTexture(){
+	assert(textures_.empty());
+
+	// 1x1の白
+	DirectX::ScratchImage image{};
+	HRESULT hr = image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, 1, 1, 1, 1);
 	assert(SUCCEEDED(hr));
-	
-	return resource;
+	uint32_t* pixel = reinterpret_cast<uint32_t*>(image.GetPixels());
+	*pixel = 0xFFFFFFFF;
+
+	Texture& texture = textures_.emplace_back();
+	texture.filePath = "<fallback>";
+
+	UploadJob job = CreateUploadJob(kFallbackTexture, image.GetMetadata(), image.GetImages(), image.GetImageCount());
+	assert(SUCCEEDED(job.hr));
+	RecordUpload(job);
+	// 代わりのテクスチャがないと読み込み中・失敗したテクスチャを描けないので止める
+	if (texture.state != State::Ready) {
+		Log("TextureManager: failed to create the fallback texture\n");
+		std::abort();
+	}
 }
 
-void TextureManager::UploadTextureData(ID3D12Resource* texture, const DirectX::ScratchImage& mipImages){
-	// meta情報を取得
-	const DirectX::TexMetadata& metadata = mipImages.GetMetadata();
-	// 全MipMapについて
-	for (size_t mipLevel = 0; mipLevel < metadata.mipLevels; ++mipLevel) {
-		// MioMapLevelを指定して各Imageを取得
-		const DirectX::Image* img = mipImages.GetImage(mipLevel, 0, 0);
-		// Textureに転送
-		HRESULT hr = texture->WriteToSubresource(
-			UINT(mipLevel),
-			nullptr,				// 全領域へのコピー
-			img->pixels,			// 元データアドレス
-			UINT(img->rowPitch),	// 1ラインサイズ
-			UINT(img->slicePitch)	// 1枚サイズ
-		);
-		assert(SUCCEEDED(hr));
+//=============================================================================================================================
+//	accessor
+//=============================================================================================================================
+D3D12_GPU_DESCRIPTOR_HANDLE TextureManager::GetGPUHandle(uint32_t handle) const{
+	assert(handle < textures_.size());
+	const Texture& texture = textures_[handle];
+	if (texture.state != State::Ready) {
+		return textures_[kFallbackTexture].srvHandle.gpu;
 	}
+	return texture.srvHandle.gpu;
+}
+
+bool TextureManager::IsReady(uint32_t handle) const{
+	assert(handle < textures_.size());
+	return textures_[handle].state == State::Ready;
+}
+
+const DirectX::TexMetadata& TextureManager::GetMetadata(uint32_t handle) const{
+	assert(handle < textures_.size());
+	return textures_[handle].metadata;
 }
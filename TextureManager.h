@@ -3,10 +3,33 @@
 #include <cassert>
 #include <DirectXTex.h>
 
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "CookManifest.h"
 #include "Function/Convert.h"
+#include "Function/ThreadPool.h"
 #include "DirectXCommon/DirectXCommon.h"
 
+/// <summary>
+/// テクスチャの非同期読み込みと管理
+/// 読み込み・ミップ作成・アップロード用バッファへの書き込みはワーカースレッドで行い、
+/// メインスレッドはUpdateでコピーコマンドを積むだけにする
+/// </summary>
 class TextureManager{
+public:
+
+	/// 読み込みが終わるまで代わりに使う白いテクスチャ
+	static const uint32_t kFallbackTexture = 0;
+
+	/// 1フレームでアップロードする量の目安(これを超えたら次のフレームに回す)
+	static const uint64_t kUploadBudgetPerFrame = 64ull * 1024 * 1024;
+
 public: // メンバ関数
 
 	/// <summary>
@@ -25,8 +48,9 @@ public:
 	/// <summary>
 	/// 初期化
 	/// </summary>
-	/// <param name="device"></param>
-	void Initialize(DirectXCommon* dxCommon);
+	/// <param name="dxCommon"></param>
+	/// <param name="workerCount">読み込みに使うスレッド数(0ならCPUに合わせる)</param>
+	void Initialize(DirectXCommon* dxCommon, uint32_t workerCount = 0);
 
 	/// <summary>
 	/// 終了
@@ -34,31 +58,122 @@ public:
 	void Finalize();
 
 	/// <summary>
-	/// Textrueデータを読む
+	/// 読み込みを要求する。すぐにハンドルを返し、読み込みはワーカーで行う
+	/// 同じパスを2回読んだ場合は同じハンドルを返す
+	/// Resource/Cookedに焼いたDDSがあればそちらをマップして読む
 	/// </summary>
-	/// <returns></returns>
-	DirectX::ScratchImage LoadTextrue(const std::string& filePath);
+	/// <param name="filePath"></param>
+	/// <returns>テクスチャのハンドル</returns>
+	uint32_t Load(const std::string& filePath);
+
+	/// <summary>
+	/// 読み終わったテクスチャのコピーコマンドを積む。毎フレーム、描画コマンドより前に呼ぶ
+	/// </summary>
+	void Update();
+
+	/// <summary>
+	/// 要求した読み込みがすべて終わるまで待ち、コピーコマンドを積む(ロード画面用)
+	/// </summary>
+	void WaitForAll();
+
+public: // accessor
 
 	/// <summary>
-	/// Textureを読んで使えるようにする流れ
+	/// 描画に使うSRV。読み込みが終わっていなければ代わりのテクスチャを返す
 	/// </summary>
-	/// <param name="device"></param>
-	/// <param name="metaData"></param>
+	/// <param name="handle"></param>
 	/// <returns></returns>
-	ID3D12Resource* CreateTextureResource(ID3D12Device* device, const DirectX::TexMetadata& metaData);
+	D3D12_GPU_DESCRIPTOR_HANDLE GetGPUHandle(uint32_t handle) const;
+
+	bool IsReady(uint32_t handle) const;
+
+	const DirectX::TexMetadata& GetMetadata(uint32_t handle) const;
+
+	/// 読み込みが終わっていない数
+	uint32_t GetPendingCount() const { return pendingCount_; }
+
+	/// 直近のまとめて読み込んだ時間(ミリ秒)
+	float GetLastBatchLoadTime() const { return lastBatchLoadTime_; }
+
+private:
+
+	enum class State {
+		Loading,
+		Ready,
+		Failed,
+	};
+
+	struct Texture {
+		std::string filePath;
+		State state = State::Loading;
+		ID3D12Resource* resource = nullptr;
+		DescriptorHandle srvHandle;
+		DirectX::TexMetadata metadata{};
+	};
 
 	/// <summary>
-	/// TextureResourceにデータを転送する
+	/// ワーカーが作った、コピーコマンドを積むのを待っているデータ
 	/// </summary>
-	/// <param name="texture"></param>
-	/// <param name="mipImages"></param>
-	void UploadTextureData(ID3D12Resource* texture, const DirectX::ScratchImage& mipImages);
+	struct UploadJob {
+		uint32_t handle = 0;
+		HRESULT hr = S_OK;
+		DirectX::TexMetadata metadata{};
+		ID3D12Resource* resource = nullptr;
+		ID3D12Resource* intermediateResource = nullptr;
+		std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> footprints;
+		uint64_t uploadSize = 0;
+	};
+
+	/// <summary>
+	/// GPUが使い終わったら解放するリソース
+	/// </summary>
+	struct PendingRelease {
+		ID3D12Resource* resource;
+		uint64_t fenceValue;
+	};
 
 private:
-	DirectX::ScratchImage mipImage_;
-	ID3D12Resource* textureResource_;
-	
-	//D3D12_CPU_DESCRIPTOR_HANDLE srvHandleCPU_;
-	//D3D12_GPU_DESCRIPTOR_HANDLE srvHandleGPU_;
-};
 
+	/// <summary>
+	/// 画像からテクスチャとアップロード用バッファを作り、データを書き込む(ワーカーからも呼ぶ)
+	/// imagesはScratchImageでも、マップしたDDS(MappedDDS)のものでもよい
+	/// 失敗した場合、返すジョブはリソースを持たない
+	/// </summary>
+	UploadJob CreateUploadJob(uint32_t handle, const DirectX::TexMetadata& metadata, const DirectX::Image* images, size_t imageCount) const;
+
+	/// <summary>
+	/// コピーコマンドを積んでSRVを作る(メインスレッド)
+	/// </summary>
+	void RecordUpload(UploadJob& job);
+
+	/// <summary>
+	/// 代わりのテクスチャを作る
+	/// </summary>
+	void CreateFallbackTexture();
+
+private:
+	DirectXCommon* dxCommon_ = nullptr;
+
+	ThreadPool threadPool_;
+	// 終了時に読み込み中のジョブを打ち切る
+	std::atomic<bool> isCanceled_ = false;
+	// 焼いたDDSから読めた数
+	std::atomic<uint32_t> cookedLoadCount_ = 0;
+	// AssetCookerが書いた対応表(Initializeで読んだ後は書き換えないので、ワーカーから引いて良い)
+	CookManifest cookManifest_;
+
+	// メインスレッドだけが触る ------------------------------
+	std::vector<Texture> textures_;
+	std::unordered_map<std::string, uint32_t> handleMap_;
+	std::deque<UploadJob> uploadQueue_;
+	std::vector<PendingRelease> pendingReleases_;
+	uint32_t pendingCount_ = 0;
+
+	std::chrono::steady_clock::time_point batchStartTime_;
+	uint32_t batchLoadCount_ = 0;
+	float lastBatchLoadTime_ = 0.0f;
+
+	// ワーカーとの受け渡し ----------------------------------
+	std::mutex completedMutex_;
+	std::vector<UploadJob> completedJobs_;
+};
@@ -0,0 +1,284 @@
+/*================================================================================================
+AssetCooker
+テクスチャをミップ付き・ブロック圧縮済みのDDSに、OBJを.mesh(MeshFile.h)に焼いてキャッシュに置くコマンドラインツール
+
+AssetCooker [オプション] <ファイル or ディレクトリ>...
+	-o <dir>                 キャッシュの置き場所(既定: Resource/Cooked)
+	-c <none|bc1|bc3|bc7>    テクスチャの圧縮形式(既定: bc7)
+	--no-mips                テクスチャのミップを作らない
+	--no-optimize            メッシュのインデックス・頂点を並べ替えない
+	--overdraw <threshold>   オーバードローを減らす並べ替えで許すACMRの悪化(既定: 1.05。0で並べ替えない)
+	--lods <n>               メッシュのLODの段数の上限(既定: 4。1でLODを作らない)
+	--no-meshlets            メッシュレットを作らない
+	-f                       キャッシュがあっても焼き直す
+	-j <n>                   スレッド数(既定: CPUに合わせる)
+==================================================================================================*/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwctype>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <objbase.h>
+#endif
+
+#include "CookManifest.h"
+#include "MeshCooker.h"
+#include "TextureCooker.h"
+#include "TextureDecoder.h"
+#include "Function/ThreadPool.h"
+
+namespace {
+
+void PrintUsage() {
+	std::printf("usage: AssetCooker [-o dir] [-c none|bc1|bc3|bc7] [--no-mips] [--no-optimize] [--overdraw threshold] [--lods n] [--no-meshlets] [-f] [-j threads] <file or directory>...\n");
+}
+
+/// <summary>
+/// 拡張子を小文字で返す(ドットを含む)
+/// </summary>
+std::wstring GetLowerExtension(const std::wstring& filePath) {
+	std::wstring extension = std::filesystem::path(filePath).extension().wstring();
+	for (wchar_t& c : extension) {
+		c = static_cast<wchar_t>(std::towlower(c));
+	}
+	return extension;
+}
+
+bool IsTextureExtension(const std::wstring& extension) {
+	static const wchar_t* const kExtensions[] = { L".png", L".jpg", L".jpeg", L".bmp", L".tga", L".hdr", L".dds", L".tif", L".tiff" };
+	for (const wchar_t* candidate : kExtensions) {
+		if (extension == candidate) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool IsMeshExtension(const std::wstring& extension) {
+	return extension == L".obj";
+}
+
+/// <summary>
+/// pathがdirectoryの中(下の階層も含む)にあるか
+/// どちらも揃えたパス(weakly_canonical)で渡す
+/// </summary>
+bool IsInsideDirectory(const std::filesystem::path& path, const std::filesystem::path& directory) {
+	auto pathIt = path.begin();
+	for (auto directoryIt = directory.begin(); directoryIt != directory.end(); ++directoryIt, ++pathIt) {
+		// 末尾の区切りは空の要素になる
+		if (directoryIt->empty()) {
+			continue;
+		}
+		if (pathIt == path.end() || *pathIt != *directoryIt) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/// <summary>
+/// 引数のファイル・ディレクトリ(再帰)からテクスチャとOBJを集める
+/// </summary>
+void CollectAssets(const std::filesystem::path& path, const std::filesystem::path& cacheDirectory, std::vector<std::wstring>& outFiles) {
+	std::error_code error;
+	// "./Resource/Cooked" と "Resource/Cooked/" 等の書き方の違いで漏れないように揃えて比べる
+	const std::filesystem::path canonicalCacheDirectory = std::filesystem::weakly_canonical(cacheDirectory, error);
+	if (std::filesystem::is_directory(path, error)) {
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(path, error)) {
+			if (entry.is_directory()) {
+				continue;
+			}
+			// キャッシュ自体(下のディレクトリも)は対象にしない
+			std::error_code canonicalError;
+			const std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(entry.path(), canonicalError);
+			if (!canonicalCacheDirectory.empty() && !canonicalError && IsInsideDirectory(canonicalPath, canonicalCacheDirectory)) {
+				continue;
+			}
+			const std::wstring extension = GetLowerExtension(entry.path().wstring());
+			if (IsTextureExtension(extension) || IsMeshExtension(extension)) {
+				outFiles.push_back(entry.path().generic_wstring());
+			}
+		}
+	} else if (std::filesystem::exists(path, error)) {
+		outFiles.push_back(path.generic_wstring());
+	} else {
+		std::printf("not found: %s\n", path.string().c_str());
+	}
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	TextureCookSettings settings;
+	MeshCookSettings meshSettings;
+	std::wstring cacheDirectory = kTextureCacheDirectory;
+	bool force = false;
+	uint32_t threadCount = 0;
+	std::vector<std::filesystem::path> inputs;
+
+	// 引数 -----------------------------------------------------------------------
+	for (int index = 1; index < argc; ++index) {
+		const char* arg = argv[index];
+		if (std::strcmp(arg, "-o") == 0 && index + 1 < argc) {
+			cacheDirectory = std::filesystem::path(argv[++index]).generic_wstring();
+		} else if (std::strcmp(arg, "-c") == 0 && index + 1 < argc) {
+			const char* name = argv[++index];
+			if (std::strcmp(name, "none") == 0) {
+				settings.compression = TextureCompression::None;
+			} else if (std::strcmp(name, "bc1") == 0) {
+				settings.compression = TextureCompression::BC1;
+			} else if (std::strcmp(name, "bc3") == 0) {
+				settings.compression = TextureCompression::BC3;
+			} else if (std::strcmp(name, "bc7") == 0) {
+				settings.compression = TextureCompression::BC7;
+			} else {
+				PrintUsage();
+				return 1;
+			}
+		} else if (std::strcmp(arg, "--no-mips") == 0) {
+			settings.generateMips = 0;
+		} else if (std::strcmp(arg, "--no-optimize") == 0) {
+			meshSettings.optimize = 0;
+		} else if (std::strcmp(arg, "--overdraw") == 0 && index + 1 < argc) {
+			meshSettings.overdrawThreshold = static_cast<float>(std::atof(argv[++index]));
+		} else if (std::strcmp(arg, "--no-meshlets") == 0) {
+			meshSettings.buildMeshlets = 0;
+		} else if (std::strcmp(arg, "--lods") == 0 && index + 1 < argc) {
+			meshSettings.lodCount = static_cast<uint32_t>((std::max)(std::atoi(argv[++index]), 1));
+		} else if (std::strcmp(arg, "-f") == 0) {
+			force = true;
+		} else if (std::strcmp(arg, "-j") == 0 && index + 1 < argc) {
+			threadCount = static_cast<uint32_t>(std::atoi(argv[++index]));
+		} else if (arg[0] == '-') {
+			PrintUsage();
+			return 1;
+		} else {
+			inputs.emplace_back(arg);
+		}
+	}
+	if (inputs.empty()) {
+		PrintUsage();
+		return 1;
+	}
+
+	std::vector<std::wstring> files;
+	for (const std::filesystem::path& input : inputs) {
+		CollectAssets(input, std::filesystem::path(cacheDirectory), files);
+	}
+
+	// 焼く ---------------------------------------------------------------------------
+	const auto start = std::chrono::steady_clock::now();
+	std::mutex printMutex;
+	std::atomic<uint32_t> cookedCount = 0;
+	std::atomic<uint32_t> cachedCount = 0;
+	std::atomic<uint32_t> failedCount = 0;
+	// 焼けた(キャッシュがあった)ものを対応表に載せる
+	std::vector<CookManifestEntry> manifestEntries;
+
+	ThreadPool threadPool;
+#ifdef _WIN32
+	// WICはスレッドごとにCOMの初期化が必要
+	threadPool.Init(threadCount,
+		[](uint32_t) { (void)CoInitializeEx(nullptr, COINIT_MULTITHREADED); },
+		[](uint32_t) { CoUninitialize(); }
+	);
+#else
+	threadPool.Init(threadCount);
+#endif
+
+	// OBJは1ファイルずつ焼き、中の解析・サブメッシュごとの簡略化をワーカーに分ける(1つが大きく、数は少ない)
+	for (const std::wstring& file : files) {
+		if (!IsMeshExtension(GetLowerExtension(file))) {
+			continue;
+		}
+		const std::string name = std::filesystem::path(file).string();
+		MeshCookResult result;
+		const bool isSucceeded = CookMesh(file, meshSettings, result, cacheDirectory, force, &threadPool);
+		if (isSucceeded) {
+			manifestEntries.push_back(std::move(result.manifestEntry));
+		}
+		if (!isSucceeded) {
+			++failedCount;
+			std::printf("[failed] %s\n", name.c_str());
+		} else if (result.isCached) {
+			++cachedCount;
+			std::printf("[cached] %s\n", name.c_str());
+		} else {
+			++cookedCount;
+			std::printf("[cooked] %s  hash %.1fms  import %.1fms  optimize %.1fms  lod %.1fms  meshlet %.1fms  save %.1fms  %u vertices %u triangles  %llu -> %llu bytes\n",
+				name.c_str(), result.hashTime, result.importTime, result.optimizeTime, result.lodTime, result.meshletTime, result.saveTime, result.vertexCount, result.triangleCount,
+				static_cast<unsigned long long>(result.sourceSize), static_cast<unsigned long long>(result.cookedSize));
+			if (result.skippedLineCount != 0 || result.skippedTriangleCount != 0) {
+				std::printf("         warning: skipped %u lines, %u triangles (first: \"%s\")\n",
+					result.skippedLineCount, result.skippedTriangleCount, result.firstSkippedLine.c_str());
+			}
+			std::printf("         ACMR %.3f -> %.3f  ATVR %.3f -> %.3f  overfetch %.3f -> %.3f\n",
+				result.cacheBefore.acmr, result.cacheAfter.acmr, result.cacheBefore.atvr, result.cacheAfter.atvr,
+				result.fetchBefore.overfetch, result.fetchAfter.overfetch);
+			for (size_t lod = 1; lod < result.lodTriangleCounts.size(); ++lod) {
+				std::printf("         LOD%zu %u triangles  error %.5f\n", lod, result.lodTriangleCounts[lod], result.lodErrors[lod]);
+			}
+			if (result.meshletCount != 0) {
+				std::printf("         %u meshlets\n", result.meshletCount);
+			}
+		}
+	}
+
+	// テクスチャは1ファイル1ジョブ
+	for (const std::wstring& file : files) {
+		if (IsMeshExtension(GetLowerExtension(file))) {
+			continue;
+		}
+		threadPool.Submit([&, file]() {
+			const std::string name = std::filesystem::path(file).string();
+
+			TextureCookResult result;
+			const HRESULT hr = CookTexture(file, settings, result, cacheDirectory, force);
+
+			std::lock_guard<std::mutex> lock(printMutex);
+			if (SUCCEEDED(hr)) {
+				manifestEntries.push_back(std::move(result.manifestEntry));
+			}
+			if (FAILED(hr)) {
+				++failedCount;
+				std::printf("[failed] %s (hr = 0x%08X)\n", name.c_str(), static_cast<unsigned int>(hr));
+			} else if (result.isCached) {
+				++cachedCount;
+				std::printf("[cached] %s\n", name.c_str());
+			} else {
+				++cookedCount;
+				std::printf("[cooked] %s  hash %.1fms  decode+mips %.1fms  compress %.1fms  save %.1fms  %llu -> %llu bytes\n",
+					name.c_str(), result.hashTime, result.decodeTime, result.compressTime, result.saveTime,
+					static_cast<unsigned long long>(result.sourceSize), static_cast<unsigned long long>(result.cookedSize));
+			}
+		});
+	}
+	threadPool.WaitIdle();
+	threadPool.Finalize();
+
+	// 対応表は前回までの分に足して書き直す(別の設定で焼き直したものは新しい方になる)
+	const std::wstring manifestPath = GetCookManifestPath(cacheDirectory);
+	CookManifest manifest;
+	manifest.Load(manifestPath);
+	for (const CookManifestEntry& entry : manifestEntries) {
+		manifest.Set(entry);
+	}
+	if (!manifest.Save(manifestPath)) {
+		std::printf("failed to write %s\n", std::filesystem::path(manifestPath).string().c_str());
+		++failedCount;
+	}
+
+	const float totalTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	std::printf("%u cooked, %u cached, %u failed in %.1fms (%zu files)\n",
+		cookedCount.load(), cachedCount.load(), failedCount.load(), totalTime, files.size());
+
+	return failedCount == 0 ? 0 : 1;
+}
@@ -1,11 +1,23 @@
 #include "Window/WinApp.h"
 #include "DirectXCommon/DirectXCommon.h"
 #include "Function/Convert.h"
+#include "Function/DirectXUtils.h"
 #include "Camera.h"
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <format>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "ImGuiManager.h"
 #include "TextureManager.h"
+#include "ObjLoader.h"
+#include "MeshCooker.h"
+#include "MeshFile.h"
+#include "MeshLodSelector.h"
+#include "MeshletCulling.h"
 
 static const int kWindowWidth = 1280;
 static const int kWindowHeight = 720;
@@ -38,14 +50,101 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 
 
 	// Texture ------------------------------------------------------
-	/*TextureManager* textureManager = nullptr;
+	TextureManager* textureManager = nullptr;
 	textureManager = TextureManager::GetInstacne();
-	textureManager->Initialize(sDirectX);*/
+	textureManager->Initialize(sDirectX);
+	// 読み込みは裏で行われ、終わるまでは白いテクスチャで描画される
+	const uint32_t uvCheckerHandle = textureManager->Load("Resource/uvChecker.png");
+	sDirectX->SetTexture(uvCheckerHandle);
+
+	// モデル -------------------------------------------------------
+	// 焼いたもの(AssetCookerで作る)があればそれをマップして使い、なければOBJを読む
+	// どちらも読めなければ最初から入っている三角形のまま
+	const std::wstring modelPath = L"Resource/cube.obj";
+	// LODを選ぶ時の大きさ(最初から入っている三角形は原点を中心に半径1に収まる)
+	MeshBounds modelBounds{ { -0.5f, -0.5f, -0.5f }, { 0.5f, 0.5f, 0.5f }, { 0.0f, 0.0f, 0.0f }, 1.0f };
+	// メッシュレットのカリング用(LODごとの範囲はmodelLodsのfirstMeshlet, meshletCount)
+	std::vector<Meshlet> modelMeshlets;
+	std::vector<MeshletBounds> modelMeshletBounds;
+	std::vector<MeshFileLod> modelLods;
+	MappedMesh cookedModel;
+	const std::wstring cookedModelPath = FindCookedMesh(modelPath);
+	if (!cookedModelPath.empty() && cookedModel.Open(cookedModelPath)) {
+		sDirectX->SetMesh(cookedModel);
+		modelBounds = cookedModel.GetBounds();
+		modelMeshlets.assign(cookedModel.GetMeshlets(), cookedModel.GetMeshlets() + cookedModel.GetMeshletCount());
+		modelMeshletBounds.assign(cookedModel.GetMeshletBounds(), cookedModel.GetMeshletBounds() + cookedModel.GetMeshletCount());
+		modelLods.assign(cookedModel.GetLods(), cookedModel.GetLods() + cookedModel.GetLodCount());
+		if (cookedModel.GetSubmeshCount() != 0) {
+			const MeshFileMaterial& material = cookedModel.GetMaterial(cookedModel.GetSubmeshes()[0].materialIndex);
+			const std::string texturePath = cookedModel.GetString(material.diffuseTextureOffset);
+			if (!texturePath.empty()) {
+				sDirectX->SetTexture(textureManager->Load(texturePath));
+			}
+		}
+		Log(std::format("MappedMesh: {} triangles, {} lods\n", cookedModel.GetLods()[0].indexCount / 3, cookedModel.GetLodCount()));
+		cookedModel.Close();
+	} else {
+		ObjModel model;
+		ObjLoadStats modelStats;
+		if (LoadObj(modelPath, model, nullptr, &modelStats)) {
+			sDirectX->SetMesh(model.mesh);
+			modelBounds = ComputeMeshBounds(model.mesh.vertices.data(), model.mesh.vertices.size());
+			// OBJから読んだ時はLODがないので、全体を1つの範囲として分ける
+			MeshletData meshlets;
+			MeshFileLod lod{};
+			lod.meshletCount = static_cast<uint32_t>(BuildMeshlets(meshlets, model.mesh.indices.data(), model.mesh.indices.size(), model.mesh.vertices.data(), model.mesh.vertices.size()));
+			modelMeshlets = std::move(meshlets.meshlets);
+			modelMeshletBounds = std::move(meshlets.bounds);
+			modelLods.push_back(lod);
+			const ObjMaterial& material = model.materials[model.submeshes.front().materialIndex];
+			if (!material.diffuseTexture.empty()) {
+				sDirectX->SetTexture(textureManager->Load(material.diffuseTexture));
+			}
+			Log(std::format("LoadObj: {} triangles, {:.2f}ms\n", modelStats.triangleCount, modelStats.totalTime));
+			if (modelStats.skippedLineCount != 0 || modelStats.skippedTriangleCount != 0) {
+				Log(std::format("LoadObj: warning: skipped {} lines, {} triangles (first: \"{}\")\n",
+					modelStats.skippedLineCount, modelStats.skippedTriangleCount, modelStats.firstSkippedLine));
+			}
+		}
+	}
 
 	// camera -------------------------------------------------------
 	std::unique_ptr<Camera> camera = std::make_unique<Camera>();
 	camera->Init();
 
+	// インスタンス描画 ---------------------------------------------
+	// 並べた分を1回の描画で描く
+	const int kInstanceColumns = 16;
+	const int kInstanceRows = 9;
+	const float kInstanceScale = 0.3f;
+	const Vector3 kInstanceCenter = { 0.0f, 0.0f, 2.0f };
+	TransformBatch instances;
+	std::vector<Vector4> instanceColors;
+	std::vector<Matrix4x4> instanceWvps(kInstanceColumns * kInstanceRows);
+	std::vector<Matrix4x4> instanceWorlds(kInstanceColumns * kInstanceRows);
+	instances.Reserve(kInstanceColumns * kInstanceRows);
+	for (int row = 0; row < kInstanceRows; ++row) {
+		for (int column = 0; column < kInstanceColumns; ++column) {
+			const float x = (float(column) - float(kInstanceColumns - 1) * 0.5f) * 0.35f;
+			const float y = (float(row) - float(kInstanceRows - 1) * 0.5f) * 0.35f;
+			instances.Add({ { kInstanceScale, kInstanceScale, kInstanceScale }, { 0.0f, 0.0f, 0.0f }, { kInstanceCenter.x + x, kInstanceCenter.y + y, kInstanceCenter.z } });
+			instanceColors.push_back({ float(column) / float(kInstanceColumns - 1), float(row) / float(kInstanceRows - 1), 1.0f, 1.0f });
+		}
+	}
+
+	// スプライト ---------------------------------------------------
+	Vector2 spriteTranslate = { 0.0f, 0.0f };
+	int spriteParticleCount = 1024;
+	float spriteTime = 0.0f;
+
+	// LOD ----------------------------------------------------------
+	float lodPixelError = 1.0f;
+	bool isLodForced = false;
+	int forcedLod = 0;
+	// メッシュレットのカリングは数えるだけなので、見たい時だけ行う
+	bool isMeshletStatsEnabled = false;
+
 	//===============================================================
 	//	メインループ
 	//===============================================================
@@ -53,13 +152,106 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	while (sWinApp->ProcessMessage()) {
 		imGuiManager->Begin();
 		sDirectX->BeginFrame();
+		// 読み終わったテクスチャの転送コマンドを積む
+		textureManager->Update();
 
 		sDirectX->CreateWVPResource(camera->GetVpMatrix());
-		sDirectX->CreateaWVPSpriteRespirce();
 
 		ImGui::ShowDemoWindow();
+
+		// CPUがGPUを待った時間を確認する
+		const FrameScheduler& frameScheduler = sDirectX->GetFrameScheduler();
+		ImGui::Begin("Frame");
+		ImGui::Text("frames in flight : %u", frameScheduler.GetFramesInFlight());
+		ImGui::Text("fence : %llu / %llu", frameScheduler.GetCompletedValue(), frameScheduler.GetLastSignaledValue());
+		const LinearRingAllocator& uploadRing = sDirectX->GetUploadRing()->GetAllocator();
+		ImGui::Text("upload ring : %llu / %llu KB (peak frame %llu KB, %llu failed)", uploadRing.GetUsedSize() / 1024, uploadRing.GetCapacity() / 1024, uploadRing.GetPeakFrameUsedSize() / 1024,
+			sDirectX->GetUploadRing()->GetFailedAllocationCount());
+		ImGui::Text("instances : %u / %u (%u dropped)", sDirectX->GetLastFrameInstanceCount(), DirectXCommon::GetMaxInstancesPerFrame(), sDirectX->GetLastFrameDroppedInstanceCount());
+		ImGui::Text("texture pending : %u (last batch %.1f ms)", textureManager->GetPendingCount(), textureManager->GetLastBatchLoadTime());
+		const StateFilter::Stats& commandStats = sDirectX->GetStateFilter()->GetLastFrameStats();
+		ImGui::Text("commands : %u issued / %u filtered (%u draws)", commandStats.issuedCount, commandStats.filteredCount, commandStats.drawCount);
+		SpriteBatch* spriteBatch = sDirectX->GetSpriteBatch();
+		ImGui::Text("sprites : %u / %u (%u draws, %u dropped)", spriteBatch->GetLastSpriteCount(), spriteBatch->GetMaxSprites(), spriteBatch->GetLastDrawCount(), spriteBatch->GetLastDroppedCount());
+		ImGui::PlotLines("wait (ms)", frameScheduler.GetWaitHistory().data(), static_cast<int>(FrameScheduler::kWaitHistoryCount), static_cast<int>(frameScheduler.GetWaitHistoryOffset()));
+		ImGui::End();
+
+		// スプライトを追加する(描くのはSpriteDraw) ----------------------------
+		ImGui::Begin("sprite");
+		ImGui::SliderFloat2("translate", &spriteTranslate.x, 0, 1280);
+		ImGui::SliderInt("particles", &spriteParticleCount, 0, 60000);
+		ImGui::End();
+		spriteTime += 1.0f / 60.0f;
+		// 左上を原点とした640x360の1枚
+		spriteBatch->Add({ { spriteTranslate.x + 320.0f, spriteTranslate.y + 180.0f }, { 640.0f, 360.0f } });
+		// 円状に回る小さいスプライト(テクスチャの4分の1ずつを切り出す)
+		for (int index = 0; index < spriteParticleCount; ++index) {
+			const float t = float(index) / float(spriteParticleCount);
+			const float angle = t * 6.2831853f * 7.0f + spriteTime;
+			const float radius = 40.0f + t * 300.0f;
+			Sprite sprite{};
+			sprite.position = { float(kWindowWidth) * 0.5f + std::cos(angle) * radius, float(kWindowHeight) * 0.5f + std::sin(angle) * radius };
+			sprite.size = { 16.0f, 16.0f };
+			sprite.uvMin = { float(index & 1) * 0.5f, float((index >> 1) & 1) * 0.5f };
+			sprite.uvMax = { sprite.uvMin.x + 0.5f, sprite.uvMin.y + 0.5f };
+			sprite.color = { 1.0f, t, 1.0f - t, 0.8f };
+			sprite.rotation = angle;
+			sprite.textureHandle = uvCheckerHandle;
+			spriteBatch->Add(sprite);
+		}
+
+		// LODを選ぶ ---------------------------------------------------------
+		// インスタンスは1回で描くので、並びの中心までの距離で全部同じ段にする
+		const Mesh& mesh = sDirectX->GetMesh();
+		const Vector3 boundsCenter = {
+			kInstanceCenter.x + modelBounds.sphereCenter.x * kInstanceScale,
+			kInstanceCenter.y + modelBounds.sphereCenter.y * kInstanceScale,
+			kInstanceCenter.z + modelBounds.sphereCenter.z * kInstanceScale };
+		const float lodDistance = ComputeLodDistance(*camera, boundsCenter, modelBounds.sphereRadius * kInstanceScale);
+		const float lodPixelScale = ComputeLodPixelScale(*camera, float(kWindowWidth), float(kWindowHeight));
+		uint32_t meshLod = SelectMeshLod(mesh.GetLods(), mesh.GetLodCount(), kInstanceScale, lodDistance, lodPixelScale, lodPixelError);
+		ImGui::Begin("mesh");
+		ImGui::SliderFloat("lod pixel error", &lodPixelError, 0.1f, 32.0f);
+		ImGui::Checkbox("force lod", &isLodForced);
+		ImGui::SliderInt("lod", &forcedLod, 0, static_cast<int>(mesh.GetLodCount()) - 1);
+		if (isLodForced) {
+			meshLod = static_cast<uint32_t>(forcedLod);
+		}
+		sDirectX->SetMeshLod(meshLod);
+		const MeshLod& lod = mesh.GetLod(sDirectX->GetMeshLod());
+		ImGui::Text("lod : %u / %u (%u triangles, error %.2f px)", sDirectX->GetMeshLod(), mesh.GetLodCount(), lod.indexCount / 3,
+			lod.error * kInstanceScale * lodPixelScale / lodDistance);
+		ImGui::Checkbox("meshlet culling stats", &isMeshletStatsEnabled);
+		ImGui::End();
+
 		// 三角形の描画
 		sDirectX->DrawCall();
+		for (float& rotateY : instances.GetRotate().y) {
+			rotateY += 0.02f;
+		}
+		// メッシュレットのカリング(描画はまだメッシュ全体なので、インスタンスごとに捨てられる量を数えるだけ)
+		const uint32_t meshLodIndex = sDirectX->GetMeshLod();
+		if (isMeshletStatsEnabled && meshLodIndex < modelLods.size() && modelLods[meshLodIndex].meshletCount != 0) {
+			const auto cullStart = std::chrono::steady_clock::now();
+			const MeshFileLod& meshletLod = modelLods[meshLodIndex];
+			instances.ComputeWorldMatrices(camera->GetVpMatrix(), instanceWvps.data(), instanceWorlds.data());
+			MeshletCullStats meshletStats;
+			for (size_t index = 0; index < instances.GetSize(); ++index) {
+				// 視錐台・カメラの位置をメッシュの座標に持ってくる(拡縮が等倍でなければ円錐は使えない)
+				const Frustum frustum = MakeFrustum(instanceWvps[index]);
+				const Vector3 cameraPosition = Transform(camera->GetTranslate(), InverseAffine(instanceWorlds[index]));
+				CullMeshlets(modelMeshlets.data() + meshletLod.firstMeshlet, modelMeshletBounds.data() + meshletLod.firstMeshlet, meshletLod.meshletCount,
+					frustum, cameraPosition, IsUniformScale(instanceWorlds[index]), nullptr, &meshletStats);
+			}
+			const float cullTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - cullStart).count();
+			ImGui::Begin("mesh");
+			ImGui::Text("meshlets : %u / %u visible (frustum %u, backface %u)", meshletStats.visibleCount, meshletStats.meshletCount,
+				meshletStats.frustumCulledCount, meshletStats.backfaceCulledCount);
+			ImGui::Text("triangles culled : %.1f%% (%.3f ms)", meshletStats.GetCulledTriangleRatio() * 100.0f, cullTime);
+			ImGui::End();
+		}
+		sDirectX->DrawInstances(instances, camera->GetVpMatrix(), instanceColors.data());
+		// 2Dは3Dの上に描く
 		sDirectX->SpriteDraw();
 
 		imGuiManager->End();
@@ -72,11 +264,11 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	//	終了処理
 	//===============================================================
 	imGuiManager->Finalize();
-	/*textureManager->Finalize();*/
+	textureManager->Finalize();
 	sDirectX->Finalize();
 
 	imGuiManager = nullptr;
-	/*textureManager = nullptr;*/
+	textureManager = nullptr;
 	sWinApp = nullptr;
 	sDirectX = nullptr;
 